@@ -13,12 +13,15 @@
 #include "bat/ledger/ledger_client.h"
 #include "bat/ledger/publisher_info.h"
 #include "bat/ledger/media_publisher_info.h"
+#include "bat/ledger/metrics_snapshot.h"
 
 namespace ledger {
 
 extern bool is_production;
 extern int reconcile_time; // minutes
 extern bool short_retries;
+// Saves the ledger state in the compact binary format, both formats load
+extern bool binary_state;
 
 LEDGER_EXPORT struct VisitData {
   VisitData();
@@ -189,6 +192,15 @@ class LEDGER_EXPORT Ledger {
                                           const uint32_t date) = 0;
   virtual void RemoveRecurring(const std::string& publisher_key) = 0;
   virtual double GetDefaultContributionAmount() = 0;
+
+  // Metrics are off by default, collecting them costs a lookup and a few
+  // atomic adds on state saves, database calls and requests
+  virtual void SetMetricsEnabled(bool enabled) = 0;
+  virtual MetricsSnapshot GetMetricsSnapshot() const = 0;
+
+  // Messages above |level| are dropped before they are formatted, by
+  // default every level goes to LedgerClient::Log()
+  virtual void SetLogLevel(LogLevel level) = 0;
 };
 
 }  // namespace ledger
@@ -5,6 +5,7 @@
 #ifndef BAT_LEDGER_LEDGER_CALLBACK_HANDLER_
 #define BAT_LEDGER_LEDGER_CALLBACK_HANDLER_
 
+#include <map>
 #include <string>
 
 #include "bat/ledger/export.h"
@@ -45,6 +46,10 @@ class LEDGER_EXPORT LedgerCallbackHandler {
                                    const std::string& data) {};
   virtual void OnLedgerStateSaved(Result result) {};
 
+  virtual void OnLedgerHistoryLoaded(Result result,
+                                     const std::string& data) {};
+  virtual void OnLedgerHistorySaved(Result result) {};
+
   virtual void OnPublisherStateLoaded(Result result,
                                       const std::string& data) {};
   virtual void OnPublisherStateSaved(Result result) {};
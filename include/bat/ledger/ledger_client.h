@@ -48,6 +48,7 @@ class LEDGER_EXPORT LogStream {
 using PublisherInfoCallback = std::function<void(Result,
     std::unique_ptr<PublisherInfo>)>;
 // TODO(nejczdovc) we should be providing result back as well
+// |next_record| is start of the next page, 0 when there are no more records
 using PublisherInfoListCallback =
     std::function<void(const PublisherInfoList&, uint32_t /* next_record */)>;
 using GetNicewareListCallback =
@@ -75,6 +76,15 @@ class LEDGER_EXPORT LedgerClient {
   virtual void SaveLedgerState(const std::string& ledger_state,
                                LedgerCallbackHandler* handler) = 0;
 
+  // Transactions of past contributions, saved apart from the ledger state
+  // and far less often. The record may be binary and must be stored as is;
+  // NO_LEDGER_STATE when none is stored, any other error fails the startup
+  // like one of the ledger state. History moved out of an older ledger
+  // state is only kept in this record.
+  virtual void LoadLedgerHistory(LedgerCallbackHandler* handler) = 0;
+  virtual void SaveLedgerHistory(const std::string& ledger_history,
+                                 LedgerCallbackHandler* handler) = 0;
+
   virtual void LoadPublisherState(LedgerCallbackHandler* handler) = 0;
   virtual void SavePublisherState(const std::string& publisher_state,
                                   LedgerCallbackHandler* handler) = 0;
@@ -0,0 +1,36 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef BAT_LEDGER_LEDGER_CLIENT_RECORDER_
+#define BAT_LEDGER_LEDGER_CLIENT_RECORDER_
+
+#include <ostream>
+
+#include "bat/ledger/export.h"
+#include "bat/ledger/ledger_client.h"
+
+namespace ledger {
+
+// LedgerClient that forwards everything to |client| and writes the calls
+// made by the ledger, and the results that come back for them, to
+// |trace|. Pass it to Ledger::CreateInstance instead of |client| to
+// capture a session that can be replayed offline. Saved state is only
+// recorded by size, and the loaded ledger state without its wallet info.
+// |client| and |trace| need to outlive the recorder, and the recorder
+// needs to outlive the ledger and its pending callbacks. It is only built
+// into the test targets.
+class LEDGER_EXPORT LedgerClientRecorder : public LedgerClient {
+ public:
+  ~LedgerClientRecorder() override = default;
+
+  static LedgerClientRecorder* Create(LedgerClient* client,
+                                      std::ostream* trace);
+
+  // Number of records written so far
+  virtual size_t size() const = 0;
+};
+
+}  // namespace ledger
+
+#endif  // BAT_LEDGER_LEDGER_CLIENT_RECORDER_
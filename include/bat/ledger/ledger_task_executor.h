@@ -0,0 +1,48 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef BAT_LEDGER_LEDGER_TASK_EXECUTOR_
+#define BAT_LEDGER_LEDGER_TASK_EXECUTOR_
+
+#include <stddef.h>
+
+#include <functional>
+#include <memory>
+
+#include "bat/ledger/export.h"
+#include "bat/ledger/ledger_task_runner.h"
+
+namespace ledger {
+
+// Optional thread pool for embedders that don't have one, it can be used
+// to implement LedgerClient::RunIOTask. Tasks run on the pool threads and
+// what they pass to CallerThreadCallback is run back on the ledger sequence,
+// either through |post_reply| or, when it's not set, by RunReplies().
+class LEDGER_EXPORT LedgerTaskExecutor {
+ public:
+  using Closure = std::function<void(void)>;
+  using PostReplyCallback = std::function<void(Closure)>;
+
+  virtual ~LedgerTaskExecutor() = default;
+
+  // Uses one thread per core when |threads| is 0
+  static LedgerTaskExecutor* Create(size_t threads,
+                                    PostReplyCallback post_reply = nullptr);
+
+  // Can be called from any thread, also from a running task
+  virtual void RunIOTask(std::unique_ptr<LedgerTaskRunner> task) = 0;
+
+  // Runs replies that are waiting for the ledger sequence and returns
+  // how many of them were run. Needs to be called on the ledger sequence.
+  virtual size_t RunReplies() = 0;
+
+  // Finishes queued tasks and stops the threads, tasks that are added
+  // later run on the calling thread. Must not be called from a task of
+  // this executor, since it joins the pool threads.
+  virtual void Shutdown() = 0;
+};
+
+}  // namespace ledger
+
+#endif  // BAT_LEDGER_LEDGER_TASK_EXECUTOR_
@@ -0,0 +1,41 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef BAT_LEDGER_METRICS_SNAPSHOT_H_
+#define BAT_LEDGER_METRICS_SNAPSHOT_H_
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "bat/ledger/export.h"
+
+namespace ledger {
+
+LEDGER_EXPORT struct HistogramSnapshot {
+  HistogramSnapshot();
+  HistogramSnapshot(const HistogramSnapshot& histogram);
+  ~HistogramSnapshot();
+
+  // Upper bounds of the buckets in milliseconds, |buckets| has one more
+  // entry for the values above the last bound
+  std::vector<uint64_t> bounds;
+  std::vector<uint64_t> buckets;
+  uint64_t count;
+  uint64_t sum;
+};
+
+LEDGER_EXPORT struct MetricsSnapshot {
+  MetricsSnapshot();
+  MetricsSnapshot(const MetricsSnapshot& snapshot);
+  ~MetricsSnapshot();
+
+  bool enabled;
+  std::map<std::string, uint64_t> counters;
+  std::map<std::string, HistogramSnapshot> histograms;
+};
+
+}  // namespace ledger
+
+#endif  // BAT_LEDGER_METRICS_SNAPSHOT_H_
@@ -4,7 +4,9 @@
 
 #include "bat/ledger/ledger.h"
 
+#include "bat/ledger/ledger_task_executor.h"
 #include "ledger_impl.h"
+#include "ledger_task_executor_impl.h"
 #include "rapidjson/document.h"
 #include "rapidjson/stringbuffer.h"
 #include "rapidjson/writer.h"
@@ -15,6 +17,7 @@ namespace ledger {
 bool is_production = true;
 int reconcile_time = 0; // minutes
 bool short_retries = false;
+bool binary_state = false;
 
 VisitData::VisitData():
     tab_id(-1) {}
@@ -200,6 +203,12 @@ ledger::Ledger* Ledger::CreateInstance(LedgerClient* client) {
   return new bat_ledger::LedgerImpl(client);
 }
 
+// static
+LedgerTaskExecutor* LedgerTaskExecutor::Create(size_t threads,
+                                               PostReplyCallback post_reply) {
+  return new bat_ledger::LedgerTaskExecutorImpl(threads, post_reply);
+}
+
 WalletInfo::WalletInfo () : balance_(0), parameters_days_(0) {}
 WalletInfo::~WalletInfo () {}
 WalletInfo::WalletInfo (const ledger::WalletInfo &info) {
@@ -246,6 +255,19 @@ BalanceReportInfo::BalanceReportInfo(const BalanceReportInfo& state) {
 
 BalanceReportInfo::~BalanceReportInfo() {}
 
+HistogramSnapshot::HistogramSnapshot() : count(0), sum(0) {}
+
+HistogramSnapshot::HistogramSnapshot(const HistogramSnapshot& histogram) =
+    default;
+
+HistogramSnapshot::~HistogramSnapshot() {}
+
+MetricsSnapshot::MetricsSnapshot() : enabled(false) {}
+
+MetricsSnapshot::MetricsSnapshot(const MetricsSnapshot& snapshot) = default;
+
+MetricsSnapshot::~MetricsSnapshot() {}
+
 bool Ledger::IsMediaLink(const std::string& url, const std::string& first_party_url, const std::string& referrer) {
   return braveledger_bat_get_media::BatGetMedia::GetLinkType(url, first_party_url, referrer) == TWITCH_MEDIA_TYPE;
 }
@@ -0,0 +1,243 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "bat_binary_fields.h"
+
+#include "bat_helper_platform.h"
+
+// CRC-32C has an instruction since SSE 4.2, picked at run time like the
+// AVX2 codecs
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define BAT_STATE_CRC32C_SSE42
+#include <nmmintrin.h>
+#endif
+
+namespace braveledger_bat_helper {
+
+namespace {
+
+// can not start a JSON text
+const char kMagic[] = {'\x89', 'B', 'A', 'T'};
+const size_t kVersionOffset = sizeof(kMagic);
+const size_t kChecksumOffset = kVersionOffset + 1;
+const size_t kHeaderSize = kChecksumOffset + 4;
+
+// Room left for the length of a block, a varint of up to 35 bits
+const size_t kBlockLengthSize = 5;
+
+size_t EncodeVarint(uint64_t value, char* out) {
+  size_t size = 0;
+  while (value >= 0x80) {
+    out[size++] = static_cast<char>(value | 0x80);
+    value >>= 7;
+  }
+  out[size++] = static_cast<char>(value);
+  return size;
+}
+
+const uint32_t* GetCrcTable() {
+  static uint32_t* table = [] {
+    uint32_t* table = new uint32_t[256];
+    for (uint32_t i = 0; i < 256; i++) {
+      uint32_t crc = i;
+      for (int bit = 0; bit < 8; bit++) {
+        crc = (crc >> 1) ^ (0x82f63b78u & (0u - (crc & 1)));
+      }
+      table[i] = crc;
+    }
+    return table;
+  }();
+  return table;
+}
+
+uint32_t Crc32cTable(uint32_t crc, const char* data, size_t length) {
+  const uint32_t* table = GetCrcTable();
+  for (size_t i = 0; i < length; i++) {
+    crc = table[(crc ^ static_cast<uint8_t>(data[i])) & 0xff] ^ (crc >> 8);
+  }
+  return crc;
+}
+
+#if defined(BAT_STATE_CRC32C_SSE42)
+bool HasSSE42() {
+  static const bool has_sse42 = __builtin_cpu_supports("sse4.2");
+  return has_sse42;
+}
+
+__attribute__((target("sse4.2")))
+uint32_t Crc32cSSE42(uint32_t crc, const char* data, size_t length) {
+  uint64_t crc64 = crc;
+  for (; length >= 8; data += 8, length -= 8) {
+    uint64_t word;
+    memcpy(&word, data, sizeof(word));
+    crc64 = _mm_crc32_u64(crc64, word);
+  }
+  crc = static_cast<uint32_t>(crc64);
+  for (; length > 0; data++, length--) {
+    crc = _mm_crc32_u8(crc, static_cast<uint8_t>(*data));
+  }
+  return crc;
+}
+#endif
+
+}  // namespace
+
+uint32_t Crc32c(const char* data, size_t length) {
+#if defined(BAT_STATE_CRC32C_SSE42)
+  if (HasSSE42()) {
+    return ~Crc32cSSE42(0xffffffffu, data, length);
+  }
+#endif
+  return Crc32cPortable(data, length);
+}
+
+uint32_t Crc32cPortable(const char* data, size_t length) {
+  return ~Crc32cTable(0xffffffffu, data, length);
+}
+
+void BinaryWriter::Varint(uint64_t value) {
+  char bytes[10];
+  out_->append(bytes, EncodeVarint(value, bytes));
+}
+
+void BinaryWriter::Fixed64(uint64_t value) {
+  for (int i = 0; i < 8; i++) {
+    out_->push_back(static_cast<char>(value >> (i * 8)));
+  }
+}
+
+void BinaryWriter::Bytes(const void* data, size_t length) {
+  Varint(length);
+  out_->append(static_cast<const char*>(data), length);
+}
+
+void BinaryWriter::Key(size_t field, WireType type) {
+  Varint((static_cast<uint64_t>(field) << 3) | static_cast<uint8_t>(type));
+}
+
+size_t BinaryWriter::StartBlock() {
+  out_->append(kBlockLengthSize, '\0');
+  return out_->size();
+}
+
+// The block is moved back over the room its length does not need
+void BinaryWriter::EndBlock(size_t start) {
+  size_t length = out_->size() - start;
+  char prefix[10];
+  size_t prefix_size = EncodeVarint(length, prefix);
+  DCHECK(prefix_size <= kBlockLengthSize);
+
+  size_t begin = start - kBlockLengthSize;
+  if (prefix_size < kBlockLengthSize) {
+    memmove(&(*out_)[begin + prefix_size], &(*out_)[start], length);
+    out_->resize(begin + prefix_size + length);
+  }
+  memcpy(&(*out_)[begin], prefix, prefix_size);
+}
+
+bool BinaryReader::Varint(uint64_t* value) {
+  uint64_t result = 0;
+  for (int shift = 0; shift < 64; shift += 7) {
+    if (position_ == end_) {
+      return false;
+    }
+
+    uint8_t byte = static_cast<uint8_t>(*position_++);
+    result |= static_cast<uint64_t>(byte & 0x7f) << shift;
+    if (!(byte & 0x80)) {
+      *value = result;
+      return true;
+    }
+  }
+  return false;
+}
+
+bool BinaryReader::Fixed64(uint64_t* value) {
+  if (end_ - position_ < 8) {
+    return false;
+  }
+
+  uint64_t result = 0;
+  for (int i = 0; i < 8; i++) {
+    result |= static_cast<uint64_t>(static_cast<uint8_t>(position_[i]))
+        << (i * 8);
+  }
+  position_ += 8;
+  *value = result;
+  return true;
+}
+
+bool BinaryReader::Bytes(const char** data, size_t* length) {
+  uint64_t size;
+  if (!Varint(&size) || size > static_cast<uint64_t>(end_ - position_)) {
+    return false;
+  }
+
+  *data = position_;
+  *length = static_cast<size_t>(size);
+  position_ += size;
+  return true;
+}
+
+bool BinaryReader::Skip(WireType type) {
+  uint64_t ignored;
+  const char* data;
+  size_t length;
+  switch (type) {
+    case WireType::VARINT:
+      return Varint(&ignored);
+    case WireType::FIXED64:
+      return Fixed64(&ignored);
+    case WireType::BYTES:
+      return Bytes(&data, &length);
+  }
+  return false;
+}
+
+bool IsBinaryState(const std::string& data) {
+  return data.size() >= sizeof(kMagic) &&
+      0 == data.compare(0, sizeof(kMagic), kMagic, sizeof(kMagic));
+}
+
+void StartBinaryState(std::string* out) {
+  out->clear();
+  out->append(kMagic, sizeof(kMagic));
+  out->push_back(static_cast<char>(kBinaryStateVersion));
+  out->append(4, '\0');
+}
+
+void FinishBinaryState(std::string* out) {
+  DCHECK(out->size() >= kHeaderSize);
+  uint32_t crc = Crc32c(out->data() + kHeaderSize, out->size() - kHeaderSize);
+  for (int i = 0; i < 4; i++) {
+    (*out)[kChecksumOffset + i] = static_cast<char>(crc >> (i * 8));
+  }
+}
+
+bool OpenBinaryState(const std::string& data, BinaryReader* body) {
+  if (data.size() < kHeaderSize || !IsBinaryState(data)) {
+    return false;
+  }
+
+  // no older binary versions yet, JSON states are migrated by saving them
+  if (static_cast<uint8_t>(data[kVersionOffset]) != kBinaryStateVersion) {
+    return false;
+  }
+
+  uint32_t crc = 0;
+  for (int i = 0; i < 4; i++) {
+    crc |= static_cast<uint32_t>(
+        static_cast<uint8_t>(data[kChecksumOffset + i])) << (i * 8);
+  }
+  const char* begin = data.data() + kHeaderSize;
+  size_t length = data.size() - kHeaderSize;
+  if (crc != Crc32c(begin, length)) {
+    return false;
+  }
+
+  *body = BinaryReader(begin, length);
+  return true;
+}
+
+}  // namespace braveledger_bat_helper
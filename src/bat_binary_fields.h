@@ -0,0 +1,466 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVELEDGER_BAT_BINARY_FIELDS_H_
+#define BRAVELEDGER_BAT_BINARY_FIELDS_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <map>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "bat_fields.h"
+
+// Binary encoding of the member tables of bat_fields.h. A saved struct is
+// a header and the fields of its table, each field is a key with the table
+// index and the wire type, then the value:
+//
+//   header   "\x89BAT", version byte, CRC-32C of the rest, little endian
+//   VARINT   unsigned, bool and enum values, int is zigzag encoded
+//   FIXED64  double, little endian
+//   BYTES    varint length, then string bytes, a nested struct, or the
+//            elements of a vector or map
+//
+// Strings and blobs are saved as they are, nothing is escaped. Readers
+// skip fields they do not know, so members can be added to the end of a
+// table without a new version. Any other change bumps kBinaryStateVersion,
+// OpenBinaryState() turns down versions it does not know.
+namespace braveledger_bat_helper {
+
+const uint8_t kBinaryStateVersion = 1;
+
+enum class WireType : uint8_t {
+  VARINT = 0,
+  FIXED64 = 1,
+  BYTES = 2,
+};
+
+class BinaryWriter {
+ public:
+  explicit BinaryWriter(std::string* out) : out_(out) {}
+
+  void Varint(uint64_t value);
+  void Fixed64(uint64_t value);
+  void Bytes(const void* data, size_t length);
+  void Key(size_t field, WireType type);
+
+  // BYTES of unknown length, the length is filled in by EndBlock()
+  size_t StartBlock();
+  void EndBlock(size_t start);
+
+ private:
+  std::string* out_;  // NOT OWNED
+};
+
+class BinaryReader {
+ public:
+  BinaryReader(const char* data, size_t length) :
+    position_(data),
+    end_(data + length) {}
+
+  bool Varint(uint64_t* value);
+  bool Fixed64(uint64_t* value);
+  // |data| points into the reader input
+  bool Bytes(const char** data, size_t* length);
+  bool Skip(WireType type);
+
+  const char* position() const { return position_; }
+  const char* end() const { return end_; }
+  bool AtEnd() const { return position_ == end_; }
+
+ private:
+  const char* position_;
+  const char* end_;
+};
+
+template <typename T>
+void WriteBinaryObject(BinaryWriter& writer, const T& value);
+
+template <typename T>
+bool ReadBinaryObject(BinaryReader& reader, T* value);
+
+// Wire types, one per member type or codec
+
+inline WireType BinaryWireType(const std::string*, Plain) {
+  return WireType::BYTES;
+}
+
+inline WireType BinaryWireType(const unsigned int*, Plain) {
+  return WireType::VARINT;
+}
+
+inline WireType BinaryWireType(const int*, Plain) {
+  return WireType::VARINT;
+}
+
+inline WireType BinaryWireType(const uint64_t*, Plain) {
+  return WireType::VARINT;
+}
+
+inline WireType BinaryWireType(const double*, Plain) {
+  return WireType::FIXED64;
+}
+
+inline WireType BinaryWireType(const bool*, Plain) {
+  return WireType::VARINT;
+}
+
+template <typename E>
+typename std::enable_if<std::is_enum<E>::value, WireType>::type
+BinaryWireType(const E*, Plain) {
+  return WireType::VARINT;
+}
+
+template <typename T>
+auto BinaryWireType(const T*, Plain)
+    -> decltype(FieldTable<T>::Get(), WireType()) {
+  return WireType::BYTES;
+}
+
+template <typename V>
+WireType BinaryWireType(const std::vector<V>*, Plain) {
+  return WireType::BYTES;
+}
+
+template <typename V>
+WireType BinaryWireType(const std::map<std::string, V>*, Plain) {
+  return WireType::BYTES;
+}
+
+inline WireType BinaryWireType(const std::vector<uint8_t>*, Base64) {
+  return WireType::BYTES;
+}
+
+// The other codecs only change the JSON form of a member
+template <typename M, typename Codec>
+typename std::enable_if<!std::is_same<Codec, Plain>::value, WireType>::type
+BinaryWireType(const M* value, Codec) {
+  return BinaryWireType(value, Plain());
+}
+
+// Value writers
+
+inline void WriteBinary(BinaryWriter& writer,
+                        const std::string& value,
+                        Plain) {
+  writer.Bytes(value.data(), value.size());
+}
+
+inline void WriteBinary(BinaryWriter& writer, unsigned int value, Plain) {
+  writer.Varint(value);
+}
+
+inline void WriteBinary(BinaryWriter& writer, int value, Plain) {
+  // zigzag, small negative numbers stay short
+  uint32_t bits = static_cast<uint32_t>(value);
+  writer.Varint((bits << 1) ^ (value < 0 ? 0xffffffffu : 0u));
+}
+
+inline void WriteBinary(BinaryWriter& writer, uint64_t value, Plain) {
+  writer.Varint(value);
+}
+
+inline void WriteBinary(BinaryWriter& writer, double value, Plain) {
+  uint64_t bits;
+  memcpy(&bits, &value, sizeof(bits));
+  writer.Fixed64(bits);
+}
+
+inline void WriteBinary(BinaryWriter& writer, bool value, Plain) {
+  writer.Varint(value ? 1 : 0);
+}
+
+template <typename E>
+typename std::enable_if<std::is_enum<E>::value>::type
+WriteBinary(BinaryWriter& writer, E value, Plain) {
+  WriteBinary(writer, static_cast<int>(value), Plain());
+}
+
+template <typename T>
+auto WriteBinary(BinaryWriter& writer, const T& value, Plain)
+    -> decltype(FieldTable<T>::Get(), void()) {
+  size_t start = writer.StartBlock();
+  WriteBinaryObject(writer, value);
+  writer.EndBlock(start);
+}
+
+template <typename V>
+void WriteBinary(BinaryWriter& writer, const std::vector<V>& value, Plain) {
+  size_t start = writer.StartBlock();
+  for (const auto& item : value) {
+    WriteBinary(writer, item, Plain());
+  }
+  writer.EndBlock(start);
+}
+
+template <typename V>
+void WriteBinary(BinaryWriter& writer,
+                 const std::map<std::string, V>& value,
+                 Plain) {
+  size_t start = writer.StartBlock();
+  for (const auto& item : value) {
+    WriteBinary(writer, item.first, Plain());
+    WriteBinary(writer, item.second, Plain());
+  }
+  writer.EndBlock(start);
+}
+
+inline void WriteBinary(BinaryWriter& writer,
+                        const std::vector<uint8_t>& value,
+                        Base64) {
+  writer.Bytes(value.data(), value.size());
+}
+
+template <typename M, typename Codec>
+typename std::enable_if<!std::is_same<Codec, Plain>::value>::type
+WriteBinary(BinaryWriter& writer, const M& value, Codec) {
+  WriteBinary(writer, value, Plain());
+}
+
+// Value readers, false when the input ends early. Nested structs and the
+// elements of containers are loaded on a best effort basis, as from JSON.
+
+inline bool ReadBinary(BinaryReader& reader, std::string* value, Plain) {
+  const char* data;
+  size_t length;
+  if (!reader.Bytes(&data, &length)) {
+    return false;
+  }
+  value->assign(data, length);
+  return true;
+}
+
+inline bool ReadBinary(BinaryReader& reader, unsigned int* value, Plain) {
+  uint64_t varint;
+  if (!reader.Varint(&varint)) {
+    return false;
+  }
+  *value = static_cast<unsigned int>(varint);
+  return true;
+}
+
+inline bool ReadBinary(BinaryReader& reader, int* value, Plain) {
+  uint64_t varint;
+  if (!reader.Varint(&varint)) {
+    return false;
+  }
+  uint32_t bits = static_cast<uint32_t>(varint);
+  *value = static_cast<int>((bits >> 1) ^ (0u - (bits & 1)));
+  return true;
+}
+
+inline bool ReadBinary(BinaryReader& reader, uint64_t* value, Plain) {
+  return reader.Varint(value);
+}
+
+inline bool ReadBinary(BinaryReader& reader, double* value, Plain) {
+  uint64_t bits;
+  if (!reader.Fixed64(&bits)) {
+    return false;
+  }
+  memcpy(value, &bits, sizeof(bits));
+  return true;
+}
+
+inline bool ReadBinary(BinaryReader& reader, bool* value, Plain) {
+  uint64_t varint;
+  if (!reader.Varint(&varint)) {
+    return false;
+  }
+  *value = varint != 0;
+  return true;
+}
+
+template <typename E>
+typename std::enable_if<std::is_enum<E>::value, bool>::type
+ReadBinary(BinaryReader& reader, E* value, Plain) {
+  int number;
+  if (!ReadBinary(reader, &number, Plain())) {
+    return false;
+  }
+  *value = static_cast<E>(number);
+  return true;
+}
+
+template <typename T>
+auto ReadBinary(BinaryReader& reader, T* value, Plain)
+    -> decltype(FieldTable<T>::Get(), bool()) {
+  const char* data;
+  size_t length;
+  if (!reader.Bytes(&data, &length)) {
+    return false;
+  }
+  BinaryReader object(data, length);
+  ReadBinaryObject(object, value);
+  return true;
+}
+
+template <typename V>
+bool ReadBinary(BinaryReader& reader, std::vector<V>* value, Plain) {
+  const char* data;
+  size_t length;
+  if (!reader.Bytes(&data, &length)) {
+    return false;
+  }
+
+  value->clear();
+  BinaryReader items(data, length);
+  while (!items.AtEnd()) {
+    value->emplace_back();
+    if (!ReadBinary(items, &value->back(), Plain())) {
+      value->pop_back();
+      return false;
+    }
+  }
+  return true;
+}
+
+template <typename V>
+bool ReadBinary(BinaryReader& reader,
+                std::map<std::string, V>* value,
+                Plain) {
+  const char* data;
+  size_t length;
+  if (!reader.Bytes(&data, &length)) {
+    return false;
+  }
+
+  value->clear();
+  BinaryReader items(data, length);
+  while (!items.AtEnd()) {
+    std::string key;
+    V entry;
+    if (!ReadBinary(items, &key, Plain()) ||
+        !ReadBinary(items, &entry, Plain())) {
+      return false;
+    }
+    value->insert(std::make_pair(std::move(key), std::move(entry)));
+  }
+  return true;
+}
+
+inline bool ReadBinary(BinaryReader& reader,
+                       std::vector<uint8_t>* value,
+                       Base64) {
+  const char* data;
+  size_t length;
+  if (!reader.Bytes(&data, &length)) {
+    return false;
+  }
+  value->assign(data, data + length);
+  return true;
+}
+
+template <typename M, typename Codec>
+typename std::enable_if<!std::is_same<Codec, Plain>::value, bool>::type
+ReadBinary(BinaryReader& reader, M* value, Codec) {
+  return ReadBinary(reader, value, Plain());
+}
+
+template <typename T>
+void WriteBinaryObject(BinaryWriter& writer, const T& value) {
+  VisitFields<T>([&writer, &value](const auto& field, size_t i) {
+    typedef typename std::decay<decltype(field)>::type::CodecType Codec;
+    const auto& member = field.access.Get(value);
+    writer.Key(i, BinaryWireType(&member, Codec()));
+    WriteBinary(writer, member, Codec());
+  });
+}
+
+// Same rules as ReadObject(): |value| is only assigned when every required
+// field is there with its wire type
+template <typename T>
+bool ReadBinaryObject(BinaryReader& reader, T* value) {
+  WireType types[FieldCount<T>()];
+  VisitFields<T>([&types, value](const auto& field, size_t i) {
+    typedef typename std::decay<decltype(field)>::type::CodecType Codec;
+    types[i] = BinaryWireType(&field.access.Get(value), Codec());
+  });
+
+  const char* found[FieldCount<T>()] = {};
+  while (!reader.AtEnd()) {
+    uint64_t key;
+    if (!reader.Varint(&key)) {
+      return false;
+    }
+
+    const char* start = reader.position();
+    WireType type = static_cast<WireType>(key & 7);
+    if (!reader.Skip(type)) {
+      return false;
+    }
+
+    // unknown fields come from newer versions, a wire type that does not
+    // match counts as missing
+    uint64_t field = key >> 3;
+    if (field < FieldCount<T>() && !found[field] && types[field] == type) {
+      found[field] = start;
+    }
+  }
+
+  bool valid = true;
+  VisitFields<T>([&found, &valid](const auto& field, size_t i) {
+    if (!found[i] && field.presence == Presence::REQUIRED) {
+      valid = false;
+    }
+  });
+  if (!valid) {
+    return false;
+  }
+
+  const char* end = reader.end();
+  VisitFields<T>([&found, end, value](const auto& field, size_t i) {
+    typedef typename std::decay<decltype(field)>::type::CodecType Codec;
+    if (found[i]) {
+      BinaryReader member(found[i], end - found[i]);
+      ReadBinary(member, &field.access.Get(value), Codec());
+    }
+  });
+  return true;
+}
+
+// True when |data| starts with the binary header, anything else is taken
+// for JSON
+bool IsBinaryState(const std::string& data);
+
+// Checksum of the header, with the SSE 4.2 instruction when the CPU has
+// it. The table version is what other CPUs use, it is exposed so that
+// both can be tested on one machine.
+uint32_t Crc32c(const char* data, size_t length);
+uint32_t Crc32cPortable(const char* data, size_t length);
+
+// Header of the current version, the checksum is filled in by
+// FinishBinaryState() once the fields are written
+void StartBinaryState(std::string* out);
+void FinishBinaryState(std::string* out);
+
+// Checks the header and the checksum, |body| then reads the fields
+bool OpenBinaryState(const std::string& data, BinaryReader* body);
+
+template <typename T>
+void SaveToBinaryString(const T& value, std::string* out) {
+  StartBinaryState(out);
+  BinaryWriter writer(out);
+  WriteBinaryObject(writer, value);
+  FinishBinaryState(out);
+}
+
+template <typename T>
+bool LoadFromBinaryString(const std::string& data, T* value) {
+  BinaryReader body(nullptr, 0);
+  if (!OpenBinaryState(data, &body)) {
+    return false;
+  }
+
+  return ReadBinaryObject(body, value);
+}
+
+}  // namespace braveledger_bat_helper
+
+#endif  // BRAVELEDGER_BAT_BINARY_FIELDS_H_
@@ -5,10 +5,12 @@
 #include "bat_client.h"
 
 #include <algorithm>
+#include <ctime>
 #include <sstream>
 
 #include "ledger_impl.h"
 #include "bat_helper.h"
+#include "http_signature.h"
 #include "rapidjson_bat_helper.h"
 #include "static_values.h"
 
@@ -20,7 +22,9 @@ using namespace std::placeholders;
 namespace braveledger_bat_client {
 
 BatClient::BatClient(bat_ledger::LedgerImpl* ledger) :
-      ledger_(ledger) {
+      ledger_(ledger),
+      handler_(ledger->GetURLRequestScheduler(),
+               bat_ledger::URLRequestPriority::PANEL) {
   initAnonize();
 }
 
@@ -81,19 +85,21 @@ void BatClient::requestCredentialsCallback(bool result, const std::string& respo
 
   wallet_info.keyInfoSeed_ = key_info_seed;
   ledger_->SetWalletInfo(wallet_info);
-  std::vector<uint8_t> secretKey = braveledger_bat_helper::getHKDF(key_info_seed);
-  std::vector<uint8_t> publicKey;
-  std::vector<uint8_t> newSecretKey;
-  braveledger_bat_helper::getPublicKeyFromSeed(secretKey, publicKey, newSecretKey);
+  bat_ledger::HttpSigner* signer = ledger_->GetWalletSigner();
+  if (!signer) {
+    ledger_->OnWalletInitialized(ledger::Result::LEDGER_ERROR);
+    return;
+  }
+  std::vector<uint8_t> publicKey = signer->GetPublicKey();
   std::string label = ledger_->GenerateGUID();
   std::string publicKeyHex = braveledger_bat_helper::uint8ToHex(publicKey);
   std::string keys[3] = {"currency", "label", "publicKey"};
   std::string values[3] = {CURRENCY, label, publicKeyHex};
   std::string octets = braveledger_bat_helper::stringify(keys, values, 3);
-  std::string headerDigest = "SHA-256=" + braveledger_bat_helper::getBase64(braveledger_bat_helper::getSHA256(octets));
-  std::string headerKeys[1] = {"digest"};
-  std::string headerValues[1] = {headerDigest};
-  std::string headerSignature = braveledger_bat_helper::sign(headerKeys, headerValues, 1, "primary", newSecretKey);
+  std::string headerDigest;
+  bat_ledger::HttpSigner::GetDigest(octets, &headerDigest);
+  std::string headerSignature;
+  signer->SignDigest(headerDigest, &headerSignature);
 
   braveledger_bat_helper::REQUEST_CREDENTIALS_ST requestCredentials;
   requestCredentials.requestType_ = "httpSignature";
@@ -122,6 +128,7 @@ void BatClient::requestCredentialsCallback(bool result, const std::string& respo
 }
 
 std::string BatClient::getAnonizeProof(const std::string& registrarVK, const std::string& id, std::string& preFlight) {
+  uint64_t start = ledger_->GetMetrics()->StartTime();
   const char* cred = makeCred(id.c_str());
   if (nullptr != cred) {
     preFlight = cred;
@@ -130,6 +137,7 @@ std::string BatClient::getAnonizeProof(const std::string& registrarVK, const std
     return "";
   }
   const char* proofTemp = registerUserMessage(preFlight.c_str(), registrarVK.c_str());
+  ledger_->GetMetrics()->AddTime("anonize.register_user_message", start);
   std::string proof;
   if (nullptr != proofTemp) {
     proof = proofTemp;
@@ -156,8 +164,10 @@ void BatClient::registerPersonaCallback(bool result,
     ledger_->OnWalletInitialized(ledger::Result::BAD_REGISTRATION_RESPONSE);
     return;
   }
+  uint64_t start = ledger_->GetMetrics()->StartTime();
   const char* masterUserToken = registerUserFinal(ledger_->GetUserId().c_str(), verification.c_str(),
     ledger_->GetPreFlight().c_str(), ledger_->GetRegistrarVK().c_str());
+  ledger_->GetMetrics()->AddTime("anonize.register_user_final", start);
   if (nullptr != masterUserToken) {
     ledger_->SetMasterUserToken(masterUserToken);
     free((void*)masterUserToken);
@@ -195,41 +205,81 @@ void BatClient::getWalletProperties() {
   }
 
   std::string path = (std::string)WALLET_PROPERTIES + payment_id + WALLET_PROPERTIES_END;
-   auto request_id = ledger_->LoadURL(
-       braveledger_bat_helper::buildURL(path, PREFIX_V2, braveledger_bat_helper::SERVER_TYPES::BALANCE),
-       std::vector<std::string>(),
-       "",
-       "",
-       ledger::URL_METHOD::GET,
-       &handler_);
-
-   handler_.AddRequestHandler(std::move(request_id),
+  std::string url = braveledger_bat_helper::buildURL(path, PREFIX_V2,
+      braveledger_bat_helper::SERVER_TYPES::BALANCE);
+  bat_ledger::URLResponseCache* cache = ledger_->GetURLResponseCache();
+  if (cache->IsFresh(url, std::time(nullptr))) {
+    // panel refreshes that come in a burst share the last response, it is
+    // still answered from a timer so callers always get it asynchronously
+    ledger_->SetTimer(0,
+        std::bind(&BatClient::cachedWalletPropertiesCallback, this));
+    return;
+  }
+
+  std::vector<std::string> headers;
+  cache->AddConditionalHeaders(url, &headers);
+  auto request_id = ledger_->LoadURL(
+      url,
+      headers,
+      "",
+      "",
+      ledger::URL_METHOD::GET,
+      &handler_);
+
+  handler_.AddResponseHandler(std::move(request_id),
                               std::bind(&BatClient::walletPropertiesCallback,
                                         this,
+                                        url,
                                         _1,
                                         _2,
                                         _3));
- }
-
- void BatClient::walletPropertiesCallback(bool success,
-                                          const std::string& response,
-                                          const std::map<std::string, std::string>& headers) {
-   braveledger_bat_helper::WALLET_PROPERTIES_ST properties;
-   ledger_->LogResponse(__func__, success, response, headers);
-   if (!success) {
-     ledger_->OnWalletProperties(ledger::Result::LEDGER_ERROR, properties);
-     return;
-   }
-
-   bool ok = braveledger_bat_helper::loadFromJson(properties, response);
-   if (!ok) {
-     BLOG(ledger_, ledger::LogLevel::LOG_ERROR) <<
-       "Failed to load wallet properties state";
-     ledger_->OnWalletProperties(ledger::Result::LEDGER_ERROR, properties);
-     return;
-   }
-   ledger_->SetWalletProperties(properties);
-   ledger_->OnWalletProperties(ledger::Result::LEDGER_OK, properties);
+}
+
+void BatClient::cachedWalletPropertiesCallback() {
+  ledger_->OnWalletProperties(ledger::Result::LEDGER_OK,
+                              ledger_->GetWalletProperties());
+}
+
+void BatClient::walletPropertiesCallback(const std::string& url,
+                                         int response_code,
+                                         const std::string& response,
+                                         const std::map<std::string, std::string>& headers) {
+  bool success = response_code == 200 || response_code == 304;
+  braveledger_bat_helper::WALLET_PROPERTIES_ST properties;
+  ledger_->LogResponse(__func__, success, response, headers);
+  if (!success) {
+    ledger_->OnWalletProperties(ledger::Result::LEDGER_ERROR, properties);
+    return;
+  }
+
+  bat_ledger::URLResponseCache* cache = ledger_->GetURLResponseCache();
+  if (response_code == 304) {
+    // properties that were parsed from the last response are still current
+    cache->OnResponse(url,
+                      response_code,
+                      headers,
+                      braveledger_ledger::_wallet_properties_ttl,
+                      std::time(nullptr));
+    ledger_->OnWalletProperties(ledger::Result::LEDGER_OK,
+                                ledger_->GetWalletProperties());
+    return;
+  }
+
+  bool ok = braveledger_bat_helper::loadFromJson(properties, response);
+  if (!ok) {
+    BLOG(ledger_, ledger::LogLevel::LOG_ERROR) <<
+      "Failed to load wallet properties state";
+    cache->Remove(url);
+    ledger_->OnWalletProperties(ledger::Result::LEDGER_ERROR, properties);
+    return;
+  }
+  cache->OnResponse(url,
+                    response_code,
+                    headers,
+                    braveledger_ledger::_wallet_properties_ttl,
+                    std::time(nullptr));
+  ledger_->SetWalletProperties(properties);
+  ledger_->OnWalletProperties(ledger::Result::LEDGER_OK, properties);
 }
 
 std::string BatClient::getWalletPassphrase() const {
@@ -32,7 +32,10 @@ class BatClient {
   void registerPersonaCallback(bool result, const std::string& response,
       const std::map<std::string, std::string>& headers);
   std::string getWalletPassphrase() const;
-  void walletPropertiesCallback(bool success, const std::string& response,
+  void cachedWalletPropertiesCallback();
+  void walletPropertiesCallback(const std::string& url,
+      int response_code,
+      const std::string& response,
       const std::map<std::string, std::string>& headers);
   void recoverWallet(const std::string& passPhrase);
   void getGrant(const std::string& lang, const std::string& forPaymentId);
@@ -0,0 +1,348 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "bat_codec.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define BAT_CODEC_SSE2
+#include <emmintrin.h>
+#endif
+
+// AVX2 is picked at run time, GCC and clang can build it into this file
+// without -mavx2
+#if (defined(__x86_64__) || defined(__i386__)) && \
+    (defined(__GNUC__) || defined(__clang__))
+#define BAT_CODEC_AVX2
+#include <immintrin.h>
+#endif
+
+namespace braveledger_bat_codec {
+
+namespace {
+
+const char kHexDigits[] = "0123456789abcdef";
+
+const char kBase64Chars[] =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+const uint8_t kInvalid = 0xff;
+
+// Value of every character, kInvalid for the others
+struct DecodeTables {
+  DecodeTables() {
+    for (int i = 0; i < 256; i++) {
+      hex[i] = kInvalid;
+      base64[i] = kInvalid;
+    }
+    for (int i = 0; i < 10; i++) {
+      hex['0' + i] = i;
+    }
+    for (int i = 0; i < 6; i++) {
+      hex['a' + i] = 10 + i;
+      hex['A' + i] = 10 + i;
+    }
+    for (int i = 0; i < 64; i++) {
+      base64[static_cast<uint8_t>(kBase64Chars[i])] = i;
+    }
+  }
+
+  uint8_t hex[256];
+  uint8_t base64[256];
+};
+
+const DecodeTables& GetDecodeTables() {
+  static const DecodeTables tables;
+  return tables;
+}
+
+void HexEncodeScalar(const uint8_t* in, size_t length, char* out) {
+  for (size_t i = 0; i < length; i++) {
+    out[2 * i] = kHexDigits[in[i] >> 4];
+    out[2 * i + 1] = kHexDigits[in[i] & 0x0f];
+  }
+}
+
+void Base64EncodeScalar(const uint8_t* in, size_t length, char* out) {
+  size_t i = 0;
+  for (; i + 3 <= length; i += 3) {
+    uint32_t value = in[i] << 16 | in[i + 1] << 8 | in[i + 2];
+    out[0] = kBase64Chars[value >> 18];
+    out[1] = kBase64Chars[(value >> 12) & 0x3f];
+    out[2] = kBase64Chars[(value >> 6) & 0x3f];
+    out[3] = kBase64Chars[value & 0x3f];
+    out += 4;
+  }
+
+  if (i + 1 == length) {
+    uint32_t value = in[i] << 16;
+    out[0] = kBase64Chars[value >> 18];
+    out[1] = kBase64Chars[(value >> 12) & 0x3f];
+    out[2] = '=';
+    out[3] = '=';
+  } else if (i + 2 == length) {
+    uint32_t value = in[i] << 16 | in[i + 1] << 8;
+    out[0] = kBase64Chars[value >> 18];
+    out[1] = kBase64Chars[(value >> 12) & 0x3f];
+    out[2] = kBase64Chars[(value >> 6) & 0x3f];
+    out[3] = '=';
+  }
+}
+
+#if defined(BAT_CODEC_SSE2)
+// Nibbles to '0'-'9' and 'a'-'f'
+inline __m128i NibblesToHex(__m128i nibbles) {
+  const __m128i letters = _mm_and_si128(
+      _mm_cmpgt_epi8(nibbles, _mm_set1_epi8(9)),
+      _mm_set1_epi8('a' - '0' - 10));
+  return _mm_add_epi8(_mm_add_epi8(nibbles, _mm_set1_epi8('0')), letters);
+}
+
+// 16 bytes per round
+size_t HexEncodeSSE2(const uint8_t* in, size_t length, char* out) {
+  const __m128i mask = _mm_set1_epi8(0x0f);
+  size_t i = 0;
+  for (; i + 16 <= length; i += 16) {
+    __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+    __m128i high = _mm_and_si128(_mm_srli_epi16(bytes, 4), mask);
+    __m128i low = _mm_and_si128(bytes, mask);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 2 * i),
+                     NibblesToHex(_mm_unpacklo_epi8(high, low)));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 2 * i + 16),
+                     NibblesToHex(_mm_unpackhi_epi8(high, low)));
+  }
+
+  return i;
+}
+#endif
+
+#if defined(BAT_CODEC_AVX2)
+bool HasAVX2() {
+  static const bool has_avx2 = __builtin_cpu_supports("avx2");
+  return has_avx2;
+}
+
+__attribute__((target("avx2")))
+inline __m256i NibblesToHexAVX2(__m256i nibbles) {
+  const __m256i letters = _mm256_and_si256(
+      _mm256_cmpgt_epi8(nibbles, _mm256_set1_epi8(9)),
+      _mm256_set1_epi8('a' - '0' - 10));
+  return _mm256_add_epi8(_mm256_add_epi8(nibbles, _mm256_set1_epi8('0')),
+                         letters);
+}
+
+// 32 bytes per round. Unpacking works within the 128 bit lanes, so the
+// halves are put back in order before the store.
+__attribute__((target("avx2")))
+size_t HexEncodeAVX2(const uint8_t* in, size_t length, char* out) {
+  const __m256i mask = _mm256_set1_epi8(0x0f);
+  size_t i = 0;
+  for (; i + 32 <= length; i += 32) {
+    __m256i bytes =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));
+    __m256i high = _mm256_and_si256(_mm256_srli_epi16(bytes, 4), mask);
+    __m256i low = _mm256_and_si256(bytes, mask);
+    __m256i first = NibblesToHexAVX2(_mm256_unpacklo_epi8(high, low));
+    __m256i second = NibblesToHexAVX2(_mm256_unpackhi_epi8(high, low));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + 2 * i),
+                        _mm256_permute2x128_si256(first, second, 0x20));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + 2 * i + 32),
+                        _mm256_permute2x128_si256(first, second, 0x31));
+  }
+
+  return i;
+}
+
+// 24 bytes to 32 characters per round, after Muła and Lemire. Every lane
+// gets 12 bytes, the 6 bit indexes of each 3 bytes are moved into their
+// own bytes with two multiplies and then turned into characters by range.
+__attribute__((target("avx2")))
+size_t Base64EncodeAVX2(const uint8_t* in, size_t length, char* out) {
+  const __m256i lanes = _mm256_setr_epi32(0, 1, 2, 3, 3, 4, 5, 6);
+  const __m256i shuffle = _mm256_setr_epi8(
+      1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10,
+      1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10);
+  const __m256i shift = _mm256_setr_epi8(
+      'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+      '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62,
+      '/' - 63, 'A', 0, 0,
+      'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+      '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62,
+      '/' - 63, 'A', 0, 0);
+
+  size_t i = 0;
+  // the load takes 32 bytes for the 24 of the round
+  for (; i + 32 <= length; i += 24) {
+    __m256i bytes =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));
+    bytes = _mm256_permutevar8x32_epi32(bytes, lanes);
+    bytes = _mm256_shuffle_epi8(bytes, shuffle);
+
+    const __m256i t0 = _mm256_and_si256(bytes, _mm256_set1_epi32(0x0fc0fc00));
+    const __m256i t1 = _mm256_mulhi_epu16(t0, _mm256_set1_epi32(0x04000040));
+    const __m256i t2 = _mm256_and_si256(bytes, _mm256_set1_epi32(0x003f03f0));
+    const __m256i t3 = _mm256_mullo_epi16(t2, _mm256_set1_epi32(0x01000010));
+    const __m256i indexes = _mm256_or_si256(t1, t3);
+
+    // 0-25 -> 13, 26-51 -> 0, 52-61 -> 1-10, 62 -> 11, 63 -> 12
+    __m256i ranges = _mm256_subs_epu8(indexes, _mm256_set1_epi8(51));
+    const __m256i upper =
+        _mm256_cmpgt_epi8(_mm256_set1_epi8(26), indexes);
+    ranges = _mm256_or_si256(ranges,
+                             _mm256_and_si256(upper, _mm256_set1_epi8(13)));
+    const __m256i chars = _mm256_add_epi8(
+        _mm256_shuffle_epi8(shift, ranges), indexes);
+
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i / 3 * 4), chars);
+  }
+
+  return i;
+}
+#endif
+
+}  // namespace
+
+void HexEncode(const uint8_t* in, size_t length, char* out) {
+  size_t done = 0;
+#if defined(BAT_CODEC_AVX2)
+  if (HasAVX2()) {
+    done = HexEncodeAVX2(in, length, out);
+  }
+#endif
+#if defined(BAT_CODEC_SSE2)
+  done += HexEncodeSSE2(in + done, length - done, out + 2 * done);
+#endif
+  HexEncodeScalar(in + done, length - done, out + 2 * done);
+}
+
+void AppendHex(const uint8_t* in, size_t length, std::string* out) {
+  size_t offset = out->size();
+  out->resize(offset + HexEncodedLength(length));
+  if (length > 0) {
+    HexEncode(in, length, &(*out)[offset]);
+  }
+}
+
+bool HexDecode(const char* in, size_t length, uint8_t* out) {
+  if (length % 2 != 0) {
+    return false;
+  }
+
+  const uint8_t* table = GetDecodeTables().hex;
+  uint8_t invalid = 0;
+  for (size_t i = 0; i < length; i += 2) {
+    uint8_t high = table[static_cast<uint8_t>(in[i])];
+    uint8_t low = table[static_cast<uint8_t>(in[i + 1])];
+    // invalid entries have the high bit set
+    invalid |= high | low;
+    out[i / 2] = static_cast<uint8_t>(high << 4 | (low & 0x0f));
+  }
+
+  return (invalid & 0x80) == 0;
+}
+
+void Base64Encode(const uint8_t* in, size_t length, char* out) {
+  size_t done = 0;
+#if defined(BAT_CODEC_AVX2)
+  if (HasAVX2()) {
+    done = Base64EncodeAVX2(in, length, out);
+  }
+#endif
+  Base64EncodeScalar(in + done, length - done, out + done / 3 * 4);
+}
+
+void AppendBase64(const uint8_t* in, size_t length, std::string* out) {
+  size_t offset = out->size();
+  out->resize(offset + Base64EncodedLength(length));
+  if (length > 0) {
+    Base64Encode(in, length, &(*out)[offset]);
+  }
+}
+
+bool Base64Decode(const char* in,
+                  size_t length,
+                  uint8_t* out,
+                  size_t* out_length) {
+  *out_length = 0;
+  if (length % 4 != 0) {
+    return false;
+  }
+  if (length == 0) {
+    return true;
+  }
+
+  const uint8_t* table = GetDecodeTables().base64;
+  const uint8_t* chars = reinterpret_cast<const uint8_t*>(in);
+  uint8_t invalid = 0;
+  uint8_t* start = out;
+
+  // all quads but the last have no padding
+  size_t last = length - 4;
+  for (size_t i = 0; i < last; i += 4) {
+    uint8_t a = table[chars[i]];
+    uint8_t b = table[chars[i + 1]];
+    uint8_t c = table[chars[i + 2]];
+    uint8_t d = table[chars[i + 3]];
+    invalid |= a | b | c | d;
+    uint32_t value = a << 18 | b << 12 | c << 6 | d;
+    out[0] = static_cast<uint8_t>(value >> 16);
+    out[1] = static_cast<uint8_t>(value >> 8);
+    out[2] = static_cast<uint8_t>(value);
+    out += 3;
+  }
+
+  if (invalid & 0x80) {
+    return false;
+  }
+
+  // xxxx, xxx= or xx==
+  size_t padding = 0;
+  if (chars[last + 3] == '=') {
+    padding = chars[last + 2] == '=' ? 2 : 1;
+  }
+
+  uint8_t a = table[chars[last]];
+  uint8_t b = table[chars[last + 1]];
+  uint8_t c = padding >= 2 ? 0 : table[chars[last + 2]];
+  uint8_t d = padding >= 1 ? 0 : table[chars[last + 3]];
+  if ((a | b | c | d) & 0x80) {
+    return false;
+  }
+
+  uint32_t value = a << 18 | b << 12 | c << 6 | d;
+  out[0] = static_cast<uint8_t>(value >> 16);
+  if (padding < 2) {
+    out[1] = static_cast<uint8_t>(value >> 8);
+  }
+  if (padding < 1) {
+    out[2] = static_cast<uint8_t>(value);
+  }
+
+  *out_length = out - start + 3 - padding;
+  return true;
+}
+
+bool IsBase64(const char* in, size_t length) {
+  if (length % 4 != 0) {
+    return false;
+  }
+  if (length == 0) {
+    return true;
+  }
+
+  const uint8_t* table = GetDecodeTables().base64;
+  const uint8_t* chars = reinterpret_cast<const uint8_t*>(in);
+  size_t padding = 0;
+  if (chars[length - 1] == '=') {
+    padding = chars[length - 2] == '=' ? 2 : 1;
+  }
+
+  uint8_t invalid = 0;
+  for (size_t i = 0; i < length - padding; i++) {
+    invalid |= table[chars[i]];
+  }
+  return !(invalid & 0x80);
+}
+
+}  // namespace braveledger_bat_codec
@@ -0,0 +1,54 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVELEDGER_BAT_CODEC_H_
+#define BRAVELEDGER_BAT_CODEC_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <string>
+
+// Hex and base64 for keys, signatures, digests and media payloads. Output
+// goes to buffers of the caller, so nothing is allocated per call. Encoders
+// use SSE2 and AVX2 when the CPU has them.
+namespace braveledger_bat_codec {
+
+inline size_t HexEncodedLength(size_t length) {
+  return length * 2;
+}
+
+// Lower case, the way the ledger server expects keys
+void HexEncode(const uint8_t* in, size_t length, char* out);
+void AppendHex(const uint8_t* in, size_t length, std::string* out);
+// Takes both cases, |out| gets |length| / 2 bytes. Returns false for odd
+// lengths and other characters.
+bool HexDecode(const char* in, size_t length, uint8_t* out);
+
+// Padded, without the NUL that EVP_EncodedLength counts
+inline size_t Base64EncodedLength(size_t length) {
+  return (length + 2) / 3 * 4;
+}
+
+// Upper bound, padding makes the result shorter
+inline size_t Base64DecodedMaxLength(size_t length) {
+  return length / 4 * 3;
+}
+
+// Same output as EVP_EncodeBlock without the NUL
+void Base64Encode(const uint8_t* in, size_t length, char* out);
+void AppendBase64(const uint8_t* in, size_t length, std::string* out);
+// Takes the input that EVP_DecodeBase64 takes: whole quads, padding only
+// at the end and no white space. |out| needs
+// Base64DecodedMaxLength(|length|) bytes.
+bool Base64Decode(const char* in,
+                  size_t length,
+                  uint8_t* out,
+                  size_t* out_length);
+// True when Base64Decode() would take |in|, without decoding it
+bool IsBase64(const char* in, size_t length);
+
+}  // namespace braveledger_bat_codec
+
+#endif  // BRAVELEDGER_BAT_CODEC_H_
@@ -6,10 +6,13 @@
 #include <cmath>
 #include <ctime>
 #include <map>
+#include <memory>
+#include <set>
 #include <vector>
 
 #include "anon/anon.h"
 #include "bat_contribution.h"
+#include "http_signature.h"
 #include "ledger_impl.h"
 #include "rapidjson_bat_helper.h"
 
@@ -21,11 +24,56 @@ static bool winners_votes_compare(
   return (first.votes_ < second.votes_);
 }
 
+// Keeps the log names of the old per step callbacks
+static const char* GetReconcileStepName(
+    braveledger_bat_helper::ContributionRetry step) {
+  switch (step) {
+    case braveledger_bat_helper::ContributionRetry::STEP_RECONCILE:
+      return "ReconcileCallback";
+    case braveledger_bat_helper::ContributionRetry::STEP_CURRENT:
+      return "CurrentReconcileCallback";
+    case braveledger_bat_helper::ContributionRetry::STEP_PAYLOAD:
+      return "ReconcilePayloadCallback";
+    case braveledger_bat_helper::ContributionRetry::STEP_REGISTER:
+      return "RegisterViewingCallback";
+    case braveledger_bat_helper::ContributionRetry::STEP_VIEWING:
+      return "ViewingCredentialsCallback";
+    default:
+      return "ReconcileStepCallback";
+  }
+}
+
+// Reconcile step durations are kept under these names
+static const char* GetReconcileStepMetric(
+    braveledger_bat_helper::ContributionRetry step) {
+  switch (step) {
+    case braveledger_bat_helper::ContributionRetry::STEP_RECONCILE:
+      return "reconcile.reconcile";
+    case braveledger_bat_helper::ContributionRetry::STEP_CURRENT:
+      return "reconcile.current";
+    case braveledger_bat_helper::ContributionRetry::STEP_PAYLOAD:
+      return "reconcile.payload";
+    case braveledger_bat_helper::ContributionRetry::STEP_REGISTER:
+      return "reconcile.register";
+    case braveledger_bat_helper::ContributionRetry::STEP_VIEWING:
+      return "reconcile.viewing";
+    case braveledger_bat_helper::ContributionRetry::STEP_PREPARE:
+      return "reconcile.prepare";
+    case braveledger_bat_helper::ContributionRetry::STEP_PROOF:
+      return "reconcile.proof";
+    case braveledger_bat_helper::ContributionRetry::STEP_VOTE:
+      return "reconcile.vote";
+    default:
+      return "reconcile.other";
+  }
+}
+
 BatContribution::BatContribution(bat_ledger::LedgerImpl* ledger) :
     ledger_(ledger),
+    handler_(ledger->GetURLRequestScheduler(),
+             bat_ledger::URLRequestPriority::CONTRIBUTION),
     last_reconcile_timer_id_(0u),
-    last_prepare_vote_batch_timer_id_(0u),
-    last_vote_batch_timer_id_(0u) {
+    auto_contribute_pending_(false) {
   initAnonize();
 }
 
@@ -34,22 +82,40 @@ BatContribution::~BatContribution() {
 
 
 void BatContribution::OnStartUp() {
-  // Check if we have some more pending ballots to go out
-  PrepareBallots();
-
-  // Resume in progress contributions
   braveledger_bat_helper::CurrentReconciles currentReconciles =
       ledger_->GetCurrentReconciles();
 
+  // Check if we have some more pending ballots to go out,
+  // every reconcile votes in its own pipeline. Older versions removed
+  // finished reconciles before their votes were sent, so votes can be
+  // pending without a reconcile.
+  std::set<std::string> voting;
+  for (const auto& ballot : ledger_->GetBallots()) {
+    voting.insert(ballot.viewingId_);
+  }
+  for (const auto& votes : ledger_->GetBatch()) {
+    voting.insert(votes.viewingId_);
+  }
+
+  // Resume in progress contributions
   for (const auto& value : currentReconciles) {
     braveledger_bat_helper::CURRENT_RECONCILE reconcile = value.second;
 
+    if (voting.count(reconcile.viewingId_) > 0) {
+      // resumed by its voting pipeline, reconcile is kept for the retries
+      continue;
+    }
+
     if (reconcile.retry_step_ == braveledger_bat_helper::ContributionRetry::STEP_FINAL) {
       ledger_->RemoveReconcileById(reconcile.viewingId_);
     } else {
       DoRetry(reconcile.viewingId_);
     }
   }
+
+  for (const auto& viewing_id : voting) {
+    PrepareBallots(viewing_id);
+  }
 }
 
 // TODO(nejczdovc) we have the same function in bat-client
@@ -58,6 +124,7 @@ std::string BatContribution::GetAnonizeProof(
     const std::string& registrar_VK,
     const std::string& id,
     std::string& pre_flight) {
+  uint64_t start = ledger_->GetMetrics()->StartTime();
   const char* cred = makeCred(id.c_str());
   if (nullptr != cred) {
     pre_flight = cred;
@@ -67,6 +134,7 @@ std::string BatContribution::GetAnonizeProof(
   }
   const char* proof_temp = registerUserMessage(pre_flight.c_str(),
                                               registrar_VK.c_str());
+  ledger_->GetMetrics()->AddTime("anonize.register_user_message", start);
   std::string proof;
   if (nullptr != proof_temp) {
     proof = proof_temp;
@@ -83,6 +151,7 @@ void BatContribution::ReconcilePublisherList(
     const ledger::PublisherInfoList& list,
     uint32_t next_record) {
   braveledger_bat_helper::PublisherList new_list;
+  new_list.reserve(list.size());
   for (const auto &publisher : list) {
     braveledger_bat_helper::PUBLISHER_ST new_publisher;
     new_publisher.id_ = publisher.id;
@@ -91,10 +160,10 @@ void BatContribution::ReconcilePublisherList(
     new_publisher.duration_ = publisher.duration;
     new_publisher.score_ = publisher.score;
     new_publisher.visits_ = publisher.visits;
-    new_list.push_back(new_publisher);
+    new_list.push_back(std::move(new_publisher));
   }
 
-  StartReconcile(ledger_->GenerateGUID(), category, new_list);
+  StartReconcile(ledger_->GenerateGUID(), category, std::move(new_list));
 }
 
 void BatContribution::OnTimerReconcile() {
@@ -106,7 +175,20 @@ void BatContribution::OnTimerReconcile() {
                 std::placeholders::_2));
 }
 
+void BatContribution::OnPublisherListReady() {
+  if (auto_contribute_pending_) {
+    auto_contribute_pending_ = false;
+    StartAutoContribute();
+  }
+}
+
 void BatContribution::StartAutoContribute() {
+  if (ledger_->IsPublisherListWarming()) {
+    // unverified publishers would be left out of the winners
+    auto_contribute_pending_ = true;
+    return;
+  }
+
   uint64_t current_reconcile_stamp = ledger_->GetReconcileStamp();
   ledger::PublisherInfoFilter filter = ledger_->CreatePublisherFilter(
       "",
@@ -116,10 +198,11 @@ void BatContribution::StartAutoContribute() {
       ledger::PUBLISHER_EXCLUDE_FILTER::FILTER_ALL_EXCEPT_EXCLUDED,
       true,
       current_reconcile_stamp);
-  ledger_->GetPublisherInfoList(
-      0,
-      0,
+  // percents are normalized against all the publishers, so publishers that
+  // can't get any votes don't need to be in the reconcile
+  ledger_->GetTopPublishers(
       filter,
+      TOP_PUBLISHERS_COUNT,
       std::bind(&BatContribution::ReconcilePublisherList,
                 this,
                 ledger::PUBLISHER_CATEGORY::AUTO_CONTRIBUTE,
@@ -130,7 +213,7 @@ void BatContribution::StartAutoContribute() {
 void BatContribution::StartReconcile(
     const std::string& viewing_id,
     const ledger::PUBLISHER_CATEGORY category,
-    const braveledger_bat_helper::PublisherList& list,
+    braveledger_bat_helper::PublisherList list,
     const braveledger_bat_helper::Directions& directions) {
   if (ledger_->ReconcileExists(viewing_id)) {
     BLOG(ledger_, ledger::LogLevel::LOG_ERROR) <<
@@ -165,7 +248,7 @@ void BatContribution::StartReconcile(
       return;
     }
 
-    reconcile.list_ = list;
+    reconcile.list_ = std::move(list);
   }
 
   if (category == ledger::PUBLISHER_CATEGORY::RECURRING_DONATION) {
@@ -198,7 +281,7 @@ void BatContribution::StartReconcile(
       return;
     }
 
-    reconcile.list_ = list;
+    reconcile.list_ = std::move(list);
   }
 
   if (category == ledger::PUBLISHER_CATEGORY::DIRECT_DONATION) {
@@ -240,191 +323,231 @@ void BatContribution::StartReconcile(
   reconcile.directions_ = directions;
   reconcile.category_ = category;
 
+  reconcile.retry_step_ =
+      braveledger_bat_helper::ContributionRetry::STEP_RECONCILE;
+  reconcile.retry_level_ = -1;
+
   ledger_->AddReconcile(viewing_id, reconcile);
-  Reconcile(viewing_id);
+  RunReconcileStep(AddReconcileTask(reconcile));
 }
 
-void BatContribution::Reconcile(const std::string& viewing_id) {
-  ledger_->AddReconcileStep(viewing_id,
-                            braveledger_bat_helper::ContributionRetry::STEP_RECONCILE);
-    std::string url = braveledger_bat_helper::buildURL(
-      (std::string)RECONCILE_CONTRIBUTION + ledger_->GetUserId(), PREFIX_V2);
-  auto request_id = ledger_->LoadURL(url,
-      std::vector<std::string>(),
-      "",
-      "",
-      ledger::URL_METHOD::GET,
-      &handler_);
-
-  handler_.AddRequestHandler(std::move(request_id),
-                             std::bind(&BatContribution::ReconcileCallback,
-                                       this,
-                                       viewing_id,
-                                       std::placeholders::_1,
-                                       std::placeholders::_2,
-                                       std::placeholders::_3));
+braveledger_bat_helper::CURRENT_RECONCILE* BatContribution::AddReconcileTask(
+    const braveledger_bat_helper::CURRENT_RECONCILE& reconcile) {
+  auto& task = reconciles_[reconcile.viewingId_];
+  task.reset(new braveledger_bat_helper::CURRENT_RECONCILE(reconcile));
+  return task.get();
 }
 
-void BatContribution::ReconcileCallback(
-    const std::string& viewing_id,
-    bool result,
-    const std::string& response,
-    const std::map<std::string, std::string>& headers) {
-  ledger_->LogResponse(__func__, result, response, headers);
-
-  auto reconcile = ledger_->GetReconcileById(viewing_id);
-
-  if (!result || reconcile.viewingId_.empty()) {
-    AddRetry(braveledger_bat_helper::ContributionRetry::STEP_RECONCILE, viewing_id);
-    return;
-  }
-
-  bool success = braveledger_bat_helper::getJSONValue(
-      SURVEYOR_ID,
-      response,
-      reconcile.surveyorInfo_.surveyorId_);
-  if (!success) {
-    AddRetry(braveledger_bat_helper::ContributionRetry::STEP_RECONCILE, viewing_id);
-    return;
-  }
-
-  success = ledger_->UpdateReconcile(reconcile);
-  if (!success) {
-    OnReconcileComplete(ledger::Result::LEDGER_ERROR,
-                        viewing_id,
-                        reconcile.category_);
-    return;
-  }
+void BatContribution::RunReconcileStep(
+    braveledger_bat_helper::CURRENT_RECONCILE* reconcile) {
+  std::string url;
+  std::vector<std::string> headers;
+  std::string content;
+  std::string content_type;
+  ledger::URL_METHOD method = ledger::URL_METHOD::GET;
+  uint64_t start = ledger_->GetMetrics()->StartTime();
 
-  CurrentReconcile(viewing_id);
-}
+  switch (reconcile->retry_step_) {
+    case braveledger_bat_helper::ContributionRetry::STEP_RECONCILE: {
+      url = braveledger_bat_helper::buildURL(
+          (std::string)RECONCILE_CONTRIBUTION + ledger_->GetUserId(),
+          PREFIX_V2);
+      break;
+    }
+    case braveledger_bat_helper::ContributionRetry::STEP_CURRENT: {
+      std::ostringstream amount;
+      if (reconcile->category_ ==
+          ledger::PUBLISHER_CATEGORY::AUTO_CONTRIBUTE) {
+        amount << ledger_->GetContributionAmount();
+      } else {
+        amount << reconcile->fee_;
+      }
 
-void BatContribution::CurrentReconcile(const std::string& viewing_id) {
-  ledger_->AddReconcileStep(viewing_id,
-                            braveledger_bat_helper::ContributionRetry::STEP_CURRENT);
-  std::ostringstream amount;
-  auto reconcile = ledger_->GetReconcileById(viewing_id);
+      std::string path = (std::string)WALLET_PROPERTIES +
+                          ledger_->GetPaymentId() +
+                          "?refresh=true" +
+                          "&amount=" +
+                          amount.str() +
+                          "&altcurrency=" +
+                          ledger_->GetCurrency();
+      url = braveledger_bat_helper::buildURL(path, PREFIX_V2);
+      break;
+    }
+    case braveledger_bat_helper::ContributionRetry::STEP_PAYLOAD: {
+      content = GetReconcilePayload(*reconcile);
+      if (content.empty()) {
+        // TODO(nejczdovc) what should we do in this case?
+        return;
+      }
 
-  if (reconcile.category_ == ledger::PUBLISHER_CATEGORY::AUTO_CONTRIBUTE) {
-    amount << ledger_->GetContributionAmount();
-  } else {
-    amount << reconcile.fee_;
+      headers.push_back("Content-Type: application/json; charset=UTF-8");
+      content_type = "application/json; charset=utf-8";
+      method = ledger::URL_METHOD::PUT;
+      url = braveledger_bat_helper::buildURL(
+          (std::string)WALLET_PROPERTIES + ledger_->GetPaymentId(),
+          PREFIX_V2);
+      break;
+    }
+    case braveledger_bat_helper::ContributionRetry::STEP_REGISTER: {
+      url = braveledger_bat_helper::buildURL(
+          (std::string)REGISTER_VIEWING, PREFIX_V2);
+      break;
+    }
+    case braveledger_bat_helper::ContributionRetry::STEP_VIEWING: {
+      std::string keys[1] = {"proof"};
+      std::string values[1] = {reconcile->proof_};
+      content = braveledger_bat_helper::stringify(keys, values, 1);
+      content_type = "application/json; charset=utf-8";
+      method = ledger::URL_METHOD::POST;
+      url = braveledger_bat_helper::buildURL(
+          (std::string)REGISTER_VIEWING + "/" + reconcile->anonizeViewingId_,
+          PREFIX_V2);
+      break;
+    }
+    default: {
+      // phase two is not driven by the reconcile steps
+      DCHECK(false);
+      return;
+    }
   }
 
-  std::string currency = ledger_->GetCurrency();
-  std::string path = (std::string)WALLET_PROPERTIES +
-                      ledger_->GetPaymentId() +
-                      "?refresh=true" +
-                      "&amount=" +
-                      amount.str() +
-                      "&altcurrency=" +
-                      currency;
-
-  auto request_id = ledger_->LoadURL(
-      braveledger_bat_helper::buildURL(path, PREFIX_V2),
-      std::vector<std::string>(),
-      "",
-      "",
-      ledger::URL_METHOD::GET,
-      &handler_);
+  auto request_id = ledger_->LoadURL(url,
+                                     headers,
+                                     content,
+                                     content_type,
+                                     method,
+                                     &handler_);
   handler_.AddRequestHandler(std::move(request_id),
                              std::bind(
-                                 &BatContribution::CurrentReconcileCallback,
+                                 &BatContribution::OnReconcileStepResponse,
                                  this,
-                                 viewing_id,
+                                 reconcile,
+                                 start,
                                  std::placeholders::_1,
                                  std::placeholders::_2,
                                  std::placeholders::_3));
 }
 
-void BatContribution::CurrentReconcileCallback(
-    const std::string& viewing_id,
+void BatContribution::OnReconcileStepResponse(
+    braveledger_bat_helper::CURRENT_RECONCILE* reconcile,
+    uint64_t start,
     bool result,
     const std::string& response,
     const std::map<std::string, std::string>& headers) {
-  ledger_->LogResponse(__func__, result, response, headers);
+  const braveledger_bat_helper::ContributionRetry step = reconcile->retry_step_;
+  ledger_->GetMetrics()->AddTime(GetReconcileStepMetric(step), start);
+  ledger_->LogResponse(GetReconcileStepName(step), result, response, headers);
 
   if (!result) {
-    AddRetry(braveledger_bat_helper::ContributionRetry::STEP_CURRENT, viewing_id);
+    AddRetry(step, reconcile->viewingId_);
     return;
   }
 
-  auto reconcile = ledger_->GetReconcileById(viewing_id);
+  bool success = false;
+  braveledger_bat_helper::ContributionRetry next_step = step;
+  switch (step) {
+    case braveledger_bat_helper::ContributionRetry::STEP_RECONCILE: {
+      std::string surveyor_id;
+      success = braveledger_bat_helper::getJSONValue(SURVEYOR_ID,
+                                                     response,
+                                                     surveyor_id);
+      if (success) {
+        reconcile->surveyorInfo_.surveyorId_ = surveyor_id;
+      }
+      next_step = braveledger_bat_helper::ContributionRetry::STEP_CURRENT;
+      break;
+    }
+    case braveledger_bat_helper::ContributionRetry::STEP_CURRENT: {
+      success = OnCurrentReconcile(reconcile, response);
+      next_step = braveledger_bat_helper::ContributionRetry::STEP_PAYLOAD;
+      break;
+    }
+    case braveledger_bat_helper::ContributionRetry::STEP_PAYLOAD: {
+      success = OnReconcilePayload(*reconcile, response);
+      next_step = braveledger_bat_helper::ContributionRetry::STEP_REGISTER;
+      break;
+    }
+    case braveledger_bat_helper::ContributionRetry::STEP_REGISTER: {
+      success = OnRegisterViewing(reconcile, response);
+      next_step = braveledger_bat_helper::ContributionRetry::STEP_VIEWING;
+      break;
+    }
+    case braveledger_bat_helper::ContributionRetry::STEP_VIEWING: {
+      // last step of phase one
+      OnViewingCredentials(reconcile, response);
+      return;
+    }
+    default: {
+      DCHECK(false);
+      return;
+    }
+  }
 
-  bool success = braveledger_bat_helper::getJSONRates(response,
-                                                      reconcile.rates_);
   if (!success) {
-    AddRetry(braveledger_bat_helper::ContributionRetry::STEP_CURRENT, viewing_id);
+    AddRetry(step, reconcile->viewingId_);
+    return;
+  }
+
+  // results of the step and the next step are saved together
+  reconcile->retry_step_ = next_step;
+  reconcile->retry_level_ = -1;
+  if (!ledger_->UpdateReconcile(*reconcile)) {
+    OnReconcileComplete(ledger::Result::LEDGER_ERROR,
+                        reconcile->viewingId_,
+                        reconcile->category_);
     return;
   }
 
+  RunReconcileStep(reconcile);
+}
+
+bool BatContribution::OnCurrentReconcile(
+    braveledger_bat_helper::CURRENT_RECONCILE* reconcile,
+    const std::string& response) {
+  std::map<std::string, double> rates;
+  bool success = braveledger_bat_helper::getJSONRates(response, rates);
+  if (!success) {
+    return false;
+  }
+
   braveledger_bat_helper::UNSIGNED_TX unsigned_tx;
   success = braveledger_bat_helper::getJSONUnsignedTx(response, unsigned_tx);
   if (!success) {
-    AddRetry(braveledger_bat_helper::ContributionRetry::STEP_CURRENT, viewing_id);
-    return;
+    return false;
   }
 
   if (unsigned_tx.amount_.empty() &&
       unsigned_tx.currency_.empty() &&
       unsigned_tx.destination_.empty()) {
     // We don't have any unsigned transactions
-    AddRetry(braveledger_bat_helper::ContributionRetry::STEP_CURRENT, viewing_id);
-    return;
+    return false;
   }
 
-  reconcile.amount_ = unsigned_tx.amount_;
-  reconcile.currency_ = unsigned_tx.currency_;
-  reconcile.destination_ = unsigned_tx.destination_;
-  success = ledger_->UpdateReconcile(reconcile);
-
-  if (!success) {
-    OnReconcileComplete(ledger::Result::LEDGER_ERROR,
-                        viewing_id,
-                        reconcile.category_);
-    return;
-  }
-
-  ReconcilePayload(viewing_id);
+  reconcile->rates_ = rates;
+  reconcile->amount_ = unsigned_tx.amount_;
+  reconcile->currency_ = unsigned_tx.currency_;
+  reconcile->destination_ = unsigned_tx.destination_;
+  return true;
 }
 
-void BatContribution::ReconcilePayload(const std::string& viewing_id) {
-  ledger_->AddReconcileStep(viewing_id,
-                            braveledger_bat_helper::ContributionRetry::STEP_PAYLOAD);
-  auto reconcile = ledger_->GetReconcileById(viewing_id);
-  braveledger_bat_helper::WALLET_INFO_ST wallet_info = ledger_->GetWalletInfo();
-
+std::string BatContribution::GetReconcilePayload(
+    const braveledger_bat_helper::CURRENT_RECONCILE& reconcile) {
   braveledger_bat_helper::UNSIGNED_TX unsigned_tx;
   unsigned_tx.amount_ = reconcile.amount_;
   unsigned_tx.currency_ = reconcile.currency_;
   unsigned_tx.destination_ = reconcile.destination_;
   std::string octets = braveledger_bat_helper::stringifyUnsignedTx(unsigned_tx);
 
-  std::string header_digest = "SHA-256=" +
-      braveledger_bat_helper::getBase64(
-          braveledger_bat_helper::getSHA256(octets));
-
-  std::string header_keys[1] = {"digest"};
-  std::string header_values[1] = {header_digest};
-
-  std::vector<uint8_t> secret_key = braveledger_bat_helper::getHKDF(
-      wallet_info.keyInfoSeed_);
-  std::vector<uint8_t> public_key;
-  std::vector<uint8_t> new_secret_key;
-  bool success = braveledger_bat_helper::getPublicKeyFromSeed(
-      secret_key,
-      public_key,
-      new_secret_key);
-  if (!success) {
-    // TODO(nejczdovc) what should we do in this case?
-    return;
+  std::string header_digest;
+  bat_ledger::HttpSigner::GetDigest(octets, &header_digest);
+
+  bat_ledger::HttpSigner* signer = ledger_->GetWalletSigner();
+  if (!signer) {
+    return "";
   }
 
-  std::string headerSignature = braveledger_bat_helper::sign(header_keys,
-                                                             header_values,
-                                                             1,
-                                                             "primary",
-                                                             new_secret_key);
+  std::string headerSignature;
+  signer->SignDigest(header_digest, &headerSignature);
 
   braveledger_bat_helper::RECONCILE_PAYLOAD_ST reconcile_payload;
   reconcile_payload.requestType_ = "httpSignature";
@@ -434,50 +557,18 @@ void BatContribution::ReconcilePayload(const std::string& viewing_id) {
   reconcile_payload.request_signedtx_octets_ = octets;
   reconcile_payload.request_viewingId_ = reconcile.viewingId_;
   reconcile_payload.request_surveyorId_ = reconcile.surveyorInfo_.surveyorId_;
-  std::string payload_stringify =
-      braveledger_bat_helper::stringifyReconcilePayloadSt(reconcile_payload);
-
-  std::vector<std::string> wallet_header;
-  wallet_header.push_back("Content-Type: application/json; charset=UTF-8");
-  std::string path = (std::string)WALLET_PROPERTIES + ledger_->GetPaymentId();
-
-  auto request_id = ledger_->LoadURL(
-      braveledger_bat_helper::buildURL(path, PREFIX_V2),
-      wallet_header,
-      payload_stringify,
-      "application/json; charset=utf-8",
-      ledger::URL_METHOD::PUT,
-      &handler_);
-  handler_.AddRequestHandler(
-      std::move(request_id),
-      std::bind(&BatContribution::ReconcilePayloadCallback,
-               this,
-               viewing_id,
-               std::placeholders::_1,
-               std::placeholders::_2,
-               std::placeholders::_3));
+  return braveledger_bat_helper::stringifyReconcilePayloadSt(
+      reconcile_payload);
 }
 
-void BatContribution::ReconcilePayloadCallback(
-    const std::string& viewing_id,
-    bool result,
-    const std::string& response,
-    const std::map<std::string, std::string>& headers) {
-  ledger_->LogResponse(__func__, result, response, headers);
-
-  if (!result) {
-    AddRetry(braveledger_bat_helper::ContributionRetry::STEP_PAYLOAD, viewing_id);
-    return;
-  }
-
-  const auto reconcile = ledger_->GetReconcileById(viewing_id);
-
+bool BatContribution::OnReconcilePayload(
+    const braveledger_bat_helper::CURRENT_RECONCILE& reconcile,
+    const std::string& response) {
   braveledger_bat_helper::TRANSACTION_ST transaction;
   bool success = braveledger_bat_helper::getJSONTransaction(response,
                                                             transaction);
   if (!success) {
-    AddRetry(braveledger_bat_helper::ContributionRetry::STEP_PAYLOAD, viewing_id);
-    return;
+    return false;
   }
 
   transaction.viewingId_ = reconcile.viewingId_;
@@ -490,156 +581,76 @@ void BatContribution::ReconcilePayloadCallback(
       ledger_->GetTransactions();
   transactions.push_back(transaction);
   ledger_->SetTransactions(transactions);
-  RegisterViewing(viewing_id);
+  return true;
 }
 
-void BatContribution::RegisterViewing(const std::string& viewing_id) {
-  ledger_->AddReconcileStep(viewing_id,
-                            braveledger_bat_helper::ContributionRetry::STEP_REGISTER);
-  auto request_id = ledger_->LoadURL(
-      braveledger_bat_helper::buildURL(
-          (std::string)REGISTER_VIEWING, PREFIX_V2),
-      std::vector<std::string>(),
-      "",
-      "",
-      ledger::URL_METHOD::GET,
-      &handler_);
-  handler_.AddRequestHandler(std::move(request_id),
-                             std::bind(
-                                 &BatContribution::RegisterViewingCallback,
-                                 this,
-                                 viewing_id,
-                                 std::placeholders::_1,
-                                 std::placeholders::_2,
-                                 std::placeholders::_3));
-}
-
-void BatContribution::RegisterViewingCallback(
-    const std::string& viewing_id,
-    bool result,
-    const std::string& response,
-    const std::map<std::string, std::string>& headers) {
-  ledger_->LogResponse(__func__, result, response, headers);
-
-  if (!result) {
-    AddRetry(braveledger_bat_helper::ContributionRetry::STEP_REGISTER, viewing_id);
-    return;
-  }
-
-  auto reconcile = ledger_->GetReconcileById(viewing_id);
-
+bool BatContribution::OnRegisterViewing(
+    braveledger_bat_helper::CURRENT_RECONCILE* reconcile,
+    const std::string& response) {
+  std::string registrar_vk;
   bool success = braveledger_bat_helper::getJSONValue(REGISTRARVK_FIELDNAME,
                                                       response,
-                                                      reconcile.registrarVK_);
-  DCHECK(!reconcile.registrarVK_.empty());
-  if (!success || reconcile.registrarVK_.empty()) {
-    AddRetry(braveledger_bat_helper::ContributionRetry::STEP_REGISTER, viewing_id);
-    return;
+                                                      registrar_vk);
+  DCHECK(!registrar_vk.empty());
+  if (!success || registrar_vk.empty()) {
+    return false;
   }
 
-  reconcile.anonizeViewingId_ = reconcile.viewingId_;
-  reconcile.anonizeViewingId_.erase(
-      std::remove(reconcile.anonizeViewingId_.begin(),
-                  reconcile.anonizeViewingId_.end(),
+  reconcile->registrarVK_ = registrar_vk;
+  reconcile->anonizeViewingId_ = reconcile->viewingId_;
+  reconcile->anonizeViewingId_.erase(
+      std::remove(reconcile->anonizeViewingId_.begin(),
+                  reconcile->anonizeViewingId_.end(),
                   '-'),
-      reconcile.anonizeViewingId_.end());
-  reconcile.anonizeViewingId_.erase(12, 1);
-  reconcile.proof_ = GetAnonizeProof(reconcile.registrarVK_,
-                                     reconcile.anonizeViewingId_,
-                                     reconcile.preFlight_);
-
-  success = ledger_->UpdateReconcile(reconcile);
-  if (!success) {
-    OnReconcileComplete(ledger::Result::LEDGER_ERROR,
-                        viewing_id,
-                        reconcile.category_);
-    return;
-  }
-
-  ViewingCredentials(viewing_id);
+      reconcile->anonizeViewingId_.end());
+  reconcile->anonizeViewingId_.erase(12, 1);
+  reconcile->proof_ = GetAnonizeProof(reconcile->registrarVK_,
+                                      reconcile->anonizeViewingId_,
+                                      reconcile->preFlight_);
+  return true;
 }
 
-void BatContribution::ViewingCredentials(const std::string& viewing_id) {
-  ledger_->AddReconcileStep(viewing_id,
-                            braveledger_bat_helper::ContributionRetry::STEP_VIEWING);
-  auto reconcile = ledger_->GetReconcileById(viewing_id);
-
-  std::string keys[1] = {"proof"};
-  std::string values[1] = {reconcile.proof_};
-  std::string proof_stringified = braveledger_bat_helper::stringify(keys,
-                                                                    values,
-                                                                    1);
-
-  std::string url = braveledger_bat_helper::buildURL(
-      (std::string)REGISTER_VIEWING +
-      "/" +
-      reconcile.anonizeViewingId_,
-      PREFIX_V2);
-
-  auto request_id = ledger_->LoadURL(url,
-                                     std::vector<std::string>(),
-                                     proof_stringified,
-                                     "application/json; charset=utf-8",
-                                     ledger::URL_METHOD::POST,
-                                     &handler_);
-  handler_.AddRequestHandler(std::move(request_id),
-                             std::bind(
-                                 &BatContribution::ViewingCredentialsCallback,
-                                 this,
-                                 viewing_id,
-                                 std::placeholders::_1,
-                                 std::placeholders::_2,
-                                 std::placeholders::_3));
-}
-
-void BatContribution::ViewingCredentialsCallback(
-    const std::string& viewing_id,
-    bool result,
-    const std::string& response,
-    const std::map<std::string, std::string>& headers) {
-  ledger_->LogResponse(__func__, result, response, headers);
-
-  if (!result) {
-    AddRetry(braveledger_bat_helper::ContributionRetry::STEP_VIEWING, viewing_id);
-    return;
-  }
-
-  auto reconcile = ledger_->GetReconcileById(viewing_id);
-
+void BatContribution::OnViewingCredentials(
+    braveledger_bat_helper::CURRENT_RECONCILE* reconcile,
+    const std::string& response) {
   std::string verification;
   bool success = braveledger_bat_helper::getJSONValue(VERIFICATION_FIELDNAME,
                                                       response,
                                                       verification);
   if (!success) {
-    AddRetry(braveledger_bat_helper::ContributionRetry::STEP_VIEWING, viewing_id);
+    AddRetry(braveledger_bat_helper::ContributionRetry::STEP_VIEWING,
+             reconcile->viewingId_);
     return;
   }
 
+  std::vector<std::string> surveyors;
+  success = braveledger_bat_helper::getJSONList(SURVEYOR_IDS,
+                                                response,
+                                                surveyors);
+  if (!success) {
+    AddRetry(braveledger_bat_helper::ContributionRetry::STEP_VIEWING,
+             reconcile->viewingId_);
+    return;
+  }
+
+  uint64_t start = ledger_->GetMetrics()->StartTime();
   const char* master_user_token = registerUserFinal(
-      reconcile.anonizeViewingId_.c_str(),
+      reconcile->anonizeViewingId_.c_str(),
       verification.c_str(),
-      reconcile.preFlight_.c_str(),
-      reconcile.registrarVK_.c_str());
+      reconcile->preFlight_.c_str(),
+      reconcile->registrarVK_.c_str());
+  ledger_->GetMetrics()->AddTime("anonize.register_user_final", start);
 
   if (nullptr != master_user_token) {
-    reconcile.masterUserToken_ = master_user_token;
+    reconcile->masterUserToken_ = master_user_token;
     free((void*)master_user_token);
   }
 
-  success = ledger_->UpdateReconcile(reconcile);
+  success = ledger_->UpdateReconcile(*reconcile);
   if (!success) {
     OnReconcileComplete(ledger::Result::LEDGER_ERROR,
-                        viewing_id,
-                        reconcile.category_);
-    return;
-  }
-
-  std::vector<std::string> surveyors;
-  success = braveledger_bat_helper::getJSONList(SURVEYOR_IDS,
-                                                response,
-                                                surveyors);
-  if (!success) {
-    AddRetry(braveledger_bat_helper::ContributionRetry::STEP_VIEWING, viewing_id);
+                        reconcile->viewingId_,
+                        reconcile->category_);
     return;
   }
 
@@ -649,21 +660,21 @@ void BatContribution::ViewingCredentialsCallback(
       ledger_->GetTransactions();
 
   for (size_t i = 0; i < transactions.size(); i++) {
-    if (transactions[i].viewingId_ != reconcile.viewingId_) {
+    if (transactions[i].viewingId_ != reconcile->viewingId_) {
       continue;
     }
 
-    transactions[i].anonizeViewingId_ = reconcile.anonizeViewingId_;
-    transactions[i].registrarVK_ = reconcile.registrarVK_;
-    transactions[i].masterUserToken_ = reconcile.masterUserToken_;
+    transactions[i].anonizeViewingId_ = reconcile->anonizeViewingId_;
+    transactions[i].registrarVK_ = reconcile->registrarVK_;
+    transactions[i].masterUserToken_ = reconcile->masterUserToken_;
     transactions[i].surveyorIds_ = surveyors;
     probi = transactions[i].contribution_probi_;
   }
 
   ledger_->SetTransactions(transactions);
   OnReconcileComplete(ledger::Result::LEDGER_OK,
-                      reconcile.viewingId_,
-                      reconcile.category_,
+                      reconcile->viewingId_,
+                      reconcile->category_,
                       probi);
 }
 
@@ -671,6 +682,15 @@ void BatContribution::OnReconcileComplete(ledger::Result result,
                                           const std::string& viewing_id,
                                           int category,
                                           const std::string& probi) {
+  // phase one is over, |viewing_id| can point into the task,
+  // so it's released at the end
+  std::unique_ptr<braveledger_bat_helper::CURRENT_RECONCILE> task;
+  auto iter = reconciles_.find(viewing_id);
+  if (iter != reconciles_.end()) {
+    task = std::move(iter->second);
+    reconciles_.erase(iter);
+  }
+
   // Start the timer again if it wasn't a direct donation
   if (category == ledger::PUBLISHER_CATEGORY::AUTO_CONTRIBUTE) {
     ledger_->ResetReconcileStamp();
@@ -711,16 +731,21 @@ unsigned int BatContribution::GetBallotsCount(const std::string& viewing_id) {
 
 void BatContribution::GetReconcileWinners(const std::string& viewing_id) {
   unsigned int ballots_count = GetBallotsCount(viewing_id);
-  const auto reconcile = ledger_->GetReconcileById(viewing_id);
+  auto reconcile = ledger_->GetReconcileById(viewing_id);
 
   switch (reconcile.category_) {
     case ledger::PUBLISHER_CATEGORY::AUTO_CONTRIBUTE: {
-      GetContributeWinners(ballots_count, viewing_id, reconcile.list_);
+      GetContributeWinners(ballots_count,
+                           viewing_id,
+                           std::move(reconcile.list_));
       break;
     }
 
     case ledger::PUBLISHER_CATEGORY::RECURRING_DONATION: {
-      GetDonationWinners(ballots_count, viewing_id, reconcile.list_);
+      GetDonationWinners(ballots_count,
+                         viewing_id,
+                         reconcile.fee_,
+                         std::move(reconcile.list_));
       break;
     }
 
@@ -748,32 +773,27 @@ void BatContribution::GetReconcileWinners(const std::string& viewing_id) {
 void BatContribution::GetContributeWinners(
     const unsigned int& ballots,
     const std::string& viewing_id,
-    const braveledger_bat_helper::PublisherList& list) {
-  ledger::PublisherInfoList new_list;
-  ledger_->NormalizeContributeWinners(&new_list, false, list, 0);
-  std::sort(new_list.begin(), new_list.end());
+    braveledger_bat_helper::PublisherList list) {
+  // percents were set against the whole publisher table when the reconcile
+  // was started, normalizing the top publishers again would inflate them
+  std::sort(list.begin(), list.end());
 
   unsigned int total_votes = 0;
-  std::vector<unsigned int> votes;
   braveledger_bat_helper::Winners res;
+  res.reserve(list.size());
   // TODO there is underscore.shuffle
-  for (auto &item : new_list) {
-    if (item.percent <= 0) {
+  for (auto &item : list) {
+    if (item.percent_ <= 0) {
       continue;
     }
 
     braveledger_bat_helper::WINNERS_ST winner;
     winner.votes_ = (unsigned int)std::lround(
-        (double) item.percent * (double)ballots / 100.0);
+        (double) item.percent_ * (double)ballots / 100.0);
 
     total_votes += winner.votes_;
-    winner.publisher_data_.id_ = item.id;
-    winner.publisher_data_.duration_ = item.duration;
-    winner.publisher_data_.score_ = item.score;
-    winner.publisher_data_.visits_ = item.visits;
-    winner.publisher_data_.percent_ = item.percent;
-    winner.publisher_data_.weight_ = item.weight;
-    res.push_back(winner);
+    winner.publisher_data_ = std::move(item);
+    res.push_back(std::move(winner));
   }
 
   if (res.size()) {
@@ -793,28 +813,23 @@ void BatContribution::GetContributeWinners(
 void BatContribution::GetDonationWinners(
     const unsigned int& ballots,
     const std::string& viewing_id,
-    const braveledger_bat_helper::PublisherList& list) {
-  const auto reconcile = ledger_->GetReconcileById(viewing_id);
+    double fee,
+    braveledger_bat_helper::PublisherList list) {
   unsigned int total_votes = 0;
-  std::vector<unsigned int> votes;
   braveledger_bat_helper::Winners res;
+  res.reserve(list.size());
 
-  for (const auto &item : list) {
+  for (auto &item : list) {
     if (item.weight_ <= 0) {
       continue;
     }
 
     braveledger_bat_helper::WINNERS_ST winner;
-    double percent = item.weight_ / reconcile.fee_;
+    double percent = item.weight_ / fee;
     winner.votes_ = (unsigned int)std::lround(percent * (double)ballots);
     total_votes += winner.votes_;
-    winner.publisher_data_.id_ = item.id_;
-    winner.publisher_data_.duration_ = 0;
-    winner.publisher_data_.score_ = 0;
-    winner.publisher_data_.visits_ = 0;
-    winner.publisher_data_.percent_ = 0;
-    winner.publisher_data_.weight_ = 0;
-    res.push_back(winner);
+    winner.publisher_data_.id_ = std::move(item.id_);
+    res.push_back(std::move(winner));
   }
 
   if (res.size()) {
@@ -848,7 +863,7 @@ void BatContribution::VotePublishers(
   ledger_->AddReconcileStep(viewing_id,
                             braveledger_bat_helper::ContributionRetry::STEP_FINAL);
 
-  PrepareBallots();
+  PrepareBallots(viewing_id);
 }
 
 void BatContribution::VotePublisher(const std::string& publisher,
@@ -899,39 +914,65 @@ void BatContribution::VotePublisher(const std::string& publisher,
   ledger_->SetBallots(ballots);
 }
 
-void BatContribution::PrepareBallots() {
-  braveledger_bat_helper::Transactions transactions =
-      ledger_->GetTransactions();
-  braveledger_bat_helper::Ballots ballots = ledger_->GetBallots();
+void BatContribution::PrepareBallots(const std::string& viewing_id) {
+  const braveledger_bat_helper::Ballots& ballots = ledger_->GetBallots();
+
+  bool has_ballots = false;
+  bool unprepared = false;
+  bool unproved = false;
+  for (const auto& ballot : ballots) {
+    if (ballot.viewingId_ != viewing_id) {
+      continue;
+    }
+
+    has_ballots = true;
+    if (ballot.prepareBallot_.empty()) {
+      unprepared = true;
+    } else if (ballot.proofBallot_.empty()) {
+      unproved = true;
+    }
+  }
 
-  if (ballots.size() == 0) {
+  if (!has_ballots) {
     // skip ballots and start sending votes
-    SetTimer(last_vote_batch_timer_id_);
+    SetTimer(pipelines_[viewing_id].vote_batch_timer_id_,
+             std::bind(&BatContribution::OnVoteBatchTimer, this, viewing_id));
     return;
   }
 
-  for (int i = ballots.size() - 1; i >= 0; i--) {
-    for (size_t j = 0; j < transactions.size(); j++) {
-      if (transactions[j].viewingId_ == ballots[i].viewingId_) {
-        if (ballots[i].prepareBallot_.empty()) {
-          PrepareBatch(ballots[i], transactions[j]);
-          return;
-        }
+  const braveledger_bat_helper::TRANSACTION_ST* transaction =
+      GetTransaction(viewing_id);
+  if (transaction) {
+    if (unprepared) {
+      PrepareBatch(viewing_id, *transaction);
+      return;
+    }
 
-        if (ballots[i].proofBallot_.empty()) {
-          Proof();
-          return;
-        }
-      }
+    if (unproved) {
+      Proof(viewing_id);
+      return;
     }
   }
 
   // In case we already prepared all ballots
-  PrepareVoteBatch();
+  PrepareVoteBatch(viewing_id);
+}
+
+const braveledger_bat_helper::TRANSACTION_ST* BatContribution::GetTransaction(
+    const std::string& viewing_id) const {
+  const braveledger_bat_helper::Transactions& transactions =
+      ledger_->GetTransactions();
+  for (const auto& transaction : transactions) {
+    if (transaction.viewingId_ == viewing_id) {
+      return &transaction;
+    }
+  }
+
+  return nullptr;
 }
 
 void BatContribution::PrepareBatch(
-    const braveledger_bat_helper::BALLOT_ST& ballot,
+    const std::string& viewing_id,
     const braveledger_bat_helper::TRANSACTION_ST& transaction) {
   std::string url = braveledger_bat_helper::buildURL(
       (std::string)SURVEYOR_BATCH_VOTING +
@@ -948,19 +989,28 @@ void BatContribution::PrepareBatch(
   handler_.AddRequestHandler(std::move(request_id),
                              std::bind(&BatContribution::PrepareBatchCallback,
                                        this,
+                                       viewing_id,
+                                       ledger_->GetMetrics()->StartTime(),
                                        std::placeholders::_1,
                                        std::placeholders::_2,
                                        std::placeholders::_3));
 }
 
 void BatContribution::PrepareBatchCallback(
+    const std::string& viewing_id,
+    uint64_t start,
     bool result,
     const std::string& response,
     const std::map<std::string, std::string>& headers) {
   ledger_->LogResponse(__func__, result, response, headers);
+  ledger_->GetMetrics()->AddTime(
+      GetReconcileStepMetric(
+          braveledger_bat_helper::ContributionRetry::STEP_PREPARE),
+      start);
 
   if (!result) {
-    AddRetry(braveledger_bat_helper::ContributionRetry::STEP_PREPARE, "");
+    AddRetry(braveledger_bat_helper::ContributionRetry::STEP_PREPARE,
+             viewing_id);
     return;
   }
 
@@ -968,14 +1018,22 @@ void BatContribution::PrepareBatchCallback(
   bool success = braveledger_bat_helper::getJSONBatchSurveyors(response,
                                                                surveyors);
   if (!success) {
-    AddRetry(braveledger_bat_helper::ContributionRetry::STEP_PREPARE, "");
+    AddRetry(braveledger_bat_helper::ContributionRetry::STEP_PREPARE,
+             viewing_id);
     return;
   }
 
-  braveledger_bat_helper::Transactions transactions =
-    ledger_->GetTransactions();
   braveledger_bat_helper::Ballots ballots = ledger_->GetBallots();
 
+  // only ballots of this reconcile are prepared here
+  std::map<std::string, size_t> ballot_index;
+  for (size_t i = 0; i < ballots.size(); i++) {
+    if (ballots[i].viewingId_ == viewing_id &&
+        ballots[i].proofBallot_.empty()) {
+      ballot_index[ballots[i].surveyorId_] = i;
+    }
+  }
+
   for (size_t j = 0; j < surveyors.size(); j++) {
     std::string error;
     braveledger_bat_helper::getJSONValue("error", surveyors[j], error);
@@ -993,57 +1051,59 @@ void BatContribution::PrepareBatchCallback(
       continue;
     }
 
-    for (int i = ballots.size() - 1; i >= 0; i--) {
-      if (ballots[i].surveyorId_ == surveyor_id) {
-        for (size_t k = 0; k < transactions.size(); k++) {
-          if (transactions[k].viewingId_ == ballots[i].viewingId_ &&
-              ballots[i].proofBallot_.empty()) {
-            ballots[i].prepareBallot_ = surveyors[j];
-          }
-        }
-      }
+    auto ballot = ballot_index.find(surveyor_id);
+    if (ballot != ballot_index.end()) {
+      ballots[ballot->second].prepareBallot_ = surveyors[j];
     }
   }
 
   ledger_->SetBallots(ballots);
-  Proof();
+  Proof(viewing_id);
 }
 
-void BatContribution::Proof() {
+void BatContribution::Proof(const std::string& viewing_id) {
   braveledger_bat_helper::BathProofs batch_proof;
 
-  braveledger_bat_helper::Transactions transactions =
-    ledger_->GetTransactions();
-  braveledger_bat_helper::Ballots ballots = ledger_->GetBallots();
+  const braveledger_bat_helper::TRANSACTION_ST* transaction =
+      GetTransaction(viewing_id);
+  if (!transaction) {
+    // TODO(nejczdovc) what should we do here
+    return;
+  }
+
+  const braveledger_bat_helper::Ballots& ballots = ledger_->GetBallots();
 
   for (int i = ballots.size() - 1; i >= 0; i--) {
-    for (size_t k = 0; k < transactions.size(); k++) {
-      if (transactions[k].viewingId_ == ballots[i].viewingId_) {
-        if (ballots[i].prepareBallot_.empty()) {
-          // TODO(nejczdovc) what should we do here
-          return;
-        }
+    if (ballots[i].viewingId_ != viewing_id) {
+      continue;
+    }
 
-        if (ballots[i].proofBallot_.empty()) {
-          braveledger_bat_helper::BATCH_PROOF batch_proof_el;
-          batch_proof_el.transaction_ = transactions[k];
-          batch_proof_el.ballot_ = ballots[i];
-          batch_proof.push_back(batch_proof_el);
-        }
-      }
+    if (ballots[i].prepareBallot_.empty()) {
+      // TODO(nejczdovc) what should we do here
+      return;
+    }
+
+    if (ballots[i].proofBallot_.empty()) {
+      braveledger_bat_helper::BATCH_PROOF batch_proof_el;
+      batch_proof_el.transaction_ = *transaction;
+      batch_proof_el.ballot_ = ballots[i];
+      batch_proof.push_back(batch_proof_el);
     }
   }
 
   ledger_->RunIOTask(std::bind(&BatContribution::ProofBatch,
                                this,
+                               viewing_id,
                                batch_proof,
                                std::placeholders::_1));
 
 }
 
 void BatContribution::ProofBatch(
+    const std::string& viewing_id,
     const braveledger_bat_helper::BathProofs& batch_proof,
     ledger::LedgerTaskRunner::CallerThreadCallback callback) {
+  uint64_t batch_start = ledger_->GetMetrics()->StartTime();
   std::vector<std::string> proofs;
 
   for (size_t i = 0; i < batch_proof.size(); i++) {
@@ -1078,6 +1138,7 @@ void BatContribution::ProofBatch(
     std::string msg_value[1] = {batch_proof[i].ballot_.publisher_};
     std::string msg = braveledger_bat_helper::stringify(msg_key, msg_value, 1);
 
+    uint64_t start = ledger_->GetMetrics()->StartTime();
     const char* proof = submitMessage(
         msg.c_str(),
         batch_proof[i].transaction_.masterUserToken_.c_str(),
@@ -1085,6 +1146,7 @@ void BatContribution::ProofBatch(
         signature_to_send.c_str(),
         surveyor.surveyorId_.c_str(),
         surveyor.surveyVK_.c_str());
+    ledger_->GetMetrics()->AddTime("anonize.submit_message", start);
 
     std::string annon_proof;
     if (nullptr != proof) {
@@ -1095,15 +1157,24 @@ void BatContribution::ProofBatch(
     proofs.push_back(annon_proof);
   }
 
-  callback(std::bind(&BatContribution::ProofBatchCallback, this, batch_proof, proofs));
+  ledger_->GetMetrics()->AddTime(
+      GetReconcileStepMetric(
+          braveledger_bat_helper::ContributionRetry::STEP_PROOF),
+      batch_start);
+  callback(std::bind(&BatContribution::ProofBatchCallback,
+                     this,
+                     viewing_id,
+                     batch_proof,
+                     proofs));
 }
 
 void BatContribution::ProofBatchCallback(
+    const std::string& viewing_id,
     const braveledger_bat_helper::BathProofs& batch_proof,
     const std::vector<std::string>& proofs) {
   braveledger_bat_helper::Ballots ballots = ledger_->GetBallots();
 
-  for (size_t i = 0; i < batch_proof.size(); i++) {
+  for (size_t i = 0; i < batch_proof.size() && i < proofs.size(); i++) {
     for (size_t j = 0; j < ballots.size(); j++) {
       if (ballots[j].surveyorId_ == batch_proof[i].ballot_.surveyorId_) {
         ballots[j].proofBallot_ = proofs[i];
@@ -1114,56 +1185,58 @@ void BatContribution::ProofBatchCallback(
   ledger_->SetBallots(ballots);
 
   if (batch_proof.size() != proofs.size()) {
-    AddRetry(braveledger_bat_helper::ContributionRetry::STEP_PROOF, "");
+    AddRetry(braveledger_bat_helper::ContributionRetry::STEP_PROOF,
+             viewing_id);
     return;
   }
 
-  SetTimer(last_prepare_vote_batch_timer_id_);
+  SetTimer(pipelines_[viewing_id].prepare_vote_batch_timer_id_,
+           std::bind(&BatContribution::OnPrepareVoteBatchTimer,
+                     this,
+                     viewing_id));
 }
 
-void BatContribution::PrepareVoteBatch() {
+void BatContribution::PrepareVoteBatch(const std::string& viewing_id) {
   braveledger_bat_helper::Transactions transactions =
       ledger_->GetTransactions();
   braveledger_bat_helper::Ballots ballots = ledger_->GetBallots();
   braveledger_bat_helper::BatchVotes batch = ledger_->GetBatch();
 
-  if (ballots.size() == 0) {
-    SetTimer(last_vote_batch_timer_id_);
-    return;
+  int transaction_index = -1;
+  for (size_t k = 0; k < transactions.size(); k++) {
+    if (transactions[k].viewingId_ == viewing_id) {
+      transaction_index = k;
+      break;
+    }
   }
 
-  for (int i = ballots.size() - 1; i >= 0; i--) {
+  bool changed = false;
+  for (int i = ballots.size() - 1; i >= 0 && transaction_index >= 0; i--) {
+    if (ballots[i].viewingId_ != viewing_id) {
+      continue;
+    }
+
     if (ballots[i].prepareBallot_.empty() || ballots[i].proofBallot_.empty()) {
       // TODO(nejczdovc) what to do in this case
       continue;
     }
 
-    bool transaction_exit = false;
-    for (size_t k = 0; k < transactions.size(); k++) {
-      if (transactions[k].viewingId_ == ballots[i].viewingId_) {
-        bool ballot_exit = false;
-        for (size_t j = 0; j < transactions[k].ballots_.size(); j++) {
-          if (transactions[k].ballots_[j].publisher_ == ballots[i].publisher_) {
-            transactions[k].ballots_[j].offset_++;
-            ballot_exit = true;
-            break;
-          }
-        }
-
-        if (!ballot_exit) {
-          braveledger_bat_helper::TRANSACTION_BALLOT_ST transactionBallot;
-          transactionBallot.publisher_ = ballots[i].publisher_;
-          transactionBallot.offset_++;
-          transactions[k].ballots_.push_back(transactionBallot);
-        }
-        transaction_exit = true;
+    braveledger_bat_helper::TRANSACTION_ST& transaction =
+        transactions[transaction_index];
+    bool ballot_exit = false;
+    for (size_t j = 0; j < transaction.ballots_.size(); j++) {
+      if (transaction.ballots_[j].publisher_ == ballots[i].publisher_) {
+        transaction.ballots_[j].offset_++;
+        ballot_exit = true;
         break;
       }
     }
 
-    if (!transaction_exit) {
-      // TODO(nejczdovc) what to do in this case
-      continue;
+    if (!ballot_exit) {
+      braveledger_bat_helper::TRANSACTION_BALLOT_ST transactionBallot;
+      transactionBallot.publisher_ = ballots[i].publisher_;
+      transactionBallot.offset_++;
+      transaction.ballots_.push_back(transactionBallot);
     }
 
     bool exist_batch = false;
@@ -1172,7 +1245,8 @@ void BatContribution::PrepareVoteBatch() {
     batchVotesInfoSt.proof_ = ballots[i].proofBallot_;
 
     for (size_t k = 0; k < batch.size(); k++) {
-      if (batch[k].publisher_ == ballots[i].publisher_) {
+      if (batch[k].publisher_ == ballots[i].publisher_ &&
+          batch[k].viewingId_ == viewing_id) {
         exist_batch = true;
         batch[k].batchVotesInfo_.push_back(batchVotesInfoSt);
       }
@@ -1181,36 +1255,45 @@ void BatContribution::PrepareVoteBatch() {
     if (!exist_batch) {
       braveledger_bat_helper::BATCH_VOTES_ST batchVotesSt;
       batchVotesSt.publisher_ = ballots[i].publisher_;
+      batchVotesSt.viewingId_ = viewing_id;
       batchVotesSt.batchVotesInfo_.push_back(batchVotesInfoSt);
       batch.push_back(batchVotesSt);
     }
 
     ballots.erase(ballots.begin() + i);
+    changed = true;
   }
 
-  ledger_->SetTransactions(transactions);
-  ledger_->SetBallots(ballots);
-  ledger_->SetBatch(batch);
-  SetTimer(last_vote_batch_timer_id_);
+  if (changed) {
+    ledger_->SetTransactions(transactions);
+    ledger_->SetBallots(ballots);
+    ledger_->SetBatch(batch);
+  }
+
+  SetTimer(pipelines_[viewing_id].vote_batch_timer_id_,
+           std::bind(&BatContribution::OnVoteBatchTimer, this, viewing_id));
 }
 
-void BatContribution::VoteBatch() {
-  braveledger_bat_helper::BatchVotes batch = ledger_->GetBatch();
-  if (batch.size() == 0) {
-    return;
+void BatContribution::VoteBatch(const std::string& viewing_id) {
+  const braveledger_bat_helper::BatchVotes& batch = ledger_->GetBatch();
+  const braveledger_bat_helper::BATCH_VOTES_ST* batch_votes = nullptr;
+  for (const auto& votes : batch) {
+    if (votes.viewingId_ == viewing_id) {
+      batch_votes = &votes;
+      break;
+    }
   }
 
-  braveledger_bat_helper::BATCH_VOTES_ST batch_votes = batch[0];
-  std::vector<braveledger_bat_helper::BATCH_VOTES_INFO_ST> vote_batch;
-
-  if (batch_votes.batchVotesInfo_.size() > VOTE_BATCH_SIZE) {
-    vote_batch.assign(batch_votes.batchVotesInfo_.begin(),
-                     batch_votes.batchVotesInfo_.begin() + VOTE_BATCH_SIZE);
-  } else {
-    vote_batch = batch_votes.batchVotesInfo_;
+  if (!batch_votes) {
+    OnVotingComplete(viewing_id);
+    return;
   }
 
-  std::string payload = braveledger_bat_helper::stringifyBatch(vote_batch);
+  std::string publisher = batch_votes->publisher_;
+  std::string payload;
+  braveledger_bat_helper::stringifyBatch(batch_votes->batchVotesInfo_,
+                                         VOTE_BATCH_SIZE,
+                                         &payload);
 
   std::string url = braveledger_bat_helper::buildURL(
       (std::string)SURVEYOR_BATCH_VOTING ,
@@ -1225,21 +1308,30 @@ void BatContribution::VoteBatch() {
   handler_.AddRequestHandler(std::move(request_id),
                              std::bind(&BatContribution::VoteBatchCallback,
                                        this,
-                                       batch_votes.publisher_,
+                                       viewing_id,
+                                       publisher,
+                                       ledger_->GetMetrics()->StartTime(),
                                        std::placeholders::_1,
                                        std::placeholders::_2,
                                        std::placeholders::_3));
 }
 
 void BatContribution::VoteBatchCallback(
+    const std::string& viewing_id,
     const std::string& publisher,
+    uint64_t start,
     bool result,
     const std::string& response,
     const std::map<std::string, std::string>& headers) {
   ledger_->LogResponse(__func__, result, response, headers);
+  ledger_->GetMetrics()->AddTime(
+      GetReconcileStepMetric(
+          braveledger_bat_helper::ContributionRetry::STEP_VOTE),
+      start);
 
   if (!result) {
-    AddRetry(braveledger_bat_helper::ContributionRetry::STEP_VOTE, "");
+    AddRetry(braveledger_bat_helper::ContributionRetry::STEP_VOTE,
+             viewing_id);
     return;
   }
 
@@ -1247,78 +1339,103 @@ void BatContribution::VoteBatchCallback(
   bool success = braveledger_bat_helper::getJSONBatchSurveyors(response,
                                                                surveyors);
   if (!success) {
-    AddRetry(braveledger_bat_helper::ContributionRetry::STEP_VOTE, "");
+    AddRetry(braveledger_bat_helper::ContributionRetry::STEP_VOTE,
+             viewing_id);
     return;
   }
 
+  std::set<std::string> accepted;
+  for (size_t k = 0; k < surveyors.size(); k++) {
+    std::string surveyor_id;
+    bool success = braveledger_bat_helper::getJSONValue("surveyorId",
+                                                        surveyors[k],
+                                                        surveyor_id);
+    if (!success) {
+      // TODO(nejczdovc) what to do in this case
+      continue;
+    }
+
+    accepted.insert(surveyor_id);
+  }
+
   braveledger_bat_helper::BatchVotes batch = ledger_->GetBatch();
 
-  for (size_t i = 0; i < batch.size(); i++) {
-    if (batch[i].publisher_ == publisher) {
+  bool has_votes = false;
+  for (auto iter = batch.begin(); iter != batch.end();) {
+    if (iter->viewingId_ != viewing_id) {
+      ++iter;
+      continue;
+    }
+
+    if (iter->publisher_ == publisher) {
       size_t sizeToCheck = VOTE_BATCH_SIZE;
-      if (batch[i].batchVotesInfo_.size() < VOTE_BATCH_SIZE) {
-        sizeToCheck = batch[i].batchVotesInfo_.size();
+      if (iter->batchVotesInfo_.size() < VOTE_BATCH_SIZE) {
+        sizeToCheck = iter->batchVotesInfo_.size();
       }
 
       for (int j = sizeToCheck - 1; j >= 0; j--) {
-        for (size_t k = 0; k < surveyors.size(); k++) {
-          std::string surveyor_id;
-          bool success = braveledger_bat_helper::getJSONValue("surveyorId",
-                                                              surveyors[k],
-                                                              surveyor_id);
-          if (!success) {
-            // TODO(nejczdovc) what to do in this case
-            continue;
-          }
-
-          if (surveyor_id == batch[i].batchVotesInfo_[j].surveyorId_) {
-            batch[i].batchVotesInfo_.erase(
-                batch[i].batchVotesInfo_.begin() + j);
-            break;
-          }
+        if (accepted.count(iter->batchVotesInfo_[j].surveyorId_) > 0) {
+          iter->batchVotesInfo_.erase(iter->batchVotesInfo_.begin() + j);
         }
       }
 
-      if (batch[i].batchVotesInfo_.size() == 0) {
-        batch.erase(batch.begin() + i);
+      if (iter->batchVotesInfo_.size() == 0) {
+        iter = batch.erase(iter);
+        continue;
       }
-      break;
     }
+
+    has_votes = true;
+    ++iter;
   }
 
   ledger_->SetBatch(batch);
 
-  if (batch.size() > 0) {
-    SetTimer(last_vote_batch_timer_id_);
+  if (has_votes) {
+    SetTimer(pipelines_[viewing_id].vote_batch_timer_id_,
+             std::bind(&BatContribution::OnVoteBatchTimer, this, viewing_id));
+  } else {
+    OnVotingComplete(viewing_id);
   }
 }
 
-void BatContribution::OnTimer(uint32_t timer_id) {
-  if (timer_id == last_reconcile_timer_id_) {
-    last_reconcile_timer_id_ = 0;
-    OnTimerReconcile();
-    return;
+void BatContribution::OnVotingComplete(const std::string& viewing_id) {
+  auto pipeline = pipelines_.find(viewing_id);
+  if (pipeline != pipelines_.end()) {
+    ledger_->CancelTimer(pipeline->second.prepare_vote_batch_timer_id_);
+    ledger_->CancelTimer(pipeline->second.vote_batch_timer_id_);
+    pipelines_.erase(pipeline);
   }
 
-  if (timer_id == last_prepare_vote_batch_timer_id_) {
-    last_prepare_vote_batch_timer_id_ = 0;
-    PrepareVoteBatch();
-    return;
+  // reconcile is removed on the next start up
+  const auto reconcile = ledger_->GetReconcileById(viewing_id);
+  if (!reconcile.viewingId_.empty() &&
+      reconcile.retry_step_ !=
+          braveledger_bat_helper::ContributionRetry::STEP_FINAL) {
+    ledger_->AddReconcileStep(
+        viewing_id,
+        braveledger_bat_helper::ContributionRetry::STEP_FINAL);
   }
+}
 
-  if (timer_id == last_vote_batch_timer_id_) {
-    last_vote_batch_timer_id_ = 0;
-    VoteBatch();
-    return;
-  }
+void BatContribution::OnReconcileTimer() {
+  last_reconcile_timer_id_ = 0;
+  OnTimerReconcile();
+}
 
-  for(std::pair<std::string, uint32_t> const& value: retry_timers_) {
-    if (value.second == timer_id) {
-      std::string viewing_id = value.first;
-      DoRetry(viewing_id);
-      retry_timers_[viewing_id] = 0u;
-    }
-  }
+void BatContribution::OnPrepareVoteBatchTimer(const std::string& viewing_id) {
+  pipelines_[viewing_id].prepare_vote_batch_timer_id_ = 0;
+  PrepareVoteBatch(viewing_id);
+}
+
+void BatContribution::OnVoteBatchTimer(const std::string& viewing_id) {
+  pipelines_[viewing_id].vote_batch_timer_id_ = 0;
+  VoteBatch(viewing_id);
+}
+
+void BatContribution::OnRetryTimer(const std::string& viewing_id) {
+  retry_timers_.erase(viewing_id);
+  DoRetry(viewing_id);
 }
 
 void BatContribution::SetReconcileTimer() {
@@ -1333,10 +1450,19 @@ void BatContribution::SetReconcileTimer() {
       (next_reconcile_stamp == 0 || next_reconcile_stamp < now) ?
         0 : next_reconcile_stamp - now;
 
-  SetTimer(last_reconcile_timer_id_, time_to_next_reconcile);
+  SetTimer(last_reconcile_timer_id_,
+           std::bind(&BatContribution::OnReconcileTimer, this),
+           time_to_next_reconcile);
 }
 
-void BatContribution::SetTimer(uint32_t& timer_id, uint64_t start_timer_in) {
+void BatContribution::SetTimer(uint32_t& timer_id,
+                               bat_ledger::TimerService::TimerCallback callback,
+                               uint64_t start_timer_in) {
+  // only the latest timer of the kind is kept
+  if (timer_id != 0) {
+    ledger_->CancelTimer(timer_id);
+  }
+
   if (start_timer_in == 0) {
     start_timer_in = braveledger_bat_helper::getRandomValue(10, 60);
   }
@@ -1344,7 +1470,7 @@ void BatContribution::SetTimer(uint32_t& timer_id, uint64_t start_timer_in) {
   BLOG(ledger_, ledger::LogLevel::LOG_INFO) <<
     "Starts in " << start_timer_in;
 
-  ledger_->SetTimer(start_timer_in, timer_id);
+  timer_id = ledger_->SetTimer(start_timer_in, callback);
 }
 
 void BatContribution::OnReconcileCompleteSuccess(
@@ -1414,23 +1540,30 @@ void BatContribution::AddRetry(
       << std::to_string(step)
       << "for" << viewing_id;
 
-  if (reconcile.viewingId_.empty()) {
+  // phase one task is updated in place, so that it resumes with
+  // the same retry step and level as the saved reconcile
+  braveledger_bat_helper::CURRENT_RECONCILE* current = &reconcile;
+  auto task = reconciles_.find(viewing_id);
+  if (task != reconciles_.end()) {
+    current = task->second.get();
+  } else if (reconcile.viewingId_.empty()) {
     reconcile = ledger_->GetReconcileById(viewing_id);
   }
 
-  uint64_t start_timer_in = GetRetryTimer(step, viewing_id, reconcile);
+  uint64_t start_timer_in = GetRetryTimer(step, viewing_id, *current);
   bool success = ledger_->AddReconcileStep(viewing_id,
-                                           reconcile.retry_step_,
-                                           reconcile.retry_level_);
+                                           current->retry_step_,
+                                           current->retry_level_);
   if (!success || start_timer_in == 0) {
     OnReconcileComplete(ledger::Result::LEDGER_ERROR,
                         viewing_id,
-                        reconcile.category_);
+                        current->category_);
     return;
   }
 
-  retry_timers_[viewing_id] = 0u;
-  SetTimer(retry_timers_[viewing_id], start_timer_in);
+  SetTimer(retry_timers_[viewing_id],
+           std::bind(&BatContribution::OnRetryTimer, this, viewing_id),
+           start_timer_in);
 }
 
 uint64_t BatContribution::GetRetryTimer(
@@ -1512,39 +1645,35 @@ int BatContribution::GetRetryPhase(braveledger_bat_helper::ContributionRetry ste
 }
 
 void BatContribution::DoRetry(const std::string& viewing_id) {
+  auto task = reconciles_.find(viewing_id);
+  if (task != reconciles_.end()) {
+    RunReconcileStep(task->second.get());
+    return;
+  }
+
   auto reconcile = ledger_->GetReconcileById(viewing_id);
 
   switch (reconcile.retry_step_) {
-    case braveledger_bat_helper::ContributionRetry::STEP_RECONCILE: {
-      Reconcile(viewing_id);
-      break;
-    }
-    case braveledger_bat_helper::ContributionRetry::STEP_CURRENT: {
-      CurrentReconcile(viewing_id);
-      break;
-    }
-    case braveledger_bat_helper::ContributionRetry::STEP_PAYLOAD: {
-      ReconcilePayload(viewing_id);
-      break;
-    }
-    case braveledger_bat_helper::ContributionRetry::STEP_REGISTER: {
-      RegisterViewing(viewing_id);
-      break;
-    }
+    case braveledger_bat_helper::ContributionRetry::STEP_RECONCILE:
+    case braveledger_bat_helper::ContributionRetry::STEP_CURRENT:
+    case braveledger_bat_helper::ContributionRetry::STEP_PAYLOAD:
+    case braveledger_bat_helper::ContributionRetry::STEP_REGISTER:
     case braveledger_bat_helper::ContributionRetry::STEP_VIEWING: {
-      ViewingCredentials(viewing_id);
+      // resumes from the saved step, everything that previous
+      // steps fetched is already in the reconcile
+      RunReconcileStep(AddReconcileTask(reconcile));
       break;
     }
     case braveledger_bat_helper::ContributionRetry::STEP_PREPARE: {
-      PrepareBallots();
+      PrepareBallots(viewing_id);
       break;
     }
     case braveledger_bat_helper::ContributionRetry::STEP_PROOF: {
-      Proof();
+      Proof(viewing_id);
       break;
     }
     case braveledger_bat_helper::ContributionRetry::STEP_VOTE: {
-      VoteBatch();
+      VoteBatch(viewing_id);
       break;
     }
     case braveledger_bat_helper::ContributionRetry::STEP_WINNERS: {
@@ -6,9 +6,11 @@
 
 #include <string>
 #include <map>
+#include <memory>
 
 #include "bat/ledger/ledger.h"
 #include "bat_helper.h"
+#include "timer_service.h"
 #include "url_request_handler.h"
 
 // Contribution has two big phases. PHASE 1 is starting the contribution,
@@ -42,17 +44,11 @@
 
 // PHASE 1 (reconcile)
 // 1. StartReconcile
-// 2. Reconcile
-// 3. ReconcileCallback
-// 4. CurrentReconcile
-// 5. CurrentReconcileCallback
-// 6. ReconcilePayload
-// 7. ReconcilePayloadCallback
-// 8. RegisterViewing
-// 9. RegisterViewingCallback
-// 10. ViewingCredentials
-// 11. ViewingCredentialsCallback
-// 12. OnReconcileComplete
+// 2. RunReconcileStep - sends request of the current step
+// 3. OnReconcileStepResponse - saves the result and moves to the next step
+//    STEP_RECONCILE -> STEP_CURRENT -> STEP_PAYLOAD -> STEP_REGISTER ->
+//    STEP_VIEWING
+// 4. OnReconcileComplete
 
 // PHASE 2 (voting)
 // 1. GetReconcileWinners
@@ -108,17 +104,17 @@ class BatContribution {
 
   void OnStartUp();
 
+  // Runs the auto contribute that waited for the verified publishers
+  void OnPublisherListReady();
+
   // Starting point for contribution
   // We determinate which contribution we want to do and do appropriate actions
   void StartReconcile(
       const std::string &viewing_id,
       const ledger::PUBLISHER_CATEGORY category,
-      const braveledger_bat_helper::PublisherList& list,
+      braveledger_bat_helper::PublisherList list,
       const braveledger_bat_helper::Directions& directions = {});
 
-  // Called when timer is triggered
-  void OnTimer(uint32_t timer_id);
-
   // Sets new reconcile timer for monthly contribution in 30 days
   void SetReconcileTimer();
 
@@ -148,44 +144,40 @@ class BatContribution {
   // Triggers contribution process for auto contribute table
   void StartAutoContribute();
 
-  void Reconcile(const std::string &viewing_id);
+  // Phase one runs as a state machine over |retry_step_| of the reconcile.
+  // Reconcile is loaded once into a task that lives until phase one
+  // is over, every step updates the task and saves it together with
+  // the next step, so retries and restarts resume from the saved step.
+  braveledger_bat_helper::CURRENT_RECONCILE* AddReconcileTask(
+      const braveledger_bat_helper::CURRENT_RECONCILE& reconcile);
 
-  void ReconcileCallback(const std::string& viewing_id,
-                         bool result,
-                         const std::string& response,
-                         const std::map<std::string, std::string>& headers);
+  void RunReconcileStep(braveledger_bat_helper::CURRENT_RECONCILE* reconcile);
 
-  void CurrentReconcile(const std::string& viewing_id);
-
-  void CurrentReconcileCallback(
-      const std::string& viewing_id,
+  void OnReconcileStepResponse(
+      braveledger_bat_helper::CURRENT_RECONCILE* reconcile,
+      uint64_t start,
       bool result,
       const std::string& response,
       const std::map<std::string, std::string>& headers);
 
-  void ReconcilePayload(const std::string& viewing_id);
+  // Step handlers return false when the step needs to be retried
+  bool OnCurrentReconcile(braveledger_bat_helper::CURRENT_RECONCILE* reconcile,
+                          const std::string& response);
 
-  void ReconcilePayloadCallback(
-      const std::string& viewing_id,
-      bool result,
-      const std::string& response,
-      const std::map<std::string, std::string>& headers);
-
-  void RegisterViewing(const std::string& viewing_id);
+  // Returns empty string when the payload can't be signed
+  std::string GetReconcilePayload(
+      const braveledger_bat_helper::CURRENT_RECONCILE& reconcile);
 
-  void RegisterViewingCallback(
-      const std::string& viewing_id,
-      bool result,
-      const std::string& response,
-      const std::map<std::string, std::string>& headers);
+  bool OnReconcilePayload(
+      const braveledger_bat_helper::CURRENT_RECONCILE& reconcile,
+      const std::string& response);
 
-  void ViewingCredentials(const std::string& viewing_id);
+  bool OnRegisterViewing(braveledger_bat_helper::CURRENT_RECONCILE* reconcile,
+                         const std::string& response);
 
-  void ViewingCredentialsCallback(
-      const std::string& viewing_id,
-      bool result,
-      const std::string& response,
-      const std::map<std::string, std::string>& headers);
+  void OnViewingCredentials(
+      braveledger_bat_helper::CURRENT_RECONCILE* reconcile,
+      const std::string& response);
 
   void OnReconcileComplete(ledger::Result result,
                            const std::string& viewing_id,
@@ -196,13 +188,16 @@ class BatContribution {
 
   void GetReconcileWinners(const std::string& viewing_id);
 
+  // Publisher list of the reconcile is handed over, so that its records
+  // can be normalized, sorted and moved into the winners without copies
   void GetContributeWinners(const unsigned int& ballots,
                             const std::string& viewing_id,
-                            const braveledger_bat_helper::PublisherList& list);
+                            braveledger_bat_helper::PublisherList list);
 
   void GetDonationWinners(const unsigned int& ballots,
                           const std::string& viewing_id,
-                          const braveledger_bat_helper::PublisherList& list);
+                          double fee,
+                          braveledger_bat_helper::PublisherList list);
 
   void VotePublishers(const braveledger_bat_helper::Winners& winners,
                       const std::string& viewing_id);
@@ -210,38 +205,61 @@ class BatContribution {
   void VotePublisher(const std::string& publisher,
                      const std::string& viewing_id);
 
-  void PrepareBallots();
+  // Phase two is done per reconcile, so that several reconciles
+  // can prepare, prove and send their votes at the same time
+  void PrepareBallots(const std::string& viewing_id);
+
+  // Returns nullptr when there is no transaction for |viewing_id|
+  const braveledger_bat_helper::TRANSACTION_ST* GetTransaction(
+      const std::string& viewing_id) const;
 
   void PrepareBatch(
-      const braveledger_bat_helper::BALLOT_ST& ballot,
+      const std::string& viewing_id,
       const braveledger_bat_helper::TRANSACTION_ST& transaction);
 
   void PrepareBatchCallback(
+      const std::string& viewing_id,
+      uint64_t start,
       bool result,
       const std::string& response,
       const std::map<std::string, std::string>& headers);
 
-  void Proof();
+  void Proof(const std::string& viewing_id);
 
   void ProofBatch(
+      const std::string& viewing_id,
       const braveledger_bat_helper::BathProofs& batch_proof,
       ledger::LedgerTaskRunner::CallerThreadCallback callback);
 
   void ProofBatchCallback(
+      const std::string& viewing_id,
       const braveledger_bat_helper::BathProofs& batch_proof,
       const std::vector<std::string>& proofs);
 
-  void PrepareVoteBatch();
+  void PrepareVoteBatch(const std::string& viewing_id);
 
-  void VoteBatch();
+  void VoteBatch(const std::string& viewing_id);
 
   void VoteBatchCallback(
+      const std::string& viewing_id,
       const std::string& publisher,
+      uint64_t start,
       bool result,
       const std::string& response,
       const std::map<std::string, std::string>& headers);
 
-  void SetTimer(uint32_t& timer_id, uint64_t start_timer_in = 0);
+  // All votes of the reconcile were accepted
+  void OnVotingComplete(const std::string& viewing_id);
+
+  // Replaces the timer that |timer_id| points to
+  void SetTimer(uint32_t& timer_id,
+                bat_ledger::TimerService::TimerCallback callback,
+                uint64_t start_timer_in = 0);
+
+  void OnReconcileTimer();
+  void OnPrepareVoteBatchTimer(const std::string& viewing_id);
+  void OnVoteBatchTimer(const std::string& viewing_id);
+  void OnRetryTimer(const std::string& viewing_id);
 
   void AddRetry(
     braveledger_bat_helper::ContributionRetry step,
@@ -258,10 +276,20 @@ class BatContribution {
 
   bat_ledger::LedgerImpl* ledger_;  // NOT OWNED
   bat_ledger::URLRequestHandler handler_;
+  // Phase two timers of one reconcile
+  struct VotingPipeline {
+    uint32_t prepare_vote_batch_timer_id_ = 0u;
+    uint32_t vote_batch_timer_id_ = 0u;
+  };
+
   uint32_t last_reconcile_timer_id_;
-  uint32_t last_prepare_vote_batch_timer_id_;
-  uint32_t last_vote_batch_timer_id_;
+  bool auto_contribute_pending_;
+  // keyed by viewing id
+  std::map<std::string, VotingPipeline> pipelines_;
   std::map<std::string, uint32_t> retry_timers_;
+  // phase one tasks keyed by viewing id
+  std::map<std::string,
+      std::unique_ptr<braveledger_bat_helper::CURRENT_RECONCILE>> reconciles_;
 };
 
 }  // namespace braveledger_bat_contribution
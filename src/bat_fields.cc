@@ -0,0 +1,92 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "bat_fields.h"
+
+#include <string.h>
+
+#include "bat_codec.h"
+#include "bat_helper_platform.h"
+
+namespace braveledger_bat_helper {
+
+namespace {
+
+uint32_t HashName(const char* name, size_t length) {
+  // FNV-1a
+  uint32_t hash = 2166136261u;
+  for (size_t i = 0; i < length; i++) {
+    hash ^= static_cast<uint8_t>(name[i]);
+    hash *= 16777619u;
+  }
+  return hash;
+}
+
+}  // namespace
+
+FieldIndex::FieldIndex(const Names& names) {
+  // at most half full, a miss ends on the first empty slot
+  size_t size = 4;
+  while (size < names.size() * 2) {
+    size *= 2;
+  }
+  entries_.assign(size, Entry{nullptr, 0, -1});
+  mask_ = size - 1;
+
+  for (size_t i = 0; i < names.size(); i++) {
+    DCHECK(Find(names[i].first, names[i].second) < 0);
+    size_t slot = HashName(names[i].first, names[i].second) & mask_;
+    while (entries_[slot].name) {
+      slot = (slot + 1) & mask_;
+    }
+    entries_[slot] = Entry{names[i].first, names[i].second,
+                           static_cast<int>(i)};
+  }
+}
+
+int FieldIndex::Find(const char* name, size_t length) const {
+  size_t slot = HashName(name, length) & mask_;
+  while (entries_[slot].name) {
+    const Entry& entry = entries_[slot];
+    if (entry.length == length && 0 == memcmp(entry.name, name, length)) {
+      return entry.field;
+    }
+    slot = (slot + 1) & mask_;
+  }
+  return -1;
+}
+
+void WriteJson(JsonWriter& writer,
+               const std::vector<uint8_t>& value,
+               Base64) {
+  std::string encoded;
+  braveledger_bat_codec::AppendBase64(value.data(), value.size(), &encoded);
+  writer.String(encoded.c_str(),
+                static_cast<rapidjson::SizeType>(encoded.size()));
+}
+
+// The text is only checked here, ReadJson decodes it once
+bool CheckJson(const rapidjson::Value& json,
+               const std::vector<uint8_t>*,
+               Base64) {
+  return json.IsString() &&
+      braveledger_bat_codec::IsBase64(json.GetString(),
+                                      json.GetStringLength());
+}
+
+void ReadJson(const rapidjson::Value& json,
+              std::vector<uint8_t>* value,
+              Base64) {
+  size_t length = json.GetStringLength();
+  value->resize(braveledger_bat_codec::Base64DecodedMaxLength(length));
+  size_t decoded = 0;
+  // checked by CheckJson, |decoded| stays 0 if it wasn't
+  braveledger_bat_codec::Base64Decode(json.GetString(),
+                                      length,
+                                      value->data(),
+                                      &decoded);
+  value->resize(decoded);
+}
+
+}  // namespace braveledger_bat_helper
@@ -0,0 +1,485 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVELEDGER_BAT_FIELDS_H_
+#define BRAVELEDGER_BAT_FIELDS_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <map>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "rapidjson_bat_helper.h"
+
+// Member tables for the structs that are saved by the ledger. A struct
+// lists its members once, in the order they are written, in a FieldTable
+// specialization:
+//
+//   template <>
+//   struct FieldTable<BALLOT_ST> {
+//     static constexpr auto Get() {
+//       return std::make_tuple(
+//           Required("viewingId", &BALLOT_ST::viewingId_),
+//           Optional("destination", &BALLOT_ST::destination_));
+//     }
+//   };
+//
+// and its loader and writer come from the table. The codec tag of a field
+// picks the encoding when the member type alone does not say it. Encodings
+// walk a table with VisitFields, JSON is the one below.
+namespace braveledger_bat_helper {
+
+// Codec tags
+struct Plain {};  // by the member type
+struct AsUint {};  // uint64_t member saved as a 32 bit number
+struct Base64 {};  // bytes as a base64 string, "" when empty
+struct KeyedArray {};  // map as [{"key": value}, ...]
+
+enum class Presence {
+  REQUIRED,  // missing or of the wrong type fails the load
+  OPTIONAL,  // missing or of the wrong type keeps the member as it is
+};
+
+template <typename T, typename M>
+struct MemberAccess {
+  M& Get(T* owner) const { return owner->*member; }
+  const M& Get(const T& owner) const { return owner.*member; }
+
+  M T::* member;
+};
+
+// Member of a member, for structs that are saved flattened into the owner
+template <typename T, typename O, typename M>
+struct NestedAccess {
+  M& Get(T* owner) const { return (owner->*outer).*member; }
+  const M& Get(const T& owner) const { return (owner.*outer).*member; }
+
+  O T::* outer;
+  M O::* member;
+};
+
+template <typename Access, typename Codec>
+struct Field {
+  typedef Codec CodecType;
+
+  const char* name;
+  size_t name_length;
+  Presence presence;
+  Access access;
+};
+
+template <typename Codec = Plain, typename T, typename M, size_t N>
+constexpr Field<MemberAccess<T, M>, Codec> Required(const char (&name)[N],
+                                                    M T::* member) {
+  return {name, N - 1, Presence::REQUIRED, {member}};
+}
+
+template <typename Codec = Plain, typename T, typename M, size_t N>
+constexpr Field<MemberAccess<T, M>, Codec> Optional(const char (&name)[N],
+                                                    M T::* member) {
+  return {name, N - 1, Presence::OPTIONAL, {member}};
+}
+
+template <typename Codec = Plain, typename T, typename O, typename M,
+          size_t N>
+constexpr Field<NestedAccess<T, O, M>, Codec> Required(const char (&name)[N],
+                                                       O T::* outer,
+                                                       M O::* member) {
+  return {name, N - 1, Presence::REQUIRED, {outer, member}};
+}
+
+template <typename T>
+struct FieldTable;
+
+namespace internal {
+
+template <typename Fields, typename Visitor, size_t... I>
+void VisitTuple(const Fields& fields,
+                Visitor& visitor,
+                std::index_sequence<I...>) {
+  // braced lists are evaluated in order, fields are visited as listed
+  int expand[] = {0, (visitor(std::get<I>(fields), I), 0)...};
+  (void)expand;
+}
+
+}  // namespace internal
+
+template <typename T>
+constexpr size_t FieldCount() {
+  return std::tuple_size<decltype(FieldTable<T>::Get())>::value;
+}
+
+// Calls |visitor|(field, index) for every field of T
+template <typename T, typename Visitor>
+void VisitFields(Visitor&& visitor) {
+  const auto fields = FieldTable<T>::Get();
+  internal::VisitTuple(fields,
+                       visitor,
+                       std::make_index_sequence<FieldCount<T>()>());
+}
+
+// Open addressed table from names to field indexes, built once per struct
+// so that every key of a loaded object costs a single lookup
+class FieldIndex {
+ public:
+  template <typename T>
+  static const FieldIndex& Get() {
+    static const FieldIndex* index = new FieldIndex(GetNames<T>());
+    return *index;
+  }
+
+  // -1 when |name| is not a field
+  int Find(const char* name, size_t length) const;
+
+ private:
+  typedef std::vector<std::pair<const char*, size_t>> Names;
+
+  struct Entry {
+    const char* name;
+    size_t length;
+    int field;
+  };
+
+  explicit FieldIndex(const Names& names);
+
+  template <typename T>
+  static Names GetNames() {
+    Names names;
+    VisitFields<T>([&names](const auto& field, size_t) {
+      names.push_back(std::make_pair(field.name, field.name_length));
+    });
+    return names;
+  }
+
+  std::vector<Entry> entries_;
+  size_t mask_;
+};
+
+/////////////////////////////////////////////////////////////////////////////
+// JSON
+
+template <typename T>
+void WriteObject(JsonWriter& writer, const T& value);
+
+template <typename T>
+bool ReadObject(const rapidjson::Value& json, T* value);
+
+// Value writers, one per member type or codec
+
+inline void WriteJson(JsonWriter& writer, const std::string& value, Plain) {
+  writer.String(value.c_str());
+}
+
+inline void WriteJson(JsonWriter& writer, unsigned int value, Plain) {
+  writer.Uint(value);
+}
+
+inline void WriteJson(JsonWriter& writer, int value, Plain) {
+  writer.Int(value);
+}
+
+inline void WriteJson(JsonWriter& writer, uint64_t value, Plain) {
+  writer.Uint64(value);
+}
+
+inline void WriteJson(JsonWriter& writer, double value, Plain) {
+  writer.Double(value);
+}
+
+inline void WriteJson(JsonWriter& writer, bool value, Plain) {
+  writer.Bool(value);
+}
+
+template <typename E>
+typename std::enable_if<std::is_enum<E>::value>::type
+WriteJson(JsonWriter& writer, E value, Plain) {
+  writer.Int(static_cast<int>(value));
+}
+
+template <typename T>
+auto WriteJson(JsonWriter& writer, const T& value, Plain)
+    -> decltype(FieldTable<T>::Get(), void()) {
+  WriteObject(writer, value);
+}
+
+template <typename V>
+void WriteJson(JsonWriter& writer, const std::vector<V>& value, Plain) {
+  writer.StartArray();
+  for (const auto& item : value) {
+    WriteJson(writer, item, Plain());
+  }
+  writer.EndArray();
+}
+
+template <typename V>
+void WriteJson(JsonWriter& writer,
+               const std::map<std::string, V>& value,
+               Plain) {
+  writer.StartObject();
+  for (const auto& item : value) {
+    writer.String(item.first.c_str());
+    WriteJson(writer, item.second, Plain());
+  }
+  writer.EndObject();
+}
+
+inline void WriteJson(JsonWriter& writer, uint64_t value, AsUint) {
+  writer.Uint(static_cast<unsigned int>(value));
+}
+
+void WriteJson(JsonWriter& writer, const std::vector<uint8_t>& value, Base64);
+
+template <typename V>
+void WriteJson(JsonWriter& writer,
+               const std::map<std::string, V>& value,
+               KeyedArray) {
+  writer.StartArray();
+  for (const auto& item : value) {
+    writer.StartObject();
+    writer.String(item.first.c_str());
+    WriteJson(writer, item.second, Plain());
+    writer.EndObject();
+  }
+  writer.EndArray();
+}
+
+// Type checks, a loader only assigns members that pass them. Nested
+// structs and containers are checked by their own type, what they hold is
+// loaded on a best effort basis the way the old loaders did.
+
+inline bool CheckJson(const rapidjson::Value& json,
+                      const std::string*,
+                      Plain) {
+  return json.IsString();
+}
+
+inline bool CheckJson(const rapidjson::Value& json,
+                      const unsigned int*,
+                      Plain) {
+  return json.IsUint();
+}
+
+inline bool CheckJson(const rapidjson::Value& json, const int*, Plain) {
+  return json.IsInt();
+}
+
+inline bool CheckJson(const rapidjson::Value& json, const uint64_t*, Plain) {
+  return json.IsUint64();
+}
+
+inline bool CheckJson(const rapidjson::Value& json, const double*, Plain) {
+  return json.IsNumber();
+}
+
+inline bool CheckJson(const rapidjson::Value& json, const bool*, Plain) {
+  return json.IsBool();
+}
+
+template <typename E>
+typename std::enable_if<std::is_enum<E>::value, bool>::type
+CheckJson(const rapidjson::Value& json, const E*, Plain) {
+  return json.IsInt();
+}
+
+template <typename T>
+auto CheckJson(const rapidjson::Value& json, const T*, Plain)
+    -> decltype(FieldTable<T>::Get(), bool()) {
+  return json.IsObject();
+}
+
+template <typename V>
+bool CheckJson(const rapidjson::Value& json, const std::vector<V>*, Plain) {
+  return json.IsArray();
+}
+
+template <typename V>
+bool CheckJson(const rapidjson::Value& json,
+               const std::map<std::string, V>*,
+               Plain) {
+  return json.IsObject();
+}
+
+inline bool CheckJson(const rapidjson::Value& json, const uint64_t*, AsUint) {
+  return json.IsUint();
+}
+
+bool CheckJson(const rapidjson::Value& json,
+               const std::vector<uint8_t>*,
+               Base64);
+
+template <typename V>
+bool CheckJson(const rapidjson::Value& json,
+               const std::map<std::string, V>*,
+               KeyedArray) {
+  return json.IsArray();
+}
+
+// Value readers, called with values that passed CheckJson
+
+inline void ReadJson(const rapidjson::Value& json,
+                     std::string* value,
+                     Plain) {
+  *value = json.GetString();
+}
+
+inline void ReadJson(const rapidjson::Value& json,
+                     unsigned int* value,
+                     Plain) {
+  *value = json.GetUint();
+}
+
+inline void ReadJson(const rapidjson::Value& json, int* value, Plain) {
+  *value = json.GetInt();
+}
+
+inline void ReadJson(const rapidjson::Value& json, uint64_t* value, Plain) {
+  *value = json.GetUint64();
+}
+
+inline void ReadJson(const rapidjson::Value& json, double* value, Plain) {
+  *value = json.GetDouble();
+}
+
+inline void ReadJson(const rapidjson::Value& json, bool* value, Plain) {
+  *value = json.GetBool();
+}
+
+template <typename E>
+typename std::enable_if<std::is_enum<E>::value>::type
+ReadJson(const rapidjson::Value& json, E* value, Plain) {
+  *value = static_cast<E>(json.GetInt());
+}
+
+template <typename T>
+auto ReadJson(const rapidjson::Value& json, T* value, Plain)
+    -> decltype(FieldTable<T>::Get(), void()) {
+  ReadObject(json, value);
+}
+
+template <typename V>
+void ReadJson(const rapidjson::Value& json, std::vector<V>* value, Plain) {
+  value->clear();
+  value->reserve(json.Size());
+  for (const auto& item : json.GetArray()) {
+    value->emplace_back();
+    if (CheckJson(item, &value->back(), Plain())) {
+      ReadJson(item, &value->back(), Plain());
+    }
+  }
+}
+
+template <typename V>
+void ReadJson(const rapidjson::Value& json,
+              std::map<std::string, V>* value,
+              Plain) {
+  value->clear();
+  for (const auto& item : json.GetObject()) {
+    V entry;
+    if (CheckJson(item.value, &entry, Plain())) {
+      ReadJson(item.value, &entry, Plain());
+    }
+    value->insert(std::make_pair(item.name.GetString(), entry));
+  }
+}
+
+inline void ReadJson(const rapidjson::Value& json, uint64_t* value, AsUint) {
+  *value = json.GetUint();
+}
+
+void ReadJson(const rapidjson::Value& json,
+              std::vector<uint8_t>* value,
+              Base64);
+
+template <typename V>
+void ReadJson(const rapidjson::Value& json,
+              std::map<std::string, V>* value,
+              KeyedArray) {
+  value->clear();
+  for (const auto& item : json.GetArray()) {
+    if (!item.IsObject() || item.MemberCount() == 0) {
+      continue;
+    }
+
+    const auto& first = *item.MemberBegin();
+    V entry;
+    if (CheckJson(first.value, &entry, Plain())) {
+      ReadJson(first.value, &entry, Plain());
+    }
+    value->insert(std::make_pair(first.name.GetString(), entry));
+  }
+}
+
+template <typename T>
+void WriteObject(JsonWriter& writer, const T& value) {
+  writer.StartObject();
+  VisitFields<T>([&writer, &value](const auto& field, size_t) {
+    typedef typename std::decay<decltype(field)>::type::CodecType Codec;
+    writer.String(field.name,
+                  static_cast<rapidjson::SizeType>(field.name_length));
+    WriteJson(writer, field.access.Get(value), Codec());
+  });
+  writer.EndObject();
+}
+
+// Every member of |json| is looked up once in the index of T. Nothing is
+// assigned unless all the required fields are there with the right type,
+// a failed load leaves |value| as it was.
+template <typename T>
+bool ReadObject(const rapidjson::Value& json, T* value) {
+  if (!json.IsObject()) {
+    return false;
+  }
+
+  const FieldIndex& index = FieldIndex::Get<T>();
+  const rapidjson::Value* found[FieldCount<T>()] = {};
+  for (auto it = json.MemberBegin(); it != json.MemberEnd(); ++it) {
+    int field = index.Find(it->name.GetString(), it->name.GetStringLength());
+    // the first of duplicated keys wins, as with operator[]
+    if (field >= 0 && !found[field]) {
+      found[field] = &it->value;
+    }
+  }
+
+  bool valid = true;
+  VisitFields<T>([&found, &valid, value](const auto& field, size_t i) {
+    typedef typename std::decay<decltype(field)>::type::CodecType Codec;
+    if (found[i] && !CheckJson(*found[i], &field.access.Get(value), Codec())) {
+      found[i] = nullptr;
+    }
+    if (!found[i] && field.presence == Presence::REQUIRED) {
+      valid = false;
+    }
+  });
+  if (!valid) {
+    return false;
+  }
+
+  VisitFields<T>([&found, value](const auto& field, size_t i) {
+    typedef typename std::decay<decltype(field)>::type::CodecType Codec;
+    if (found[i]) {
+      ReadJson(*found[i], &field.access.Get(value), Codec());
+    }
+  });
+  return true;
+}
+
+template <typename T>
+bool LoadFromJsonString(const std::string& json, T* value) {
+  rapidjson::Document document;
+  document.Parse(json.c_str());
+  if (document.HasParseError()) {
+    return false;
+  }
+
+  return ReadObject(document, value);
+}
+
+}  // namespace braveledger_bat_helper
+
+#endif  // BRAVELEDGER_BAT_FIELDS_H_
@@ -5,11 +5,11 @@
 
 #include "bat_get_media.h"
 
-#include <sstream>
 #include <cmath>
 
 #include "bat_get_media.h"
 #include "bat_helper.h"
+#include "bat_media_classifier.h"
 #include "ledger_impl.h"
 #include "rapidjson_bat_helper.h"
 #include "static_values.h"
@@ -24,33 +24,20 @@ void onVisitSavedDummy(ledger::Result result,
 }
 
 BatGetMedia::BatGetMedia(bat_ledger::LedgerImpl* ledger):
-  ledger_(ledger) {
+  ledger_(ledger),
+  handler_(ledger->GetURLRequestScheduler(),
+           bat_ledger::URLRequestPriority::PANEL),
+  twitch_sessions_(TWITCH_MAXIMUM_SESSIONS,
+                   braveledger_ledger::_twitch_session_idle_timeout) {
 }
 
 BatGetMedia::~BatGetMedia() {}
 
 std::string BatGetMedia::GetLinkType(const std::string& url, const std::string& first_party_url,
   const std::string& referrer) {
-  std::string type = "";
-
-  if (url.find("https://m.youtube.com/api/stats/watchtime?") != std::string::npos
-      || url.find("https://www.youtube.com/api/stats/watchtime?") != std::string::npos) {
-    type = YOUTUBE_MEDIA_TYPE;
-  }  else if (
-    (
-      (first_party_url.find("https://www.twitch.tv/") == 0 ||
-        first_party_url.find("https://m.twitch.tv/") == 0) ||
-      (referrer.find("https://player.twitch.tv/") == 0)
-    ) &&
-    (
-      url.find(".ttvnw.net/v1/segment/") != std::string::npos ||
-      url.find("https://ttvnw.net/v1/segment/") != std::string::npos
-    )
-  ) {
-    type = TWITCH_MEDIA_TYPE;
-  }
-
-  return type;
+  return MediaClassifier::GetInstance().GetLinkType(url,
+                                                    first_party_url,
+                                                    referrer);
 }
 
 void BatGetMedia::processMedia(const std::map<std::string, std::string>& parts, const std::string& type,
@@ -66,17 +53,17 @@ void BatGetMedia::processMedia(const std::map<std::string, std::string>& parts,
   std::string media_key = braveledger_bat_helper::getMediaKey(mediaId, type);
   BLOG(ledger_, ledger::LogLevel::LOG_DEBUG) << "Media key: " << media_key;
   uint64_t duration = 0;
-  ledger::TwitchEventInfo twitchEventInfo;
+  TwitchEventState twitchEventInfo;
   if (type == YOUTUBE_MEDIA_TYPE) {
     duration = braveledger_bat_helper::getMediaDuration(parts, media_key, type);
   } else if (type == TWITCH_MEDIA_TYPE) {
     std::map<std::string, std::string>::const_iterator iter = parts.find("event");
     if (iter != parts.end()) {
-      twitchEventInfo.event_ = iter->second;
+      twitchEventInfo.event_ = GetTwitchEvent(iter->second);
     }
     iter = parts.find("time");
     if (iter != parts.end()) {
-      twitchEventInfo.time_ = iter->second;
+      twitchEventInfo.time_ = GetTwitchTime(iter->second);
     }
   }
   BLOG(ledger_, ledger::LogLevel::LOG_DEBUG) << "Media duration: " << duration;
@@ -99,7 +86,7 @@ void BatGetMedia::getPublisherInfoDataCallback(const std::string& mediaId,
     const std::string& media_key,
     const std::string& providerName,
     const uint64_t& duration,
-    const ledger::TwitchEventInfo& twitchEventInfo,
+    const TwitchEventState& twitchEventInfo,
     const ledger::VisitData& visit_data,
     const uint64_t window_id,
     ledger::Result result,
@@ -132,17 +119,7 @@ void BatGetMedia::getPublisherInfoDataCallback(const std::string& mediaId,
         return;
       }
 
-      ledger::TwitchEventInfo oldEvent;
-      std::map<std::string, ledger::TwitchEventInfo>::const_iterator iter = twitchEvents.find(media_key);
-      if (iter != twitchEvents.end()) {
-        oldEvent = iter->second;
-      }
-
-      ledger::TwitchEventInfo newEvent(twitchEventInfo);
-      newEvent.status_ = getTwitchStatus(oldEvent, newEvent);
-
-      uint64_t realDuration = getTwitchDuration(oldEvent, newEvent);
-      twitchEvents[media_key] = newEvent;
+      uint64_t realDuration = updateTwitchSession(media_key, twitchEventInfo);
 
       if (realDuration == 0) {
         return;
@@ -205,17 +182,7 @@ void BatGetMedia::getPublisherInfoDataCallback(const std::string& mediaId,
       updated_visit_data.provider = TWITCH_MEDIA_TYPE;
       updated_visit_data.favicon_url = publisher_info->favicon_url;
 
-      ledger::TwitchEventInfo oldEvent;
-      std::map<std::string, ledger::TwitchEventInfo>::const_iterator iter = twitchEvents.find(media_key);
-      if (iter != twitchEvents.end()) {
-        oldEvent = iter->second;
-      }
-
-      ledger::TwitchEventInfo newEvent(twitchEventInfo);
-      newEvent.status_ = getTwitchStatus(oldEvent, newEvent);
-
-      uint64_t realDuration = getTwitchDuration(oldEvent, newEvent);
-      twitchEvents[media_key] = newEvent;
+      uint64_t realDuration = updateTwitchSession(media_key, twitchEventInfo);
 
       std::string id = publisher_info->id;
       ledger_->SaveMediaVisit(id, updated_visit_data, realDuration, window_id);
@@ -223,72 +190,83 @@ void BatGetMedia::getPublisherInfoDataCallback(const std::string& mediaId,
   }
 }
 
-std::string BatGetMedia::getTwitchStatus(const ledger::TwitchEventInfo& oldEventInfo, const ledger::TwitchEventInfo& newEventInfo) {
-  std::string status = "playing";
+uint64_t BatGetMedia::updateTwitchSession(
+    const std::string& media_key,
+    const TwitchEventState& twitchEventInfo) {
+  uint64_t now = braveledger_bat_helper::currentTime();
+  TwitchEventState oldEvent = twitch_sessions_.Get(media_key, now);
+
+  TwitchEventState newEvent(twitchEventInfo);
+  newEvent.status_ = getTwitchStatus(oldEvent, newEvent);
+
+  uint64_t realDuration = getTwitchDuration(oldEvent, newEvent);
+  twitch_sessions_.Set(media_key, newEvent, now);
+
+  return realDuration;
+}
+
+TwitchStatus BatGetMedia::getTwitchStatus(const TwitchEventState& oldEventInfo, const TwitchEventState& newEventInfo) {
+  TwitchStatus status = TwitchStatus::PLAYING;
 
   if (
     (
-      newEventInfo.event_ == "video_pause" &&
-      oldEventInfo.event_ != "video_pause"
+      newEventInfo.event_ == TwitchEvent::VIDEO_PAUSE &&
+      oldEventInfo.event_ != TwitchEvent::VIDEO_PAUSE
     ) ||  // User clicked pause (we need to exclude seeking while paused)
     (
-      newEventInfo.event_ == "video_pause" &&
-      oldEventInfo.event_ == "video_pause" &&
-      oldEventInfo.status_ == "playing"
+      newEventInfo.event_ == TwitchEvent::VIDEO_PAUSE &&
+      oldEventInfo.event_ == TwitchEvent::VIDEO_PAUSE &&
+      oldEventInfo.status_ == TwitchStatus::PLAYING
     ) ||  // User clicked pause as soon as he clicked play
     (
-      newEventInfo.event_ == "player_click_vod_seek" &&
-      oldEventInfo.status_ == "paused"
+      newEventInfo.event_ == TwitchEvent::PLAYER_CLICK_VOD_SEEK &&
+      oldEventInfo.status_ == TwitchStatus::PAUSED
     )  // Seeking a video while it is paused
   ) {
-    status = "paused";
+    status = TwitchStatus::PAUSED;
   }
 
   // User pauses a video, then seeks it and plays it again
-  if (newEventInfo.event_ == "video_pause" &&
-      oldEventInfo.event_ == "player_click_vod_seek" &&
-      oldEventInfo.status_ == "paused") {
-    status = "playing";
+  if (newEventInfo.event_ == TwitchEvent::VIDEO_PAUSE &&
+      oldEventInfo.event_ == TwitchEvent::PLAYER_CLICK_VOD_SEEK &&
+      oldEventInfo.status_ == TwitchStatus::PAUSED) {
+    status = TwitchStatus::PLAYING;
   }
 
   return status;
 }
 
-uint64_t BatGetMedia::getTwitchDuration(const ledger::TwitchEventInfo& oldEventInfo, const ledger::TwitchEventInfo& newEventInfo) {
+uint64_t BatGetMedia::getTwitchDuration(const TwitchEventState& oldEventInfo, const TwitchEventState& newEventInfo) {
   // Remove duplicated events
   if (oldEventInfo.event_ == newEventInfo.event_ &&
       oldEventInfo.time_ == newEventInfo.time_) {
     return 0;
   }
 
-  if (newEventInfo.event_ == "video-play") {  // Start event
+  if (newEventInfo.event_ == TwitchEvent::VIDEO_PLAY) {  // Start event
     return TWITCH_MINIMUM_SECONDS;
   }
 
-  // TODO: check if converted properly
   double time = 0;
-  std::stringstream tempTime(newEventInfo.time_);
-  double currentTime = 0;
-  tempTime >> currentTime;
-  std::stringstream tempOld(oldEventInfo.time_);
-  double oldTime = 0;
-  tempOld >> oldTime;
-
-  if (oldEventInfo.event_ == "video-play") {
+  double currentTime = newEventInfo.time_;
+  double oldTime = oldEventInfo.time_;
+
+  if (oldEventInfo.event_ == TwitchEvent::VIDEO_PLAY) {
     time = currentTime - oldTime - TWITCH_MINIMUM_SECONDS;
-  } else if (newEventInfo.event_ == "minute-watched" ||  // Minute watched
-      newEventInfo.event_ == "buffer-empty" ||  // Run out of buffer
-      newEventInfo.event_ == "video_error" ||  // Video has some problems
-      newEventInfo.event_ == "video_end" ||  // Video ended
-      (newEventInfo.event_ == "player_click_vod_seek" && oldEventInfo.status_ == "paused") ||  // Vod seek
+  } else if (newEventInfo.event_ == TwitchEvent::MINUTE_WATCHED ||  // Minute watched
+      newEventInfo.event_ == TwitchEvent::BUFFER_EMPTY ||  // Run out of buffer
+      newEventInfo.event_ == TwitchEvent::VIDEO_ERROR ||  // Video has some problems
+      newEventInfo.event_ == TwitchEvent::VIDEO_END ||  // Video ended
+      (newEventInfo.event_ == TwitchEvent::PLAYER_CLICK_VOD_SEEK &&
+        oldEventInfo.status_ == TwitchStatus::PAUSED) ||  // Vod seek
       (
-        newEventInfo.event_ == "video_pause" &&
+        newEventInfo.event_ == TwitchEvent::VIDEO_PAUSE &&
         (
           (
-            oldEventInfo.event_ != "video_pause" &&
-            oldEventInfo.event_ != "player_click_vod_seek"
+            oldEventInfo.event_ != TwitchEvent::VIDEO_PAUSE &&
+            oldEventInfo.event_ != TwitchEvent::PLAYER_CLICK_VOD_SEEK
           ) ||
-          oldEventInfo.status_ == "playing"
+          oldEventInfo.status_ == TwitchStatus::PLAYING
         )
       )  // User paused video
     ) {
@@ -299,7 +277,7 @@ uint64_t BatGetMedia::getTwitchDuration(const ledger::TwitchEventInfo& oldEventI
     return 0;
   }
 
-  if (oldEventInfo.status_.empty()) { // if autoplay is off and play is pressed
+  if (oldEventInfo.status_ == TwitchStatus::NONE) { // if autoplay is off and play is pressed
     return 0;
   }
 
@@ -766,7 +744,7 @@ void BatGetMedia::onMediaPublisherActivity(ledger::Result result,
   }
 
   if (result == ledger::Result::NOT_FOUND) {
-    ledger::TwitchEventInfo twitchEventInfo;
+    TwitchEventState twitchEventInfo;
     getPublisherInfoDataCallback(media_id,
                                  media_key,
                                  providerType,
@@ -11,6 +11,7 @@
 
 #include "bat/ledger/ledger.h"
 #include "bat_helper.h"
+#include "bat_twitch_sessions.h"
 #include "url_request_handler.h"
 
 namespace bat_ledger {
@@ -78,8 +79,8 @@ class BatGetMedia {
                          const std::string& favIconURL,
                          const std::string& channelId);
 
-  uint64_t getTwitchDuration(const ledger::TwitchEventInfo& oldEventInfo,
-                             const ledger::TwitchEventInfo& newEventInfo);
+  uint64_t getTwitchDuration(const TwitchEventState& oldEventInfo,
+                             const TwitchEventState& newEventInfo);
 
   void onFetchFavIcon(const std::string& publisher_key,
                       bool success,
@@ -89,14 +90,17 @@ class BatGetMedia {
                            std::unique_ptr<ledger::PublisherInfo> info,
                            const std::string& favicon_url);
 
-  std::string getTwitchStatus(const ledger::TwitchEventInfo& oldEventInfo,
-                              const ledger::TwitchEventInfo& newEventInfo);
+  TwitchStatus getTwitchStatus(const TwitchEventState& oldEventInfo,
+                               const TwitchEventState& newEventInfo);
+
+  uint64_t updateTwitchSession(const std::string& media_key,
+                               const TwitchEventState& twitchEventInfo);
 
   void getPublisherInfoDataCallback(const std::string& mediaId,
                                     const std::string& media_key,
                                     const std::string& providerName,
                                     const uint64_t& duration,
-                                    const ledger::TwitchEventInfo& twitchEventInfo,
+                                    const TwitchEventState& twitchEventInfo,
                                     const ledger::VisitData& visit_data,
                                     const uint64_t window_id,
                                     ledger::Result result,
@@ -206,7 +210,7 @@ class BatGetMedia {
 
   bat_ledger::URLRequestHandler handler_;
 
-  std::map<std::string, ledger::TwitchEventInfo> twitchEvents;
+  TwitchSessionTable twitch_sessions_;
 };
 
 }  // namespace braveledger_bat_get_media
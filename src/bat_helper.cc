@@ -4,8 +4,12 @@
 
 #include "bat_helper.h"
 
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <locale>
 #include <sstream>
-#include <random>
 #include <utility>
 #include <iomanip>
 #include <ctime>
@@ -14,12 +18,14 @@
 #include <string>
 #include <regex>
 
-#include <openssl/base64.h>
 #include <openssl/digest.h>
 #include <openssl/hkdf.h>
 #include <openssl/sha.h>
 
 #include "bat/ledger/ledger.h"
+#include "bat_codec.h"
+#include "bat_helper_fields.h"
+#include "random_service.h"
 #include "rapidjson_bat_helper.h"
 #include "static_values.h"
 #include "tweetnacl.h"
@@ -67,68 +73,12 @@ static bool ignore_ = false;
   WALLET_INFO_ST::~WALLET_INFO_ST() {}
 
 
-  bool WALLET_INFO_ST::loadFromJson(const std::string & json) {
-    rapidjson::Document d;
-    d.Parse(json.c_str());
-
-    //has parser errors or wrong types
-    bool error = d.HasParseError();
-    if (false == error) {
-      error = !( d.HasMember("paymentId") && d["paymentId"].IsString() &&
-        d.HasMember("addressBAT") && d["addressBAT"].IsString() &&
-        d.HasMember("addressBTC") && d["addressBTC"].IsString() &&
-        d.HasMember("addressCARD_ID") && d["addressCARD_ID"].IsString() &&
-        d.HasMember("addressETH") && d["addressETH"].IsString() &&
-        d.HasMember("addressLTC") && d["addressLTC"].IsString() &&
-        d.HasMember("keyInfoSeed") && d["keyInfoSeed"].IsString() );
-    }
-
-    if (false == error) {
-      //convert keyInfoSeed and check error
-      std::string sKeyInfoSeed = d["keyInfoSeed"].GetString();
-      error = !getFromBase64(sKeyInfoSeed, keyInfoSeed_);
-    }
-
-    if (false == error) {
-      paymentId_ = d["paymentId"].GetString();
-      addressBAT_ = d["addressBAT"].GetString();
-      addressBTC_ = d["addressBTC"].GetString();
-      addressCARD_ID_ = d["addressCARD_ID"].GetString();
-      addressETH_ = d["addressETH"].GetString();
-      addressLTC_ = d["addressLTC"].GetString();
-    }
-    return !error;
+  bool WALLET_INFO_ST::loadFromJson(const std::string& json) {
+    return LoadFromJsonString(json, this);
   }
 
-  void saveToJson(JsonWriter & writer, const WALLET_INFO_ST& data) {
-    writer.StartObject();
-
-    writer.String("paymentId");
-    writer.String(data.paymentId_.c_str());
-
-    writer.String("addressBAT");
-    writer.String(data.addressBAT_.c_str());
-
-    writer.String("addressBTC");
-    writer.String(data.addressBTC_.c_str());
-
-    writer.String("addressCARD_ID");
-    writer.String(data.addressCARD_ID_.c_str());
-
-    writer.String("addressETH");
-    writer.String(data.addressETH_.c_str());
-
-    writer.String("addressLTC");
-    writer.String(data.addressLTC_.c_str());
-
-    writer.String("keyInfoSeed");
-    if (data.keyInfoSeed_.size() == 0) {
-      writer.String("");
-    } else {
-      writer.String(getBase64(data.keyInfoSeed_).c_str());
-    }
-
-    writer.EndObject();
+  void saveToJson(JsonWriter& writer, const WALLET_INFO_ST& data) {
+    WriteObject(writer, data);
   }
 
   /////////////////////////////////////////////////////////////////////////////
@@ -142,35 +92,12 @@ static bool ignore_ = false;
 
   TRANSACTION_BALLOT_ST::~TRANSACTION_BALLOT_ST() {}
 
-  bool TRANSACTION_BALLOT_ST::loadFromJson(const std::string & json) {
-    rapidjson::Document d;
-    d.Parse(json.c_str());
-
-    //has parser errors or wrong types
-    bool error = d.HasParseError();
-    if (false == error) {
-      error = !(d.HasMember("publisher") && d["publisher"].IsString() &&
-        d.HasMember("offset") && d["offset"].IsUint() );
-    }
-
-    if (false == error) {
-      publisher_ = d["publisher"].GetString();
-      offset_ = d["offset"].GetUint();
-    }
-
-    return !error;
+  bool TRANSACTION_BALLOT_ST::loadFromJson(const std::string& json) {
+    return LoadFromJsonString(json, this);
   }
 
-  void saveToJson(JsonWriter & writer, const TRANSACTION_BALLOT_ST& data) {
-    writer.StartObject();
-
-    writer.String("publisher");
-    writer.String(data.publisher_.c_str());
-
-    writer.String("offset");
-    writer.Uint(data.offset_);
-
-    writer.EndObject();
+  void saveToJson(JsonWriter& writer, const TRANSACTION_BALLOT_ST& data) {
+    WriteObject(writer, data);
   }
 
   /////////////////////////////////////////////////////////////////////////////
@@ -199,139 +126,13 @@ static bool ignore_ = false;
 
   TRANSACTION_ST::~TRANSACTION_ST() {}
 
-  bool TRANSACTION_ST::loadFromJson(const std::string & json) {
-    rapidjson::Document d;
-    d.Parse(json.c_str());
-
-    //has parser errors or wrong types
-    bool error = d.HasParseError();
-    if (false == error) {
-      error = !(d.HasMember("viewingId") && d["viewingId"].IsString() &&
-        d.HasMember("surveyorId") && d["surveyorId"].IsString() &&
-        d.HasMember("contribution_fiat_amount") && d["contribution_fiat_amount"].IsString() &&
-        d.HasMember("contribution_fiat_currency") && d["contribution_fiat_currency"].IsString() &&
-        d.HasMember("rates") && d["rates"].IsObject() &&
-        d["rates"].HasMember("ETH") &&
-        d["rates"].HasMember("LTC") &&
-        d["rates"].HasMember("BTC") &&
-        d["rates"].HasMember("USD") &&
-        d["rates"].HasMember("EUR") &&
-        d.HasMember("contribution_altcurrency") && d["contribution_altcurrency"].IsString() &&
-        d.HasMember("contribution_probi") && d["contribution_probi"].IsString() &&
-        d.HasMember("contribution_fee") && d["contribution_fee"].IsString() &&
-        d.HasMember("submissionStamp") && d["submissionStamp"].IsString() &&
-        d.HasMember("submissionId") && d["submissionId"].IsString() &&
-        d.HasMember("anonizeViewingId") && d["anonizeViewingId"].IsString() &&
-        d.HasMember("registrarVK") && d["registrarVK"].IsString() &&
-        d.HasMember("masterUserToken") && d["masterUserToken"].IsString() &&
-        d.HasMember("surveyorIds") && d["surveyorIds"].IsArray() &&
-        d.HasMember("votes") && d["votes"].IsUint() &&
-        d.HasMember("ballots") && d["ballots"].IsArray());
-    }
-
-    if (false == error) {
-      viewingId_ = d["viewingId"].GetString();
-      surveyorId_ = d["surveyorId"].GetString();
-      contribution_fiat_amount_ = d["contribution_fiat_amount"].GetString();
-      contribution_fiat_currency_ = d["contribution_fiat_currency"].GetString();
-      contribution_altcurrency_ = d["contribution_altcurrency"].GetString();
-      contribution_probi_ = d["contribution_probi"].GetString();
-      contribution_fee_ = d["contribution_fee"].GetString();
-      submissionStamp_ = d["submissionStamp"].GetString();
-      submissionId_ = d["submissionId"].GetString();
-      anonizeViewingId_ = d["anonizeViewingId"].GetString();
-      registrarVK_ = d["registrarVK"].GetString();
-      masterUserToken_ = d["masterUserToken"].GetString();
-      votes_ = d["votes"].GetUint();
-
-      for ( auto & i : d["rates"].GetObject()) {
-        contribution_rates_.insert(std::make_pair(i.name.GetString(), i.value.GetDouble() ));
-      }
-
-      for (auto & i : d["surveyorIds"].GetArray()) {
-        surveyorIds_.push_back(i.GetString());
-      }
-
-      for (const auto & i : d["ballots"].GetArray() ) {
-        rapidjson::StringBuffer sb;
-        rapidjson::Writer<rapidjson::StringBuffer> writer(sb);
-        i.Accept(writer);
-
-        TRANSACTION_BALLOT_ST ballot;
-        ballot.loadFromJson(sb.GetString());
-        ballots_.push_back(ballot);
-      }
-    }
-
-    return !error;
+  bool TRANSACTION_ST::loadFromJson(const std::string& json) {
+    return LoadFromJsonString(json, this);
   }
 
 
-  void saveToJson(JsonWriter & writer, const TRANSACTION_ST& data) {
-    writer.StartObject();
-
-    writer.String("viewingId");
-    writer.String(data.viewingId_.c_str());
-
-    writer.String("surveyorId");
-    writer.String(data.surveyorId_.c_str());
-
-    writer.String("contribution_fiat_amount");
-    writer.String(data.contribution_fiat_amount_.c_str());
-
-    writer.String("contribution_fiat_currency");
-    writer.String(data.contribution_fiat_currency_.c_str());
-
-    writer.String("rates");
-    writer.StartObject();
-    for (auto & p : data.contribution_rates_) {
-      writer.String(p.first.c_str());
-      writer.Double(p.second);
-    }
-    writer.EndObject();
-
-    writer.String("contribution_altcurrency");
-    writer.String(data.contribution_altcurrency_.c_str());
-
-    writer.String("contribution_probi");
-    writer.String(data.contribution_probi_.c_str());
-
-    writer.String("contribution_fee");
-    writer.String(data.contribution_fee_.c_str());
-
-    writer.String("submissionStamp");
-    writer.String(data.submissionStamp_.c_str());
-
-    writer.String("submissionId");
-    writer.String(data.submissionId_.c_str());
-
-    writer.String("anonizeViewingId");
-    writer.String(data.anonizeViewingId_.c_str());
-
-    writer.String("registrarVK");
-    writer.String(data.registrarVK_.c_str());
-
-    writer.String("masterUserToken");
-    writer.String(data.masterUserToken_.c_str());
-
-    writer.String("surveyorIds");
-    writer.StartArray();
-    for (auto & i : data.surveyorIds_) {
-      writer.String(i.c_str());
-    }
-    writer.EndArray();
-
-    writer.String("votes");
-    writer.Uint(data.votes_);
-
-    writer.String("ballots");
-    writer.StartArray();
-    for (auto & i : data.ballots_) {
-      saveToJson(writer, i);
-    }
-    writer.EndArray();
-
-    writer.EndObject();
+  void saveToJson(JsonWriter& writer, const TRANSACTION_ST& data) {
+    WriteObject(writer, data);
   }
 
   /////////////////////////////////////////////////////////////////////////////
@@ -351,55 +152,12 @@ static bool ignore_ = false;
 
   BALLOT_ST::~BALLOT_ST() {}
 
-  bool BALLOT_ST::loadFromJson(const std::string & json) {
-    rapidjson::Document d;
-    d.Parse(json.c_str());
-
-    //has parser errors or wrong types
-    bool error = d.HasParseError();
-    if (false == error) {
-      error = !(d.HasMember("viewingId") &&  d["viewingId"].IsString() &&
-        d.HasMember("surveyorId") && d["surveyorId"].IsString() &&
-        d.HasMember("publisher") && d["publisher"].IsString() &&
-        d.HasMember("offset") && d["offset"].IsUint() &&
-        d.HasMember("prepareBallot") && d["prepareBallot"].IsString() &&
-        d.HasMember("delayStamp") && d["delayStamp"].IsUint64() );
-    }
-
-    if (false == error) {
-      viewingId_ = d["viewingId"].GetString();
-      surveyorId_ = d["surveyorId"].GetString();
-      publisher_ = d["publisher"].GetString();
-      offset_ = d["offset"].GetUint();
-      prepareBallot_ = d["prepareBallot"].GetString();
-      delayStamp_ = d["delayStamp"].GetUint64();
-    }
-
-    return !error;
+  bool BALLOT_ST::loadFromJson(const std::string& json) {
+    return LoadFromJsonString(json, this);
   }
 
-  void saveToJson(JsonWriter & writer, const BALLOT_ST& data) {
-    writer.StartObject();
-
-    writer.String("viewingId");
-    writer.String(data.viewingId_.c_str());
-
-    writer.String("surveyorId");
-    writer.String(data.surveyorId_.c_str());
-
-    writer.String("publisher");
-    writer.String(data.publisher_.c_str());
-
-    writer.String("offset");
-    writer.Uint(data.offset_);
-
-    writer.String("prepareBallot");
-    writer.String(data.prepareBallot_.c_str());
-
-    writer.String("delayStamp");
-    writer.Uint64(data.delayStamp_);
-
-    writer.EndObject();
+  void saveToJson(JsonWriter& writer, const BALLOT_ST& data) {
+    WriteObject(writer, data);
   }
 
   /////////////////////////////////////////////////////////////////////////////
@@ -412,35 +170,12 @@ static bool ignore_ = false;
 
   BATCH_VOTES_INFO_ST::~BATCH_VOTES_INFO_ST() {}
 
-  bool BATCH_VOTES_INFO_ST::loadFromJson(const std::string & json) {
-    rapidjson::Document d;
-    d.Parse(json.c_str());
-
-    // Has parser errors or wrong types
-    bool error = d.HasParseError();
-    if (false == error) {
-      error = !(d.HasMember("surveyorId") && d["surveyorId"].IsString() &&
-        d.HasMember("proof") && d["proof"].IsString());
-    }
-
-    if (false == error) {
-      surveyorId_ = d["surveyorId"].GetString();
-      proof_ = d["proof"].GetString();
-    }
-
-    return !error;
+  bool BATCH_VOTES_INFO_ST::loadFromJson(const std::string& json) {
+    return LoadFromJsonString(json, this);
   }
 
-  void saveToJson(JsonWriter & writer, const BATCH_VOTES_INFO_ST& data) {
-    writer.StartObject();
-
-    writer.String("surveyorId");
-    writer.String(data.surveyorId_.c_str());
-
-    writer.String("proof");
-    writer.String(data.proof_.c_str());
-
-    writer.EndObject();
+  void saveToJson(JsonWriter& writer, const BATCH_VOTES_INFO_ST& data) {
+    WriteObject(writer, data);
   }
 
   /////////////////////////////////////////////////////////////////////////////
@@ -448,52 +183,18 @@ static bool ignore_ = false;
 
   BATCH_VOTES_ST::BATCH_VOTES_ST(const BATCH_VOTES_ST& other) {
     publisher_ = other.publisher_;
+    viewingId_ = other.viewingId_;
     batchVotesInfo_ = other.batchVotesInfo_;
   }
 
   BATCH_VOTES_ST::~BATCH_VOTES_ST() {}
 
-  bool BATCH_VOTES_ST::loadFromJson(const std::string & json) {
-    rapidjson::Document d;
-    d.Parse(json.c_str());
-
-    // Has parser errors or wrong types
-    bool error = d.HasParseError();
-    if (false == error) {
-      error = !(d.HasMember("publisher") &&  d["publisher"].IsString() &&
-        d.HasMember("batchVotesInfo") && d["batchVotesInfo"].IsArray());
-    }
-
-    if (false == error) {
-      publisher_ = d["publisher"].GetString();
-      for (const auto & i : d["batchVotesInfo"].GetArray()) {
-        rapidjson::StringBuffer sb;
-        rapidjson::Writer<rapidjson::StringBuffer> writer(sb);
-        i.Accept(writer);
-
-        BATCH_VOTES_INFO_ST b;
-        b.loadFromJson(sb.GetString());
-        batchVotesInfo_.push_back(b);
-      }
-    }
-
-    return !error;
+  bool BATCH_VOTES_ST::loadFromJson(const std::string& json) {
+    return LoadFromJsonString(json, this);
   }
 
-  void saveToJson(JsonWriter & writer, const BATCH_VOTES_ST& data) {
-    writer.StartObject();
-
-    writer.String("publisher");
-    writer.String(data.publisher_.c_str());
-
-    writer.String("batchVotesInfo");
-    writer.StartArray();
-    for (auto & b : data.batchVotesInfo_) {
-      saveToJson(writer, b);
-    }
-    writer.EndArray();
-
-    writer.EndObject();
+  void saveToJson(JsonWriter& writer, const BATCH_VOTES_ST& data) {
+    WriteObject(writer, data);
   }
 
   /////////////////////////////////////////////////////////////////////////////
@@ -523,77 +224,11 @@ static bool ignore_ = false;
   REPORT_BALANCE_ST::~REPORT_BALANCE_ST() {}
 
   bool REPORT_BALANCE_ST::loadFromJson(const std::string& json) {
-    rapidjson::Document d;
-    d.Parse(json.c_str());
-
-    bool error = d.HasParseError();
-    if (false == error) {
-      error = !(d.HasMember("opening_balance") && d["opening_balance"].IsString() && isProbiValid(d["opening_balance"].GetString()) &&
-        d.HasMember("closing_balance") && d["closing_balance"].IsString() && isProbiValid(d["closing_balance"].GetString()) &&
-        d.HasMember("deposits") && d["deposits"].IsString() && isProbiValid(d["deposits"].GetString()) &&
-        d.HasMember("grants") && d["grants"].IsString() && isProbiValid(d["grants"].GetString()) &&
-        d.HasMember("earning_from_ads") && d["earning_from_ads"].IsString() && isProbiValid(d["earning_from_ads"].GetString()) &&
-        d.HasMember("auto_contribute") && d["auto_contribute"].IsString() && isProbiValid(d["auto_contribute"].GetString()) &&
-        d.HasMember("recurring_donation") && d["recurring_donation"].IsString() && isProbiValid(d["recurring_donation"].GetString()) &&
-        d.HasMember("one_time_donation") && d["one_time_donation"].IsString() && isProbiValid(d["one_time_donation"].GetString()) &&
-        d.HasMember("total") && d["total"].IsString() && isProbiValid(d["total"].GetString()));
-    }
-
-    if (false == error) {
-      opening_balance_ = d["opening_balance"].GetString();
-      closing_balance_ = d["closing_balance"].GetString();
-      deposits_ = d["deposits"].GetString();
-      grants_ = d["grants"].GetString();
-      earning_from_ads_ = d["earning_from_ads"].GetString();
-      auto_contribute_ = d["auto_contribute"].GetString();
-      recurring_donation_ = d["recurring_donation"].GetString();
-      one_time_donation_ = d["one_time_donation"].GetString();
-      total_ = d["total"].GetString();
-    }
-
-    return !error;
+    return LoadFromJsonString(json, this);
   }
 
   void saveToJson(JsonWriter& writer, const REPORT_BALANCE_ST& data) {
-    writer.StartObject();
-
-    writer.String("opening_balance");
-
-    writer.String(data.opening_balance_.c_str());
-
-    writer.String("closing_balance");
-
-    writer.String(data.closing_balance_.c_str());
-
-    writer.String("deposits");
-
-    writer.String(data.deposits_.c_str());
-
-    writer.String("grants");
-
-    writer.String(data.grants_.c_str());
-
-    writer.String("earning_from_ads");
-
-    writer.String(data.earning_from_ads_.c_str());
-
-    writer.String("auto_contribute");
-
-    writer.String(data.auto_contribute_.c_str());
-
-    writer.String("recurring_donation");
-
-    writer.String(data.recurring_donation_.c_str());
-
-    writer.String("one_time_donation");
-
-    writer.String(data.one_time_donation_.c_str());
-
-    writer.String("total");
-
-    writer.String(data.total_.c_str());
-
-    writer.EndObject();
+    WriteObject(writer, data);
   }
 
   /////////////////////////////////////////////////////////////////////////////
@@ -611,6 +246,8 @@ static bool ignore_ = false;
     num_excluded_sites_ = state.num_excluded_sites_;
     allow_non_verified_ = state.allow_non_verified_;
     pubs_load_timestamp_ = state.pubs_load_timestamp_;
+    pubs_list_etag_ = state.pubs_list_etag_;
+    pubs_list_last_modified_ = state.pubs_list_last_modified_;
     allow_videos_ = state.allow_videos_;
     monthly_balances_ = state.monthly_balances_;
     recurring_donation_ = state.recurring_donation_;
@@ -619,108 +256,11 @@ static bool ignore_ = false;
   PUBLISHER_STATE_ST::~PUBLISHER_STATE_ST() {}
 
   bool PUBLISHER_STATE_ST::loadFromJson(const std::string& json) {
-    rapidjson::Document d;
-    d.Parse(json.c_str());
-
-    //has parser errors or wrong types
-    bool error = d.HasParseError();
-    if (false == error) {
-      error = !(d.HasMember("min_pubslisher_duration") && d["min_pubslisher_duration"].IsUint() &&
-        d.HasMember("min_visits") && d["min_visits"].IsUint() &&
-        d.HasMember("num_excluded_sites") && d["num_excluded_sites"].IsUint() &&
-        d.HasMember("allow_non_verified") && d["allow_non_verified"].IsBool() &&
-        d.HasMember("pubs_load_timestamp") && d["pubs_load_timestamp"].IsUint64() &&
-        d.HasMember("allow_videos") && d["allow_videos"].IsBool() &&
-        d.HasMember("monthly_balances") && d["monthly_balances"].IsArray() &&
-        d.HasMember("recurring_donation") && d["recurring_donation"].IsArray());
-    }
-
-    if (false == error) {
-      min_publisher_duration_ = d["min_pubslisher_duration"].GetUint();
-      min_visits_ = d["min_visits"].GetUint();
-      num_excluded_sites_ = d["num_excluded_sites"].GetUint();
-      allow_non_verified_ = d["allow_non_verified"].GetBool();
-      pubs_load_timestamp_ = d["pubs_load_timestamp"].GetUint64();
-      allow_videos_ = d["allow_videos"].GetBool();
-
-      for (const auto & i : d["monthly_balances"].GetArray()) {
-        rapidjson::StringBuffer sb;
-        rapidjson::Writer<rapidjson::StringBuffer> writer(sb);
-        i.Accept(writer);
-
-        rapidjson::Document d1;
-        d1.Parse(sb.GetString());
-
-        rapidjson::Value::ConstMemberIterator itr = d1.MemberBegin();
-        if (itr != d1.MemberEnd()) {
-          rapidjson::StringBuffer sb1;
-          rapidjson::Writer<rapidjson::StringBuffer> writer1(sb1);
-          itr->value.Accept(writer1);
-          REPORT_BALANCE_ST r;
-          r.loadFromJson(sb1.GetString());
-          monthly_balances_.insert(std::make_pair(itr->name.GetString(), r));
-        }
-      }
-      for (const auto & i : d["recurring_donation"].GetArray()) {
-        rapidjson::StringBuffer sb;
-        rapidjson::Writer<rapidjson::StringBuffer> writer(sb);
-        i.Accept(writer);
-
-        rapidjson::Document d1;
-        d1.Parse(sb.GetString());
-
-        rapidjson::Value::ConstMemberIterator itr = d1.MemberBegin();
-        if (itr != d1.MemberEnd()) {
-          recurring_donation_.insert(std::make_pair(itr->name.GetString(), itr->value.GetDouble()));
-        }
-      }
-    }
-
-    return !error;
+    return LoadFromJsonString(json, this);
   }
 
-  void saveToJson(JsonWriter & writer, const PUBLISHER_STATE_ST& data) {
-    writer.StartObject();
-
-    writer.String("min_pubslisher_duration");
-    writer.Uint(data.min_publisher_duration_);
-
-    writer.String("min_visits");
-    writer.Uint(data.min_visits_);
-
-    writer.String("num_excluded_sites");
-    writer.Uint(data.num_excluded_sites_);
-
-    writer.String("allow_non_verified");
-    writer.Bool(data.allow_non_verified_);
-
-    writer.String("pubs_load_timestamp");
-    writer.Uint64(data.pubs_load_timestamp_);
-
-    writer.String("allow_videos");
-    writer.Bool(data.allow_videos_);
-
-    writer.String("monthly_balances");
-    writer.StartArray();
-    for (auto & p : data.monthly_balances_) {
-      writer.StartObject();
-      writer.String(p.first.c_str());
-      saveToJson(writer, p.second);
-      writer.EndObject();
-    }
-    writer.EndArray();
-
-    writer.String("recurring_donation");
-    writer.StartArray();
-    for (auto & p : data.recurring_donation_) {
-      writer.StartObject();
-      writer.String(p.first.c_str());
-      writer.Double(p.second);
-      writer.EndObject();
-    }
-    writer.EndArray();
-
-    writer.EndObject();
+  void saveToJson(JsonWriter& writer, const PUBLISHER_STATE_ST& data) {
+    WriteObject(writer, data);
   }
 
   /////////////////////////////////////////////////////////////////////////////
@@ -732,6 +272,14 @@ static bool ignore_ = false;
     percent_(0),
     weight_(0) {}
 
+  PUBLISHER_ST::PUBLISHER_ST(const PUBLISHER_ST&) = default;
+
+  PUBLISHER_ST::PUBLISHER_ST(PUBLISHER_ST&&) = default;
+
+  PUBLISHER_ST& PUBLISHER_ST::operator=(const PUBLISHER_ST&) = default;
+
+  PUBLISHER_ST& PUBLISHER_ST::operator=(PUBLISHER_ST&&) = default;
+
   PUBLISHER_ST::~PUBLISHER_ST() {}
 
   bool PUBLISHER_ST::operator<(const PUBLISHER_ST& rhs) const {
@@ -739,60 +287,25 @@ static bool ignore_ = false;
   }
 
   bool PUBLISHER_ST::loadFromJson(const std::string& json) {
-    rapidjson::Document d;
-    d.Parse(json.c_str());
-
-    //has parser errors or wrong types
-    bool error = d.HasParseError();
-    if (false == error) {
-      error = !(d.HasMember("id") && d["id"].IsString() &&
-        d.HasMember("duration") && d["duration"].IsUint64() &&
-        d.HasMember("score") && d["score"].IsDouble() &&
-        d.HasMember("visits") && d["visits"].IsUint() &&
-        d.HasMember("percent") && d["percent"].IsUint() &&
-        d.HasMember("weight") && d["weight"].IsDouble());
-    }
-
-    if (false == error) {
-      id_ = d["id"].GetString();
-      duration_ = d["duration"].GetUint64();
-      score_ = d["score"].GetDouble();
-      visits_ = d["visits"].GetUint();
-      percent_ = d["percent"].GetUint();
-      weight_ = d["pubs_load_timestamp"].GetDouble();
-    }
-
-    return !error;
+    return LoadFromJsonString(json, this);
   }
 
-  void saveToJson(JsonWriter & writer, const PUBLISHER_ST& data) {
-    writer.StartObject();
-
-    writer.String("id");
-    writer.String(data.id_.c_str());
-
-    writer.String("duration");
-    writer.Uint64(data.duration_);
-
-    writer.String("score");
-    writer.Double(data.score_);
-
-    writer.String("visits");
-    writer.Uint(data.visits_);
-
-    writer.String("percent");
-    writer.Uint(data.percent_);
-
-    writer.String("weight");
-    writer.Double(data.weight_);
-
-    writer.EndObject();
+  void saveToJson(JsonWriter& writer, const PUBLISHER_ST& data) {
+    WriteObject(writer, data);
   }
 
   /////////////////////////////////////////////////////////////////////////////
   WINNERS_ST::WINNERS_ST() :
     votes_(0) {}
 
+  WINNERS_ST::WINNERS_ST(const WINNERS_ST&) = default;
+
+  WINNERS_ST::WINNERS_ST(WINNERS_ST&&) = default;
+
+  WINNERS_ST& WINNERS_ST::operator=(const WINNERS_ST&) = default;
+
+  WINNERS_ST& WINNERS_ST::operator=(WINNERS_ST&&) = default;
+
   WINNERS_ST::~WINNERS_ST() {}
 
   /////////////////////////////////////////////////////////////////////////////
@@ -926,304 +439,80 @@ static bool ignore_ = false;
       probi = d["probi"].GetString();
     }
 
-    return !error;
-  }
-
-  /////////////////////////////////////////////////////////////////////////////
-  SURVEYOR_INFO_ST::SURVEYOR_INFO_ST() {}
-
-  SURVEYOR_INFO_ST::~SURVEYOR_INFO_ST() {}
-
-  /////////////////////////////////////////////////////////////////////////////
-  SURVEYOR_ST::SURVEYOR_ST() {}
-
-  SURVEYOR_ST::~SURVEYOR_ST() {}
-
-  bool SURVEYOR_ST::loadFromJson(const std::string & json) {
-    rapidjson::Document d;
-    d.Parse(json.c_str());
-
-    //has parser errors or wrong types
-    bool error = d.HasParseError();
-    if (false == error) {
-      error = !(d.HasMember("signature") && d["signature"].IsString() &&
-        d.HasMember("surveyorId") && d["surveyorId"].IsString() &&
-        d.HasMember("surveyVK") && d["surveyVK"].IsString() &&
-        d.HasMember("registrarVK") && d["registrarVK"].IsString());
-    }
-
-    if (false == error) {
-      signature_ = d["signature"].GetString();
-      surveyorId_ = d["surveyorId"].GetString();
-      surveyVK_ = d["surveyVK"].GetString();
-      registrarVK_ = d["registrarVK"].GetString();
-      if (d.HasMember("surveySK") && d["surveySK"].IsString()) {
-        surveySK_ = d["surveySK"].GetString();
-      }
-    }
-
-    return !error;
-  }
-
-  void saveToJson(JsonWriter & writer, const SURVEYOR_ST& data) {
-    writer.StartObject();
-
-    writer.String("signature");
-    writer.String(data.signature_.c_str());
-
-    writer.String("surveyorId");
-    writer.String(data.surveyorId_.c_str());
-
-    writer.String("surveyVK");
-    writer.String(data.surveyVK_.c_str());
-
-    writer.String("registrarVK");
-    writer.String(data.registrarVK_.c_str());
-
-    writer.String("surveySK");
-    writer.String(data.surveySK_.c_str());
-
-    writer.EndObject();
-  }
-
-  /////////////////////////////////////////////////////////////////////////////
-  RECONCILE_DIRECTION::RECONCILE_DIRECTION() {}
-  RECONCILE_DIRECTION::RECONCILE_DIRECTION(const std::string& publisher_key,
-                                           const int amount,
-                                           const std::string& currency) :
-    publisher_key_(publisher_key),
-    amount_(amount),
-    currency_(currency) {}
-  RECONCILE_DIRECTION::~RECONCILE_DIRECTION() {}
-
-  bool RECONCILE_DIRECTION::loadFromJson(const std::string & json) {
-    rapidjson::Document d;
-    d.Parse(json.c_str());
-
-    //has parser errors or wrong types
-    bool error = d.HasParseError();
-    if (false == error) {
-      error = !(d.HasMember("amount") && d["amount"].IsInt() &&
-        d.HasMember("publisher_key") && d["publisher_key"].IsString() &&
-        d.HasMember("currency") && d["currency"].IsString());
-    }
-
-    if (false == error) {
-      amount_ = d["amount"].GetInt();
-      publisher_key_ = d["publisher_key"].GetString();
-      currency_ = d["currency"].GetString();
-    }
-
-    return !error;
-  }
-
-  void saveToJson(JsonWriter & writer, const RECONCILE_DIRECTION& data) {
-    writer.StartObject();
-
-    writer.String("amount");
-    writer.Int(data.amount_);
-
-    writer.String("publisher_key");
-    writer.String(data.publisher_key_.c_str());
-
-    writer.String("currency");
-    writer.String(data.currency_.c_str());
-
-    writer.EndObject();
-  }
-
-  /////////////////////////////////////////////////////////////////////////////
-  CURRENT_RECONCILE::CURRENT_RECONCILE() :
-    timestamp_(0),
-    fee_(.0),
-    retry_step_(braveledger_bat_helper::ContributionRetry::STEP_NO),
-    retry_level_(0) {}
-
-  CURRENT_RECONCILE::CURRENT_RECONCILE(const CURRENT_RECONCILE& data):
-    viewingId_(data.viewingId_),
-    anonizeViewingId_(data.anonizeViewingId_),
-    registrarVK_(data.registrarVK_),
-    preFlight_(data.preFlight_),
-    masterUserToken_(data.masterUserToken_),
-    surveyorInfo_(data.surveyorInfo_),
-    timestamp_(data.timestamp_),
-    rates_(data.rates_),
-    amount_(data.amount_),
-    currency_(data.currency_),
-    fee_(data.fee_),
-    directions_(data.directions_),
-    category_(data.category_),
-    list_(data.list_),
-    retry_step_(data.retry_step_),
-    retry_level_(data.retry_level_),
-    destination_(data.destination_),
-    proof_(data.proof_) {}
-
-  CURRENT_RECONCILE::~CURRENT_RECONCILE() {}
-
-  bool CURRENT_RECONCILE::loadFromJson(const std::string & json) {
-    rapidjson::Document d;
-    d.Parse(json.c_str());
-
-    //has parser errors or wrong types
-    bool error = d.HasParseError();
-    if (false == error) {
-      error = !(d.HasMember("viewingId") && d["viewingId"].IsString() &&
-        d.HasMember("fee") && d["fee"].IsDouble() &&
-        d.HasMember("category") && d["category"].IsInt());
-    }
-
-    if (false == error) {
-      viewingId_ = d["viewingId"].GetString();
-      anonizeViewingId_ = d["anonizeViewingId"].GetString();
-      registrarVK_ = d["registrarVK"].GetString();
-      preFlight_ = d["preFlight"].GetString();
-      masterUserToken_ = d["masterUserToken"].GetString();
-      timestamp_ = d["timestamp"].GetUint64();
-      amount_ = d["amount"].GetString();
-      currency_ = d["currency"].GetString();
-      fee_ = d["fee"].GetDouble();
-      category_ = d["category"].GetInt();
-
-      if (d.HasMember("surveyorInfo") && d["surveyorInfo"].IsObject()) {
-        auto obj = d["surveyorInfo"].GetObject();
-        SURVEYOR_INFO_ST info;
-        info.surveyorId_ = obj["surveyorId"].GetString();
-        surveyorInfo_ = info;
-      }
-
-      if (d.HasMember("rates") && d["rates"].IsObject()) {
-        for (auto & i : d["rates"].GetObject()) {
-          rates_.insert(std::make_pair(i.name.GetString(), i.value.GetDouble()));
-        }
-      }
-
-      if (d.HasMember("directions") && d["directions"].IsArray()) {
-        for (auto & i : d["directions"].GetArray()) {
-          auto obj = i.GetObject();
-          RECONCILE_DIRECTION direction;
-          direction.amount_ = obj["amount"].GetInt();
-          direction.publisher_key_ = obj["publisher_key"].GetString();
-          direction.currency_ = obj["currency"].GetString();
-          directions_.push_back(direction);
-        }
-      }
-
-      if (d.HasMember("list") && d["list"].IsArray()) {
-        for (auto &i : d["list"].GetArray()) {
-          PUBLISHER_ST publisher_st;
-
-          auto obj = i.GetObject();
-          publisher_st.id_ = obj["id"].GetString();
-          publisher_st.duration_ = obj["duration"].GetUint64();
-          publisher_st.score_ = obj["score"].GetDouble();
-          publisher_st.visits_ = obj["visits"].GetUint();
-          publisher_st.percent_ = obj["percent"].GetUint();
-          publisher_st.weight_ = obj["weight"].GetDouble();
-
-          list_.push_back(publisher_st);
-        }
-      }
-
-      if (d.HasMember("retry_step") && d["retry_step"].IsInt()) {
-        retry_step_ = static_cast<braveledger_bat_helper::ContributionRetry>(
-            d["retry_step"].GetInt());
-      } else {
-        retry_step_ = braveledger_bat_helper::ContributionRetry::STEP_NO;
-      }
-
-      if (d.HasMember("retry_level") && d["retry_level"].IsInt()) {
-        retry_level_ = d["retry_level"].GetInt();
-      } else {
-        retry_level_ = 0;
-      }
-
-      if (d.HasMember("destination") && d["destination"].IsString()) {
-        destination_ = d["destination"].GetString();
-      }
-
-      if (d.HasMember("proof") && d["proof"].IsString()) {
-        proof_ = d["proof"].GetString();
-      }
-    }
-
-    return !error;
-  }
-
-  void saveToJson(JsonWriter & writer, const CURRENT_RECONCILE& data) {
-    writer.StartObject();
-
-    writer.String("viewingId");
-    writer.String(data.viewingId_.c_str());
-
-    writer.String("anonizeViewingId");
-    writer.String(data.anonizeViewingId_.c_str());
-
-    writer.String("registrarVK");
-    writer.String(data.registrarVK_.c_str());
-
-    writer.String("preFlight");
-    writer.String(data.preFlight_.c_str());
-
-    writer.String("masterUserToken");
-    writer.String(data.masterUserToken_.c_str());
+    return !error;
+  }
 
-    writer.String("surveyorInfo");
-    writer.StartObject();
-      writer.String("surveyorId");
-      writer.String(data.surveyorInfo_.surveyorId_.c_str());
-    writer.EndObject();
+  /////////////////////////////////////////////////////////////////////////////
+  SURVEYOR_INFO_ST::SURVEYOR_INFO_ST() {}
 
-    writer.String("timestamp");
-    writer.Uint64(data.timestamp_);
+  SURVEYOR_INFO_ST::~SURVEYOR_INFO_ST() {}
 
-    writer.String("amount");
-    writer.String(data.amount_.c_str());
+  /////////////////////////////////////////////////////////////////////////////
+  SURVEYOR_ST::SURVEYOR_ST() {}
 
-    writer.String("currency");
-    writer.String(data.currency_.c_str());
+  SURVEYOR_ST::~SURVEYOR_ST() {}
 
-    writer.String("fee");
-    writer.Double(data.fee_);
+  bool SURVEYOR_ST::loadFromJson(const std::string& json) {
+    return LoadFromJsonString(json, this);
+  }
 
-    writer.String("category");
-    writer.Int(data.category_);
+  void saveToJson(JsonWriter& writer, const SURVEYOR_ST& data) {
+    WriteObject(writer, data);
+  }
 
-    writer.String("rates");
-    writer.StartObject();
-    for (auto & p : data.rates_) {
-      writer.String(p.first.c_str());
-      writer.Double(p.second);
-    }
-    writer.EndObject();
+  /////////////////////////////////////////////////////////////////////////////
+  RECONCILE_DIRECTION::RECONCILE_DIRECTION() {}
+  RECONCILE_DIRECTION::RECONCILE_DIRECTION(const std::string& publisher_key,
+                                           const int amount,
+                                           const std::string& currency) :
+    publisher_key_(publisher_key),
+    amount_(amount),
+    currency_(currency) {}
+  RECONCILE_DIRECTION::~RECONCILE_DIRECTION() {}
 
-    writer.String("directions");
-    writer.StartArray();
-    for (auto & i : data.directions_) {
-      saveToJson(writer, i);
-    }
-    writer.EndArray();
+  bool RECONCILE_DIRECTION::loadFromJson(const std::string& json) {
+    return LoadFromJsonString(json, this);
+  }
 
-    writer.String("list");
-    writer.StartArray();
-    for (auto & i : data.list_) {
-      saveToJson(writer, i);
-    }
-    writer.EndArray();
+  void saveToJson(JsonWriter& writer, const RECONCILE_DIRECTION& data) {
+    WriteObject(writer, data);
+  }
 
-    writer.String("retry_step");
-    writer.Int(data.retry_step_);
+  /////////////////////////////////////////////////////////////////////////////
+  CURRENT_RECONCILE::CURRENT_RECONCILE() :
+    timestamp_(0),
+    fee_(.0),
+    retry_step_(braveledger_bat_helper::ContributionRetry::STEP_NO),
+    retry_level_(0) {}
 
-    writer.String("retry_level");
-    writer.Int(data.retry_level_);
+  CURRENT_RECONCILE::CURRENT_RECONCILE(const CURRENT_RECONCILE& data):
+    viewingId_(data.viewingId_),
+    anonizeViewingId_(data.anonizeViewingId_),
+    registrarVK_(data.registrarVK_),
+    preFlight_(data.preFlight_),
+    masterUserToken_(data.masterUserToken_),
+    surveyorInfo_(data.surveyorInfo_),
+    timestamp_(data.timestamp_),
+    rates_(data.rates_),
+    amount_(data.amount_),
+    currency_(data.currency_),
+    fee_(data.fee_),
+    directions_(data.directions_),
+    category_(data.category_),
+    list_(data.list_),
+    retry_step_(data.retry_step_),
+    retry_level_(data.retry_level_),
+    destination_(data.destination_),
+    proof_(data.proof_) {}
 
-    writer.String("destination");
-    writer.String(data.destination_.c_str());
+  CURRENT_RECONCILE::~CURRENT_RECONCILE() {}
 
-    writer.String("proof");
-    writer.String(data.proof_.c_str());
+  bool CURRENT_RECONCILE::loadFromJson(const std::string& json) {
+    return LoadFromJsonString(json, this);
+  }
 
-    writer.EndObject();
+  void saveToJson(JsonWriter& writer, const CURRENT_RECONCILE& data) {
+    WriteObject(writer, data);
   }
 
   /////////////////////////////////////////////////////////////////////////////
@@ -1265,204 +554,29 @@ static bool ignore_ = false;
 
   CLIENT_STATE_ST::~CLIENT_STATE_ST() {}
 
-  bool CLIENT_STATE_ST::loadFromJson(const std::string & json) {
-    rapidjson::Document d;
-    d.Parse(json.c_str());
-
-    //has parser error or wrong types
-    bool error = d.HasParseError();
-    if (false == error) {
-      error = !(d.HasMember("walletInfo") && d["walletInfo"].IsObject() &&
-        d.HasMember("bootStamp") && d["bootStamp"].IsUint64() &&
-        d.HasMember("reconcileStamp") && d["reconcileStamp"].IsUint64() &&
-        d.HasMember("personaId") && d["personaId"].IsString() &&
-        d.HasMember("userId") && d["userId"].IsString() &&
-        d.HasMember("registrarVK") && d["registrarVK"].IsString() &&
-        d.HasMember("masterUserToken") && d["masterUserToken"].IsString() &&
-        d.HasMember("preFlight") && d["preFlight"].IsString() &&
-        d.HasMember("fee_currency") && d["fee_currency"].IsString() &&
-        d.HasMember("settings") && d["settings"].IsString() &&
-        d.HasMember("fee_amount") && d["fee_amount"].IsDouble() &&
-        d.HasMember("user_changed_fee") && d["user_changed_fee"].IsBool() &&
-        d.HasMember("days") && d["days"].IsUint() &&
-        d.HasMember("transactions") && d["transactions"].IsArray() &&
-        d.HasMember("ballots") && d["ballots"].IsArray() &&
-        d.HasMember("ruleset") && d["ruleset"].IsString() &&
-        d.HasMember("rulesetV2") && d["rulesetV2"].IsString() &&
-        d.HasMember("batch") && d["batch"].IsArray() &&
-        d.HasMember("auto_contribute") && d["auto_contribute"].IsBool() &&
-        d.HasMember("rewards_enabled") && d["rewards_enabled"].IsBool()
-      );
-    }
-
-    if (false == error) {
-      {
-        auto & i = d["walletInfo"];
-        rapidjson::StringBuffer sb;
-        rapidjson::Writer<rapidjson::StringBuffer> writer(sb);
-        i.Accept(writer);
-        walletInfo_.loadFromJson(sb.GetString());
-      }
-
-      bootStamp_ = d["bootStamp"].GetUint64();
-      reconcileStamp_ = d["reconcileStamp"].GetUint64();
-
-      if (d.HasMember("last_grant_fetch_stamp") &&
-          d["last_grant_fetch_stamp"].IsUint64()) {
-        last_grant_fetch_stamp_ = d["last_grant_fetch_stamp"].GetUint64();
-      } else {
-        last_grant_fetch_stamp_ = 0u;
-      }
-
-      personaId_ = d["personaId"].GetString();
-      userId_ = d["userId"].GetString();
-      registrarVK_ = d["registrarVK"].GetString();
-      masterUserToken_ = d["masterUserToken"].GetString();
-      preFlight_ = d["preFlight"].GetString();
-      fee_currency_ = d["fee_currency"].GetString();
-      settings_ = d["settings"].GetString();
-      fee_amount_ = d["fee_amount"].GetDouble();
-      user_changed_fee_ = d["user_changed_fee"].GetBool();
-      days_ = d["days"].GetUint();
-      auto_contribute_ = d["auto_contribute"].GetBool();
-      rewards_enabled_ = d["rewards_enabled"].GetBool();
-
-      for (const auto & i : d["transactions"].GetArray()) {
-        rapidjson::StringBuffer sb;
-        rapidjson::Writer<rapidjson::StringBuffer> writer(sb);
-        i.Accept(writer);
-
-        TRANSACTION_ST ta;
-        ta.loadFromJson(sb.GetString());
-        transactions_.push_back(ta);
-      }
-
-      for (const auto & i : d["ballots"].GetArray()) {
-        rapidjson::StringBuffer sb;
-        rapidjson::Writer<rapidjson::StringBuffer> writer(sb);
-        i.Accept(writer);
-
-        BALLOT_ST b;
-        b.loadFromJson(sb.GetString());
-        ballots_.push_back(b);
-      }
-
-      ruleset_ = d["ruleset"].GetString();
-      rulesetV2_ = d["rulesetV2"].GetString();
-
-      for (const auto & i : d["batch"].GetArray()) {
-        rapidjson::StringBuffer sb;
-        rapidjson::Writer<rapidjson::StringBuffer> writer(sb);
-        i.Accept(writer);
-
-        BATCH_VOTES_ST b;
-        b.loadFromJson(sb.GetString());
-        batch_.push_back(b);
-      }
-
-      if (d.HasMember("current_reconciles") && d["current_reconciles"].IsObject()) {
-        for (const auto & i : d["current_reconciles"].GetObject()) {
-          rapidjson::StringBuffer sb;
-          rapidjson::Writer<rapidjson::StringBuffer> writer(sb);
-          i.value.Accept(writer);
-
-          CURRENT_RECONCILE b;
-          b.loadFromJson(sb.GetString());
-          current_reconciles_[i.name.GetString()] = b;
-        }
-      }
-    }
-
-    return !error;
+  bool CLIENT_STATE_ST::loadFromJson(const std::string& json) {
+    return LoadFromJsonString(json, this);
   }
 
-  void saveToJson(JsonWriter & writer, const CLIENT_STATE_ST& data) {
-    writer.StartObject();
-
-    writer.String("walletInfo");
-    saveToJson(writer, data.walletInfo_);
-
-    writer.String("bootStamp");
-    writer.Uint64(data.bootStamp_);
-
-    writer.String("reconcileStamp");
-    writer.Uint64(data.reconcileStamp_);
-
-    writer.String("last_grant_fetch_stamp");
-    writer.Uint64(data.last_grant_fetch_stamp_);
-
-    writer.String("personaId");
-    writer.String(data.personaId_.c_str());
-
-    writer.String("userId");
-    writer.String(data.userId_.c_str());
-
-    writer.String("registrarVK");
-    writer.String(data.registrarVK_.c_str());
-
-    writer.String("masterUserToken");
-    writer.String(data.masterUserToken_.c_str());
-
-    writer.String("preFlight");
-    writer.String(data.preFlight_.c_str());
-
-    writer.String("fee_currency");
-    writer.String(data.fee_currency_.c_str());
-
-    writer.String("settings");
-    writer.String(data.settings_.c_str());
-
-    writer.String("fee_amount");
-    writer.Double(data.fee_amount_);
-
-    writer.String("user_changed_fee");
-    writer.Bool(data.user_changed_fee_);
-
-    writer.String("days");
-    writer.Uint(data.days_);
-
-    writer.String("rewards_enabled");
-    writer.Bool(data.rewards_enabled_);
-
-    writer.String("auto_contribute");
-    writer.Bool(data.auto_contribute_);
-
-    writer.String("transactions");
-    writer.StartArray();
-    for (auto & t : data.transactions_) {
-      saveToJson(writer, t);
-    }
-    writer.EndArray();
-
-    writer.String("ballots");
-    writer.StartArray();
-    for (auto & b : data.ballots_) {
-      saveToJson(writer, b);
-    }
-    writer.EndArray();
+  void saveToJson(JsonWriter& writer, const CLIENT_STATE_ST& data) {
+    WriteObject(writer, data);
+  }
 
-    writer.String("ruleset");
-    writer.String(data.ruleset_.c_str());
+  /////////////////////////////////////////////////////////////////////////////
+  CLIENT_HISTORY_ST::CLIENT_HISTORY_ST() {}
 
-    writer.String("rulesetV2");
-    writer.String(data.rulesetV2_.c_str());
+  CLIENT_HISTORY_ST::CLIENT_HISTORY_ST(const CLIENT_HISTORY_ST& other) {
+    transactions_ = other.transactions_;
+  }
 
-    writer.String("batch");
-    writer.StartArray();
-    for (auto & b : data.batch_) {
-      saveToJson(writer, b);
-    }
-    writer.EndArray();
+  CLIENT_HISTORY_ST::~CLIENT_HISTORY_ST() {}
 
-    writer.String("current_reconciles");
-    writer.StartObject();
-    for (auto & t : data.current_reconciles_) {
-      writer.Key(t.first.c_str());
-      saveToJson(writer, t.second);
-    }
-    writer.EndObject();
+  bool CLIENT_HISTORY_ST::loadFromJson(const std::string& json) {
+    return LoadFromJsonString(json, this);
+  }
 
-    writer.EndObject();
+  void saveToJson(JsonWriter& writer, const CLIENT_HISTORY_ST& data) {
+    WriteObject(writer, data);
   }
 
   /////////////////////////////////////////////////////////////////////////////
@@ -1489,64 +603,12 @@ static bool ignore_ = false;
   MEDIA_PUBLISHER_INFO::~MEDIA_PUBLISHER_INFO() {}
 
 
-  bool MEDIA_PUBLISHER_INFO::loadFromJson(const std::string & json) {
-    rapidjson::Document d;
-    d.Parse(json.c_str());
-
-    //has parser errors or wrong types
-    bool error = d.HasParseError();
-    if (false == error) {
-      error = !(d.HasMember("publisherName") && d["publisherName"].IsString() &&
-        d.HasMember("publisherURL") && d["publisherURL"].IsString() &&
-        d.HasMember("favIconURL") && d["favIconURL"].IsString() &&
-        d.HasMember("channelName") && d["channelName"].IsString() &&
-        d.HasMember("publisherId") && d["publisherId"].IsString() &&
-        d.HasMember("twitch_event") && d["twitch_event"].IsString() &&
-        d.HasMember("twitch_time") && d["twitch_time"].IsString() &&
-        d.HasMember("twitch_status") && d["twitch_status"].IsString());
-    }
-
-    if (false == error) {
-      publisherName_ = d["publisherName"].GetString();
-      publisherURL_ = d["publisherURL"].GetString();
-      favIconURL_ = d["favIconURL"].GetString();
-      channelName_ = d["channelName"].GetString();
-      publisher_id_ = d["publisherId"].GetString();
-      twitchEventInfo_.event_ = d["twitch_event"].GetString();
-      twitchEventInfo_.time_ = d["twitch_time"].GetString();
-      twitchEventInfo_.status_ = d["twitch_status"].GetString();
-    }
-    return !error;
+  bool MEDIA_PUBLISHER_INFO::loadFromJson(const std::string& json) {
+    return LoadFromJsonString(json, this);
   }
 
-  void saveToJson(JsonWriter & writer, const MEDIA_PUBLISHER_INFO& data) {
-    writer.StartObject();
-
-    writer.String("publisherName");
-    writer.String(data.publisherName_.c_str());
-
-    writer.String("publisherURL");
-    writer.String(data.publisherURL_.c_str());
-
-    writer.String("favIconURL");
-    writer.String(data.favIconURL_.c_str());
-
-    writer.String("channelName");
-    writer.String(data.channelName_.c_str());
-
-    writer.String("publisherId");
-    writer.String(data.publisher_id_.c_str());
-
-    writer.String("twitch_event");
-    writer.String(data.twitchEventInfo_.event_.c_str());
-
-    writer.String("twitch_time");
-    writer.String(data.twitchEventInfo_.time_.c_str());
-
-    writer.String("twitch_status");
-    writer.String(data.twitchEventInfo_.status_.c_str());
-
-    writer.EndObject();
+  void saveToJson(JsonWriter& writer, const MEDIA_PUBLISHER_INFO& data) {
+    WriteObject(writer, data);
   }
 
 /////////////////////////////////////////////////////////////////////////////
@@ -1568,14 +630,89 @@ static bool ignore_ = false;
   SERVER_LIST_BANNER::~SERVER_LIST_BANNER() {}
 
 /////////////////////////////////////////////////////////////////////////////
-  void split(std::vector<std::string>& tmp, std::string query, char delimiter) {
-    std::stringstream ss(query);
-    std::string item;
-    while (std::getline(ss, item, delimiter)) {
-      if (query[0] != '\n') {
-        tmp.push_back(item);
+  // End of the plain decimal number at |pos|, [+-]digits[.digits][e[+-]digits].
+  // Returns |pos| when there is none, so inf, nan and hex are not numbers.
+  const char* getDecimalEnd(const char* pos) {
+    const char* end = pos;
+    if (*end == '+' || *end == '-') {
+      end++;
+    }
+
+    const char* digits = end;
+    while (isdigit(static_cast<unsigned char>(*end))) {
+      end++;
+    }
+    if (*end == '.') {
+      end++;
+      while (isdigit(static_cast<unsigned char>(*end))) {
+        end++;
+      }
+    }
+    if (end == digits || (end == digits + 1 && *digits == '.')) {
+      return pos;
+    }
+
+    if (*end == 'e' || *end == 'E') {
+      const char* exponent = end + 1;
+      if (*exponent == '+' || *exponent == '-') {
+        exponent++;
+      }
+      if (isdigit(static_cast<unsigned char>(*exponent))) {
+        end = exponent;
+        while (isdigit(static_cast<unsigned char>(*end))) {
+          end++;
+        }
       }
     }
+
+    return end;
+  }
+
+  // The number is read in the "C" locale, strtod would use the decimal
+  // point of the current one
+  double getDecimalValue(const char* value, const char** end) {
+    const char* number_end = getDecimalEnd(value);
+    if (end) {
+      *end = number_end;
+    }
+    if (number_end == value) {
+      return 0;
+    }
+
+    // reused, so that the locale is only set up once per thread
+    static thread_local std::istringstream stream;
+    static thread_local bool imbued = false;
+    if (!imbued) {
+      stream.imbue(std::locale::classic());
+      imbued = true;
+    }
+
+    double number = 0;
+    stream.clear();
+    stream.str(std::string(value, number_end));
+    if (!(stream >> number)) {
+      return 0;
+    }
+
+    return number;
+  }
+
+  // Reads the next comma separated number and moves |pos| behind it.
+  // Values that are not decimal numbers are read as 0.
+  bool getNextListValue(const char*& pos, double* value) {
+    if (*pos == '\0') {
+      return false;
+    }
+
+    const char* end = nullptr;
+    *value = getDecimalValue(pos, &end);
+
+    while (*end != '\0' && *end != ',') {
+      end++;
+    }
+
+    pos = (*end == ',') ? end + 1 : end;
+    return true;
   }
 
   bool getJSONValue(const std::string& fieldName, const std::string& json, std::string & value) {
@@ -1606,8 +743,14 @@ static bool ignore_ = false;
   }
 
   bool getJSONTwitchProperties(const std::string& json, std::vector<std::map<std::string, std::string>>& parts) {
+    return getJSONTwitchProperties(json.data(), json.length(), parts);
+  }
+
+  bool getJSONTwitchProperties(const char* json,
+                               size_t length,
+                               std::vector<std::map<std::string, std::string>>& parts) {
     rapidjson::Document d;
-    d.Parse(json.c_str());
+    d.Parse(json, length);
 
     //has parser errors or wrong types
     bool error = d.HasParseError();
@@ -1936,14 +1079,9 @@ static bool ignore_ = false;
   }
 
   std::vector<uint8_t> generateSeed() {
-    //std::ostringstream seedStr;
-
     std::vector<uint8_t> vSeed(SEED_LENGTH);
-    std::random_device r;
-    std::seed_seq seed{r(), r(), r(), r(), r(), r(), r(), r()};
-    auto rand = std::bind(std::uniform_int_distribution<>(0, UCHAR_MAX), std::mt19937(seed));
-
-    std::generate_n(vSeed.begin(), SEED_LENGTH, rand);
+    bat_ledger::RandomService::GetInstance()->RandBytes(&vSeed.front(),
+                                                        SEED_LENGTH);
     return vSeed;
   }
 
@@ -1990,45 +1128,46 @@ static bool ignore_ = false;
   }
 
   std::string uint8ToHex(const std::vector<uint8_t>& in) {
-    std::ostringstream res;
-    for (size_t i = 0; i < in.size(); i++) {
-      res << std::setfill('0') << std::setw(sizeof(uint8_t) * 2)
-         << std::hex << (int)in[i];
-    }
-    return res.str();
+    std::string res;
+    braveledger_bat_codec::AppendHex(in.data(), in.size(), &res);
+    return res;
   }
 
 
-  std::string stringifyBatch(std::vector<BATCH_VOTES_INFO_ST> payload) {
-    rapidjson::StringBuffer buffer;
-    JsonWriter writer(buffer);
+  void stringifyBatch(const std::vector<BATCH_VOTES_INFO_ST>& payload,
+                      size_t size,
+                      std::string* json) {
+    json->clear();
+    JsonStringStream stream(json);
+    JsonWriter writer(stream);
 
     writer.StartArray();
-    for (auto & d : payload) {
-      saveToJson(writer, d);
+    size = std::min(size, payload.size());
+    for (size_t i = 0; i < size; i++) {
+      saveToJson(writer, payload[i]);
     }
     writer.EndArray();
-
-    return buffer.GetString();
   }
 
-  std::string stringify(std::string* keys, std::string* values, const unsigned int& size) {
-    rapidjson::StringBuffer buffer;
-    JsonWriter writer(buffer);
+  void stringify(const std::string* keys, const std::string* values,
+                 size_t size, std::string* json) {
+    json->clear();
+    JsonStringStream stream(json);
+    JsonWriter writer(stream);
     writer.StartObject();
 
-    for (unsigned int i = 0; i < size; i++) {
+    for (size_t i = 0; i < size; i++) {
       writer.String(keys[i].c_str());
       writer.String(values[i].c_str());
     }
 
     writer.EndObject();
-    return buffer.GetString();
   }
 
-  std::string stringifyUnsignedTx(const UNSIGNED_TX& unsignedTx) {
-    rapidjson::StringBuffer buffer;
-    JsonWriter writer(buffer);
+  void stringifyUnsignedTx(const UNSIGNED_TX& unsignedTx, std::string* json) {
+    json->clear();
+    JsonStringStream stream(json);
+    JsonWriter writer(stream);
     writer.StartObject();
 
     writer.String("denomination");
@@ -2045,13 +1184,14 @@ static bool ignore_ = false;
     writer.String(unsignedTx.destination_.c_str());
 
     writer.EndObject();
-    return buffer.GetString();
   }
 
-  std::string stringifyRequestCredentialsSt(const REQUEST_CREDENTIALS_ST& request_credentials) {
-
-    rapidjson::StringBuffer buffer;
-    JsonWriter writer(buffer);
+  void stringifyRequestCredentialsSt(
+      const REQUEST_CREDENTIALS_ST& request_credentials,
+      std::string* json) {
+    json->clear();
+    JsonStringStream stream(json);
+    JsonWriter writer(stream);
     writer.StartObject(); //root
 
     writer.String("requestType");
@@ -2093,12 +1233,14 @@ static bool ignore_ = false;
     writer.String("proof");
     writer.String(request_credentials.proof_.c_str());
     writer.EndObject(); //root
-    return buffer.GetString();
   }
 
-  std::string stringifyReconcilePayloadSt(const RECONCILE_PAYLOAD_ST& reconcile_payload) {
-    rapidjson::StringBuffer buffer;
-    JsonWriter writer(buffer);
+  void stringifyReconcilePayloadSt(
+      const RECONCILE_PAYLOAD_ST& reconcile_payload,
+      std::string* json) {
+    json->clear();
+    JsonStringStream stream(json);
+    JsonWriter writer(stream);
     writer.StartObject(); //root
 
     writer.String("requestType");
@@ -2150,7 +1292,36 @@ static bool ignore_ = false;
     writer.String(reconcile_payload.request_viewingId_.c_str());
 
     writer.EndObject(); //root
-    return buffer.GetString();
+  }
+
+  std::string stringifyBatch(const std::vector<BATCH_VOTES_INFO_ST>& payload) {
+    std::string json;
+    stringifyBatch(payload, payload.size(), &json);
+    return json;
+  }
+
+  std::string stringify(std::string* keys, std::string* values, const unsigned int& size) {
+    std::string json;
+    stringify(keys, values, size, &json);
+    return json;
+  }
+
+  std::string stringifyUnsignedTx(const UNSIGNED_TX& unsignedTx) {
+    std::string json;
+    stringifyUnsignedTx(unsignedTx, &json);
+    return json;
+  }
+
+  std::string stringifyRequestCredentialsSt(const REQUEST_CREDENTIALS_ST& request_credentials) {
+    std::string json;
+    stringifyRequestCredentialsSt(request_credentials, &json);
+    return json;
+  }
+
+  std::string stringifyReconcilePayloadSt(const RECONCILE_PAYLOAD_ST& reconcile_payload) {
+    std::string json;
+    stringifyReconcilePayloadSt(reconcile_payload, &json);
+    return json;
   }
 
   std::vector<uint8_t> getSHA256(const std::string& in) {
@@ -2161,64 +1332,30 @@ static bool ignore_ = false;
 
   std::string getBase64(const std::vector<uint8_t>& in) {
     std::string res;
-    size_t size = 0;
-    if (!EVP_EncodedLength(&size, in.size())) {
-      DCHECK(false);
-      return "";
-    }
-    std::vector<uint8_t> out(size);
-    int numEncBytes = EVP_EncodeBlock(&out.front(), &in.front(), in.size());
-    DCHECK(numEncBytes != 0);
-    res = (char*)&out.front();
+    braveledger_bat_codec::AppendBase64(in.data(), in.size(), &res);
     return res;
   }
 
   bool getFromBase64(const std::string& in, std::vector<uint8_t> & out) {
-    bool succeded = true;
-    size_t size = 0;
-    if (!EVP_DecodedLength(&size, in.length())) {
+    if (in.length() % 4 != 0) {
       DCHECK(false);
-      succeded = false;
-    }
-
-    if (succeded) {
-      out.resize(size);
-      size_t final_size = 0;
-      int numDecBytes = EVP_DecodeBase64(&out.front(), &final_size, size, (const uint8_t*)in.c_str(), in.length());
-      DCHECK(numDecBytes != 0);
-
-      if (0 == numDecBytes) {
-        succeded = false;
-        out.clear();
-      } else if (final_size != size) {
-        out.resize(final_size);
-      }
+      return false;
     }
-    return succeded;
-  }
 
-  std::string sign(std::string* keys, std::string* values, const unsigned int& size,
-      const std::string& keyId, const std::vector<uint8_t>& secretKey) {
-    std::string headers;
-    std::string message;
-    for (unsigned int i = 0; i < size; i++) {
-      if (0 != i) {
-        headers += " ";
-        message += "\n";
-      }
-      headers += keys[i];
-      message += keys[i] + ": " + values[i];
+    out.resize(braveledger_bat_codec::Base64DecodedMaxLength(in.length()));
+    size_t final_size = 0;
+    bool succeded = braveledger_bat_codec::Base64Decode(in.data(),
+                                                        in.length(),
+                                                        out.data(),
+                                                        &final_size);
+    DCHECK(succeded);
+    if (!succeded) {
+      out.clear();
+      return false;
     }
-    std::vector<uint8_t> signedMsg(crypto_sign_BYTES + message.length());
 
-    unsigned long long signedMsgSize = 0;
-    crypto_sign(&signedMsg.front(), &signedMsgSize, (const unsigned char*)message.c_str(), (unsigned long long)message.length(), &secretKey.front());
-
-    std::vector<uint8_t> signature(crypto_sign_BYTES);
-    std::copy(signedMsg.begin(), signedMsg.begin() + crypto_sign_BYTES, signature.begin());
-
-    return "keyId=\"" + keyId + "\",algorithm=\"" + SIGNATURE_ALGORITHM +
-      "\",headers=\"" + headers + "\",signature=\"" + getBase64(signature) + "\"";
+    out.resize(final_size);
+    return true;
   }
 
   uint64_t currentTime() {
@@ -2226,17 +1363,57 @@ static bool ignore_ = false;
   }
 
   void getTwitchParts(const std::string& query, std::vector<std::map<std::string, std::string>>& parts) {
+    std::vector<uint8_t> scratch;
+    getTwitchParts(query, &scratch, parts);
+  }
+
+  void getTwitchParts(const std::string& query,
+                      std::vector<uint8_t>* scratch,
+                      std::vector<std::map<std::string, std::string>>& parts) {
     size_t pos = query.find("data=");
-    if (std::string::npos != pos && query.length() > 5) {
-      std::string varValue = query.substr(5);
-      //DecodeURLChars(query.substr(5), varValue);
-      std::vector<uint8_t> decoded;
-      bool succeded = braveledger_bat_helper::getFromBase64(varValue, decoded);
-      if (succeded) {
-        decoded.push_back((uint8_t)'\0');
-        braveledger_bat_helper::getJSONTwitchProperties((char*)&decoded.front(), parts);
-      }
+    if (std::string::npos == pos || query.length() <= 5) {
+      return;
+    }
+
+    // decode straight from the query into the scratch buffer, it only
+    // grows so the allocation is reused between the requests
+    const char* data = query.data() + 5;
+    size_t data_length = query.length() - 5;
+    size_t size = braveledger_bat_codec::Base64DecodedMaxLength(data_length);
+    if (data_length % 4 != 0 || size == 0) {
+      return;
+    }
+
+    if (scratch->size() < size) {
+      scratch->resize(size);
+    }
+
+    size_t final_size = 0;
+    if (!braveledger_bat_codec::Base64Decode(data,
+                                             data_length,
+                                             &scratch->front(),
+                                             &final_size)) {
+      return;
     }
+
+    getJSONTwitchProperties(reinterpret_cast<const char*>(&scratch->front()),
+                            final_size,
+                            parts);
+  }
+
+  int getTwitchEventIndex(const std::string& event) {
+    if (event.length() < 5) {
+      return -1;
+    }
+
+    size_t hash = ((uint8_t)event[4] + (uint8_t)event[event.length() - 4]) &
+        (braveledger_ledger::_twitch_events_hash_size - 1);
+    int index = braveledger_ledger::_twitch_events_hash[hash];
+    if (index < 0 || event != braveledger_ledger::_twitch_events[index]) {
+      return -1;
+    }
+
+    return index;
   }
 
   std::string getMediaId(const std::map<std::string, std::string>& data, const std::string& type) {
@@ -2247,25 +1424,30 @@ static bool ignore_ = false;
       }
     } else if (TWITCH_MEDIA_TYPE == type) {
       std::map<std::string, std::string>::const_iterator iter = data.find("event");
-      if (iter != data.end() && data.find("properties") != data.end()) {
-        for (size_t i = 0; i < braveledger_ledger::_twitch_events_array_size; i++) {
-          if (iter->second == braveledger_ledger::_twitch_events[i]) {
-            iter = data.find("channel");
-            std::string id("");
-            if (iter != data.end()) {
-              id = iter->second;
-            }
-            iter = data.find("vod");
-            if (iter != data.end()) {
-              std::string idAddition(iter->second);
-              if (idAddition.find('v') != std::string::npos) {
-                id += "_vod_" + braveledger_bat_helper::split(idAddition, 'v')[1];
-              }
+      if (iter != data.end() && data.find("properties") != data.end() &&
+          getTwitchEventIndex(iter->second) >= 0) {
+        iter = data.find("channel");
+        std::string id("");
+        if (iter != data.end()) {
+          id = iter->second;
+        }
+        iter = data.find("vod");
+        if (iter != data.end()) {
+          // vod id is in format v123456789
+          const std::string& vod = iter->second;
+          size_t start = vod.find('v');
+          if (start != std::string::npos) {
+            start++;
+            size_t end = vod.find('v', start);
+            if (end == std::string::npos) {
+              end = vod.length();
             }
-
-            return id;
+            id += "_vod_";
+            id.append(vod, start, end - start);
           }
         }
+
+        return id;
       }
     }
 
@@ -2283,22 +1465,22 @@ static bool ignore_ = false;
       std::map<std::string, std::string>::const_iterator iterSt = data.find("st");
       std::map<std::string, std::string>::const_iterator iterEt = data.find("et");
       if (iterSt != data.end() && iterEt != data.end()) {
-        std::vector<std::string> startTime;
-        std::vector<std::string> endTime;
-        split(startTime, iterSt->second, ',');
-        split(endTime, iterEt->second, ',');
-        if (startTime.size() != endTime.size()) {
-          return 0;
-        }
         // get all the intervals and combine them.
         // (Should only be one set if there were no seeks)
-        for (size_t i = 0; i < startTime.size(); i++) {
-          std::stringstream tempET(endTime[i]);
-          std::stringstream tempST(startTime[i]);
-          double st = 0;
-          double et = 0;
-          tempET >> et;
-          tempST >> st;
+        const char* startTime = iterSt->second.c_str();
+        const char* endTime = iterEt->second.c_str();
+        double st = 0;
+        double et = 0;
+        while (true) {
+          bool hasStart = getNextListValue(startTime, &st);
+          bool hasEnd = getNextListValue(endTime, &et);
+          if (hasStart != hasEnd) {
+            return 0;
+          }
+
+          if (!hasStart) {
+            break;
+          }
 
           // round instead of truncate
           // also make sure we include previous iterations
@@ -2392,12 +1574,7 @@ static bool ignore_ = false;
   }
 
   uint64_t getRandomValue(uint8_t min, uint8_t max) {
-    std::random_device seeder;
-    const auto seed = seeder.entropy() ? seeder() : time(nullptr);
-    std::mt19937 eng(static_cast<std::mt19937::result_type> (seed));
-    std::uniform_int_distribution <> dist(min, max);
-
-    return dist(eng);
+    return bat_ledger::RandomService::GetInstance()->RandInt(min, max);
   }
 
 }  // namespace braveledger_bat_helper
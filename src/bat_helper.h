@@ -5,6 +5,7 @@
 #ifndef BRAVELEDGER_BAT_HELPER_H_
 #define BRAVELEDGER_BAT_HELPER_H_
 
+#include <cmath>
 #include <string>
 #include <vector>
 #include <map>
@@ -158,6 +159,7 @@ namespace braveledger_bat_helper {
     bool loadFromJson(const std::string & json);
 
     std::string publisher_;
+    std::string viewingId_;  // empty for votes batched by older versions
     std::vector<BATCH_VOTES_INFO_ST> batchVotesInfo_;
   };
 
@@ -223,13 +225,21 @@ namespace braveledger_bat_helper {
     unsigned int num_excluded_sites_ = 0;
     bool allow_non_verified_ = true;
     uint64_t pubs_load_timestamp_ = 0ull; //last publishers list load timestamp (seconds)
+    std::string pubs_list_etag_; //validators of the saved publishers list
+    std::string pubs_list_last_modified_;
     bool allow_videos_ = true;
     std::map<std::string, REPORT_BALANCE_ST> monthly_balances_;
     std::map<std::string, double> recurring_donation_;
   };
 
+  // Scoring record of a publisher, used from the auto contribute list
+  // to the winners of the reconcile
   struct PUBLISHER_ST {
     PUBLISHER_ST();
+    PUBLISHER_ST(const PUBLISHER_ST&);
+    PUBLISHER_ST(PUBLISHER_ST&&);
+    PUBLISHER_ST& operator=(const PUBLISHER_ST&);
+    PUBLISHER_ST& operator=(PUBLISHER_ST&&);
     ~PUBLISHER_ST();
     bool operator<(const PUBLISHER_ST& rhs) const;
 
@@ -246,6 +256,10 @@ namespace braveledger_bat_helper {
 
   struct WINNERS_ST {
     WINNERS_ST();
+    WINNERS_ST(const WINNERS_ST&);
+    WINNERS_ST(WINNERS_ST&&);
+    WINNERS_ST& operator=(const WINNERS_ST&);
+    WINNERS_ST& operator=(WINNERS_ST&&);
     ~WINNERS_ST();
 
     PUBLISHER_ST publisher_data_;
@@ -346,6 +360,8 @@ namespace braveledger_bat_helper {
     double fee_amount_ = .0;
     bool user_changed_fee_ = false;
     unsigned int days_ = 0u;
+    // the transactions are kept in CLIENT_HISTORY_ST, these are only set
+    // on states saved before it had a record of its own
     Transactions transactions_;
     Ballots ballots_;
     std::string ruleset_;
@@ -357,6 +373,20 @@ namespace braveledger_bat_helper {
     bool rewards_enabled_ = false;
   };
 
+  // Transactions of past reconciles. Saved apart from the client state,
+  // which is saved on every change and stays small. Ballots and batch
+  // votes are only kept until they are sent, so they stay in the state.
+  struct CLIENT_HISTORY_ST {
+    CLIENT_HISTORY_ST();
+    CLIENT_HISTORY_ST(const CLIENT_HISTORY_ST&);
+    ~CLIENT_HISTORY_ST();
+
+    // Load from json string
+    bool loadFromJson(const std::string & json);
+
+    Transactions transactions_;
+  };
+
   // The struct is serialized/deserialized from/into JSON as part of MEDIA_PUBLISHER_INFO
   struct TWITCH_EVENT_INFO {
     TWITCH_EVENT_INFO();
@@ -439,6 +469,10 @@ namespace braveledger_bat_helper {
 
   bool getJSONTwitchProperties(const std::string& json, std::vector<std::map<std::string, std::string>>& parts);
 
+  bool getJSONTwitchProperties(const char* json,
+                               size_t length,
+                               std::vector<std::map<std::string, std::string>>& parts);
+
   bool getJSONBatchSurveyors(const std::string& json, std::vector<std::string>& surveyors);
 
   bool getJSONRecoverWallet(const std::string& json, double& balance, std::string& probi, std::vector<GRANT>& grants);
@@ -463,7 +497,27 @@ namespace braveledger_bat_helper {
 
   std::string stringifyUnsignedTx(const UNSIGNED_TX& unsignedTx);
 
-  std::string stringifyBatch(std::vector<BATCH_VOTES_INFO_ST> payload);
+  std::string stringifyBatch(const std::vector<BATCH_VOTES_INFO_ST>& payload);
+
+  // Versions that write into |json|, replacing what it held. Its capacity is
+  // reused, so a buffer kept between requests is only allocated once.
+  void stringify(const std::string* keys, const std::string* values,
+                 size_t size, std::string* json);
+
+  void stringifyRequestCredentialsSt(
+      const REQUEST_CREDENTIALS_ST& request_credentials,
+      std::string* json);
+
+  void stringifyReconcilePayloadSt(
+      const RECONCILE_PAYLOAD_ST& reconcile_payload,
+      std::string* json);
+
+  void stringifyUnsignedTx(const UNSIGNED_TX& unsignedTx, std::string* json);
+
+  // First |size| votes of |payload|
+  void stringifyBatch(const std::vector<BATCH_VOTES_INFO_ST>& payload,
+                      size_t size,
+                      std::string* json);
 
   std::vector<uint8_t> getSHA256(const std::string& in);
 
@@ -471,16 +525,26 @@ namespace braveledger_bat_helper {
 
   bool getFromBase64(const std::string& in, std::vector<uint8_t> & out);
 
-  // Sign using ed25519 algorithm
-  std::string sign(std::string* keys, std::string* values, const unsigned int& size,
-      const std::string& keyId, const std::vector<uint8_t>& secretKey);
-
   uint64_t currentTime();
 
   void getUrlQueryParts(const std::string& query, std::map<std::string, std::string>& parts);
 
   void getTwitchParts(const std::string& query, std::vector<std::map<std::string, std::string>>& parts);
 
+  // Same as above, but decodes into |scratch| that can be reused between calls
+  void getTwitchParts(const std::string& query,
+                      std::vector<uint8_t>* scratch,
+                      std::vector<std::map<std::string, std::string>>& parts);
+
+  // Reads the plain decimal number at the start of |value|,
+  // [+-]digits[.digits][e[+-]digits], independent of the locale. Returns 0
+  // when there is none, also for inf, nan and hex. |end| is set behind the
+  // number when it's given.
+  double getDecimalValue(const char* value, const char** end);
+
+  // Returns index into braveledger_ledger::_twitch_events or -1
+  int getTwitchEventIndex(const std::string& event);
+
   std::string getMediaId(const std::map<std::string, std::string>& data, const std::string& type);
 
   std::string getMediaKey(const std::string& mediaId, const std::string& type);
@@ -497,6 +561,73 @@ namespace braveledger_bat_helper {
     std::vector<uint8_t>& bytes_out, size_t *written,
     std::vector<std::string> wordDictionary);
   uint64_t getRandomValue(uint8_t min, uint8_t max);
+
+  // Sets percent and weight of every record from its score, percents are
+  // rounded so that they add up to 100. Records are updated in place,
+  // so both PUBLISHER_ST and ledger::PublisherInfo lists can be normalized
+  // without converting them. |list| can be just the top scored part of
+  // |totalCount| records which add up to |totalScores|, records that are
+  // left out are expected to round down to no percent.
+  template <typename T>
+  void normalizeScores(std::vector<T>& list,
+                       double totalScores,
+                       size_t totalCount,
+                       double T::*score,
+                       unsigned int T::*percent,
+                       double T::*weight) {
+    if (list.size() == 0 || totalScores <= 0.0) {
+      return;
+    }
+
+    std::vector<unsigned int> percents(list.size());
+    std::vector<double> roundoffs(list.size());
+    unsigned int totalPercents = 0;
+    for (size_t i = 0; i < list.size(); i++) {
+      double realPercent = (double)(list[i].*score) / totalScores * 100.0;
+      percents[i] = (unsigned int)std::lround(realPercent);
+      roundoffs[i] = std::fabs(percents[i] - realPercent);
+      totalPercents += percents[i];
+      list[i].*weight = (double)(list[i].*score) / (double)totalCount * 100.0;
+    }
+
+    while (totalPercents != 100) {
+      size_t valueToChange = 0;
+      double currentRoundOff = roundoffs[0];
+      for (size_t i = 1; i < percents.size(); i++) {
+        if (roundoffs[i] > currentRoundOff) {
+          currentRoundOff = roundoffs[i];
+          valueToChange = i;
+        }
+      }
+
+      if (totalPercents > 100) {
+        percents[valueToChange] -= 1;
+        totalPercents -= 1;
+      } else {
+        percents[valueToChange] += 1;
+        totalPercents += 1;
+      }
+      roundoffs[valueToChange] = 0;
+    }
+
+    for (size_t i = 0; i < list.size(); i++) {
+      list[i].*percent = percents[i];
+    }
+  }
+
+  // Same as above for the complete list of records
+  template <typename T>
+  void normalizeScores(std::vector<T>& list,
+                       double T::*score,
+                       unsigned int T::*percent,
+                       double T::*weight) {
+    double totalScores = 0.0;
+    for (size_t i = 0; i < list.size(); i++) {
+      totalScores += list[i].*score;
+    }
+
+    normalizeScores(list, totalScores, list.size(), score, percent, weight);
+  }
 }  // namespace braveledger_bat_helper
 
 #endif  // BRAVELEDGER_BAT_HELPER_H_
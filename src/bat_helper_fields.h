@@ -0,0 +1,317 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVELEDGER_BAT_HELPER_FIELDS_H_
+#define BRAVELEDGER_BAT_HELPER_FIELDS_H_
+
+#include <map>
+#include <string>
+#include <tuple>
+
+#include "bat_fields.h"
+#include "bat_helper.h"
+
+// Saved members of the ledger state structs. The order of a table is the
+// order of the keys in the saved JSON, keep it when adding members.
+namespace braveledger_bat_helper {
+
+// Codec tags of the ledger structs
+struct Probi {};  // string of digits, see isProbiValid
+struct CurrencyRates {};  // rates that have all the wallet currencies
+
+inline void WriteJson(JsonWriter& writer, const std::string& value, Probi) {
+  WriteJson(writer, value, Plain());
+}
+
+inline bool CheckJson(const rapidjson::Value& json,
+                      const std::string*,
+                      Probi) {
+  return json.IsString() && isProbiValid(json.GetString());
+}
+
+inline void ReadJson(const rapidjson::Value& json,
+                     std::string* value,
+                     Probi) {
+  ReadJson(json, value, Plain());
+}
+
+inline void WriteJson(JsonWriter& writer,
+                      const std::map<std::string, double>& value,
+                      CurrencyRates) {
+  WriteJson(writer, value, Plain());
+}
+
+inline bool CheckJson(const rapidjson::Value& json,
+                      const std::map<std::string, double>*,
+                      CurrencyRates) {
+  return json.IsObject() &&
+      json.HasMember("ETH") &&
+      json.HasMember("LTC") &&
+      json.HasMember("BTC") &&
+      json.HasMember("USD") &&
+      json.HasMember("EUR");
+}
+
+inline void ReadJson(const rapidjson::Value& json,
+                     std::map<std::string, double>* value,
+                     CurrencyRates) {
+  ReadJson(json, value, Plain());
+}
+
+template <>
+struct FieldTable<WALLET_INFO_ST> {
+  static constexpr auto Get() {
+    return std::make_tuple(
+        Required("paymentId", &WALLET_INFO_ST::paymentId_),
+        Required("addressBAT", &WALLET_INFO_ST::addressBAT_),
+        Required("addressBTC", &WALLET_INFO_ST::addressBTC_),
+        Required("addressCARD_ID", &WALLET_INFO_ST::addressCARD_ID_),
+        Required("addressETH", &WALLET_INFO_ST::addressETH_),
+        Required("addressLTC", &WALLET_INFO_ST::addressLTC_),
+        Required<Base64>("keyInfoSeed", &WALLET_INFO_ST::keyInfoSeed_));
+  }
+};
+
+template <>
+struct FieldTable<TRANSACTION_BALLOT_ST> {
+  static constexpr auto Get() {
+    return std::make_tuple(
+        Required("publisher", &TRANSACTION_BALLOT_ST::publisher_),
+        Required("offset", &TRANSACTION_BALLOT_ST::offset_));
+  }
+};
+
+template <>
+struct FieldTable<TRANSACTION_ST> {
+  static constexpr auto Get() {
+    return std::make_tuple(
+        Required("viewingId", &TRANSACTION_ST::viewingId_),
+        Required("surveyorId", &TRANSACTION_ST::surveyorId_),
+        Required("contribution_fiat_amount",
+                 &TRANSACTION_ST::contribution_fiat_amount_),
+        Required("contribution_fiat_currency",
+                 &TRANSACTION_ST::contribution_fiat_currency_),
+        Required<CurrencyRates>("rates", &TRANSACTION_ST::contribution_rates_),
+        Required("contribution_altcurrency",
+                 &TRANSACTION_ST::contribution_altcurrency_),
+        Required("contribution_probi", &TRANSACTION_ST::contribution_probi_),
+        Required("contribution_fee", &TRANSACTION_ST::contribution_fee_),
+        Required("submissionStamp", &TRANSACTION_ST::submissionStamp_),
+        Required("submissionId", &TRANSACTION_ST::submissionId_),
+        Required("anonizeViewingId", &TRANSACTION_ST::anonizeViewingId_),
+        Required("registrarVK", &TRANSACTION_ST::registrarVK_),
+        Required("masterUserToken", &TRANSACTION_ST::masterUserToken_),
+        Required("surveyorIds", &TRANSACTION_ST::surveyorIds_),
+        Required("votes", &TRANSACTION_ST::votes_),
+        Required("ballots", &TRANSACTION_ST::ballots_));
+  }
+};
+
+// proofBallot_ is not saved, it is made again from prepareBallot_
+template <>
+struct FieldTable<BALLOT_ST> {
+  static constexpr auto Get() {
+    return std::make_tuple(
+        Required("viewingId", &BALLOT_ST::viewingId_),
+        Required("surveyorId", &BALLOT_ST::surveyorId_),
+        Required("publisher", &BALLOT_ST::publisher_),
+        Required("offset", &BALLOT_ST::offset_),
+        Required("prepareBallot", &BALLOT_ST::prepareBallot_),
+        Required("delayStamp", &BALLOT_ST::delayStamp_));
+  }
+};
+
+template <>
+struct FieldTable<BATCH_VOTES_INFO_ST> {
+  static constexpr auto Get() {
+    return std::make_tuple(
+        Required("surveyorId", &BATCH_VOTES_INFO_ST::surveyorId_),
+        Required("proof", &BATCH_VOTES_INFO_ST::proof_));
+  }
+};
+
+template <>
+struct FieldTable<BATCH_VOTES_ST> {
+  static constexpr auto Get() {
+    return std::make_tuple(
+        Required("publisher", &BATCH_VOTES_ST::publisher_),
+        Optional("viewingId", &BATCH_VOTES_ST::viewingId_),
+        Required("batchVotesInfo", &BATCH_VOTES_ST::batchVotesInfo_));
+  }
+};
+
+template <>
+struct FieldTable<REPORT_BALANCE_ST> {
+  static constexpr auto Get() {
+    return std::make_tuple(
+        Required<Probi>("opening_balance", &REPORT_BALANCE_ST::opening_balance_),
+        Required<Probi>("closing_balance", &REPORT_BALANCE_ST::closing_balance_),
+        Required<Probi>("deposits", &REPORT_BALANCE_ST::deposits_),
+        Required<Probi>("grants", &REPORT_BALANCE_ST::grants_),
+        Required<Probi>("earning_from_ads",
+                        &REPORT_BALANCE_ST::earning_from_ads_),
+        Required<Probi>("auto_contribute", &REPORT_BALANCE_ST::auto_contribute_),
+        Required<Probi>("recurring_donation",
+                        &REPORT_BALANCE_ST::recurring_donation_),
+        Required<Probi>("one_time_donation",
+                        &REPORT_BALANCE_ST::one_time_donation_),
+        Required<Probi>("total", &REPORT_BALANCE_ST::total_));
+  }
+};
+
+// The key of min_publisher_duration_ is misspelled in saved states
+template <>
+struct FieldTable<PUBLISHER_STATE_ST> {
+  static constexpr auto Get() {
+    return std::make_tuple(
+        Required<AsUint>("min_pubslisher_duration",
+                         &PUBLISHER_STATE_ST::min_publisher_duration_),
+        Required("min_visits", &PUBLISHER_STATE_ST::min_visits_),
+        Required("num_excluded_sites",
+                 &PUBLISHER_STATE_ST::num_excluded_sites_),
+        Required("allow_non_verified",
+                 &PUBLISHER_STATE_ST::allow_non_verified_),
+        Required("pubs_load_timestamp",
+                 &PUBLISHER_STATE_ST::pubs_load_timestamp_),
+        Optional("pubs_list_etag", &PUBLISHER_STATE_ST::pubs_list_etag_),
+        Optional("pubs_list_last_modified",
+                 &PUBLISHER_STATE_ST::pubs_list_last_modified_),
+        Required("allow_videos", &PUBLISHER_STATE_ST::allow_videos_),
+        Required<KeyedArray>("monthly_balances",
+                             &PUBLISHER_STATE_ST::monthly_balances_),
+        Required<KeyedArray>("recurring_donation",
+                             &PUBLISHER_STATE_ST::recurring_donation_));
+  }
+};
+
+template <>
+struct FieldTable<PUBLISHER_ST> {
+  static constexpr auto Get() {
+    return std::make_tuple(
+        Required("id", &PUBLISHER_ST::id_),
+        Required("duration", &PUBLISHER_ST::duration_),
+        Required("score", &PUBLISHER_ST::score_),
+        Required("visits", &PUBLISHER_ST::visits_),
+        Required("percent", &PUBLISHER_ST::percent_),
+        Required("weight", &PUBLISHER_ST::weight_));
+  }
+};
+
+template <>
+struct FieldTable<SURVEYOR_INFO_ST> {
+  static constexpr auto Get() {
+    return std::make_tuple(
+        Required("surveyorId", &SURVEYOR_INFO_ST::surveyorId_));
+  }
+};
+
+template <>
+struct FieldTable<SURVEYOR_ST> {
+  static constexpr auto Get() {
+    return std::make_tuple(
+        Required("signature", &SURVEYOR_ST::signature_),
+        Required("surveyorId", &SURVEYOR_ST::surveyorId_),
+        Required("surveyVK", &SURVEYOR_ST::surveyVK_),
+        Required("registrarVK", &SURVEYOR_ST::registrarVK_),
+        Optional("surveySK", &SURVEYOR_ST::surveySK_));
+  }
+};
+
+template <>
+struct FieldTable<RECONCILE_DIRECTION> {
+  static constexpr auto Get() {
+    return std::make_tuple(
+        Required("amount", &RECONCILE_DIRECTION::amount_),
+        Required("publisher_key", &RECONCILE_DIRECTION::publisher_key_),
+        Required("currency", &RECONCILE_DIRECTION::currency_));
+  }
+};
+
+template <>
+struct FieldTable<CURRENT_RECONCILE> {
+  static constexpr auto Get() {
+    return std::make_tuple(
+        Required("viewingId", &CURRENT_RECONCILE::viewingId_),
+        Optional("anonizeViewingId", &CURRENT_RECONCILE::anonizeViewingId_),
+        Optional("registrarVK", &CURRENT_RECONCILE::registrarVK_),
+        Optional("preFlight", &CURRENT_RECONCILE::preFlight_),
+        Optional("masterUserToken", &CURRENT_RECONCILE::masterUserToken_),
+        Optional("surveyorInfo", &CURRENT_RECONCILE::surveyorInfo_),
+        Optional("timestamp", &CURRENT_RECONCILE::timestamp_),
+        Optional("amount", &CURRENT_RECONCILE::amount_),
+        Optional("currency", &CURRENT_RECONCILE::currency_),
+        Required("fee", &CURRENT_RECONCILE::fee_),
+        Required("category", &CURRENT_RECONCILE::category_),
+        Optional("rates", &CURRENT_RECONCILE::rates_),
+        Optional("directions", &CURRENT_RECONCILE::directions_),
+        Optional("list", &CURRENT_RECONCILE::list_),
+        Optional("retry_step", &CURRENT_RECONCILE::retry_step_),
+        Optional("retry_level", &CURRENT_RECONCILE::retry_level_),
+        Optional("destination", &CURRENT_RECONCILE::destination_),
+        Optional("proof", &CURRENT_RECONCILE::proof_));
+  }
+};
+
+template <>
+struct FieldTable<CLIENT_STATE_ST> {
+  static constexpr auto Get() {
+    return std::make_tuple(
+        Required("walletInfo", &CLIENT_STATE_ST::walletInfo_),
+        Required("bootStamp", &CLIENT_STATE_ST::bootStamp_),
+        Required("reconcileStamp", &CLIENT_STATE_ST::reconcileStamp_),
+        Optional("last_grant_fetch_stamp",
+                 &CLIENT_STATE_ST::last_grant_fetch_stamp_),
+        Required("personaId", &CLIENT_STATE_ST::personaId_),
+        Required("userId", &CLIENT_STATE_ST::userId_),
+        Required("registrarVK", &CLIENT_STATE_ST::registrarVK_),
+        Required("masterUserToken", &CLIENT_STATE_ST::masterUserToken_),
+        Required("preFlight", &CLIENT_STATE_ST::preFlight_),
+        Required("fee_currency", &CLIENT_STATE_ST::fee_currency_),
+        Required("settings", &CLIENT_STATE_ST::settings_),
+        Required("fee_amount", &CLIENT_STATE_ST::fee_amount_),
+        Required("user_changed_fee", &CLIENT_STATE_ST::user_changed_fee_),
+        Required("days", &CLIENT_STATE_ST::days_),
+        Required("rewards_enabled", &CLIENT_STATE_ST::rewards_enabled_),
+        Required("auto_contribute", &CLIENT_STATE_ST::auto_contribute_),
+        Required("transactions", &CLIENT_STATE_ST::transactions_),
+        Required("ballots", &CLIENT_STATE_ST::ballots_),
+        Required("ruleset", &CLIENT_STATE_ST::ruleset_),
+        Required("rulesetV2", &CLIENT_STATE_ST::rulesetV2_),
+        Required("batch", &CLIENT_STATE_ST::batch_),
+        Optional("current_reconciles",
+                 &CLIENT_STATE_ST::current_reconciles_));
+  }
+};
+
+// Same names as in the client state, which held the history before
+template <>
+struct FieldTable<CLIENT_HISTORY_ST> {
+  static constexpr auto Get() {
+    return std::make_tuple(
+        Required("transactions", &CLIENT_HISTORY_ST::transactions_));
+  }
+};
+
+// The twitch event is saved flattened into the media publisher
+template <>
+struct FieldTable<MEDIA_PUBLISHER_INFO> {
+  static constexpr auto Get() {
+    return std::make_tuple(
+        Required("publisherName", &MEDIA_PUBLISHER_INFO::publisherName_),
+        Required("publisherURL", &MEDIA_PUBLISHER_INFO::publisherURL_),
+        Required("favIconURL", &MEDIA_PUBLISHER_INFO::favIconURL_),
+        Required("channelName", &MEDIA_PUBLISHER_INFO::channelName_),
+        Required("publisherId", &MEDIA_PUBLISHER_INFO::publisher_id_),
+        Required("twitch_event", &MEDIA_PUBLISHER_INFO::twitchEventInfo_,
+                 &TWITCH_EVENT_INFO::event_),
+        Required("twitch_time", &MEDIA_PUBLISHER_INFO::twitchEventInfo_,
+                 &TWITCH_EVENT_INFO::time_),
+        Required("twitch_status", &MEDIA_PUBLISHER_INFO::twitchEventInfo_,
+                 &TWITCH_EVENT_INFO::status_));
+  }
+};
+
+}  // namespace braveledger_bat_helper
+
+#endif  // BRAVELEDGER_BAT_HELPER_FIELDS_H_
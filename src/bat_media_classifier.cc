@@ -0,0 +1,178 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "bat_media_classifier.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "bat_helper_platform.h"
+#include "static_values.h"
+
+namespace braveledger_bat_get_media {
+
+namespace {
+
+const char kMediaScheme[] = "https://";
+
+// Rules are checked in this order, first matching rule wins
+const MediaUrlRule kMediaUrlRules[] = {
+  {"m.youtube.com", false, "/api/stats/watchtime?", YOUTUBE_MEDIA_TYPE, false},
+  {"www.youtube.com", false, "/api/stats/watchtime?", YOUTUBE_MEDIA_TYPE, false},
+  {"ttvnw.net", true, "/v1/segment/", TWITCH_MEDIA_TYPE, true},
+};
+
+const MediaPageRule kMediaPageRules[] = {
+  {TWITCH_MEDIA_TYPE, "https://www.twitch.tv/", nullptr},
+  {TWITCH_MEDIA_TYPE, "https://m.twitch.tv/", nullptr},
+  {TWITCH_MEDIA_TYPE, nullptr, "https://player.twitch.tv/"},
+};
+
+bool StartsWith(const std::string& value, const char* prefix) {
+  return prefix && value.compare(0, strlen(prefix), prefix) == 0;
+}
+
+}  // namespace
+
+// static
+const MediaClassifier& MediaClassifier::GetInstance() {
+  static const MediaClassifier* classifier = new MediaClassifier(
+      kMediaUrlRules,
+      sizeof(kMediaUrlRules) / sizeof(kMediaUrlRules[0]),
+      kMediaPageRules,
+      sizeof(kMediaPageRules) / sizeof(kMediaPageRules[0]));
+  return *classifier;
+}
+
+MediaClassifier::MediaClassifier(const MediaUrlRule* url_rules,
+                                 size_t url_rules_size,
+                                 const MediaPageRule* page_rules,
+                                 size_t page_rules_size) :
+  url_rules_(url_rules),
+  url_rules_size_(url_rules_size),
+  page_rules_(page_rules),
+  page_rules_size_(page_rules_size),
+  classes_size_(1) {
+  // rules are kept in 32 bit masks
+  DCHECK(url_rules_size_ <= 32);
+
+  memset(classes_, 0, sizeof(classes_));
+  for (size_t i = 0; i < url_rules_size_; i++) {
+    for (const char* c = url_rules_[i].host; *c; c++) {
+      uint8_t& cls = classes_[static_cast<uint8_t>(*c)];
+      if (cls == 0) {
+        cls = static_cast<uint8_t>(classes_size_++);
+      }
+    }
+  }
+
+  // root node
+  children_.resize(classes_size_, 0);
+  exact_rules_.push_back(0);
+  subdomain_rules_.push_back(0);
+
+  for (size_t i = 0; i < url_rules_size_; i++) {
+    AddHost(url_rules_[i].host, i);
+  }
+}
+
+MediaClassifier::~MediaClassifier() {}
+
+void MediaClassifier::AddHost(const char* host, size_t rule) {
+  size_t node = 0;
+  for (size_t i = strlen(host); i > 0; i--) {
+    size_t index = node * classes_size_ + classes_[static_cast<uint8_t>(host[i - 1])];
+    if (children_[index] == 0) {
+      children_[index] = static_cast<uint16_t>(exact_rules_.size());
+      children_.resize(children_.size() + classes_size_, 0);
+      exact_rules_.push_back(0);
+      subdomain_rules_.push_back(0);
+    }
+    node = children_[index];
+  }
+
+  exact_rules_[node] |= 1u << rule;
+  if (url_rules_[rule].include_subdomains) {
+    subdomain_rules_[node] |= 1u << rule;
+  }
+}
+
+uint32_t MediaClassifier::MatchHost(const char* begin, const char* end) const {
+  // host is matched from the end, so that subdomains share the same path
+  uint32_t rules = 0;
+  size_t node = 0;
+  for (const char* c = end; c != begin;) {
+    c--;
+    if (*c == '.') {
+      rules |= subdomain_rules_[node];
+    }
+
+    uint8_t cls = classes_[static_cast<uint8_t>(*c)];
+    if (cls == 0) {
+      return rules;
+    }
+
+    node = children_[node * classes_size_ + cls];
+    if (node == 0) {
+      return rules;
+    }
+  }
+
+  return rules | exact_rules_[node];
+}
+
+bool MediaClassifier::MatchesPage(const char* type,
+                                  const std::string& first_party_url,
+                                  const std::string& referrer) const {
+  for (size_t i = 0; i < page_rules_size_; i++) {
+    if (strcmp(page_rules_[i].type, type) != 0) {
+      continue;
+    }
+
+    if (StartsWith(first_party_url, page_rules_[i].first_party_prefix) ||
+        StartsWith(referrer, page_rules_[i].referrer_prefix)) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+std::string MediaClassifier::GetLinkType(const std::string& url,
+                                         const std::string& first_party_url,
+                                         const std::string& referrer) const {
+  const size_t scheme_length = sizeof(kMediaScheme) - 1;
+  if (url.compare(0, scheme_length, kMediaScheme) != 0) {
+    return "";
+  }
+
+  const char* host = url.data() + scheme_length;
+  const char* end = url.data() + url.length();
+  const char* host_end = std::find(host, end, '/');
+  uint32_t rules = MatchHost(host, host_end);
+  if (rules == 0) {
+    return "";
+  }
+
+  size_t path = host_end - url.data();
+  for (size_t i = 0; i < url_rules_size_; i++) {
+    if (!(rules & (1u << i))) {
+      continue;
+    }
+
+    const MediaUrlRule& rule = url_rules_[i];
+    if (url.compare(path, strlen(rule.path_prefix), rule.path_prefix) != 0) {
+      continue;
+    }
+
+    if (!rule.needs_page ||
+        MatchesPage(rule.type, first_party_url, referrer)) {
+      return rule.type;
+    }
+  }
+
+  return "";
+}
+
+}  // namespace braveledger_bat_get_media
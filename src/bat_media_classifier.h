@@ -0,0 +1,77 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVELEDGER_BAT_MEDIA_CLASSIFIER_H_
+#define BRAVELEDGER_BAT_MEDIA_CLASSIFIER_H_
+
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+namespace braveledger_bat_get_media {
+
+// Request that is reported by media provider, url needs to be
+// https://<host><path_prefix>...
+struct MediaUrlRule {
+  const char* host;
+  bool include_subdomains;
+  const char* path_prefix;
+  const char* type;
+  bool needs_page;  // page also needs to match one of MediaPageRule
+};
+
+// Page that is allowed to report media for the provider
+struct MediaPageRule {
+  const char* type;
+  const char* first_party_prefix;  // can be nullptr
+  const char* referrer_prefix;  // can be nullptr
+};
+
+// Classifies request urls with a trie of reversed rule hosts that is built
+// once from the rule tables. Url is rejected as soon as its host stops
+// matching the trie, so non media requests are usually rejected after
+// a couple of bytes. New providers only need new rules.
+class MediaClassifier {
+ public:
+  static const MediaClassifier& GetInstance();
+
+  MediaClassifier(const MediaUrlRule* url_rules,
+                  size_t url_rules_size,
+                  const MediaPageRule* page_rules,
+                  size_t page_rules_size);
+  ~MediaClassifier();
+
+  // Returns media type or empty string when url is not a media link.
+  // Host ends at the first '/', so a host with an explicit :port never
+  // matches, like with the substring rules this replaced.
+  std::string GetLinkType(const std::string& url,
+                          const std::string& first_party_url,
+                          const std::string& referrer) const;
+
+ private:
+  void AddHost(const char* host, size_t rule);
+  uint32_t MatchHost(const char* begin, const char* end) const;
+  bool MatchesPage(const char* type,
+                   const std::string& first_party_url,
+                   const std::string& referrer) const;
+
+  const MediaUrlRule* url_rules_;
+  size_t url_rules_size_;
+  const MediaPageRule* page_rules_;
+  size_t page_rules_size_;
+
+  // byte -> character class, 0 is used for bytes that are not in any host
+  uint8_t classes_[256];
+  size_t classes_size_;
+  // node * classes_size_ + class -> child node, 0 when there is no child
+  std::vector<uint16_t> children_;
+  // bit masks of the rules which host ends in the node
+  std::vector<uint32_t> exact_rules_;
+  std::vector<uint32_t> subdomain_rules_;
+};
+
+}  // namespace braveledger_bat_get_media
+
+#endif  // BRAVELEDGER_BAT_MEDIA_CLASSIFIER_H_
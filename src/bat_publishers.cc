@@ -7,6 +7,7 @@
 #include <ctime>
 #include <cmath>
 #include <algorithm>
+#include <utility>
 
 #include "bat_helper.h"
 #include "bignum.h"
@@ -31,6 +32,64 @@ using namespace std::placeholders;
 
 namespace braveledger_bat_publishers {
 
+namespace {
+
+// Used as heap order, so that the lowest score is kept in front
+bool HasHigherScore(const ledger::PublisherInfo& a,
+                    const ledger::PublisherInfo& b) {
+  return a.score > b.score;
+}
+
+}  // namespace
+
+struct BatPublishers::PublisherScan {
+  ledger::PublisherInfoFilter filter;
+  size_t max_count;
+  TopPublishersCallback callback;
+  TopPublishers top;
+};
+
+TopPublishers::TopPublishers() : total_scores(.0), count(0) {}
+
+TopPublishers::TopPublishers(TopPublishers&& top) = default;
+
+TopPublishers& TopPublishers::operator=(TopPublishers&& top) = default;
+
+TopPublishers::~TopPublishers() {}
+
+void TopPublishers::Add(const ledger::PublisherInfo& info, size_t max_count) {
+  total_scores += info.score;
+  count++;
+
+  if (list.size() < max_count) {
+    list.push_back(info);
+    std::push_heap(list.begin(), list.end(), HasHigherScore);
+    return;
+  }
+
+  if (!list.empty() && HasHigherScore(info, list.front())) {
+    // lowest score goes to the back, where the new record takes its place
+    std::pop_heap(list.begin(), list.end(), HasHigherScore);
+    if (list.back().percent != 0) {
+      stale.push_back(std::move(list.back()));
+    }
+    list.back() = info;
+    std::push_heap(list.begin(), list.end(), HasHigherScore);
+  } else if (info.percent != 0) {
+    stale.push_back(info);
+  }
+}
+
+void TopPublishers::Finish() {
+  std::sort_heap(list.begin(), list.end(), HasHigherScore);
+  braveledger_bat_helper::normalizeScores(list,
+                                          total_scores,
+                                          count,
+                                          &ledger::PublisherInfo::score,
+                                          &ledger::PublisherInfo::percent,
+                                          &ledger::PublisherInfo::weight);
+}
+
 BatPublishers::BatPublishers(bat_ledger::LedgerImpl* ledger):
   ledger_(ledger),
   state_(new braveledger_bat_helper::PUBLISHER_STATE_ST),
@@ -426,6 +485,19 @@ void BatPublishers::setPublishersLastRefreshTimestamp(uint64_t ts) {
   saveState();
 }
 
+void BatPublishers::setPublishersListValidators(
+    const std::string& etag,
+    const std::string& last_modified) {
+  if (state_->pubs_list_etag_ == etag &&
+      state_->pubs_list_last_modified_ == last_modified) {
+    return;
+  }
+
+  state_->pubs_list_etag_ = etag;
+  state_->pubs_list_last_modified_ = last_modified;
+  saveState();
+}
+
 void BatPublishers::setNumExcludedSites(const unsigned int& amount) {
   state_->num_excluded_sites_ = amount;
   saveState();
@@ -457,6 +529,14 @@ uint64_t BatPublishers::getLastPublishersListLoadTimestamp() const {
   return state_->pubs_load_timestamp_;
 }
 
+std::string BatPublishers::getPublishersListETag() const {
+  return state_->pubs_list_etag_;
+}
+
+std::string BatPublishers::getPublishersListLastModified() const {
+  return state_->pubs_list_last_modified_;
+}
+
 unsigned int BatPublishers::getNumExcludedSites() const {
   return state_->num_excluded_sites_;
 }
@@ -465,91 +545,49 @@ bool BatPublishers::getPublisherAllowVideos() const {
   return state_->allow_videos_;
 }
 
-void BatPublishers::NormalizeContributeWinners(ledger::PublisherInfoList* newList, bool saveData,
-    const braveledger_bat_helper::PublisherList& oldList, uint32_t record) {
-
-  ledger::PublisherInfoList list;
+void BatPublishers::GetTopPublishers(
+    const ledger::PublisherInfoFilter& filter,
+    size_t count,
+    TopPublishersCallback callback) {
+  auto scan = std::make_shared<PublisherScan>();
+  scan->filter = filter;
+  scan->max_count = count;
+  scan->callback = callback;
+  scan->top.list.reserve(count);
+  ledger_->GetPublisherInfoList(0, PUBLISHER_LIST_PAGE_SIZE, filter,
+      std::bind(&BatPublishers::OnPublisherInfoPage, this, scan, _1, _2));
+}
 
-  for(const auto& publisher: oldList) {
-    ledger::PublisherInfo new_publisher;
-    new_publisher.id = publisher.id_;
-    new_publisher.percent = publisher.percent_;
-    new_publisher.weight = publisher.weight_;
-    new_publisher.duration = publisher.duration_;
-    new_publisher.score = publisher.score_;
-    new_publisher.visits = publisher.visits_;
+void BatPublishers::OnPublisherInfoPage(std::shared_ptr<PublisherScan> scan,
+                                        const ledger::PublisherInfoList& list,
+                                        uint32_t next_record) {
+  for (const auto& info : list) {
+    scan->top.Add(info, scan->max_count);
+  }
 
-    list.push_back(new_publisher);
+  if (next_record == 0 || list.size() < PUBLISHER_LIST_PAGE_SIZE) {
+    scan->top.Finish();
+    scan->callback(std::move(scan->top));
+    return;
   }
 
-  synopsisNormalizerInternal(newList, saveData, list, record);
+  ledger_->GetPublisherInfoList(next_record, PUBLISHER_LIST_PAGE_SIZE,
+      scan->filter,
+      std::bind(&BatPublishers::OnPublisherInfoPage, this, scan, _1, _2));
 }
 
-void BatPublishers::synopsisNormalizerInternal(ledger::PublisherInfoList* newList, bool saveData,
-    const ledger::PublisherInfoList& oldList, uint32_t /* next_record */) {
-  // TODO SZ: We can pass non const value here to avoid copying
-  ledger::PublisherInfoList list = oldList;
-  if (list.size() == 0) {
-    return;
-  }
-  double totalScores = 0.0;
-  for (size_t i = 0; i < list.size(); i++) {
-    totalScores += list[i].score;
-  }
-  std::vector<unsigned int> percents;
-  std::vector<double> weights;
-  std::vector<double> realPercents;
-  std::vector<double> roundoffs;
-  unsigned int totalPercents = 0;
-  for (size_t i = 0; i < list.size(); i++) {
-    realPercents.push_back((double)list[i].score / (double)totalScores * 100.0);
-    percents.push_back((unsigned int)std::lround(realPercents[realPercents.size() - 1]));
-    double roundoff = percents[percents.size() - 1] - realPercents[realPercents.size() - 1];
-    if (roundoff < 0.0) {
-      roundoff *= -1.0;
-    }
-    roundoffs.push_back(roundoff);
-    totalPercents += percents[percents.size() - 1];
-    weights.push_back((double)list[i].score / (double)list.size() * 100.0);
-  }
-  while (totalPercents != 100) {
-    size_t valueToChange = 0;
-    double currentRoundOff = 0.0;
-    for (size_t i = 0; i < percents.size(); i++) {
-      if (0 == i) {
-        currentRoundOff = roundoffs[i];
-        continue;
-      }
-      if (roundoffs[i] > currentRoundOff) {
-        currentRoundOff = roundoffs[i];
-        valueToChange = i;
-      }
-    }
-    if (0 != percents.size()) {
-      if (totalPercents > 100) {
-        percents[valueToChange] -= 1;
-        totalPercents -= 1;
-      } else {
-        percents[valueToChange] += 1;
-        totalPercents += 1;
-      }
-      roundoffs[valueToChange] = 0;
-    }
+void BatPublishers::synopsisNormalizerInternal(TopPublishers top) {
+  for (auto& info : top.stale) {
+    info.percent = 0;
+    info.weight = info.score / top.count * 100.0;
+    top.list.push_back(std::move(info));
   }
-  size_t currentValue = 0;
-  for (size_t i = 0; i < list.size(); i++) {
-    list[i].percent = percents[currentValue];
-    list[i].weight = weights[currentValue];
-    currentValue++;
-    if (saveData) {
-      std::unique_ptr<ledger::PublisherInfo> publisher_info;
-      publisher_info.reset(new ledger::PublisherInfo(list[i]));
-      ledger_->SetPublisherInfo(std::move(publisher_info),
-        std::bind(&onVisitSavedDummy, _1, _2));
-    }
-    if (newList) {
-      newList->push_back(list[i]);
-    }
+
+  for (auto& info : top.list) {
+    std::unique_ptr<ledger::PublisherInfo> publisher_info(
+        new ledger::PublisherInfo(std::move(info)));
+    ledger_->SetPublisherInfo(std::move(publisher_info),
+      std::bind(&onVisitSavedDummy, _1, _2));
   }
 }
 
@@ -561,10 +599,9 @@ void BatPublishers::synopsisNormalizer(const ledger::PublisherInfo& info) {
       ledger::PUBLISHER_EXCLUDE_FILTER::FILTER_ALL_EXCEPT_EXCLUDED,
       true,
       ledger_->GetReconcileStamp());
-  // TODO SZ: We pull the whole list currently, I don't think it consumes lots of RAM, but could.
-  // We need to limit it and iterate.
-  ledger_->GetPublisherInfoList(0, 0, filter, std::bind(&BatPublishers::synopsisNormalizerInternal, this,
-          nullptr, true, _1, _2));
+  // only publishers that get percent are saved, the others keep no percent
+  GetTopPublishers(filter, TOP_PUBLISHERS_COUNT,
+      std::bind(&BatPublishers::synopsisNormalizerInternal, this, _1));
 }
 
 bool BatPublishers::isVerified(const std::string& publisher_id) {
@@ -701,21 +738,33 @@ std::map<std::string, ledger::BalanceReportInfo> BatPublishers::getAllBalanceRep
 }
 
 void BatPublishers::saveState() {
-  std::string data;
-  braveledger_bat_helper::saveToJsonString(*state_, data);
-  ledger_->SavePublisherState(data, this);
+  braveledger_bat_helper::saveToJsonString(*state_, state_json_);
+  ledger_->SavePublisherState(state_json_, this);
 }
 
 bool BatPublishers::loadState(const std::string& data) {
-  braveledger_bat_helper::PUBLISHER_STATE_ST state;
-  if (!braveledger_bat_helper::loadFromJson(state, data.c_str()))
+  std::unique_ptr<braveledger_bat_helper::PUBLISHER_STATE_ST> state(
+      new braveledger_bat_helper::PUBLISHER_STATE_ST());
+  if (!parseState(data, state.get()))
     return false;
 
-  state_.reset(new braveledger_bat_helper::PUBLISHER_STATE_ST(state));
-  calcScoreConsts();
+  setState(std::move(state));
   return true;
 }
 
+// static
+bool BatPublishers::parseState(const std::string& data,
+    braveledger_bat_helper::PUBLISHER_STATE_ST* state) {
+  return braveledger_bat_helper::loadFromJson(*state, data.c_str());
+}
+
+void BatPublishers::setState(
+    std::unique_ptr<braveledger_bat_helper::PUBLISHER_STATE_ST> state) {
+  DCHECK(state);
+  state_ = std::move(state);
+  calcScoreConsts();
+}
+
 void BatPublishers::OnPublisherStateSaved(ledger::Result result) {
   if (result != ledger::Result::LEDGER_OK) {
     BLOG(ledger_, ledger::LogLevel::LOG_ERROR) <<
@@ -741,9 +790,9 @@ std::vector<ledger::ContributionInfo> BatPublishers::GetRecurringDonationList()
   return res;
 }
 
-void BatPublishers::RefreshPublishersList(const std::string& json) {
+bool BatPublishers::RefreshPublishersList(const std::string& json) {
   ledger_->SavePublishersList(json);
-  loadPublisherList(json);
+  return loadPublisherList(json);
 }
 
 void BatPublishers::OnPublishersListSaved(ledger::Result result) {
@@ -753,15 +802,28 @@ void BatPublishers::OnPublishersListSaved(ledger::Result result) {
 
 bool BatPublishers::loadPublisherList(const std::string& data) {
   std::map<std::string, braveledger_bat_helper::SERVER_LIST> list;
-  bool success = braveledger_bat_helper::getJSONServerList(data, list);
+  bool success = parsePublisherList(data, &list);
 
   if (success) {
-    server_list_ = std::map<std::string, braveledger_bat_helper::SERVER_LIST>(list);
+    setPublisherList(&list);
   }
 
   return success;
 }
 
+// static
+bool BatPublishers::parsePublisherList(
+    const std::string& data,
+    std::map<std::string, braveledger_bat_helper::SERVER_LIST>* list) {
+  return braveledger_bat_helper::getJSONServerList(data, *list);
+}
+
+// Takes the entries of |list|
+void BatPublishers::setPublisherList(
+    std::map<std::string, braveledger_bat_helper::SERVER_LIST>* list) {
+  server_list_.swap(*list);
+}
+
 void BatPublishers::getPublisherActivityFromUrl(uint64_t windowId, const ledger::VisitData& visit_data) {
   if ((visit_data.domain == YOUTUBE_TLD || visit_data.domain == TWITCH_TLD) &&
       visit_data.path != "" && visit_data.path != "/") {
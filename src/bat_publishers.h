@@ -5,6 +5,7 @@
 #ifndef BRAVELEDGER_BAT_PUBLISHERS_H_
 #define BRAVELEDGER_BAT_PUBLISHERS_H_
 
+#include <functional>
 #include <string>
 #include <map>
 #include <memory>
@@ -26,6 +27,31 @@ struct PUBLISHER_STATE_ST;
 
 namespace braveledger_bat_publishers {
 
+// Result of the paged scan over publisher info
+struct TopPublishers {
+  TopPublishers();
+  TopPublishers(TopPublishers&& top);
+  TopPublishers& operator=(TopPublishers&& top);
+  ~TopPublishers();
+
+  // Counts the record and keeps it when it's one of |max_count| records
+  // with the highest score so far
+  void Add(const ledger::PublisherInfo& info, size_t max_count);
+  // Sorts |list| once all the records were added and sets its percent and
+  // weight against the totals of all of them, the same as normalizing the
+  // complete list would
+  void Finish();
+
+  // publishers with the highest score, sorted by score
+  ledger::PublisherInfoList list;
+  // publishers left out of |list| which still have percent set
+  ledger::PublisherInfoList stale;
+  double total_scores;
+  uint32_t count;
+};
+
+using TopPublishersCallback = std::function<void(TopPublishers)>;
+
 class BatPublishers : public ledger::LedgerCallbackHandler {
  public:
 
@@ -35,6 +61,12 @@ class BatPublishers : public ledger::LedgerCallbackHandler {
 
   bool loadState(const std::string& data);
 
+  // Parsing is split from taking the result, so that it can run on an IO
+  // thread while the ledger thread goes on with the startup
+  static bool parseState(const std::string& data,
+                         braveledger_bat_helper::PUBLISHER_STATE_ST* state);
+  void setState(std::unique_ptr<braveledger_bat_helper::PUBLISHER_STATE_ST> state);
+
   void saveVisit(const std::string& publisher_id,
                  const ledger::VisitData& visit_data,
                  const uint64_t& duration);
@@ -50,6 +82,10 @@ class BatPublishers : public ledger::LedgerCallbackHandler {
 
   void setPublishersLastRefreshTimestamp(uint64_t ts);
 
+  // Validators of the saved publishers list
+  void setPublishersListValidators(const std::string& etag,
+                                   const std::string& last_modified);
+
   void setNumExcludedSites(const unsigned int& amount);
 
   void setExclude(const std::string& publisher_id, const ledger::PUBLISHER_EXCLUDE& exclude);
@@ -72,6 +108,8 @@ class BatPublishers : public ledger::LedgerCallbackHandler {
   unsigned int getPublisherMinVisits() const;
   bool getPublisherAllowNonVerified() const;
   uint64_t getLastPublishersListLoadTimestamp() const;
+  std::string getPublishersListETag() const;
+  std::string getPublishersListLastModified() const;
   unsigned int getNumExcludedSites() const;
   bool getPublisherAllowVideos() const;
 
@@ -81,12 +119,18 @@ class BatPublishers : public ledger::LedgerCallbackHandler {
   std::string GetBalanceReportName(ledger::PUBLISHER_MONTH month, int year);
   std::vector<ledger::ContributionInfo> GetRecurringDonationList();
 
-  void RefreshPublishersList(const std::string & pubs_list);
+  bool RefreshPublishersList(const std::string & pubs_list);
 
   void OnPublishersListSaved(ledger::Result result) override;
 
   bool loadPublisherList(const std::string& data);
 
+  static bool parsePublisherList(
+      const std::string& data,
+      std::map<std::string, braveledger_bat_helper::SERVER_LIST>* list);
+  void setPublisherList(
+      std::map<std::string, braveledger_bat_helper::SERVER_LIST>* list);
+
   void getPublisherActivityFromUrl(uint64_t windowId,const ledger::VisitData& visit_data);
   void getPublisherBanner(const std::string& publisher_id,
                           ledger::PublisherBannerCallback callback);
@@ -126,11 +170,15 @@ class BatPublishers : public ledger::LedgerCallbackHandler {
       const uint64_t& currentReconcileStamp);
 
   void clearAllBalanceReports();
-  void NormalizeContributeWinners(
-      ledger::PublisherInfoList* newList,
-      bool saveData,
-      const braveledger_bat_helper::PublisherList& list,
-      uint32_t /* next_record */);
+
+  double concaveScore(const uint64_t& duration);
+
+  // Goes through publisher info of |filter| page by page and keeps only
+  // |count| publishers with the highest score, so memory use doesn't grow
+  // with the number of visited sites
+  void GetTopPublishers(const ledger::PublisherInfoFilter& filter,
+                        size_t count,
+                        TopPublishersCallback callback);
 
  private:
 
@@ -174,15 +222,17 @@ class BatPublishers : public ledger::LedgerCallbackHandler {
 
   void onRestorePublishersInternal(const ledger::PublisherInfoList& publisherInfoList, uint32_t /* next_record */);
 
-  double concaveScore(const uint64_t& duration);
-
   void saveState();
 
   void calcScoreConsts();
 
   void synopsisNormalizer(const ledger::PublisherInfo& info);
-  void synopsisNormalizerInternal(ledger::PublisherInfoList* newList, bool saveData,
-    const ledger::PublisherInfoList& list, uint32_t /* next_record */);
+  void synopsisNormalizerInternal(TopPublishers top);
+
+  struct PublisherScan;
+  void OnPublisherInfoPage(std::shared_ptr<PublisherScan> scan,
+                           const ledger::PublisherInfoList& list,
+                           uint32_t next_record);
 
   bool isPublisherVisible(const braveledger_bat_helper::PUBLISHER_ST& publisher_st);
 
@@ -202,6 +252,9 @@ class BatPublishers : public ledger::LedgerCallbackHandler {
 
   std::unique_ptr<braveledger_bat_helper::PUBLISHER_STATE_ST> state_;
 
+  // last saved state, kept so the next save reuses its capacity
+  std::string state_json_;
+
   std::map<std::string, braveledger_bat_helper::SERVER_LIST> server_list_;
 
   unsigned int a_;
@@ -3,29 +3,61 @@
  * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
 
 #include "bat_state.h"
+#include "bat_binary_fields.h"
+#include "bat_helper_fields.h"
 #include "ledger_impl.h"
 #include "rapidjson_bat_helper.h"
 #include <algorithm>
+#include <utility>
 
 namespace braveledger_bat_state {
 
+namespace {
+
+// states saved before the history had its own record still hold it
+bool HoldsHistory(const braveledger_bat_helper::CLIENT_STATE_ST& state) {
+  return !state.transactions_.empty();
+}
+
+}  // namespace
+
 BatState::BatState(bat_ledger::LedgerImpl* ledger) :
       ledger_(ledger),
-      state_(new braveledger_bat_helper::CLIENT_STATE_ST()) {
+      state_(new braveledger_bat_helper::CLIENT_STATE_ST()),
+      history_loaded_(false),
+      history_failed_(false) {
 }
 
 BatState::~BatState() {
 }
 
 bool BatState::LoadState(const std::string& data) {
-  braveledger_bat_helper::CLIENT_STATE_ST state;
-  if (!braveledger_bat_helper::loadFromJson(state, data.c_str())) {
+  std::unique_ptr<braveledger_bat_helper::CLIENT_STATE_ST> state(
+      new braveledger_bat_helper::CLIENT_STATE_ST());
+  if (!ParseState(data, state.get())) {
     BLOG(ledger_, ledger::LogLevel::LOG_ERROR) <<
-      "Failed to load client state: " << data;
+      "Failed to load client state: " << bat_ledger::LogPayload(data);
     return false;
   }
 
-  state_.reset(new braveledger_bat_helper::CLIENT_STATE_ST(state));
+  SetState(std::move(state));
+  return true;
+}
+
+// static
+bool BatState::ParseState(const std::string& data,
+                          braveledger_bat_helper::CLIENT_STATE_ST* state) {
+  if (braveledger_bat_helper::IsBinaryState(data)) {
+    return braveledger_bat_helper::LoadFromBinaryString(data, state);
+  }
+
+  return braveledger_bat_helper::loadFromJson(*state, data.c_str());
+}
+
+void BatState::SetState(
+    std::unique_ptr<braveledger_bat_helper::CLIENT_STATE_ST> state) {
+  DCHECK(state);
+  state_ = std::move(state);
 
   bool stateChanged = false;
 
@@ -44,14 +76,105 @@ bool BatState::LoadState(const std::string& data) {
   if (stateChanged) {
     SaveState();
   }
+}
 
-  return true;
+// static
+bool BatState::ParseHistory(
+    const std::string& data,
+    braveledger_bat_helper::CLIENT_HISTORY_ST* history) {
+  if (braveledger_bat_helper::IsBinaryState(data)) {
+    return braveledger_bat_helper::LoadFromBinaryString(data, history);
+  }
+
+  return braveledger_bat_helper::loadFromJson(*history, data.c_str());
+}
+
+void BatState::SetHistoryData(const std::string& data) {
+  DCHECK(!history_loaded_);
+  history_.reset();
+  history_data_ = data;
+  history_loaded_ = true;
+}
+
+void BatState::SetHistoryFailed() {
+  SetHistoryData(std::string());
+  history_failed_ = true;
+}
+
+bool BatState::HistoryWritable() const {
+  return history_loaded_ && !history_failed_;
 }
 
+braveledger_bat_helper::CLIENT_HISTORY_ST* BatState::GetHistory() {
+  DCHECK(history_loaded_);
+  if (!history_) {
+    history_.reset(new braveledger_bat_helper::CLIENT_HISTORY_ST());
+    uint64_t start = ledger_->GetMetrics()->StartTime();
+    if (!history_data_.empty() &&
+        !ParseHistory(history_data_, history_.get())) {
+      BLOG(ledger_, ledger::LogLevel::LOG_ERROR) <<
+        "Failed to load client history: " <<
+        bat_ledger::LogPayload(history_data_);
+      history_->transactions_.clear();
+      history_failed_ = true;
+    }
+    ledger_->GetMetrics()->AddTime("state.history.parse", start);
+    std::string().swap(history_data_);
+  }
+
+  // the history of an older state is moved over once the stored one is
+  // there, both are saved once
+  if (HistoryWritable() && HoldsHistory(*state_)) {
+    history_->transactions_.insert(history_->transactions_.end(),
+                                   state_->transactions_.begin(),
+                                   state_->transactions_.end());
+    state_->transactions_.clear();
+    SaveHistory();
+    SaveState();
+  }
+
+  return history_.get();
+}
+
+void BatState::SaveHistory() {
+  DCHECK(history_loaded_);
+  if (history_failed_) {
+    BLOG(ledger_, ledger::LogLevel::LOG_ERROR) <<
+      "Client history is not saved, the stored one couldn't be loaded";
+    return;
+  }
+
+  uint64_t start = ledger_->GetMetrics()->StartTime();
+  if (ledger::binary_state) {
+    braveledger_bat_helper::SaveToBinaryString(*history_, &saved_history_);
+    ledger_->GetMetrics()->AddTime("state.history.save_binary", start);
+  } else {
+    braveledger_bat_helper::saveToJsonString(*history_, saved_history_);
+    ledger_->GetMetrics()->AddTime("state.history.save_json", start);
+  }
+  ledger_->SaveLedgerHistory(saved_history_);
+}
+
+// A state loaded from JSON is saved in the binary format once it is
+// enabled, and the other way round. Its size does not depend on the
+// history, which is saved by SaveHistory(). An older state keeps its
+// history until the stored one is loaded.
 void BatState::SaveState() {
-  std::string data;
-  braveledger_bat_helper::saveToJsonString(*state_, data);
-  ledger_->SaveLedgerState(data);
+  if (HistoryWritable() && HoldsHistory(*state_)) {
+    // moves the history out and saves the state
+    GetHistory();
+    return;
+  }
+
+  uint64_t start = ledger_->GetMetrics()->StartTime();
+  if (ledger::binary_state) {
+    braveledger_bat_helper::SaveToBinaryString(*state_, &saved_state_);
+    ledger_->GetMetrics()->AddTime("state.ledger.save_binary", start);
+  } else {
+    braveledger_bat_helper::saveToJsonString(*state_, saved_state_);
+    ledger_->GetMetrics()->AddTime("state.ledger.save_json", start);
+  }
+  ledger_->SaveLedgerState(saved_state_);
 }
 
 void BatState::AddReconcile(const std::string& viewing_id,
@@ -299,14 +422,14 @@ void BatState::SetDays(unsigned int days) {
   SaveState();
 }
 
-const braveledger_bat_helper::Transactions& BatState::GetTransactions() const {
-  return state_->transactions_;
+const braveledger_bat_helper::Transactions& BatState::GetTransactions() {
+  return GetHistory()->transactions_;
 }
 
 void BatState::SetTransactions(
     const braveledger_bat_helper::Transactions& transactions) {
-  state_->transactions_ = transactions;
-  SaveState();
+  GetHistory()->transactions_ = transactions;
+  SaveHistory();
 }
 
 const braveledger_bat_helper::Ballots& BatState::GetBallots() const {
@@ -23,6 +23,22 @@ class BatState {
 
   bool LoadState(const std::string& data);
 
+  // Parses |data| without touching the current state, so it can run
+  // on an IO thread. SetState() then takes the result on the ledger thread.
+  static bool ParseState(const std::string& data,
+                         braveledger_bat_helper::CLIENT_STATE_ST* state);
+  void SetState(std::unique_ptr<braveledger_bat_helper::CLIENT_STATE_ST> state);
+
+  static bool ParseHistory(const std::string& data,
+                           braveledger_bat_helper::CLIENT_HISTORY_ST* history);
+  // Stored history, empty when there is none. It is only parsed once
+  // transactions are needed, and nothing is moved into it or saved before
+  // it is set.
+  void SetHistoryData(const std::string& data);
+  // The stored history couldn't be loaded. It reads as empty, is not
+  // saved over and an older state keeps its transactions.
+  void SetHistoryFailed();
+
   void AddReconcile(
       const std::string& viewing_id,
       const braveledger_bat_helper::CURRENT_RECONCILE& reconcile);
@@ -111,7 +127,7 @@ class BatState {
 
   void SetDays(unsigned int days);
 
-  const braveledger_bat_helper::Transactions& GetTransactions() const;
+  const braveledger_bat_helper::Transactions& GetTransactions();
 
   void SetTransactions(
       const braveledger_bat_helper::Transactions& transactions);
@@ -145,8 +161,22 @@ class BatState {
  private:
   void SaveState();
 
+  // Parses the stored history on first use
+  braveledger_bat_helper::CLIENT_HISTORY_ST* GetHistory();
+  void SaveHistory();
+  // the stored history is there and could be read
+  bool HistoryWritable() const;
+
   bat_ledger::LedgerImpl* ledger_;  // NOT OWNED
   std::unique_ptr<braveledger_bat_helper::CLIENT_STATE_ST> state_;
+  // last saved state, kept so the next save reuses its capacity
+  std::string saved_state_;
+  // null until |history_data_| is parsed
+  std::unique_ptr<braveledger_bat_helper::CLIENT_HISTORY_ST> history_;
+  std::string history_data_;
+  bool history_loaded_;
+  bool history_failed_;
+  std::string saved_history_;
 };
 
 }  // namespace braveledger_bat_state
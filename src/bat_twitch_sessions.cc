@@ -0,0 +1,183 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "bat_twitch_sessions.h"
+
+#include <functional>
+#include <utility>
+
+#include "bat_helper.h"
+#include "bat_helper_platform.h"
+
+namespace braveledger_bat_get_media {
+
+TwitchEventState::TwitchEventState() :
+  event_(TwitchEvent::NONE),
+  status_(TwitchStatus::NONE),
+  time_(0) {}
+
+TwitchEvent GetTwitchEvent(const std::string& event) {
+  int index = braveledger_bat_helper::getTwitchEventIndex(event);
+  if (index < 0) {
+    return TwitchEvent::NONE;
+  }
+
+  return static_cast<TwitchEvent>(index + 1);
+}
+
+double GetTwitchTime(const std::string& time) {
+  if (time.empty()) {
+    return 0;
+  }
+
+  return braveledger_bat_helper::getDecimalValue(time.c_str(), nullptr);
+}
+
+TwitchSessionTable::Slot::Slot() :
+  hash_(0),
+  last_seen_(0),
+  used_(false) {}
+
+TwitchSessionTable::TwitchSessionTable(size_t max_sessions,
+                                       uint64_t idle_timeout) :
+  mask_(0),
+  size_(0),
+  max_sessions_(max_sessions > 0 ? max_sessions : 1),
+  idle_timeout_(idle_timeout),
+  last_eviction_(0) {
+  // keep load factor under 0.5 so that probing stays short
+  size_t capacity = 8;
+  while (capacity < max_sessions_ * 2) {
+    capacity <<= 1;
+  }
+  slots_.resize(capacity);
+  mask_ = capacity - 1;
+}
+
+TwitchSessionTable::~TwitchSessionTable() {}
+
+TwitchEventState TwitchSessionTable::Get(const std::string& media_key,
+                                         uint64_t now) const {
+  size_t index = Find(media_key, std::hash<std::string>()(media_key));
+  const Slot& slot = slots_[index];
+  if (!slot.used_ || IsExpired(slot, now)) {
+    return TwitchEventState();
+  }
+
+  return slot.state_;
+}
+
+void TwitchSessionTable::Set(const std::string& media_key,
+                             const TwitchEventState& state,
+                             uint64_t now) {
+  if (now - last_eviction_ >= idle_timeout_) {
+    EvictExpired(now);
+  }
+
+  size_t hash = std::hash<std::string>()(media_key);
+  size_t index = Find(media_key, hash);
+
+  if (!slots_[index].used_) {
+    if (size_ >= max_sessions_) {
+      EvictExpired(now);
+      if (size_ >= max_sessions_) {
+        Erase(FindOldest());
+      }
+      // erase shifts entries, so we need to probe again
+      index = Find(media_key, hash);
+    }
+
+    slots_[index].key_ = media_key;
+    slots_[index].hash_ = hash;
+    slots_[index].used_ = true;
+    size_++;
+  }
+
+  slots_[index].state_ = state;
+  slots_[index].last_seen_ = now;
+}
+
+void TwitchSessionTable::Clear() {
+  for (auto& slot : slots_) {
+    slot = Slot();
+  }
+  size_ = 0;
+}
+
+size_t TwitchSessionTable::size() const {
+  return size_;
+}
+
+size_t TwitchSessionTable::Find(const std::string& media_key,
+                                size_t hash) const {
+  size_t index = hash & mask_;
+  while (slots_[index].used_) {
+    if (slots_[index].hash_ == hash && slots_[index].key_ == media_key) {
+      break;
+    }
+    index = (index + 1) & mask_;
+  }
+
+  return index;
+}
+
+size_t TwitchSessionTable::FindOldest() const {
+  size_t oldest = 0;
+  bool found = false;
+  for (size_t i = 0; i < slots_.size(); i++) {
+    if (!slots_[i].used_) {
+      continue;
+    }
+
+    if (!found || slots_[i].last_seen_ < slots_[oldest].last_seen_) {
+      oldest = i;
+      found = true;
+    }
+  }
+
+  DCHECK(found);
+  return oldest;
+}
+
+void TwitchSessionTable::Erase(size_t index) {
+  // backward shift deletion, so that we don't need tombstones
+  size_t hole = index;
+  size_t next = index;
+  while (true) {
+    next = (next + 1) & mask_;
+    if (!slots_[next].used_) {
+      break;
+    }
+
+    size_t home = slots_[next].hash_ & mask_;
+    bool between = (hole <= next) ?
+        (hole < home && home <= next) :
+        (hole < home || home <= next);
+    if (!between) {
+      slots_[hole] = std::move(slots_[next]);
+      hole = next;
+    }
+  }
+
+  slots_[hole] = Slot();
+  size_--;
+}
+
+void TwitchSessionTable::EvictExpired(uint64_t now) {
+  last_eviction_ = now;
+  for (size_t i = 0; i < slots_.size();) {
+    if (slots_[i].used_ && IsExpired(slots_[i], now)) {
+      // entry from the same cluster can be shifted into this slot
+      Erase(i);
+      continue;
+    }
+    i++;
+  }
+}
+
+bool TwitchSessionTable::IsExpired(const Slot& slot, uint64_t now) const {
+  return now > slot.last_seen_ && now - slot.last_seen_ > idle_timeout_;
+}
+
+}  // namespace braveledger_bat_get_media
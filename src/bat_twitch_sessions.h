@@ -0,0 +1,95 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVELEDGER_BAT_TWITCH_SESSIONS_H_
+#define BRAVELEDGER_BAT_TWITCH_SESSIONS_H_
+
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+namespace braveledger_bat_get_media {
+
+// Order matches braveledger_ledger::_twitch_events, NONE is used for
+// a session that didn't receive any event yet
+enum class TwitchEvent : uint8_t {
+  NONE = 0,
+  BUFFER_EMPTY,
+  BUFFER_REFILL,
+  VIDEO_END,
+  MINUTE_WATCHED,
+  VIDEO_PAUSE,
+  PLAYER_CLICK_VOD_SEEK,
+  VIDEO_PLAY,
+  VIDEO_ERROR,
+};
+
+enum class TwitchStatus : uint8_t {
+  NONE = 0,
+  PLAYING,
+  PAUSED,
+};
+
+// Compact form of ledger::TwitchEventInfo that is kept per playback session
+struct TwitchEventState {
+  TwitchEventState();
+
+  TwitchEvent event_;
+  TwitchStatus status_;
+  double time_;
+};
+
+TwitchEvent GetTwitchEvent(const std::string& event);
+
+double GetTwitchTime(const std::string& time);
+
+// Last seen event for every Twitch channel/VOD that is being watched.
+// Open addressing table (linear probing) with a hard cap on the number of
+// sessions. Sessions that were idle longer than |idle_timeout| seconds are
+// dropped, when the table is full the least recently seen session is evicted.
+class TwitchSessionTable {
+ public:
+  TwitchSessionTable(size_t max_sessions, uint64_t idle_timeout);
+  ~TwitchSessionTable();
+
+  // Returns empty state when session doesn't exist or it expired
+  TwitchEventState Get(const std::string& media_key, uint64_t now) const;
+
+  void Set(const std::string& media_key,
+           const TwitchEventState& state,
+           uint64_t now);
+
+  void Clear();
+
+  size_t size() const;
+
+ private:
+  struct Slot {
+    Slot();
+
+    std::string key_;
+    size_t hash_;
+    uint64_t last_seen_;
+    TwitchEventState state_;
+    bool used_;
+  };
+
+  size_t Find(const std::string& media_key, size_t hash) const;
+  size_t FindOldest() const;
+  void Erase(size_t index);
+  void EvictExpired(uint64_t now);
+  bool IsExpired(const Slot& slot, uint64_t now) const;
+
+  std::vector<Slot> slots_;
+  size_t mask_;
+  size_t size_;
+  size_t max_sessions_;
+  uint64_t idle_timeout_;
+  uint64_t last_eviction_;
+};
+
+}  // namespace braveledger_bat_get_media
+
+#endif  // BRAVELEDGER_BAT_TWITCH_SESSIONS_H_
@@ -0,0 +1,134 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "http_signature.h"
+
+#include <string.h>
+
+#include <openssl/curve25519.h>
+#include <openssl/mem.h>
+#include <openssl/sha.h>
+
+#include "bat_codec.h"
+#include "bat_helper_platform.h"
+#include "static_values.h"
+
+namespace bat_ledger {
+
+namespace {
+
+const char kDigestPrefix[] = "SHA-256=";
+const char kDigestKey[] = "digest";
+
+template <size_t N>
+size_t Length(const char (&)[N]) {
+  return N - 1;
+}
+
+}  // namespace
+
+HttpSigner::HttpSigner(const std::string& key_id,
+                       const std::vector<uint8_t>& secret_key) :
+  key_id_(key_id),
+  valid_(secret_key.size() == kSecretKeySize) {
+  memset(secret_key_, 0, sizeof(secret_key_));
+  if (valid_) {
+    memcpy(secret_key_, secret_key.data(), kSecretKeySize);
+  }
+}
+
+HttpSigner::~HttpSigner() {
+  OPENSSL_cleanse(secret_key_, sizeof(secret_key_));
+}
+
+// static
+void HttpSigner::GetDigest(const std::string& body, std::string* digest) {
+  uint8_t hash[SHA256_DIGEST_LENGTH];
+  SHA256_CTX context;
+  SHA256_Init(&context);
+  SHA256_Update(&context, body.data(), body.size());
+  SHA256_Final(hash, &context);
+
+  digest->clear();
+  digest->reserve(Length(kDigestPrefix) +
+                  braveledger_bat_codec::Base64EncodedLength(sizeof(hash)));
+  digest->append(kDigestPrefix, Length(kDigestPrefix));
+  braveledger_bat_codec::AppendBase64(hash, sizeof(hash), digest);
+}
+
+std::vector<uint8_t> HttpSigner::GetPublicKey() const {
+  if (!valid_) {
+    return std::vector<uint8_t>();
+  }
+  const uint8_t* public_key = secret_key_ + kSecretKeySize - kPublicKeySize;
+  return std::vector<uint8_t>(public_key, public_key + kPublicKeySize);
+}
+
+void HttpSigner::Sign(const std::string* keys,
+                      const std::string* values,
+                      size_t size,
+                      std::string* signature) {
+  signature->clear();
+  DCHECK(valid_);
+  if (!valid_) {
+    return;
+  }
+
+  headers_.clear();
+  message_.clear();
+  for (size_t i = 0; i < size; i++) {
+    if (0 != i) {
+      headers_ += ' ';
+      message_ += '\n';
+    }
+    headers_ += keys[i];
+    message_ += keys[i];
+    message_ += ": ";
+    message_ += values[i];
+  }
+
+  uint8_t signed_message[kSignatureSize];
+  ED25519_sign(signed_message,
+               reinterpret_cast<const uint8_t*>(message_.data()),
+               message_.size(),
+               secret_key_);
+
+  const char key_id[] = "keyId=\"";
+  const char algorithm[] = "\",algorithm=\"" SIGNATURE_ALGORITHM;
+  const char headers[] = "\",headers=\"";
+  const char signature_start[] = "\",signature=\"";
+  signature->reserve(Length(key_id) + key_id_.size() + Length(algorithm) +
+                     Length(headers) + headers_.size() +
+                     Length(signature_start) +
+                     braveledger_bat_codec::Base64EncodedLength(
+                         kSignatureSize) + 1);
+  signature->append(key_id, Length(key_id));
+  signature->append(key_id_);
+  signature->append(algorithm, Length(algorithm));
+  signature->append(headers, Length(headers));
+  signature->append(headers_);
+  signature->append(signature_start, Length(signature_start));
+  braveledger_bat_codec::AppendBase64(signed_message, kSignatureSize,
+                                      signature);
+  signature->push_back('"');
+}
+
+void HttpSigner::SignDigest(const std::string& digest,
+                            std::string* signature) {
+  const std::string key(kDigestKey);
+  Sign(&key, &digest, 1, signature);
+}
+
+void HttpSigner::SignBodies(const std::vector<std::string>& bodies,
+                            std::vector<SignedRequest>* requests) {
+  requests->resize(bodies.size());
+  const std::string key(kDigestKey);
+  for (size_t i = 0; i < bodies.size(); i++) {
+    SignedRequest& request = (*requests)[i];
+    GetDigest(bodies[i], &request.digest);
+    Sign(&key, &request.digest, 1, &request.signature);
+  }
+}
+
+}  // namespace bat_ledger
@@ -0,0 +1,66 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef BAT_LEDGER_HTTP_SIGNATURE_H_
+#define BAT_LEDGER_HTTP_SIGNATURE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+namespace bat_ledger {
+
+// Digest and signature headers of one signed request body
+struct SignedRequest {
+  std::string digest;  // "SHA-256=<base64>"
+  std::string signature;  // keyId="...",algorithm="ed25519",headers=...
+};
+
+// Builds the http signature headers the ledger server checks on persona
+// registration and reconcile payloads. Signatures are detached ed25519,
+// so the message is never copied into a signed message buffer, and every
+// header is written into one buffer sized up front. The message buffer is
+// kept between calls, one signer can sign any number of bodies.
+class HttpSigner {
+ public:
+  // |secret_key| is the 64 byte key of getPublicKeyFromSeed
+  HttpSigner(const std::string& key_id, const std::vector<uint8_t>& secret_key);
+  ~HttpSigner();
+
+  // SHA-256 of |body| as the value of the digest header
+  static void GetDigest(const std::string& body, std::string* digest);
+
+  // Signs "key: value" lines of |size| headers
+  void Sign(const std::string* keys,
+            const std::string* values,
+            size_t size,
+            std::string* signature);
+  // Signs the digest header alone, what both requests send
+  void SignDigest(const std::string& digest, std::string* signature);
+  // Digest and signature of every body in |bodies|
+  void SignBodies(const std::vector<std::string>& bodies,
+                  std::vector<SignedRequest>* requests);
+
+  // The last 32 bytes of the secret key
+  std::vector<uint8_t> GetPublicKey() const;
+
+  bool is_valid() const { return valid_; }
+
+ private:
+  static const size_t kSecretKeySize = 64;
+  static const size_t kPublicKeySize = 32;
+  static const size_t kSignatureSize = 64;
+
+  std::string key_id_;
+  uint8_t secret_key_[kSecretKeySize];
+  bool valid_;
+  std::string headers_;
+  std::string message_;
+};
+
+}  // namespace bat_ledger
+
+#endif  // BAT_LEDGER_HTTP_SIGNATURE_H_
@@ -0,0 +1,533 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "ledger_client_recorder_impl.h"
+
+#include <utility>
+
+#include "bat_helper.h"
+#include "bat_state.h"
+#include "ledger_trace.h"
+#include "rapidjson_bat_helper.h"
+
+namespace ledger {
+
+// static
+LedgerClientRecorder* LedgerClientRecorder::Create(LedgerClient* client,
+                                                   std::ostream* trace) {
+  return new bat_ledger::LedgerClientRecorderImpl(client, trace);
+}
+
+}  // namespace ledger
+
+namespace bat_ledger {
+
+namespace {
+
+// The wallet seed and ids are left out, the rest of the state is kept so
+// that it can be replayed. A state that doesn't parse is recorded empty,
+// it fails to load on replay the same way.
+std::string RedactLedgerState(const std::string& data) {
+  braveledger_bat_helper::CLIENT_STATE_ST state;
+  if (!braveledger_bat_state::BatState::ParseState(data, &state)) {
+    return std::string();
+  }
+
+  state.walletInfo_ = braveledger_bat_helper::WALLET_INFO_ST();
+  std::string json;
+  braveledger_bat_helper::saveToJsonString(state, json);
+  return json;
+}
+
+}  // namespace
+
+class LedgerClientRecorderImpl::TraceHandler :
+    public ledger::LedgerCallbackHandler {
+ public:
+  TraceHandler(LedgerClientRecorderImpl* recorder,
+               uint64_t call,
+               ledger::LedgerCallbackHandler* handler) :
+    recorder_(recorder),
+    call_(call),
+    handler_(handler) {}
+
+  ~TraceHandler() override {}
+
+  void OnLedgerStateLoaded(ledger::Result result,
+                           const std::string& data) override {
+    recorder_->RecordResult("OnLedgerStateLoaded", call_,
+                            {std::to_string(result), RedactLedgerState(data)});
+    handler_->OnLedgerStateLoaded(result, data);
+    recorder_->OnHandlerDone(call_);
+  }
+
+  void OnLedgerStateSaved(ledger::Result result) override {
+    recorder_->RecordResult("OnLedgerStateSaved", call_,
+                            {std::to_string(result)});
+    handler_->OnLedgerStateSaved(result);
+    recorder_->OnHandlerDone(call_);
+  }
+
+  void OnLedgerHistoryLoaded(ledger::Result result,
+                             const std::string& data) override {
+    recorder_->RecordResult("OnLedgerHistoryLoaded", call_,
+                            {std::to_string(result), data});
+    handler_->OnLedgerHistoryLoaded(result, data);
+    recorder_->OnHandlerDone(call_);
+  }
+
+  void OnLedgerHistorySaved(ledger::Result result) override {
+    recorder_->RecordResult("OnLedgerHistorySaved", call_,
+                            {std::to_string(result)});
+    handler_->OnLedgerHistorySaved(result);
+    recorder_->OnHandlerDone(call_);
+  }
+
+  void OnPublisherStateLoaded(ledger::Result result,
+                              const std::string& data) override {
+    recorder_->RecordResult("OnPublisherStateLoaded", call_,
+                            {std::to_string(result), data});
+    handler_->OnPublisherStateLoaded(result, data);
+    recorder_->OnHandlerDone(call_);
+  }
+
+  void OnPublisherStateSaved(ledger::Result result) override {
+    recorder_->RecordResult("OnPublisherStateSaved", call_,
+                            {std::to_string(result)});
+    handler_->OnPublisherStateSaved(result);
+    recorder_->OnHandlerDone(call_);
+  }
+
+  void OnURLRequestResponse(
+      uint64_t request_id,
+      const std::string& url,
+      int response_code,
+      const std::string& response,
+      const std::map<std::string, std::string>& headers) override {
+    std::vector<std::string> header_fields;
+    for (const auto& header : headers) {
+      header_fields.push_back(header.first);
+      header_fields.push_back(header.second);
+    }
+    recorder_->RecordResult("OnURLRequestResponse", call_,
+                            {url,
+                             std::to_string(response_code),
+                             response,
+                             EncodeTraceFields(header_fields)});
+    handler_->OnURLRequestResponse(request_id, url, response_code, response,
+                                   headers);
+    recorder_->OnHandlerDone(call_);
+  }
+
+  void OnPublishersListSaved(ledger::Result result) override {
+    recorder_->RecordResult("OnPublishersListSaved", call_,
+                            {std::to_string(result)});
+    handler_->OnPublishersListSaved(result);
+    recorder_->OnHandlerDone(call_);
+  }
+
+  void OnPublisherListLoaded(ledger::Result result,
+                             const std::string& data) override {
+    recorder_->RecordResult("OnPublisherListLoaded", call_,
+                            {std::to_string(result), data});
+    handler_->OnPublisherListLoaded(result, data);
+    recorder_->OnHandlerDone(call_);
+  }
+
+ private:
+  LedgerClientRecorderImpl* recorder_;  // NOT OWNED
+  uint64_t call_;
+  ledger::LedgerCallbackHandler* handler_;  // NOT OWNED
+};
+
+LedgerClientRecorderImpl::LedgerClientRecorderImpl(
+    ledger::LedgerClient* client,
+    std::ostream* trace) :
+  client_(client),
+  trace_(trace),
+  start_(std::chrono::steady_clock::now()),
+  next_call_(1),
+  size_(0) {
+}
+
+LedgerClientRecorderImpl::~LedgerClientRecorderImpl() {
+  trace_->flush();
+}
+
+size_t LedgerClientRecorderImpl::size() const {
+  return size_;
+}
+
+uint64_t LedgerClientRecorderImpl::RecordCall(
+    const std::string& type,
+    const std::vector<std::string>& fields) const {
+  TraceRecord record;
+  record.direction = TraceRecord::CALL;
+  record.type = type;
+  record.time = std::chrono::duration_cast<std::chrono::milliseconds>(
+      std::chrono::steady_clock::now() - start_).count();
+  record.call = next_call_++;
+  record.fields = fields;
+  WriteTraceRecord(record, trace_);
+  size_++;
+  return record.call;
+}
+
+void LedgerClientRecorderImpl::RecordResult(
+    const std::string& type,
+    uint64_t call,
+    const std::vector<std::string>& fields) const {
+  TraceRecord record;
+  record.direction = TraceRecord::RESULT;
+  record.type = type;
+  record.time = std::chrono::duration_cast<std::chrono::milliseconds>(
+      std::chrono::steady_clock::now() - start_).count();
+  record.call = call;
+  record.fields = fields;
+  WriteTraceRecord(record, trace_);
+  size_++;
+}
+
+ledger::LedgerCallbackHandler* LedgerClientRecorderImpl::WrapHandler(
+    uint64_t call,
+    ledger::LedgerCallbackHandler* handler) {
+  TraceHandler* trace_handler = new TraceHandler(this, call, handler);
+  handlers_[call].reset(trace_handler);
+  return trace_handler;
+}
+
+void LedgerClientRecorderImpl::OnHandlerDone(uint64_t call) {
+  // deletes the handler that is calling us, it must not be used after this
+  handlers_.erase(call);
+}
+
+ledger::PublisherInfoCallback
+LedgerClientRecorderImpl::WrapPublisherInfoCallback(
+    uint64_t call,
+    ledger::PublisherInfoCallback callback) {
+  return [this, call, callback](ledger::Result result,
+                                std::unique_ptr<ledger::PublisherInfo> info) {
+    RecordResult("OnPublisherInfo", call,
+                 {std::to_string(result),
+                  info ? EncodePublisherInfo(*info) : ""});
+    callback(result, std::move(info));
+  };
+}
+
+ledger::PublisherInfoListCallback
+LedgerClientRecorderImpl::WrapPublisherInfoListCallback(
+    uint64_t call,
+    ledger::PublisherInfoListCallback callback) {
+  return [this, call, callback](const ledger::PublisherInfoList& list,
+                                uint32_t next_record) {
+    std::vector<std::string> fields;
+    fields.reserve(list.size() + 1);
+    fields.push_back(std::to_string(next_record));
+    for (const auto& info : list) {
+      fields.push_back(EncodePublisherInfo(info));
+    }
+    RecordResult("OnPublisherInfoList", call, fields);
+    callback(list, next_record);
+  };
+}
+
+std::string LedgerClientRecorderImpl::GenerateGUID() const {
+  std::string guid = client_->GenerateGUID();
+  RecordCall("GenerateGUID", {guid});
+  return guid;
+}
+
+void LedgerClientRecorderImpl::OnWalletInitialized(ledger::Result result) {
+  RecordCall("OnWalletInitialized", {std::to_string(result)});
+  client_->OnWalletInitialized(result);
+}
+
+void LedgerClientRecorderImpl::FetchWalletProperties() {
+  RecordCall("FetchWalletProperties", {});
+  client_->FetchWalletProperties();
+}
+
+void LedgerClientRecorderImpl::OnWalletProperties(
+    ledger::Result result,
+    std::unique_ptr<ledger::WalletInfo> info) {
+  RecordCall("OnWalletProperties", {std::to_string(result)});
+  client_->OnWalletProperties(result, std::move(info));
+}
+
+void LedgerClientRecorderImpl::OnReconcileComplete(
+    ledger::Result result,
+    const std::string& viewing_id,
+    ledger::PUBLISHER_CATEGORY category,
+    const std::string& probi) {
+  RecordCall("OnReconcileComplete",
+             {std::to_string(result), viewing_id, std::to_string(category),
+              probi});
+  client_->OnReconcileComplete(result, viewing_id, category, probi);
+}
+
+void LedgerClientRecorderImpl::LoadLedgerState(
+    ledger::LedgerCallbackHandler* handler) {
+  uint64_t call = RecordCall("LoadLedgerState", {});
+  client_->LoadLedgerState(WrapHandler(call, handler));
+}
+
+void LedgerClientRecorderImpl::SaveLedgerState(
+    const std::string& ledger_state,
+    ledger::LedgerCallbackHandler* handler) {
+  uint64_t call = RecordCall("SaveLedgerState",
+                             {std::to_string(ledger_state.size())});
+  client_->SaveLedgerState(ledger_state, WrapHandler(call, handler));
+}
+
+void LedgerClientRecorderImpl::LoadLedgerHistory(
+    ledger::LedgerCallbackHandler* handler) {
+  uint64_t call = RecordCall("LoadLedgerHistory", {});
+  client_->LoadLedgerHistory(WrapHandler(call, handler));
+}
+
+void LedgerClientRecorderImpl::SaveLedgerHistory(
+    const std::string& ledger_history,
+    ledger::LedgerCallbackHandler* handler) {
+  uint64_t call = RecordCall("SaveLedgerHistory",
+                             {std::to_string(ledger_history.size())});
+  client_->SaveLedgerHistory(ledger_history, WrapHandler(call, handler));
+}
+
+void LedgerClientRecorderImpl::LoadPublisherState(
+    ledger::LedgerCallbackHandler* handler) {
+  uint64_t call = RecordCall("LoadPublisherState", {});
+  client_->LoadPublisherState(WrapHandler(call, handler));
+}
+
+void LedgerClientRecorderImpl::SavePublisherState(
+    const std::string& publisher_state,
+    ledger::LedgerCallbackHandler* handler) {
+  uint64_t call = RecordCall("SavePublisherState",
+                             {std::to_string(publisher_state.size())});
+  client_->SavePublisherState(publisher_state, WrapHandler(call, handler));
+}
+
+void LedgerClientRecorderImpl::SavePublishersList(
+    const std::string& publisher_state,
+    ledger::LedgerCallbackHandler* handler) {
+  uint64_t call = RecordCall("SavePublishersList",
+                             {std::to_string(publisher_state.size())});
+  client_->SavePublishersList(publisher_state, WrapHandler(call, handler));
+}
+
+void LedgerClientRecorderImpl::LoadPublisherList(
+    ledger::LedgerCallbackHandler* handler) {
+  uint64_t call = RecordCall("LoadPublisherList", {});
+  client_->LoadPublisherList(WrapHandler(call, handler));
+}
+
+void LedgerClientRecorderImpl::LoadNicewareList(
+    ledger::GetNicewareListCallback callback) {
+  uint64_t call = RecordCall("LoadNicewareList", {});
+  client_->LoadNicewareList(
+      [this, call, callback](ledger::Result result, const std::string& data) {
+        RecordResult("OnNicewareListLoaded", call,
+                     {std::to_string(result), data});
+        callback(result, data);
+      });
+}
+
+void LedgerClientRecorderImpl::SavePublisherInfo(
+    std::unique_ptr<ledger::PublisherInfo> publisher_info,
+    ledger::PublisherInfoCallback callback) {
+  uint64_t call = RecordCall("SavePublisherInfo",
+      {publisher_info ? EncodePublisherInfo(*publisher_info) : ""});
+  client_->SavePublisherInfo(std::move(publisher_info),
+                             WrapPublisherInfoCallback(call, callback));
+}
+
+void LedgerClientRecorderImpl::LoadPublisherInfo(
+    ledger::PublisherInfoFilter filter,
+    ledger::PublisherInfoCallback callback) {
+  uint64_t call = RecordCall("LoadPublisherInfo",
+                             {filter.id,
+                              std::to_string(filter.category),
+                              std::to_string(filter.month),
+                              std::to_string(filter.year)});
+  client_->LoadPublisherInfo(filter,
+                             WrapPublisherInfoCallback(call, callback));
+}
+
+void LedgerClientRecorderImpl::LoadMediaPublisherInfo(
+    const std::string& media_key,
+    ledger::PublisherInfoCallback callback) {
+  uint64_t call = RecordCall("LoadMediaPublisherInfo", {media_key});
+  client_->LoadMediaPublisherInfo(media_key,
+                                  WrapPublisherInfoCallback(call, callback));
+}
+
+void LedgerClientRecorderImpl::SaveMediaPublisherInfo(
+    const std::string& media_key,
+    const std::string& publisher_id) {
+  RecordCall("SaveMediaPublisherInfo", {media_key, publisher_id});
+  client_->SaveMediaPublisherInfo(media_key, publisher_id);
+}
+
+void LedgerClientRecorderImpl::LoadPublisherInfoList(
+    uint32_t start,
+    uint32_t limit,
+    ledger::PublisherInfoFilter filter,
+    ledger::PublisherInfoListCallback callback) {
+  uint64_t call = RecordCall("LoadPublisherInfoList",
+                             {std::to_string(start),
+                              std::to_string(limit),
+                              std::to_string(filter.month),
+                              std::to_string(filter.year)});
+  client_->LoadPublisherInfoList(
+      start, limit, filter, WrapPublisherInfoListCallback(call, callback));
+}
+
+void LedgerClientRecorderImpl::FetchGrant(const std::string& lang,
+                                          const std::string& paymentId) {
+  RecordCall("FetchGrant", {lang, paymentId});
+  client_->FetchGrant(lang, paymentId);
+}
+
+void LedgerClientRecorderImpl::OnGrant(ledger::Result result,
+                                       const ledger::Grant& grant) {
+  RecordCall("OnGrant", {std::to_string(result)});
+  client_->OnGrant(result, grant);
+}
+
+void LedgerClientRecorderImpl::GetGrantCaptcha() {
+  RecordCall("GetGrantCaptcha", {});
+  client_->GetGrantCaptcha();
+}
+
+void LedgerClientRecorderImpl::OnGrantCaptcha(const std::string& image,
+                                              const std::string& hint) {
+  RecordCall("OnGrantCaptcha", {std::to_string(image.size()), hint});
+  client_->OnGrantCaptcha(image, hint);
+}
+
+void LedgerClientRecorderImpl::OnRecoverWallet(
+    ledger::Result result,
+    double balance,
+    const std::vector<ledger::Grant>& grants) {
+  RecordCall("OnRecoverWallet", {std::to_string(result)});
+  client_->OnRecoverWallet(result, balance, grants);
+}
+
+void LedgerClientRecorderImpl::OnGrantFinish(ledger::Result result,
+                                             const ledger::Grant& grant) {
+  RecordCall("OnGrantFinish", {std::to_string(result)});
+  client_->OnGrantFinish(result, grant);
+}
+
+void LedgerClientRecorderImpl::OnPublisherActivity(
+    ledger::Result result,
+    std::unique_ptr<ledger::PublisherInfo> info,
+    uint64_t windowId) {
+  RecordCall("OnPublisherActivity",
+             {std::to_string(result),
+              info ? EncodePublisherInfo(*info) : "",
+              std::to_string(windowId)});
+  client_->OnPublisherActivity(result, std::move(info), windowId);
+}
+
+void LedgerClientRecorderImpl::OnExcludedSitesChanged(
+    const std::string& publisher_id) {
+  RecordCall("OnExcludedSitesChanged", {publisher_id});
+  client_->OnExcludedSitesChanged(publisher_id);
+}
+
+void LedgerClientRecorderImpl::FetchFavIcon(
+    const std::string& url,
+    const std::string& favicon_key,
+    ledger::FetchIconCallback callback) {
+  uint64_t call = RecordCall("FetchFavIcon", {url, favicon_key});
+  client_->FetchFavIcon(url, favicon_key,
+      [this, call, callback](bool success, const std::string& favicon_url) {
+        RecordResult("OnFavIconFetched", call,
+                     {success ? "1" : "0", favicon_url});
+        callback(success, favicon_url);
+      });
+}
+
+void LedgerClientRecorderImpl::SaveContributionInfo(
+    const std::string& probi,
+    const int month,
+    const int year,
+    const uint32_t date,
+    const std::string& publisher_key,
+    const ledger::PUBLISHER_CATEGORY category) {
+  RecordCall("SaveContributionInfo",
+             {probi, std::to_string(month), std::to_string(year),
+              std::to_string(date), publisher_key, std::to_string(category)});
+  client_->SaveContributionInfo(probi, month, year, date, publisher_key,
+                                category);
+}
+
+void LedgerClientRecorderImpl::GetRecurringDonations(
+    ledger::PublisherInfoListCallback callback) {
+  uint64_t call = RecordCall("GetRecurringDonations", {});
+  client_->GetRecurringDonations(
+      WrapPublisherInfoListCallback(call, callback));
+}
+
+void LedgerClientRecorderImpl::OnRemoveRecurring(
+    const std::string& publisher_key,
+    ledger::RecurringRemoveCallback callback) {
+  uint64_t call = RecordCall("OnRemoveRecurring", {publisher_key});
+  client_->OnRemoveRecurring(publisher_key,
+      [this, call, callback](ledger::Result result) {
+        RecordResult("OnRecurringRemoved", call, {std::to_string(result)});
+        callback(result);
+      });
+}
+
+void LedgerClientRecorderImpl::SetTimer(uint64_t time_offset,
+                                        uint32_t& timer_id) {
+  client_->SetTimer(time_offset, timer_id);
+  RecordCall("SetTimer",
+             {std::to_string(time_offset), std::to_string(timer_id)});
+}
+
+std::string LedgerClientRecorderImpl::URIEncode(const std::string& value) {
+  std::string encoded = client_->URIEncode(value);
+  RecordCall("URIEncode", {value, encoded});
+  return encoded;
+}
+
+std::unique_ptr<ledger::LedgerURLLoader> LedgerClientRecorderImpl::LoadURL(
+    const std::string& url,
+    const std::vector<std::string>& headers,
+    const std::string& content,
+    const std::string& contentType,
+    const ledger::URL_METHOD& method,
+    ledger::LedgerCallbackHandler* handler) {
+  uint64_t call = RecordCall("LoadURL",
+                             {url, std::to_string(method), content});
+  return client_->LoadURL(url, headers, content, contentType, method,
+                          WrapHandler(call, handler));
+}
+
+void LedgerClientRecorderImpl::RunIOTask(
+    std::unique_ptr<ledger::LedgerTaskRunner> task) {
+  // tasks run ledger code, they don't cross the boundary
+  client_->RunIOTask(std::move(task));
+}
+
+void LedgerClientRecorderImpl::SetContributionAutoInclude(
+    std::string publisher_key,
+    bool excluded,
+    uint64_t windowId) {
+  RecordCall("SetContributionAutoInclude",
+             {publisher_key, excluded ? "1" : "0", std::to_string(windowId)});
+  client_->SetContributionAutoInclude(publisher_key, excluded, windowId);
+}
+
+std::unique_ptr<ledger::LogStream> LedgerClientRecorderImpl::Log(
+    const char* file,
+    int line,
+    const ledger::LogLevel log_level) const {
+  return client_->Log(file, line, log_level);
+}
+
+}  // namespace bat_ledger
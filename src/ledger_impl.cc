@@ -3,13 +3,14 @@
  * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
 
 #include <ctime>
-#include <random>
 #include <sstream>
 #include <vector>
 
 #include "ledger_impl.h"
 #include "ledger_task_runner_impl.h"
+#include "random_service.h"
 
+#include "bat_binary_fields.h"
 #include "bat_client.h"
 #include "bat_contribution.h"
 #include "bat_get_media.h"
@@ -30,8 +31,35 @@ using namespace std::placeholders;
 
 namespace bat_ledger {
 
+namespace {
+
+std::string GetPublishersListURL() {
+  return braveledger_bat_helper::buildURL(GET_PUBLISHERS_LIST_V1, "",
+      braveledger_bat_helper::SERVER_TYPES::PUBLISHER);
+}
+
+void OnTopPublishers(ledger::PublisherInfoListCallback callback,
+                     braveledger_bat_publishers::TopPublishers top) {
+  callback(top.list, 0);
+}
+
+}  // namespace
+
 LedgerImpl::LedgerImpl(ledger::LedgerClient* client) :
     ledger_client_(client),
+    log_level_(ledger::LogLevel::LOG_RESPONSE),
+    metrics_(new LedgerMetrics()),
+    request_trace_(new RequestTrace(
+        braveledger_ledger::_request_trace_capacity)),
+    request_scheduler_(new URLRequestScheduler(
+        braveledger_ledger::_max_url_requests,
+        braveledger_ledger::_max_url_requests_per_host)),
+    response_cache_(new URLResponseCache()),
+    timer_service_(new TimerService(
+        [client](uint64_t delay, uint32_t* timer_id) {
+          client->SetTimer(delay, *timer_id);
+        },
+        braveledger_ledger::_timer_coalescing_window)),
     bat_client_(new BatClient(this)),
     bat_publishers_(new BatPublishers(this)),
     bat_get_media_(new BatGetMedia(this)),
@@ -39,10 +67,25 @@ LedgerImpl::LedgerImpl(ledger::LedgerClient* client) :
     bat_contribution_(new BatContribution(this)),
     initialized_(false),
     initializing_(false),
+    startup_start_(0u),
+    pending_startup_loads_(0),
+    ledger_state_result_(ledger::Result::LEDGER_OK),
+    ledger_history_result_(ledger::Result::LEDGER_OK),
+    publisher_state_result_(ledger::Result::LEDGER_OK),
+    publisher_list_stage_(PublisherListStage::NOT_LOADED),
+    publisher_list_stored_(false),
+    handler_(request_scheduler_.get(), URLRequestPriority::BACKGROUND),
     last_tab_active_time_(0),
     last_shown_tab_id_(-1),
     last_pub_load_timer_id_(0u),
-    last_grant_check_timer_id_(0u) {
+    last_grant_check_timer_id_(0u),
+    request_trace_timer_id_(0u),
+    request_trace_draining_(false) {
+  request_scheduler_->SetMetrics(metrics_.get());
+  request_scheduler_->SetTrace(request_trace_.get());
+  request_trace_->SetEnabled(IsLogEnabled(ledger::LogLevel::LOG_REQUEST));
+  request_trace_->SetPreviewEnabled(
+      IsLogEnabled(ledger::LogLevel::LOG_REQUEST));
 }
 
 LedgerImpl::~LedgerImpl() {
@@ -51,7 +94,20 @@ LedgerImpl::~LedgerImpl() {
 void LedgerImpl::Initialize() {
   DCHECK(!initializing_);
   initializing_ = true;
+
+  // all the stored state is loaded at once. The wallet is initialized when
+  // the ledger and the publisher state are parsed and the ledger history is
+  // there, the publisher list warms up on its own
+  startup_start_ = metrics_->StartTime();
+  pending_startup_loads_ = 3;
+  ledger_state_result_ = ledger::Result::LEDGER_OK;
+  ledger_history_result_ = ledger::Result::LEDGER_OK;
+  publisher_state_result_ = ledger::Result::LEDGER_OK;
+  publisher_list_stage_ = PublisherListStage::WARMING;
   LoadLedgerState(this);
+  LoadLedgerHistory(this);
+  LoadPublisherState(this);
+  LoadPublisherList(this);
 }
 
 bool LedgerImpl::CreateWallet() {
@@ -174,7 +230,9 @@ void LedgerImpl::OnPostData(
   }
   std::vector<std::map<std::string, std::string>> twitchParts;
   if (TWITCH_MEDIA_TYPE == type) {
-    braveledger_bat_helper::getTwitchParts(post_data, twitchParts);
+    braveledger_bat_helper::getTwitchParts(post_data,
+                                           &media_scratch_,
+                                           twitchParts);
     for (size_t i = 0; i < twitchParts.size(); i++) {
       bat_get_media_->processMedia(twitchParts[i], type, visit_data);
     }
@@ -187,57 +245,170 @@ void LedgerImpl::LoadLedgerState(ledger::LedgerCallbackHandler* handler) {
 
 void LedgerImpl::OnLedgerStateLoaded(ledger::Result result,
                                         const std::string& data) {
+  metrics_->AddTime("startup.ledger_state_loaded", startup_start_);
   if (result == ledger::Result::LEDGER_OK) {
-    if (!bat_state_->LoadState(data)) {
-      BLOG(this, ledger::LogLevel::LOG_ERROR) <<
-        "Successfully loaded but failed to parse ledger state.";
-      BLOG(this, ledger::LogLevel::LOG_DEBUG) <<
-        "Failed ledger state: " << data;
-
-      OnWalletInitialized(ledger::Result::INVALID_LEDGER_STATE);
-    } else {
-      LoadPublisherState(this);
-      bat_contribution_->OnStartUp();
-    }
+    // the one copy of |data| is moved into the task, the reply only keeps
+    // its size for logging
+    std::string state_data(data);
+    RunIOTask(std::bind(&LedgerImpl::ParseLedgerState,
+                        this, std::move(state_data), _1));
   } else {
     BLOG(this, ledger::LogLevel::LOG_ERROR) << "Failed to load ledger state";
-    BLOG(this, ledger::LogLevel::LOG_DEBUG) << "Failed ledger state: " << data;
+    BLOG(this, ledger::LogLevel::LOG_DEBUG) <<
+      "Failed ledger state: " << LogPayload(data);
 
-    OnWalletInitialized(result);
+    ledger_state_result_ = result;
+    OnStartupStateLoaded();
   }
 }
 
+void LedgerImpl::ParseLedgerState(
+    const std::string& data,
+    ledger::LedgerTaskRunner::CallerThreadCallback callback) {
+  std::shared_ptr<braveledger_bat_helper::CLIENT_STATE_ST> state(
+      new braveledger_bat_helper::CLIENT_STATE_ST());
+  uint64_t start = metrics_->StartTime();
+  bool success = BatState::ParseState(data, state.get());
+  metrics_->AddTime(braveledger_bat_helper::IsBinaryState(data) ?
+      "state.ledger.parse_binary" : "state.ledger.parse_json", start);
+  callback(std::bind(&LedgerImpl::OnLedgerStateParsed,
+                     this, success, state, data.size()));
+}
+
+void LedgerImpl::OnLedgerStateParsed(
+    bool success,
+    std::shared_ptr<braveledger_bat_helper::CLIENT_STATE_ST> state,
+    size_t data_size) {
+  if (!success) {
+    BLOG(this, ledger::LogLevel::LOG_ERROR) <<
+      "Successfully loaded but failed to parse ledger state.";
+    BLOG(this, ledger::LogLevel::LOG_DEBUG) <<
+      "Failed ledger state: " << data_size << " bytes";
+
+    ledger_state_result_ = ledger::Result::INVALID_LEDGER_STATE;
+  } else {
+    bat_state_->SetState(std::unique_ptr<braveledger_bat_helper::CLIENT_STATE_ST>(
+        new braveledger_bat_helper::CLIENT_STATE_ST(std::move(*state))));
+  }
+
+  OnStartupStateLoaded();
+}
+
+void LedgerImpl::LoadLedgerHistory(ledger::LedgerCallbackHandler* handler) {
+  ledger_client_->LoadLedgerHistory(handler);
+}
+
+// The history is only parsed once a contribution needs it
+void LedgerImpl::OnLedgerHistoryLoaded(ledger::Result result,
+                                       const std::string& data) {
+  metrics_->AddTime("startup.ledger_history_loaded", startup_start_);
+  if (result == ledger::Result::LEDGER_OK) {
+    bat_state_->SetHistoryData(data);
+  } else if (result == ledger::Result::NO_LEDGER_STATE) {
+    bat_state_->SetHistoryData(std::string());
+  } else {
+    BLOG(this, ledger::LogLevel::LOG_ERROR) << "Failed to load ledger history";
+    ledger_history_result_ = result;
+    bat_state_->SetHistoryFailed();
+  }
+
+  OnStartupStateLoaded();
+}
+
 void LedgerImpl::LoadPublisherState(ledger::LedgerCallbackHandler* handler) {
   ledger_client_->LoadPublisherState(handler);
 }
 
 void LedgerImpl::OnPublisherStateLoaded(ledger::Result result,
                                         const std::string& data) {
+  metrics_->AddTime("startup.publisher_state_loaded", startup_start_);
   if (result == ledger::Result::LEDGER_OK) {
-    if (!bat_publishers_->loadState(data)) {
-      BLOG(this, ledger::LogLevel::LOG_ERROR) <<
-        "Successfully loaded but failed to parse ledger state.";
-      BLOG(this, ledger::LogLevel::LOG_DEBUG) <<
-        "Failed publisher state: " << data;
-
-      result = ledger::Result::INVALID_PUBLISHER_STATE;
-    }
+    std::string state_data(data);
+    RunIOTask(std::bind(&LedgerImpl::ParsePublisherState,
+                        this, std::move(state_data), _1));
   } else {
     BLOG(this, ledger::LogLevel::LOG_ERROR) <<
       "Failed to load publisher state";
       BLOG(this, ledger::LogLevel::LOG_DEBUG) <<
-        "Failed publisher state: " << data;
+        "Failed publisher state: " << LogPayload(data);
+
+    publisher_state_result_ = result;
+    OnStartupStateLoaded();
+  }
+}
+
+void LedgerImpl::ParsePublisherState(
+    const std::string& data,
+    ledger::LedgerTaskRunner::CallerThreadCallback callback) {
+  std::shared_ptr<braveledger_bat_helper::PUBLISHER_STATE_ST> state(
+      new braveledger_bat_helper::PUBLISHER_STATE_ST());
+  bool success = BatPublishers::parseState(data, state.get());
+  callback(std::bind(&LedgerImpl::OnPublisherStateParsed,
+                     this, success, state, data.size()));
+}
+
+void LedgerImpl::OnPublisherStateParsed(
+    bool success,
+    std::shared_ptr<braveledger_bat_helper::PUBLISHER_STATE_ST> state,
+    size_t data_size) {
+  if (!success) {
+    BLOG(this, ledger::LogLevel::LOG_ERROR) <<
+      "Successfully loaded but failed to parse ledger state.";
+    BLOG(this, ledger::LogLevel::LOG_DEBUG) <<
+      "Failed publisher state: " << data_size << " bytes";
+
+    publisher_state_result_ = ledger::Result::INVALID_PUBLISHER_STATE;
+  } else {
+    bat_publishers_->setState(
+        std::unique_ptr<braveledger_bat_helper::PUBLISHER_STATE_ST>(
+            new braveledger_bat_helper::PUBLISHER_STATE_ST(std::move(*state))));
+  }
+
+  OnStartupStateLoaded();
+}
+
+void LedgerImpl::OnStartupStateLoaded() {
+  DCHECK(pending_startup_loads_ > 0);
+  if (--pending_startup_loads_ > 0) {
+    return;
+  }
+
+  // contributions are resumed once the history is there, so the
+  // transactions of an older state can be moved into it
+  if (ledger_state_result_ == ledger::Result::LEDGER_OK &&
+      ledger_history_result_ == ledger::Result::LEDGER_OK) {
+    bat_contribution_->OnStartUp();
   }
 
+  // ledger state comes first, the publisher state used to be loaded
+  // only after it. The history was part of the ledger state.
+  ledger::Result result = ledger_state_result_;
+  if (result == ledger::Result::LEDGER_OK) {
+    result = ledger_history_result_;
+  }
+  if (result == ledger::Result::LEDGER_OK) {
+    result = publisher_state_result_;
+  }
+  metrics_->AddTime("startup.wallet_initialized", startup_start_);
   OnWalletInitialized(result);
 }
 
 void LedgerImpl::SaveLedgerState(const std::string& data) {
+  metrics_->AddCount("state.ledger.saves", 1);
+  metrics_->AddCount("state.ledger.bytes", data.length());
   ledger_client_->SaveLedgerState(data, this);
 }
 
+void LedgerImpl::SaveLedgerHistory(const std::string& data) {
+  metrics_->AddCount("state.history.saves", 1);
+  metrics_->AddCount("state.history.bytes", data.length());
+  ledger_client_->SaveLedgerHistory(data, this);
+}
+
 void LedgerImpl::SavePublisherState(const std::string& data,
                                     ledger::LedgerCallbackHandler* handler) {
+  metrics_->AddCount("state.publisher.saves", 1);
+  metrics_->AddCount("state.publisher.bytes", data.length());
   ledger_client_->SavePublisherState(data, handler);
 }
 
@@ -247,23 +418,72 @@ void LedgerImpl::SavePublishersList(const std::string& data) {
 }
 
 void LedgerImpl::LoadPublisherList(ledger::LedgerCallbackHandler* handler) {
+  publisher_list_stage_ = PublisherListStage::WARMING;
   ledger_client_->LoadPublisherList(handler);
 }
 
+bool LedgerImpl::IsPublisherListWarming() const {
+  return publisher_list_stage_ == PublisherListStage::WARMING;
+}
+
 void LedgerImpl::OnPublisherListLoaded(ledger::Result result,
                                        const std::string& data) {
   if (result == ledger::Result::LEDGER_OK) {
-    if (!bat_publishers_->loadPublisherList(data)) {
-      BLOG(this, ledger::LogLevel::LOG_ERROR) <<
-        "Successfully loaded but failed to parse publish list.";
-      BLOG(this, ledger::LogLevel::LOG_DEBUG) <<
-        "Failed publisher list: " << data;
-    }
-  } else {
+    std::string list_data(data);
+    RunIOTask(std::bind(&LedgerImpl::ParsePublisherList,
+                        this, std::move(list_data), _1));
+    return;
+  }
+
+  BLOG(this, ledger::LogLevel::LOG_ERROR) <<
+    "Failed to load publisher list";
+  BLOG(this, ledger::LogLevel::LOG_DEBUG) <<
+    "Failed publisher list: " << LogPayload(data);
+
+  OnPublisherListParsed(true, nullptr, data.size());
+}
+
+void LedgerImpl::ParsePublisherList(
+    const std::string& data,
+    ledger::LedgerTaskRunner::CallerThreadCallback callback) {
+  std::shared_ptr<std::map<std::string, braveledger_bat_helper::SERVER_LIST>>
+      list(new std::map<std::string, braveledger_bat_helper::SERVER_LIST>());
+  bool success = BatPublishers::parsePublisherList(data, list.get());
+  callback(std::bind(&LedgerImpl::OnPublisherListParsed,
+                     this, success, list, data.size()));
+}
+
+// |list| is null when there was no stored list to parse
+void LedgerImpl::OnPublisherListParsed(
+    bool success,
+    std::shared_ptr<
+        std::map<std::string, braveledger_bat_helper::SERVER_LIST>> list,
+    size_t data_size) {
+  if (!success) {
     BLOG(this, ledger::LogLevel::LOG_ERROR) <<
-      "Failed to load publisher list";
+      "Successfully loaded but failed to parse publish list.";
     BLOG(this, ledger::LogLevel::LOG_DEBUG) <<
-      "Failed publisher list: " << data;
+      "Failed publisher list: " << data_size << " bytes";
+  } else if (list) {
+    bat_publishers_->setPublisherList(list.get());
+  }
+
+  publisher_list_stored_ = success && list;
+  publisher_list_stage_ = PublisherListStage::READY;
+  metrics_->AddTime("startup.publisher_list_ready", startup_start_);
+  bat_contribution_->OnPublisherListReady();
+
+  if (initialized_) {
+    RefreshStoredPublishersList();
+  }
+}
+
+void LedgerImpl::RefreshStoredPublishersList() {
+  if (publisher_list_stored_) {
+    // stored list is usable, refresh can be a conditional request
+    response_cache_->SetValidators(GetPublishersListURL(),
+        bat_publishers_->getPublishersListETag(),
+        bat_publishers_->getPublishersListLastModified());
   }
 
   RefreshPublishersList(false);
@@ -279,7 +499,11 @@ void LedgerImpl::OnWalletInitialized(ledger::Result result) {
 
   if (result == ledger::Result::LEDGER_OK || result == ledger::Result::WALLET_CREATED) {
     initialized_ = true;
-    LoadPublisherList(this);
+    if (publisher_list_stage_ == PublisherListStage::NOT_LOADED) {
+      LoadPublisherList(this);
+    } else if (publisher_list_stage_ == PublisherListStage::READY) {
+      RefreshStoredPublishersList();
+    }
     bat_contribution_->SetReconcileTimer();
     RefreshGrant(false);
   } else {
@@ -293,13 +517,27 @@ std::unique_ptr<ledger::LedgerURLLoader> LedgerImpl::LoadURL(const std::string&
     const std::string& contentType,
     const ledger::URL_METHOD& method,
     ledger::LedgerCallbackHandler* handler) {
-  return ledger_client_->LoadURL(
+  auto loader = ledger_client_->LoadURL(
       url, headers, content, contentType, method, handler);
+  if (loader) {
+    request_scheduler_->SetRequestURL(loader->request_id(), url,
+                                      content.size());
+    SetRequestTraceTimer();
+  }
+  return loader;
+}
+
+URLRequestScheduler* LedgerImpl::GetURLRequestScheduler() {
+  return request_scheduler_.get();
+}
+
+URLResponseCache* LedgerImpl::GetURLResponseCache() {
+  return response_cache_.get();
 }
 
 void LedgerImpl::RunIOTask(ledger::LedgerTaskRunner::Task io_task) {
   std::unique_ptr<LedgerTaskRunnerImpl> task_runner(
-      new LedgerTaskRunnerImpl(io_task));
+      new LedgerTaskRunnerImpl(std::move(io_task)));
   ledger_client_->RunIOTask(std::move(task_runner));
 }
 
@@ -309,6 +547,7 @@ std::string LedgerImpl::URIEncode(const std::string& value) {
 
 void LedgerImpl::SetPublisherInfo(std::unique_ptr<ledger::PublisherInfo> info,
                                   ledger::PublisherInfoCallback callback) {
+  metrics_->AddCount("db.SetPublisherInfo", 1);
   ledger_client_->SavePublisherInfo(std::move(info),
       std::bind(&LedgerImpl::OnSetPublisherInfo, this, callback, _1, _2));
 }
@@ -316,6 +555,7 @@ void LedgerImpl::SetPublisherInfo(std::unique_ptr<ledger::PublisherInfo> info,
 void LedgerImpl::SetMediaPublisherInfo(const std::string& media_key,
                                 const std::string& publisher_id) {
   if (!media_key.empty() && !publisher_id.empty()) {
+    metrics_->AddCount("db.SetMediaPublisherInfo", 1);
     ledger_client_->SaveMediaPublisherInfo(media_key, publisher_id);
   }
 }
@@ -360,20 +600,30 @@ std::vector<ledger::ContributionInfo> LedgerImpl::GetRecurringDonationPublisherI
 void LedgerImpl::GetPublisherInfo(
     const ledger::PublisherInfoFilter& filter,
     ledger::PublisherInfoCallback callback) {
+  metrics_->AddCount("db.GetPublisherInfo", 1);
   ledger_client_->LoadPublisherInfo(filter, callback);
 }
 
 void LedgerImpl::GetMediaPublisherInfo(const std::string& media_key,
                                 ledger::PublisherInfoCallback callback) {
+  metrics_->AddCount("db.GetMediaPublisherInfo", 1);
   ledger_client_->LoadMediaPublisherInfo(media_key, callback);
 }
 
 void LedgerImpl::GetPublisherInfoList(uint32_t start, uint32_t limit,
                                 const ledger::PublisherInfoFilter& filter,
                                 ledger::PublisherInfoListCallback callback) {
+  metrics_->AddCount("db.GetPublisherInfoList", 1);
   ledger_client_->LoadPublisherInfoList(start, limit, filter, callback);
 }
 
+void LedgerImpl::GetTopPublishers(const ledger::PublisherInfoFilter& filter,
+                                  size_t count,
+                                  ledger::PublisherInfoListCallback callback) {
+  bat_publishers_->GetTopPublishers(filter, count,
+      std::bind(&OnTopPublishers, callback, _1));
+}
+
 void LedgerImpl::SetRewardsMainEnabled(bool enabled) {
   bat_state_->SetRewardsMainEnabled(enabled);
 }
@@ -465,6 +715,8 @@ uint64_t LedgerImpl::GetReconcileStamp() const {
 void LedgerImpl::OnReconcileComplete(ledger::Result result,
                                     const std::string& viewing_id,
                                     const std::string& probi) {
+  // balance has changed
+  response_cache_->ExpireAll();
   auto reconcile = GetReconcileById(viewing_id);
 
   ledger_client_->OnReconcileComplete(
@@ -556,6 +808,7 @@ void LedgerImpl::OnRecoverWallet(ledger::Result result, double balance, const st
   }
   if (result == ledger::Result::LEDGER_OK) {
     bat_publishers_->clearAllBalanceReports();
+    response_cache_->ExpireAll();
   }
 
   ledger_client_->OnRecoverWallet(result ? ledger::Result::LEDGER_ERROR :
@@ -569,6 +822,8 @@ void LedgerImpl::SolveGrantCaptcha(const std::string& solution) const {
 }
 
 void LedgerImpl::OnGrantFinish(ledger::Result result, const braveledger_bat_helper::GRANT& grant) {
+  // balance has changed
+  response_cache_->ExpireAll();
   ledger::Grant newGrant;
 
   newGrant.altcurrency = grant.altcurrency;
@@ -605,37 +860,53 @@ void LedgerImpl::DoDirectDonation(const ledger::PublisherInfo& publisher, const
 
   auto direction = braveledger_bat_helper::RECONCILE_DIRECTION(publisher.id, amount, currency);
   auto direction_list = std::vector<braveledger_bat_helper::RECONCILE_DIRECTION> { direction };
-  braveledger_bat_helper::PublisherList list;
   bat_contribution_->StartReconcile(GenerateGUID(),
                          ledger::PUBLISHER_CATEGORY::DIRECT_DONATION,
-                         list,
+                         braveledger_bat_helper::PublisherList(),
                          direction_list);
 }
 
 void LedgerImpl::OnTimer(uint32_t timer_id) {
-  if (timer_id == last_pub_load_timer_id_) {
-    last_pub_load_timer_id_ = 0;
-
-    //download the list
-    std::string url = braveledger_bat_helper::buildURL(GET_PUBLISHERS_LIST_V1, "", braveledger_bat_helper::SERVER_TYPES::PUBLISHER);
-    auto url_loader = LoadURL(url, std::vector<std::string>(), "", "", ledger::URL_METHOD::GET, &handler_);
-    handler_.AddRequestHandler(std::move(url_loader),
-      std::bind(&LedgerImpl::LoadPublishersListCallback,this,_1,_2,_3));
-  } else if (timer_id == last_grant_check_timer_id_) {
-    last_grant_check_timer_id_ = 0;
-    FetchGrant(std::string(), std::string());
-  }
+  timer_service_->OnHostTimer(timer_id, std::time(nullptr));
+}
+
+void LedgerImpl::OnPublishersListTimer() {
+  last_pub_load_timer_id_ = 0;
 
-  bat_contribution_->OnTimer(timer_id);
+  //download the list
+  std::string url = GetPublishersListURL();
+  std::vector<std::string> headers;
+  response_cache_->AddConditionalHeaders(url, &headers);
+  auto url_loader = LoadURL(url, headers, "", "", ledger::URL_METHOD::GET, &handler_);
+  handler_.AddResponseHandler(std::move(url_loader),
+    std::bind(&LedgerImpl::LoadPublishersListCallback,this,_1,_2,_3));
+}
+
+void LedgerImpl::OnGrantTimer() {
+  last_grant_check_timer_id_ = 0;
+  FetchGrant(std::string(), std::string());
 }
 
 void LedgerImpl::GetRecurringDonations(ledger::PublisherInfoListCallback callback) {
+  metrics_->AddCount("db.GetRecurringDonations", 1);
   ledger_client_->GetRecurringDonations(callback);
 }
 
-void LedgerImpl::LoadPublishersListCallback(bool result, const std::string& response, const std::map<std::string, std::string>& headers) {
-  if (result && !response.empty()) {
-    bat_publishers_->RefreshPublishersList(response);
+void LedgerImpl::LoadPublishersListCallback(int response_code, const std::string& response, const std::map<std::string, std::string>& headers) {
+  std::string url = GetPublishersListURL();
+  if (response_code == 304) {
+    // list that we already parsed is still current
+    BLOG(this, ledger::LogLevel::LOG_INFO) << "Publisher list not modified";
+    response_cache_->OnResponse(url, response_code, headers, 0,
+                                std::time(nullptr));
+    OnPublishersListSaved(ledger::Result::LEDGER_OK);
+  } else if (response_code == 200 && !response.empty()) {
+    // validators need to be in place before the list is saved
+    response_cache_->OnResponse(url, response_code, headers, 0,
+                                std::time(nullptr));
+    if (!bat_publishers_->RefreshPublishersList(response)) {
+      response_cache_->Remove(url);
+    }
   } else {
     BLOG(this, ledger::LogLevel::LOG_ERROR) <<
       "Can't fetch publisher list";
@@ -680,7 +951,8 @@ void LedgerImpl::RefreshPublishersList(bool retryAfterError) {
   }
 
   //start timer
-  SetTimer(start_timer_in, last_pub_load_timer_id_);
+  last_pub_load_timer_id_ = SetTimer(start_timer_in,
+      std::bind(&LedgerImpl::OnPublishersListTimer, this));
 }
 
 void LedgerImpl::RefreshGrant(bool retryAfterError) {
@@ -710,20 +982,28 @@ void LedgerImpl::RefreshGrant(bool retryAfterError) {
       start_timer_in = 0ull;
     }
   }
-  SetTimer(start_timer_in, last_grant_check_timer_id_);
+  last_grant_check_timer_id_ = SetTimer(start_timer_in,
+      std::bind(&LedgerImpl::OnGrantTimer, this));
 }
 
 uint64_t LedgerImpl::retryRequestSetup(uint64_t min_time, uint64_t max_time) {
-  std::random_device seeder;
-  const auto seed = seeder.entropy() ? seeder() : time(nullptr);
-  std::mt19937 eng(static_cast<std::mt19937::result_type>(seed));
   DCHECK(max_time > min_time);
-  std::uniform_int_distribution <> dist(min_time, max_time);
-  return dist(eng);
+  return RandomService::GetInstance()->RandInt(min_time, max_time);
 }
 
 void LedgerImpl::OnPublishersListSaved(ledger::Result result) {
   bool retryAfterError = !(ledger::Result::LEDGER_OK == result);
+  // validators are only valid for the list that is on disk
+  std::string etag;
+  std::string last_modified;
+  if (!retryAfterError) {
+    response_cache_->GetValidators(GetPublishersListURL(),
+                                   &etag,
+                                   &last_modified);
+  } else {
+    response_cache_->Remove(GetPublishersListURL());
+  }
+  bat_publishers_->setPublishersListValidators(etag, last_modified);
   bat_publishers_->OnPublishersListSaved(result);
   RefreshPublishersList(retryAfterError);
 }
@@ -790,6 +1070,7 @@ void LedgerImpl::OnReconcileCompleteSuccess(const std::string& viewing_id,
 }
 
 void LedgerImpl::RemoveRecurring(const std::string& publisher_key) {
+  metrics_->AddCount("db.RemoveRecurring", 1);
   ledger_client_->OnRemoveRecurring(publisher_key, std::bind(&LedgerImpl::OnRemovedRecurring,
                                         this,
                                         _1));
@@ -837,23 +1118,24 @@ void LedgerImpl::LogResponse(const std::string& func_name,
                              bool result,
                              const std::string& response,
                              const std::map<std::string, std::string>& headers) {
-  std::string stat = result ? "Success" : "Failure";
-
-  std::string formatted_headers = "";
-  for (auto header = headers.begin(); header != headers.end(); ++header) {
-    formatted_headers += "> headers " + header->first + ": " + header->second;
-    if (header != headers.end()) {
-      formatted_headers += "\n";
-    }
+  if (!IsLogEnabled(ledger::LogLevel::LOG_RESPONSE)) {
+    return;
   }
 
-  BLOG(this, ledger::LogLevel::LOG_RESPONSE) << std::endl
+  std::unique_ptr<ledger::LogStream> log =
+      Log(__FILE__, __LINE__, ledger::LogLevel::LOG_RESPONSE);
+  std::ostream& stream = log->stream();
+  stream << std::endl
     << "[ RESPONSE - " << func_name << " ]" << std::endl
     << "> time: " << std::time(nullptr) << std::endl
-    << "> result: " << stat << std::endl
-    << "> response: " << response
-    << formatted_headers
-    << "[ END RESPONSE ]";
+    << "> result: " << (result ? "Success" : "Failure") << std::endl
+    << "> response: " << LogPayload(response);
+
+  for (const auto& header : headers) {
+    stream << "> headers " << header.first << ": " << header.second << "\n";
+  }
+
+  stream << "[ END RESPONSE ]";
 }
 
 void LedgerImpl::ResetReconcileStamp() {
@@ -929,6 +1211,27 @@ void LedgerImpl::SetWalletInfo(
   bat_state_->SetWalletInfo(info);
 }
 
+HttpSigner* LedgerImpl::GetWalletSigner() {
+  const std::vector<uint8_t>& seed = GetWalletInfo().keyInfoSeed_;
+  if (wallet_signer_ && wallet_signer_seed_ == seed) {
+    return wallet_signer_.get();
+  }
+
+  wallet_signer_.reset();
+  std::vector<uint8_t> secret_key = braveledger_bat_helper::getHKDF(seed);
+  std::vector<uint8_t> public_key;
+  std::vector<uint8_t> new_secret_key;
+  if (!braveledger_bat_helper::getPublicKeyFromSeed(secret_key,
+                                                    public_key,
+                                                    new_secret_key)) {
+    return nullptr;
+  }
+
+  wallet_signer_.reset(new HttpSigner("primary", new_secret_key));
+  wallet_signer_seed_ = seed;
+  return wallet_signer_.get();
+}
+
 const braveledger_bat_helper::WALLET_PROPERTIES_ST&
 LedgerImpl::GetWalletProperties() const {
   return bat_state_->GetWalletProperties();
@@ -1007,6 +1310,7 @@ void LedgerImpl::SaveContributionInfo(const std::string& probi,
     const uint32_t date,
     const std::string& publisher_key,
     const ledger::PUBLISHER_CATEGORY category) {
+  metrics_->AddCount("db.SaveContributionInfo", 1);
   ledger_client_->SaveContributionInfo(probi,
                                        month,
                                        year,
@@ -1015,16 +1319,13 @@ void LedgerImpl::SaveContributionInfo(const std::string& probi,
                                        category);
 }
 
-void LedgerImpl::NormalizeContributeWinners(
-    ledger::PublisherInfoList* newList,
-    bool saveData,
-    const braveledger_bat_helper::PublisherList& list,
-    uint32_t record) {
-  bat_publishers_->NormalizeContributeWinners(newList, saveData, list, record);
+uint32_t LedgerImpl::SetTimer(uint64_t time_offset,
+                              TimerService::TimerCallback callback) {
+  return timer_service_->Start(time_offset, std::time(nullptr), callback);
 }
 
-void LedgerImpl::SetTimer(uint64_t time_offset, uint32_t& timer_id) const {
-  ledger_client_->SetTimer(time_offset, timer_id);
+void LedgerImpl::CancelTimer(uint32_t timer_id) {
+  timer_service_->Cancel(timer_id);
 }
 
 bool LedgerImpl::AddReconcileStep(const std::string& viewing_id,
@@ -1046,4 +1347,74 @@ double LedgerImpl::GetDefaultContributionAmount() {
   return bat_state_->GetDefaultContributionAmount();
 }
 
+void LedgerImpl::SetMetricsEnabled(bool enabled) {
+  metrics_->SetEnabled(enabled);
+}
+
+void LedgerImpl::SetLogLevel(ledger::LogLevel level) {
+  log_level_.store(level, std::memory_order_relaxed);
+  // request tracing is cheap enough to stay on with LOG_REQUEST. Its short
+  // response previews need LOG_REQUEST as well, the whole bodies are only
+  // logged with LOG_RESPONSE.
+  request_trace_->SetEnabled(IsLogEnabled(ledger::LogLevel::LOG_REQUEST));
+  request_trace_->SetPreviewEnabled(
+      IsLogEnabled(ledger::LogLevel::LOG_REQUEST));
+}
+
+void LedgerImpl::SetRequestTraceTimer() {
+  if (!request_trace_->IsEnabled() || request_trace_timer_id_ != 0 ||
+      request_trace_draining_) {
+    return;
+  }
+
+  request_trace_timer_id_ = SetTimer(
+      braveledger_ledger::_request_trace_drain_interval,
+      std::bind(&LedgerImpl::OnRequestTraceTimer, this));
+}
+
+void LedgerImpl::OnRequestTraceTimer() {
+  request_trace_timer_id_ = 0;
+  if (request_trace_->buffer()->size() == 0) {
+    // requests in flight are traced when they finish
+    if (request_scheduler_->active_count() > 0 ||
+        request_scheduler_->queued_count() > 0) {
+      SetRequestTraceTimer();
+    }
+    return;
+  }
+
+  request_trace_draining_ = true;
+  RunIOTask(std::bind(&LedgerImpl::DrainRequestTrace, this, _1));
+}
+
+void LedgerImpl::DrainRequestTrace(
+    ledger::LedgerTaskRunner::CallerThreadCallback callback) {
+  std::vector<RequestTraceRecord> records;
+  request_trace_->buffer()->Drain(&records,
+                                  request_trace_->buffer()->capacity());
+  callback(std::bind(&LedgerImpl::OnRequestTraceDrained,
+                     this, request_trace_->Format(records)));
+}
+
+void LedgerImpl::OnRequestTraceDrained(const std::string& batch) {
+  request_trace_draining_ = false;
+  if (!batch.empty()) {
+    BLOG(this, ledger::LogLevel::LOG_REQUEST) << std::endl << batch;
+  }
+
+  if (request_trace_->buffer()->size() > 0 ||
+      request_scheduler_->active_count() > 0 ||
+      request_scheduler_->queued_count() > 0) {
+    SetRequestTraceTimer();
+  }
+}
+
+ledger::MetricsSnapshot LedgerImpl::GetMetricsSnapshot() const {
+  return metrics_->GetSnapshot();
+}
+
+LedgerMetrics* LedgerImpl::GetMetrics() {
+  return metrics_.get();
+}
+
 }  // namespace bat_ledger
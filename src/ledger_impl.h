@@ -5,6 +5,7 @@
 #ifndef BAT_LEDGER_LEDGER_IMPL_H_
 #define BAT_LEDGER_LEDGER_IMPL_H_
 
+#include <atomic>
 #include <memory>
 #include <map>
 #include <string>
@@ -15,8 +16,14 @@
 #include "bat/ledger/ledger_client.h"
 #include "bat/ledger/ledger_url_loader.h"
 #include "bat_helper.h"
+#include "http_signature.h"
+#include "ledger_metrics.h"
 #include "ledger_task_runner_impl.h"
+#include "request_trace.h"
 #include "url_request_handler.h"
+#include "url_request_scheduler.h"
+#include "url_response_cache.h"
+#include "timer_service.h"
 #include "logging.h"
 
 namespace braveledger_bat_client {
@@ -69,6 +76,12 @@ class LedgerImpl : public ledger::Ledger,
   void GetPublisherInfoList(uint32_t start, uint32_t limit,
                             const ledger::PublisherInfoFilter& filter,
                             ledger::PublisherInfoListCallback callback) override;
+  // Same as above, but only |count| publishers with the highest score
+  // are kept while the list is read page by page. Their percent and weight
+  // are normalized against all the publishers that were read.
+  void GetTopPublishers(const ledger::PublisherInfoFilter& filter,
+                        size_t count,
+                        ledger::PublisherInfoListCallback callback);
 
   void DoDirectDonation(const ledger::PublisherInfo& publisher, const int amount, const std::string& currency) override;
 
@@ -104,17 +117,23 @@ class LedgerImpl : public ledger::Ledger,
   std::map<std::string, ledger::BalanceReportInfo> GetAllBalanceReports() const override;
 
   void SaveLedgerState(const std::string& data);
+  void SaveLedgerHistory(const std::string& data);
   void SavePublisherState(const std::string& data,
                           ledger::LedgerCallbackHandler* handler);
   void SavePublishersList(const std::string& data);
   void LoadNicewareList(ledger::GetNicewareListCallback callback);
 
   void LoadLedgerState(ledger::LedgerCallbackHandler* handler);
+  void LoadLedgerHistory(ledger::LedgerCallbackHandler* handler);
   void LoadPublisherState(ledger::LedgerCallbackHandler* handler);
   void LoadPublisherList(ledger::LedgerCallbackHandler* handler);
 
   void OnWalletInitialized(ledger::Result result);
 
+  // Verified and excluded flags of publishers aren't known until the stored
+  // publisher list is parsed
+  bool IsPublisherListWarming() const;
+
   void OnWalletProperties(ledger::Result result,
                           const braveledger_bat_helper::WALLET_PROPERTIES_ST&);
   void FetchWalletProperties() const override;
@@ -132,7 +151,8 @@ class LedgerImpl : public ledger::Ledger,
   void RecoverWallet(const std::string& passPhrase) const override;
   void OnRecoverWallet(ledger::Result result, double balance, const std::vector<braveledger_bat_helper::GRANT>& grants);
 
-  void LoadPublishersListCallback(bool result, const std::string& response,
+  void LoadPublishersListCallback(int response_code,
+      const std::string& response,
       const std::map<std::string, std::string>& headers);
 
   void OnPublishersListSaved(ledger::Result result) override;
@@ -143,6 +163,8 @@ class LedgerImpl : public ledger::Ledger,
       const std::string& contentType,
       const ledger::URL_METHOD& method,
       ledger::LedgerCallbackHandler* handler);
+  URLRequestScheduler* GetURLRequestScheduler();
+  URLResponseCache* GetURLResponseCache();
   void OnReconcileComplete(ledger::Result result,
                            const std::string& viewing_id,
                            const std::string& probi = "0");
@@ -194,6 +216,10 @@ class LedgerImpl : public ledger::Ledger,
       ledger::PUBLISHER_EXCLUDE_FILTER excluded,
       bool min_duration,
       const uint64_t& currentReconcileStamp);
+  // BLOG only asks for a stream when the level is enabled
+  bool IsLogEnabled(ledger::LogLevel log_level) const {
+    return log_level <= log_level_.load(std::memory_order_relaxed);
+  }
   std::unique_ptr<ledger::LogStream> Log(
       const char* file,
       int line,
@@ -224,6 +250,9 @@ class LedgerImpl : public ledger::Ledger,
   void SetPreFlight(const std::string& pre_flight);
   const braveledger_bat_helper::WALLET_INFO_ST& GetWalletInfo() const;
   void SetWalletInfo(const braveledger_bat_helper::WALLET_INFO_ST& info);
+  // Signer of the wallet key, derived once and kept until the key seed
+  // changes. nullptr when no key can be derived from the seed.
+  HttpSigner* GetWalletSigner();
 
   const braveledger_bat_helper::WALLET_PROPERTIES_ST&
   GetWalletProperties() const;
@@ -265,13 +294,10 @@ class LedgerImpl : public ledger::Ledger,
                             const std::string& publisher_key,
                             const ledger::PUBLISHER_CATEGORY category);
 
-  void NormalizeContributeWinners(
-      ledger::PublisherInfoList* newList,
-      bool saveData,
-      const braveledger_bat_helper::PublisherList& list,
-      uint32_t /* next_record */);
-
-  void SetTimer(uint64_t time_offset, uint32_t& timer_id) const;
+  // Returns handle that can be used to cancel the timer
+  uint32_t SetTimer(uint64_t time_offset,
+                    TimerService::TimerCallback callback);
+  void CancelTimer(uint32_t timer_id);
 
   bool AddReconcileStep(const std::string& viewing_id,
                         braveledger_bat_helper::ContributionRetry step,
@@ -280,6 +306,11 @@ class LedgerImpl : public ledger::Ledger,
   const braveledger_bat_helper::CurrentReconciles& GetCurrentReconciles() const;
   double GetDefaultContributionAmount() override;
 
+  void SetMetricsEnabled(bool enabled) override;
+  ledger::MetricsSnapshot GetMetricsSnapshot() const override;
+  void SetLogLevel(ledger::LogLevel level) override;
+  LedgerMetrics* GetMetrics();
+
  private:
   void MakePayment(const ledger::PaymentData& payment_data) override;
   void AddRecurringPayment(const std::string& publisher_id, const double& value) override;
@@ -321,22 +352,87 @@ class LedgerImpl : public ledger::Ledger,
                               const std::string& data) override;
   void OnLedgerStateLoaded(ledger::Result result,
                            const std::string& data) override;
+  void OnLedgerHistoryLoaded(ledger::Result result,
+                             const std::string& data) override;
 
   void RefreshPublishersList(bool retryAfterError);
   void RefreshGrant(bool retryAfterError);
+  void OnPublishersListTimer();
+  void OnGrantTimer();
 
   void OnPublisherListLoaded(ledger::Result result,
                              const std::string& data) override;
   uint64_t retryRequestSetup(uint64_t min_time, uint64_t max_time);
 
+  // Stored state is parsed on IO threads, the results are taken on the
+  // ledger thread
+  void ParseLedgerState(
+      const std::string& data,
+      ledger::LedgerTaskRunner::CallerThreadCallback callback);
+  void OnLedgerStateParsed(
+      bool success,
+      std::shared_ptr<braveledger_bat_helper::CLIENT_STATE_ST> state,
+      size_t data_size);
+  void ParsePublisherState(
+      const std::string& data,
+      ledger::LedgerTaskRunner::CallerThreadCallback callback);
+  void OnPublisherStateParsed(
+      bool success,
+      std::shared_ptr<braveledger_bat_helper::PUBLISHER_STATE_ST> state,
+      size_t data_size);
+  void ParsePublisherList(
+      const std::string& data,
+      ledger::LedgerTaskRunner::CallerThreadCallback callback);
+  void OnPublisherListParsed(
+      bool success,
+      std::shared_ptr<
+          std::map<std::string, braveledger_bat_helper::SERVER_LIST>> list,
+      size_t data_size);
+  // Wallet is initialized once both states are in
+  void OnStartupStateLoaded();
+
+  // Trace records are formatted on an IO thread and logged in batches
+  void SetRequestTraceTimer();
+  void OnRequestTraceTimer();
+  void DrainRequestTrace(
+      ledger::LedgerTaskRunner::CallerThreadCallback callback);
+  void OnRequestTraceDrained(const std::string& batch);
+  // Refresh needs the wallet and the stored list, the validators of the
+  // stored list are kept in the publisher state
+  void RefreshStoredPublishersList();
+
+  enum class PublisherListStage {
+    NOT_LOADED,
+    WARMING,
+    READY,
+  };
+
   ledger::LedgerClient* ledger_client_;
+  // BLOG runs on IO threads too
+  std::atomic<int> log_level_;
+  std::unique_ptr<LedgerMetrics> metrics_;
+  std::unique_ptr<RequestTrace> request_trace_;
+  // needs to outlive the components, they schedule requests through it
+  std::unique_ptr<URLRequestScheduler> request_scheduler_;
+  std::unique_ptr<URLResponseCache> response_cache_;
+  std::unique_ptr<TimerService> timer_service_;
   std::unique_ptr<braveledger_bat_client::BatClient> bat_client_;
   std::unique_ptr<braveledger_bat_publishers::BatPublishers> bat_publishers_;
   std::unique_ptr<braveledger_bat_get_media::BatGetMedia> bat_get_media_;
   std::unique_ptr<braveledger_bat_state::BatState> bat_state_;
   std::unique_ptr<braveledger_bat_contribution::BatContribution> bat_contribution_;
+  std::unique_ptr<HttpSigner> wallet_signer_;
+  // the seed |wallet_signer_| was derived from
+  std::vector<uint8_t> wallet_signer_seed_;
   bool initialized_;
   bool initializing_;
+  uint64_t startup_start_;
+  int pending_startup_loads_;
+  ledger::Result ledger_state_result_;
+  ledger::Result ledger_history_result_;
+  ledger::Result publisher_state_result_;
+  PublisherListStage publisher_list_stage_;
+  bool publisher_list_stored_;
 
   URLRequestHandler handler_;
 
@@ -346,6 +442,10 @@ class LedgerImpl : public ledger::Ledger,
   uint32_t last_shown_tab_id_;
   uint32_t last_pub_load_timer_id_;
   uint32_t last_grant_check_timer_id_;
+  uint32_t request_trace_timer_id_;
+  bool request_trace_draining_;
+  // reused by OnPostData for decoding media payloads
+  std::vector<uint8_t> media_scratch_;
  };
 }  // namespace bat_ledger
 
@@ -0,0 +1,236 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "ledger_metrics.h"
+
+#include <chrono>
+#include <iterator>
+
+#include "static_values.h"
+
+namespace bat_ledger {
+
+namespace {
+
+// Upper bounds of the latency buckets in milliseconds, last bucket
+// takes the rest
+const uint64_t kBucketBounds[] = {
+  1, 2, 5, 10, 20, 50, 100, 200, 500, 1000, 2000, 5000, 10000, 30000, 60000
+};
+
+// Paths passed to buildURL, checked in this order
+const char* const kEndpointPaths[] = {
+  REGISTER_PERSONA,
+  REGISTER_VIEWING,
+  RECONCILE_CONTRIBUTION,
+  SURVEYOR_BATCH_VOTING,
+  SURVEYOR_VOTING,
+  WALLET_PROPERTIES,
+  GET_SET_PROMOTION,
+  GET_PROMOTION_CAPTCHA,
+  GET_PUBLISHERS_LIST_V1,
+  UPDATE_RULES_V1,
+  UPDATE_RULES_V2,
+};
+
+// Matches whole path segments, "/wallet" matches "/wallet/id/balance"
+// but not "/wallets"
+bool MatchesPath(const std::string& path, const std::string& prefix) {
+  return path.compare(0, prefix.length(), prefix) == 0 &&
+      (path.length() == prefix.length() || path[prefix.length()] == '/');
+}
+
+std::string TrimPath(const std::string& path) {
+  std::string trimmed = path.substr(0, path.find('?'));
+  while (trimmed.length() > 1 && trimmed[trimmed.length() - 1] == '/') {
+    trimmed.erase(trimmed.length() - 1);
+  }
+
+  return trimmed;
+}
+
+}  // namespace
+
+LedgerMetrics::Histogram::Histogram() : count(0), sum(0) {
+  for (auto& bucket : buckets) {
+    bucket = 0;
+  }
+}
+
+LedgerMetrics::Histogram::~Histogram() {}
+
+LedgerMetrics::LedgerMetrics() : enabled_(false) {
+  static_assert(sizeof(kBucketBounds) / sizeof(kBucketBounds[0]) + 1 ==
+                    kBuckets,
+                "every bound needs a bucket, plus one for the rest");
+}
+
+LedgerMetrics::~LedgerMetrics() {}
+
+void LedgerMetrics::SetEnabled(bool enabled) {
+  enabled_.store(enabled, std::memory_order_relaxed);
+  if (!enabled) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    requests_.clear();
+  }
+}
+
+bool LedgerMetrics::IsEnabled() const {
+  return enabled_.load(std::memory_order_relaxed);
+}
+
+// static
+uint64_t LedgerMetrics::Now() {
+  return std::chrono::duration_cast<std::chrono::milliseconds>(
+      std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// static
+std::string LedgerMetrics::GetEndpoint(const std::string& url) {
+  size_t start = url.find("://");
+  start = (start == std::string::npos) ? 0 : start + 3;
+  size_t end = url.find_first_of("/?#", start);
+  if (end == std::string::npos) {
+    return url.substr(start);
+  }
+
+  std::string host = url.substr(start, end - start);
+  std::string path = TrimPath(url.substr(end));
+  const std::string prefix = PREFIX_V2;
+  if (MatchesPath(path, prefix)) {
+    path.erase(0, prefix.length());
+  }
+
+  for (const char* endpoint : kEndpointPaths) {
+    std::string endpoint_path = TrimPath(endpoint);
+    if (MatchesPath(path, endpoint_path)) {
+      return host + endpoint_path;
+    }
+  }
+
+  return host;
+}
+
+std::atomic<uint64_t>* LedgerMetrics::GetCounter(const std::string& name) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto& counter = counters_[name];
+  if (!counter) {
+    counter.reset(new std::atomic<uint64_t>(0));
+  }
+
+  return counter.get();
+}
+
+LedgerMetrics::Histogram* LedgerMetrics::GetHistogram(
+    const std::string& name) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto& histogram = histograms_[name];
+  if (!histogram) {
+    histogram.reset(new Histogram());
+  }
+
+  return histogram.get();
+}
+
+void LedgerMetrics::AddCount(const char* name, uint64_t value) {
+  if (!IsEnabled()) {
+    return;
+  }
+
+  GetCounter(name)->fetch_add(value, std::memory_order_relaxed);
+}
+
+uint64_t LedgerMetrics::StartTime() const {
+  return IsEnabled() ? Now() : 0;
+}
+
+void LedgerMetrics::AddTime(const char* name, uint64_t start) {
+  if (!IsEnabled() || start == 0) {
+    return;
+  }
+
+  AddHistogramTime(name, start);
+}
+
+void LedgerMetrics::AddHistogramTime(const std::string& name,
+                                     uint64_t start) {
+  uint64_t now = Now();
+  uint64_t time = now > start ? now - start : 0;
+  size_t bucket = 0;
+  while (bucket < kBuckets - 1 && time > kBucketBounds[bucket]) {
+    bucket++;
+  }
+
+  Histogram* histogram = GetHistogram(name);
+  histogram->buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+  histogram->count.fetch_add(1, std::memory_order_relaxed);
+  histogram->sum.fetch_add(time, std::memory_order_relaxed);
+}
+
+void LedgerMetrics::OnRequestStarted(uint64_t request_id,
+                                     const std::string& url) {
+  if (!IsEnabled()) {
+    return;
+  }
+
+  PendingRequest request;
+  request.endpoint = GetEndpoint(url);
+  request.start = Now();
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  requests_[request_id] = request;
+}
+
+void LedgerMetrics::OnRequestFinished(uint64_t request_id) {
+  if (!IsEnabled()) {
+    return;
+  }
+
+  PendingRequest request;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto iter = requests_.find(request_id);
+    if (iter == requests_.end()) {
+      return;
+    }
+    request = iter->second;
+    requests_.erase(iter);
+  }
+
+  AddHistogramTime("request." + request.endpoint, request.start);
+}
+
+void LedgerMetrics::OnRequestCancelled(uint64_t request_id) {
+  if (!IsEnabled()) {
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  requests_.erase(request_id);
+}
+
+ledger::MetricsSnapshot LedgerMetrics::GetSnapshot() const {
+  ledger::MetricsSnapshot snapshot;
+  snapshot.enabled = IsEnabled();
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (const auto& counter : counters_) {
+    snapshot.counters[counter.first] =
+        counter.second->load(std::memory_order_relaxed);
+  }
+
+  for (const auto& histogram : histograms_) {
+    ledger::HistogramSnapshot& values = snapshot.histograms[histogram.first];
+    values.bounds.assign(std::begin(kBucketBounds), std::end(kBucketBounds));
+    for (const auto& bucket : histogram.second->buckets) {
+      values.buckets.push_back(bucket.load(std::memory_order_relaxed));
+    }
+    values.count = histogram.second->count.load(std::memory_order_relaxed);
+    values.sum = histogram.second->sum.load(std::memory_order_relaxed);
+  }
+
+  return snapshot;
+}
+
+}  // namespace bat_ledger
@@ -0,0 +1,84 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef BAT_LEDGER_LEDGER_METRICS_H_
+#define BAT_LEDGER_LEDGER_METRICS_H_
+
+#include <stdint.h>
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "bat/ledger/metrics_snapshot.h"
+
+namespace bat_ledger {
+
+// Counters and latency histograms of the ledger. Everything is a no-op
+// until the metrics are enabled. Values are atomic and the maps are
+// guarded, so anonize proofs can be timed from the IO task threads.
+class LedgerMetrics {
+ public:
+  LedgerMetrics();
+  ~LedgerMetrics();
+
+  void SetEnabled(bool enabled);
+  bool IsEnabled() const;
+
+  // Names are literals, nothing is built for them while disabled
+  void AddCount(const char* name, uint64_t value);
+  // Start of a timing for AddTime(). The clock is only read when the
+  // metrics are enabled, 0 otherwise.
+  uint64_t StartTime() const;
+  // Adds time since |start|, which came from StartTime(). Timings that
+  // started while disabled are skipped.
+  void AddTime(const char* name, uint64_t start);
+
+  // Request latency is kept per endpoint, see GetEndpoint()
+  void OnRequestStarted(uint64_t request_id, const std::string& url);
+  void OnRequestFinished(uint64_t request_id);
+  void OnRequestCancelled(uint64_t request_id);
+
+  ledger::MetricsSnapshot GetSnapshot() const;
+
+  // Milliseconds of the monotonic clock
+  static uint64_t Now();
+
+  // Host and path of the ledger endpoints built with buildURL, ids and
+  // query of the url are left out. Other urls are counted per host.
+  static std::string GetEndpoint(const std::string& url);
+
+ private:
+  static const size_t kBuckets = 16;
+
+  struct Histogram {
+    Histogram();
+    ~Histogram();
+
+    std::atomic<uint64_t> buckets[kBuckets];
+    std::atomic<uint64_t> count;
+    std::atomic<uint64_t> sum;
+  };
+
+  struct PendingRequest {
+    std::string endpoint;
+    uint64_t start;
+  };
+
+  std::atomic<uint64_t>* GetCounter(const std::string& name);
+  Histogram* GetHistogram(const std::string& name);
+  void AddHistogramTime(const std::string& name, uint64_t start);
+
+  std::atomic<bool> enabled_;
+  mutable std::mutex mutex_;
+  std::map<std::string, std::unique_ptr<std::atomic<uint64_t>>> counters_;
+  std::map<std::string, std::unique_ptr<Histogram>> histograms_;
+  std::map<uint64_t, PendingRequest> requests_;
+};
+
+}  // namespace bat_ledger
+
+#endif  // BAT_LEDGER_LEDGER_METRICS_H_
@@ -0,0 +1,178 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "ledger_task_executor_impl.h"
+
+#include <utility>
+
+#include "bat_helper_platform.h"
+
+namespace bat_ledger {
+
+namespace {
+
+// Pool and queue of the current thread, used to keep tasks that are
+// added by a running task on the same thread
+thread_local const LedgerTaskExecutorImpl* current_executor = nullptr;
+thread_local size_t current_worker = 0;
+
+}  // namespace
+
+LedgerTaskExecutorImpl::LedgerTaskExecutorImpl(size_t threads,
+                                               PostReplyCallback post_reply) :
+  post_reply_(post_reply),
+  pending_(0),
+  next_worker_(0),
+  stopping_(false) {
+  if (threads == 0) {
+    threads = std::thread::hardware_concurrency();
+  }
+  if (threads == 0) {
+    threads = 1;
+  }
+
+  for (size_t i = 0; i < threads; i++) {
+    workers_.push_back(std::unique_ptr<Worker>(new Worker()));
+  }
+
+  // threads are started once all the queues exist
+  for (size_t i = 0; i < threads; i++) {
+    workers_[i]->thread =
+        std::thread(&LedgerTaskExecutorImpl::WorkerLoop, this, i);
+  }
+}
+
+LedgerTaskExecutorImpl::~LedgerTaskExecutorImpl() {
+  Shutdown();
+}
+
+void LedgerTaskExecutorImpl::RunIOTask(
+    std::unique_ptr<ledger::LedgerTaskRunner> task) {
+  size_t index = current_executor == this ?
+      current_worker : next_worker_++ % workers_.size();
+
+  {
+    // job is added under the lock, so that threads can't stop or
+    // go to sleep without seeing it. Pool threads keep running until
+    // their queue is empty, so they can still add jobs while stopping.
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!stopping_ || current_executor == this) {
+      {
+        std::lock_guard<std::mutex> worker_lock(workers_[index]->mutex);
+        workers_[index]->jobs.push_back(std::move(task));
+      }
+      pending_++;
+    }
+  }
+
+  if (task) {
+    // pool is stopped
+    RunJob(std::move(task));
+    return;
+  }
+
+  wake_up_.notify_one();
+}
+
+size_t LedgerTaskExecutorImpl::RunReplies() {
+  std::deque<Closure> replies;
+  {
+    std::lock_guard<std::mutex> lock(replies_mutex_);
+    replies.swap(replies_);
+  }
+
+  for (auto& reply : replies) {
+    reply();
+  }
+
+  return replies.size();
+}
+
+void LedgerTaskExecutorImpl::Shutdown() {
+  // a pool thread would wait to join itself
+  DCHECK(current_executor != this);
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (stopping_) {
+      return;
+    }
+    stopping_ = true;
+  }
+  wake_up_.notify_all();
+
+  for (auto& worker : workers_) {
+    if (worker->thread.joinable()) {
+      worker->thread.join();
+    }
+  }
+}
+
+void LedgerTaskExecutorImpl::WorkerLoop(size_t index) {
+  current_executor = this;
+  current_worker = index;
+
+  while (true) {
+    Job job;
+    if (PopJob(index, &job)) {
+      RunJob(std::move(job));
+      continue;
+    }
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    wake_up_.wait(lock, [this]() {
+      return stopping_ || pending_ > 0;
+    });
+
+    // queued jobs are finished before the thread stops
+    if (stopping_ && pending_ == 0) {
+      break;
+    }
+  }
+
+  current_executor = nullptr;
+}
+
+bool LedgerTaskExecutorImpl::PopJob(size_t index, Job* job) {
+  {
+    Worker& worker = *workers_[index];
+    std::lock_guard<std::mutex> lock(worker.mutex);
+    if (!worker.jobs.empty()) {
+      *job = std::move(worker.jobs.back());
+      worker.jobs.pop_back();
+      pending_--;
+      return true;
+    }
+  }
+
+  for (size_t i = 1; i < workers_.size(); i++) {
+    Worker& victim = *workers_[(index + i) % workers_.size()];
+    std::lock_guard<std::mutex> lock(victim.mutex);
+    if (!victim.jobs.empty()) {
+      *job = std::move(victim.jobs.front());
+      victim.jobs.pop_front();
+      pending_--;
+      return true;
+    }
+  }
+
+  return false;
+}
+
+void LedgerTaskExecutorImpl::RunJob(Job job) {
+  job->Run(std::bind(&LedgerTaskExecutorImpl::PostReply,
+                     this,
+                     std::placeholders::_1));
+}
+
+void LedgerTaskExecutorImpl::PostReply(Closure reply) {
+  if (post_reply_) {
+    post_reply_(reply);
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(replies_mutex_);
+  replies_.push_back(reply);
+}
+
+}  // namespace bat_ledger
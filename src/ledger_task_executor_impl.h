@@ -0,0 +1,65 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef BAT_LEDGER_LEDGER_TASK_EXECUTOR_IMPL_
+#define BAT_LEDGER_LEDGER_TASK_EXECUTOR_IMPL_
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "bat/ledger/ledger_task_executor.h"
+
+namespace bat_ledger {
+
+// Work stealing pool. Every thread has its own queue, tasks added by
+// a pool thread go to its queue and are taken newest first, so related
+// work stays on the same thread. Idle threads steal the oldest tasks
+// from the other queues. Tasks from other threads are spread round robin.
+class LedgerTaskExecutorImpl : public ledger::LedgerTaskExecutor {
+ public:
+  LedgerTaskExecutorImpl(size_t threads, PostReplyCallback post_reply);
+  ~LedgerTaskExecutorImpl() override;
+
+  void RunIOTask(std::unique_ptr<ledger::LedgerTaskRunner> task) override;
+  size_t RunReplies() override;
+  void Shutdown() override;
+
+  size_t threads() const { return workers_.size(); }
+
+ private:
+  using Job = std::unique_ptr<ledger::LedgerTaskRunner>;
+
+  struct Worker {
+    std::mutex mutex;
+    std::deque<Job> jobs;
+    std::thread thread;
+  };
+
+  void WorkerLoop(size_t index);
+  bool PopJob(size_t index, Job* job);
+  void RunJob(Job job);
+  void PostReply(Closure reply);
+
+  PostReplyCallback post_reply_;
+  std::vector<std::unique_ptr<Worker>> workers_;
+  std::atomic<size_t> pending_;
+  std::atomic<size_t> next_worker_;
+
+  // guards |stopping_| and is used to wait for jobs
+  std::mutex mutex_;
+  std::condition_variable wake_up_;
+  bool stopping_;
+
+  std::mutex replies_mutex_;
+  std::deque<Closure> replies_;
+};
+
+}  // namespace bat_ledger
+
+#endif  // BAT_LEDGER_LEDGER_TASK_EXECUTOR_IMPL_
@@ -4,9 +4,12 @@
 
 #include "ledger_task_runner_impl.h"
 
+#include <utility>
+
 namespace bat_ledger {
 
-LedgerTaskRunnerImpl::LedgerTaskRunnerImpl(Task task) : task_(task) {}
+LedgerTaskRunnerImpl::LedgerTaskRunnerImpl(Task task)
+    : task_(std::move(task)) {}
 LedgerTaskRunnerImpl::~LedgerTaskRunnerImpl() {}
 
 void LedgerTaskRunnerImpl::Run(const CallerThreadCallback& callback) {
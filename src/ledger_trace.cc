@@ -0,0 +1,228 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "ledger_trace.h"
+
+#include <stdlib.h>
+
+#include <iomanip>
+#include <limits>
+#include <sstream>
+#include <utility>
+
+namespace bat_ledger {
+
+namespace {
+
+// Fields of EncodePublisherInfo() in this order
+const size_t kPublisherInfoFields = 16;
+
+void WriteFields(const std::vector<std::string>& fields,
+                 std::ostream* stream) {
+  for (const auto& field : fields) {
+    *stream << field.size() << '\n';
+    stream->write(field.data(), field.size());
+    *stream << '\n';
+  }
+}
+
+// Smallest encoded field: an empty one, "0\n\n"
+const uint64_t kMinFieldSize = 3;
+
+// Bytes between the read position and the end of |stream|, so lengths
+// and counts from a corrupt trace are rejected before anything is
+// allocated for them
+uint64_t BytesLeft(std::istream* stream) {
+  std::istream::pos_type position = stream->tellg();
+  if (position == std::istream::pos_type(-1)) {
+    return 0;
+  }
+
+  stream->seekg(0, std::ios::end);
+  std::istream::pos_type end = stream->tellg();
+  stream->seekg(position);
+  if (end == std::istream::pos_type(-1) || end < position) {
+    return 0;
+  }
+
+  return static_cast<uint64_t>(end - position);
+}
+
+bool ReadFields(std::istream* stream,
+                uint64_t count,
+                std::vector<std::string>* fields) {
+  fields->clear();
+  uint64_t left = BytesLeft(stream);
+  if (count > left / kMinFieldSize) {
+    return false;
+  }
+
+  fields->reserve(count);
+  std::string line;
+  for (uint64_t i = 0; i < count; i++) {
+    if (!std::getline(*stream, line) || line.empty()) {
+      return false;
+    }
+
+    char* end = nullptr;
+    uint64_t length = strtoull(line.c_str(), &end, 10);
+    if (*end != '\0' || line[0] == '-') {
+      return false;
+    }
+
+    // the length line, the field and its closing newline
+    uint64_t line_size = line.size() + 1;
+    if (line_size > left || length >= left - line_size) {
+      return false;
+    }
+    left -= line_size + length + 1;
+
+    std::string field(length, '\0');
+    if (length > 0 && !stream->read(&field[0], length)) {
+      return false;
+    }
+
+    if (stream->get() != '\n') {
+      return false;
+    }
+
+    fields->push_back(std::move(field));
+  }
+
+  return true;
+}
+
+std::string DoubleToString(double value) {
+  std::ostringstream stream;
+  stream << std::setprecision(std::numeric_limits<double>::max_digits10)
+         << value;
+  return stream.str();
+}
+
+}  // namespace
+
+TraceRecord::TraceRecord() : direction(CALL), time(0), call(0) {}
+
+TraceRecord::TraceRecord(const TraceRecord& record) :
+  direction(record.direction),
+  type(record.type),
+  time(record.time),
+  call(record.call),
+  fields(record.fields) {}
+
+TraceRecord::~TraceRecord() {}
+
+void WriteTraceRecord(const TraceRecord& record, std::ostream* stream) {
+  *stream << (record.direction == TraceRecord::CALL ? 'C' : 'R') << ' '
+          << record.type << ' '
+          << record.time << ' '
+          << record.call << ' '
+          << record.fields.size() << '\n';
+  WriteFields(record.fields, stream);
+}
+
+bool ReadTraceRecord(std::istream* stream, TraceRecord* record) {
+  std::string line;
+  if (!std::getline(*stream, line) || line.empty()) {
+    return false;
+  }
+
+  std::istringstream header(line);
+  char direction = 0;
+  uint64_t count = 0;
+  if (!(header >> direction >> record->type >> record->time >> record->call >>
+        count)) {
+    return false;
+  }
+
+  if (direction != 'C' && direction != 'R') {
+    return false;
+  }
+
+  record->direction =
+      direction == 'C' ? TraceRecord::CALL : TraceRecord::RESULT;
+  return ReadFields(stream, count, &record->fields);
+}
+
+std::string EncodeTraceFields(const std::vector<std::string>& fields) {
+  std::ostringstream stream;
+  stream << fields.size() << '\n';
+  WriteFields(fields, &stream);
+  return stream.str();
+}
+
+bool DecodeTraceFields(const std::string& data,
+                       std::vector<std::string>* fields) {
+  std::istringstream stream(data);
+  std::string line;
+  if (!std::getline(stream, line) || line.empty()) {
+    return false;
+  }
+
+  char* end = nullptr;
+  uint64_t count = strtoull(line.c_str(), &end, 10);
+  if (*end != '\0') {
+    return false;
+  }
+
+  return ReadFields(&stream, count, fields);
+}
+
+std::string EncodePublisherInfo(const ledger::PublisherInfo& info) {
+  std::vector<std::string> fields;
+  fields.reserve(kPublisherInfoFields);
+  fields.push_back(info.id);
+  fields.push_back(std::to_string(info.duration));
+  fields.push_back(DoubleToString(info.score));
+  fields.push_back(std::to_string(info.visits));
+  fields.push_back(std::to_string(info.percent));
+  fields.push_back(DoubleToString(info.weight));
+  fields.push_back(std::to_string(info.excluded));
+  fields.push_back(std::to_string(info.category));
+  fields.push_back(std::to_string(info.month));
+  fields.push_back(std::to_string(info.year));
+  fields.push_back(std::to_string(info.reconcile_stamp));
+  fields.push_back(info.verified ? "1" : "0");
+  fields.push_back(info.name);
+  fields.push_back(info.url);
+  fields.push_back(info.provider);
+  fields.push_back(info.favicon_url);
+  return EncodeTraceFields(fields);
+}
+
+bool DecodePublisherInfo(const std::string& data,
+                         ledger::PublisherInfo* info) {
+  std::vector<std::string> fields;
+  if (!DecodeTraceFields(data, &fields) ||
+      fields.size() != kPublisherInfoFields) {
+    return false;
+  }
+
+  info->id = fields[0];
+  info->duration = TraceFieldToUint64(fields[1]);
+  info->score = strtod(fields[2].c_str(), nullptr);
+  info->visits = static_cast<uint32_t>(TraceFieldToUint64(fields[3]));
+  info->percent = static_cast<uint32_t>(TraceFieldToUint64(fields[4]));
+  info->weight = strtod(fields[5].c_str(), nullptr);
+  info->excluded = static_cast<ledger::PUBLISHER_EXCLUDE>(
+      strtol(fields[6].c_str(), nullptr, 10));
+  info->category = static_cast<ledger::PUBLISHER_CATEGORY>(
+      strtol(fields[7].c_str(), nullptr, 10));
+  info->month = static_cast<ledger::PUBLISHER_MONTH>(
+      strtol(fields[8].c_str(), nullptr, 10));
+  info->year = static_cast<int>(strtol(fields[9].c_str(), nullptr, 10));
+  info->reconcile_stamp = TraceFieldToUint64(fields[10]);
+  info->verified = fields[11] == "1";
+  info->name = fields[12];
+  info->url = fields[13];
+  info->provider = fields[14];
+  info->favicon_url = fields[15];
+  return true;
+}
+
+uint64_t TraceFieldToUint64(const std::string& field) {
+  return strtoull(field.c_str(), nullptr, 10);
+}
+
+}  // namespace bat_ledger
@@ -0,0 +1,60 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef BAT_LEDGER_LEDGER_TRACE_H_
+#define BAT_LEDGER_LEDGER_TRACE_H_
+
+#include <stdint.h>
+
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "bat/ledger/publisher_info.h"
+
+namespace bat_ledger {
+
+// One call that crossed the LedgerClient boundary, or the result that
+// came back for it. Results have the |call| of the call they answer.
+struct TraceRecord {
+  enum Direction {
+    CALL = 0,  // ledger -> client
+    RESULT = 1,  // client -> ledger
+  };
+
+  TraceRecord();
+  TraceRecord(const TraceRecord& record);
+  ~TraceRecord();
+
+  Direction direction;
+  std::string type;
+  uint64_t time;  // ms since the recording started
+  uint64_t call;
+  std::vector<std::string> fields;
+};
+
+// Record is a "<C|R> <type> <time> <call> <fields>" line followed by
+// every field as "<length>\n<bytes>\n", so that responses and state
+// don't need escaping.
+void WriteTraceRecord(const TraceRecord& record, std::ostream* stream);
+
+// Returns false at the end of the trace and when the record is malformed
+bool ReadTraceRecord(std::istream* stream, TraceRecord* record);
+
+// Nested lists, e.g. records of a publisher info list, are kept in a
+// single field with the same encoding
+std::string EncodeTraceFields(const std::vector<std::string>& fields);
+bool DecodeTraceFields(const std::string& data,
+                       std::vector<std::string>* fields);
+
+// Contributions are not part of the trace, the ledger doesn't read them
+std::string EncodePublisherInfo(const ledger::PublisherInfo& info);
+bool DecodePublisherInfo(const std::string& data, ledger::PublisherInfo* info);
+
+uint64_t TraceFieldToUint64(const std::string& field);
+
+}  // namespace bat_ledger
+
+#endif  // BAT_LEDGER_LEDGER_TRACE_H_
@@ -5,7 +5,56 @@
 #ifndef BAT_REWARDS_LOGGING_H_
 #define BAT_REWARDS_LOGGING_H_
 
+#include <stddef.h>
+
+#include <ostream>
+#include <string>
+
+// |client| is the LedgerImpl. Levels above the one set with
+// Ledger::SetLogLevel() don't get a stream and the streamed arguments
+// aren't evaluated.
 #define BLOG(client, severity) \
-  client->Log(__FILE__, __LINE__, severity)->stream()
+  !(client)->IsLogEnabled(severity) ? (void) 0 : \
+      bat_ledger::LogMessageVoidify() & \
+          (client)->Log(__FILE__, __LINE__, severity)->stream()
+
+namespace bat_ledger {
+
+// Stored state and the publisher list run into megabytes, only the
+// beginning of them is logged
+const size_t kMaxLogPayloadSize = 4096;
+
+// Makes the stream of BLOG void, so that it matches the other branch of
+// the level check. & binds looser than <<, but tighter than ?:.
+class LogMessageVoidify {
+ public:
+  LogMessageVoidify() {}
+  void operator&(std::ostream&) {}
+};
+
+// BLOG(...) << LogPayload(data) writes at most |max_size| bytes of |data|
+class LogPayload {
+ public:
+  explicit LogPayload(const std::string& data,
+                      size_t max_size = kMaxLogPayloadSize) :
+    data_(data),
+    max_size_(max_size) {}
+
+  friend std::ostream& operator<<(std::ostream& stream,
+                                  const LogPayload& payload) {
+    if (payload.data_.size() <= payload.max_size_) {
+      return stream << payload.data_;
+    }
+
+    stream.write(payload.data_.data(), payload.max_size_);
+    return stream << "... (" << payload.data_.size() << " bytes)";
+  }
+
+ private:
+  const std::string& data_;
+  size_t max_size_;
+};
+
+}  // namespace bat_ledger
 
 #endif  // BAT_REWARDS_LOGGING_H_
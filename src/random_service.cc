@@ -0,0 +1,113 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "random_service.h"
+
+#include <string.h>
+
+#include <algorithm>
+
+#include <openssl/chacha.h>
+#include <openssl/rand.h>
+
+#include "bat_helper_platform.h"
+
+namespace bat_ledger {
+
+namespace {
+
+const uint8_t kNonce[12] = {};
+
+}  // namespace
+
+// static
+RandomService* RandomService::GetInstance() {
+  // never destroyed, ledgers can still run on IO threads at exit
+  static RandomService* instance = new RandomService();
+  return instance;
+}
+
+RandomService::RandomService() :
+  position_(kBufferSize),
+  seeded_(false),
+  counter_(0) {
+  memset(key_, 0, sizeof(key_));
+}
+
+RandomService::~RandomService() {
+}
+
+void RandomService::Refill() {
+  if (seeded_) {
+    static const uint8_t zeros[kBufferSize] = {};
+    CRYPTO_chacha_20(buffer_, zeros, kBufferSize, key_, kNonce, counter_);
+    counter_ += kBufferSize / 64;
+  } else {
+    // BoringSSL aborts instead of failing
+    RAND_bytes(buffer_, kBufferSize);
+  }
+
+  position_ = 0;
+}
+
+void RandomService::RandBytes(uint8_t* out, size_t length) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  while (length > 0) {
+    if (position_ == kBufferSize) {
+      Refill();
+    }
+
+    size_t count = std::min(length, kBufferSize - position_);
+    memcpy(out, buffer_ + position_, count);
+    // used bytes are not kept around
+    memset(buffer_ + position_, 0, count);
+    position_ += count;
+    out += count;
+    length -= count;
+  }
+}
+
+uint64_t RandomService::RandUint64() {
+  uint64_t value;
+  RandBytes(reinterpret_cast<uint8_t*>(&value), sizeof(value));
+  return value;
+}
+
+uint64_t RandomService::RandInt(uint64_t min, uint64_t max) {
+  DCHECK(min <= max);
+  uint64_t range = max - min + 1;
+  if (range == 0) {
+    // whole uint64_t range
+    return RandUint64();
+  }
+
+  // values below |threshold| would make the low results more likely
+  uint64_t threshold = (0 - range) % range;
+  for (;;) {
+    uint64_t value = RandUint64();
+    if (value >= threshold) {
+      return min + value % range;
+    }
+  }
+}
+
+void RandomService::SetSeedForTesting(uint64_t seed) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  memset(key_, 0, sizeof(key_));
+  for (size_t i = 0; i < sizeof(seed); i++) {
+    key_[i] = static_cast<uint8_t>(seed >> (8 * i));
+  }
+  seeded_ = true;
+  counter_ = 0;
+  position_ = kBufferSize;
+}
+
+void RandomService::ClearSeedForTesting() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  memset(key_, 0, sizeof(key_));
+  seeded_ = false;
+  position_ = kBufferSize;
+}
+
+}  // namespace bat_ledger
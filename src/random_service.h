@@ -0,0 +1,52 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef BAT_LEDGER_RANDOM_SERVICE_H_
+#define BAT_LEDGER_RANDOM_SERVICE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <mutex>
+
+namespace bat_ledger {
+
+// Random bytes and numbers for all the ledgers of the process. Bytes come
+// from RAND_bytes in blocks, so most calls are a copy out of the buffer.
+// With a seed the bytes are a ChaCha20 keystream instead, runs of the
+// simulator and the benchmarks then repeat.
+// Methods can be called from any thread.
+class RandomService {
+ public:
+  static RandomService* GetInstance();
+
+  void RandBytes(uint8_t* out, size_t length);
+  uint64_t RandUint64();
+  // Uniform in [min, max]
+  uint64_t RandInt(uint64_t min, uint64_t max);
+
+  // Never for wallets that hold funds, their keys would be known
+  void SetSeedForTesting(uint64_t seed);
+  void ClearSeedForTesting();
+
+ private:
+  static const size_t kBufferSize = 4096;
+
+  RandomService();
+  ~RandomService();
+
+  // Called with |mutex_| held
+  void Refill();
+
+  std::mutex mutex_;
+  uint8_t buffer_[kBufferSize];
+  size_t position_;  // unused bytes start here
+  bool seeded_;
+  uint8_t key_[32];
+  uint32_t counter_;  // next ChaCha20 block
+};
+
+}  // namespace bat_ledger
+
+#endif  // BAT_LEDGER_RANDOM_SERVICE_H_
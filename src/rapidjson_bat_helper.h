@@ -5,6 +5,11 @@
 #ifndef BRAVELEDGER_RAPIDJSON_BAT_HELPER_H_
 #define BRAVELEDGER_RAPIDJSON_BAT_HELPER_H_
 
+#include <stddef.h>
+
+#include <algorithm>
+#include <string>
+
 #include "rapidjson/document.h"
 #include "rapidjson/error/en.h"
 #include "rapidjson/stringbuffer.h"
@@ -13,39 +18,100 @@
 namespace braveledger_bat_helper {
 
 struct BALLOT_ST;
+struct BATCH_VOTES_INFO_ST;
+struct BATCH_VOTES_ST;
 struct MEDIA_PUBLISHER_INFO;
 struct PUBLISHER_ST;
 struct PUBLISHER_STATE_ST;
 struct SURVEYOR_ST;
 struct RECONCILE_DIRECTION;
+struct REPORT_BALANCE_ST;
 struct CURRENT_RECONCILE;
 struct CLIENT_STATE_ST;
+struct CLIENT_HISTORY_ST;
 struct TRANSACTION_BALLOT_ST;
 struct TRANSACTION_ST;
 struct TWITCH_EVENT_INFO;
 struct WALLET_INFO_ST;
 
-using JsonWriter = rapidjson::Writer<rapidjson::StringBuffer>;
+// rapidjson output stream that writes into a string of the caller. The
+// string grows by doubling and is cut back to the written length on Flush,
+// which the writer calls when the root value is complete. A string that is
+// reused keeps its capacity, so the next document is written without
+// allocations and without the copy out of a StringBuffer.
+class JsonStringStream {
+ public:
+  typedef char Ch;
+
+  explicit JsonStringStream(std::string* out) :
+    out_(out),
+    size_(out->size()) {}
+
+  ~JsonStringStream() {
+    Flush();
+  }
+
+  void Put(Ch c) {
+    Reserve(1);
+    (*out_)[size_++] = c;
+  }
+
+  void PutUnsafe(Ch c) {
+    (*out_)[size_++] = c;
+  }
+
+  void Reserve(size_t count) {
+    if (size_ + count > out_->size()) {
+      out_->resize(std::max(size_ + count,
+                            std::max(out_->capacity(), out_->size() * 2)));
+    }
+  }
+
+  void Flush() {
+    out_->resize(size_);
+  }
+
+ private:
+  std::string* out_;  // NOT OWNED
+  size_t size_;
+};
+
+// Found by the writer through argument dependent lookup, in place of the
+// generic rapidjson versions that put one character at a time
+inline void PutReserve(JsonStringStream& stream, size_t count) {
+  stream.Reserve(count);
+}
+
+inline void PutUnsafe(JsonStringStream& stream, char c) {
+  stream.PutUnsafe(c);
+}
+
+using JsonWriter = rapidjson::Writer<JsonStringStream>;
 
 void saveToJson(JsonWriter & writer, const BALLOT_ST&);
+void saveToJson(JsonWriter & writer, const BATCH_VOTES_INFO_ST&);
+void saveToJson(JsonWriter & writer, const BATCH_VOTES_ST&);
 void saveToJson(JsonWriter & writer, const MEDIA_PUBLISHER_INFO&);
 void saveToJson(JsonWriter & writer, const PUBLISHER_ST&);
 void saveToJson(JsonWriter & writer, const PUBLISHER_STATE_ST&);
 void saveToJson(JsonWriter & writer, const SURVEYOR_ST&);
 void saveToJson(JsonWriter & writer, const RECONCILE_DIRECTION&);
+void saveToJson(JsonWriter & writer, const REPORT_BALANCE_ST&);
 void saveToJson(JsonWriter & writer, const CURRENT_RECONCILE&);
 void saveToJson(JsonWriter & writer, const CLIENT_STATE_ST&);
+void saveToJson(JsonWriter & writer, const CLIENT_HISTORY_ST&);
 void saveToJson(JsonWriter & writer, const TRANSACTION_BALLOT_ST&);
 void saveToJson(JsonWriter & writer, const TRANSACTION_ST&);
 void saveToJson(JsonWriter & writer, const TWITCH_EVENT_INFO&);
 void saveToJson(JsonWriter & writer, const WALLET_INFO_ST&);
 
+// Replaces the content of |json|, its capacity is reused
 template <typename T>
 void saveToJsonString(const T& t, std::string& json) {
-  rapidjson::StringBuffer buffer;
-  JsonWriter writer(buffer);
+  json.clear();
+  JsonStringStream stream(&json);
+  JsonWriter writer(stream);
   saveToJson(writer, t);
-  json = buffer.GetString();
 }
 
 //return: parsing status:  true = succeded, false = failed
@@ -0,0 +1,260 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "request_trace.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <chrono>
+#include <sstream>
+
+#include "ledger_metrics.h"
+
+namespace bat_ledger {
+
+namespace {
+
+uint32_t ClampSize(size_t size) {
+  return size > UINT32_MAX ? UINT32_MAX : static_cast<uint32_t>(size);
+}
+
+}  // namespace
+
+RequestTraceBuffer::RequestTraceBuffer(size_t capacity) :
+  mask_(0),
+  head_(0),
+  tail_(0),
+  dropped_(0) {
+  size_t size = 1;
+  while (size < capacity) {
+    size <<= 1;
+  }
+
+  slots_.reset(new Slot[size]);
+  for (size_t i = 0; i < size; i++) {
+    slots_[i].sequence.store(i, std::memory_order_relaxed);
+  }
+  mask_ = size - 1;
+}
+
+RequestTraceBuffer::~RequestTraceBuffer() {
+}
+
+// Every slot has a sequence: it equals the position while the slot is free
+// for that push, and the position + 1 once the record is written. The
+// consumer hands the slot to the push of the next lap.
+bool RequestTraceBuffer::Push(const RequestTraceRecord& record) {
+  uint64_t position = head_.load(std::memory_order_relaxed);
+  Slot* slot;
+  for (;;) {
+    slot = &slots_[position & mask_];
+    uint64_t sequence = slot->sequence.load(std::memory_order_acquire);
+    int64_t diff = static_cast<int64_t>(sequence - position);
+    if (diff == 0) {
+      if (head_.compare_exchange_weak(position, position + 1,
+                                      std::memory_order_relaxed)) {
+        break;
+      }
+    } else if (diff < 0) {
+      dropped_.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    } else {
+      position = head_.load(std::memory_order_relaxed);
+    }
+  }
+
+  slot->record = record;
+  slot->sequence.store(position + 1, std::memory_order_release);
+  return true;
+}
+
+size_t RequestTraceBuffer::Drain(std::vector<RequestTraceRecord>* records,
+                                 size_t max_records) {
+  uint64_t position = tail_.load(std::memory_order_relaxed);
+  size_t count = 0;
+  while (count < max_records) {
+    Slot& slot = slots_[position & mask_];
+    // empty, or the push of this slot didn't finish yet
+    if (slot.sequence.load(std::memory_order_acquire) != position + 1) {
+      break;
+    }
+
+    records->push_back(slot.record);
+    slot.sequence.store(position + mask_ + 1, std::memory_order_release);
+    position++;
+    count++;
+  }
+
+  tail_.store(position, std::memory_order_relaxed);
+  return count;
+}
+
+size_t RequestTraceBuffer::size() const {
+  uint64_t head = head_.load(std::memory_order_relaxed);
+  uint64_t tail = tail_.load(std::memory_order_relaxed);
+  return head > tail ? static_cast<size_t>(head - tail) : 0;
+}
+
+size_t RequestTraceBuffer::capacity() const {
+  return mask_ + 1;
+}
+
+uint64_t RequestTraceBuffer::dropped() const {
+  return dropped_.load(std::memory_order_relaxed);
+}
+
+RequestTrace::RequestTrace(size_t capacity) :
+  enabled_(false),
+  preview_enabled_(false),
+  buffer_(capacity),
+  reported_dropped_(0) {
+}
+
+RequestTrace::~RequestTrace() {
+}
+
+void RequestTrace::SetEnabled(bool enabled) {
+  enabled_.store(enabled, std::memory_order_relaxed);
+  if (!enabled) {
+    requests_.clear();
+  }
+}
+
+bool RequestTrace::IsEnabled() const {
+  return enabled_.load(std::memory_order_relaxed);
+}
+
+void RequestTrace::SetPreviewEnabled(bool enabled) {
+  preview_enabled_.store(enabled, std::memory_order_relaxed);
+}
+
+RequestTraceBuffer* RequestTrace::buffer() {
+  return &buffer_;
+}
+
+void RequestTrace::OnRequestStarted(uint64_t request_id,
+                                    const std::string& url,
+                                    size_t request_size) {
+  if (!IsEnabled()) {
+    return;
+  }
+
+  PendingRequest request;
+  request.start = LedgerMetrics::Now();
+  request.endpoint_id = GetEndpointId(LedgerMetrics::GetEndpoint(url));
+  request.request_size = ClampSize(request_size);
+  requests_[request_id] = request;
+}
+
+void RequestTrace::OnRequestFinished(uint64_t request_id,
+                                     int response_code,
+                                     const std::string& response) {
+  Push(request_id, response_code, response);
+}
+
+void RequestTrace::OnRequestCancelled(uint64_t request_id) {
+  Push(request_id, -1, std::string());
+}
+
+void RequestTrace::Push(uint64_t request_id,
+                        int32_t status,
+                        const std::string& response) {
+  auto iter = requests_.find(request_id);
+  if (iter == requests_.end()) {
+    return;
+  }
+
+  uint64_t now = LedgerMetrics::Now();
+  RequestTraceRecord record;
+  record.time = std::chrono::duration_cast<std::chrono::milliseconds>(
+      std::chrono::system_clock::now().time_since_epoch()).count();
+  record.request_id = request_id;
+  record.endpoint_id = iter->second.endpoint_id;
+  record.status = status;
+  record.request_size = iter->second.request_size;
+  record.response_size = ClampSize(response.size());
+  record.latency = ClampSize(now - iter->second.start);
+  record.body_hash = HashBody(response);
+  size_t preview = 0;
+  if (preview_enabled_.load(std::memory_order_relaxed)) {
+    preview = std::min(response.size(), RequestTraceRecord::kPreviewSize - 1);
+  }
+  memcpy(record.preview, response.data(), preview);
+  record.preview[preview] = '\0';
+  requests_.erase(iter);
+
+  buffer_.Push(record);
+}
+
+uint32_t RequestTrace::GetEndpointId(const std::string& endpoint) {
+  auto iter = endpoint_ids_.find(endpoint);
+  if (iter != endpoint_ids_.end()) {
+    return iter->second;
+  }
+
+  std::lock_guard<std::mutex> lock(endpoints_mutex_);
+  uint32_t id = static_cast<uint32_t>(endpoints_.size());
+  endpoints_.push_back(endpoint);
+  endpoint_ids_[endpoint] = id;
+  return id;
+}
+
+std::string RequestTrace::Format(
+    const std::vector<RequestTraceRecord>& records) {
+  std::ostringstream stream;
+  uint64_t dropped = buffer_.dropped();
+  if (dropped != reported_dropped_) {
+    stream << "[ TRACE dropped " << dropped - reported_dropped_ << " ]\n";
+    reported_dropped_ = dropped;
+  }
+
+  std::lock_guard<std::mutex> lock(endpoints_mutex_);
+  for (const auto& record : records) {
+    stream << "[ TRACE " << record.request_id << " ]"
+           << " time=" << record.time
+           << " endpoint=" << (record.endpoint_id < endpoints_.size() ?
+               endpoints_[record.endpoint_id] : "?")
+           << " status=" << record.status
+           << " request=" << record.request_size
+           << " response=" << record.response_size
+           << " latency=" << record.latency
+           << " hash=" << std::hex << record.body_hash << std::dec;
+    if (record.preview[0]) {
+      stream << " preview=";
+      // keeps one record per line
+      for (const char* c = record.preview; *c; c++) {
+        stream << (*c == '\n' || *c == '\r' ? ' ' : *c);
+      }
+    }
+    stream << "\n";
+  }
+
+  return stream.str();
+}
+
+// static
+// Responses can be several MB, so only their start is hashed. The size is
+// mixed in to tell apart bodies that only differ after the prefix by length.
+uint64_t RequestTrace::HashBody(const std::string& body) {
+  uint64_t hash = 14695981039346656037ull;
+  size_t hashed = body.size();
+  if (hashed > RequestTraceRecord::kHashedSize) {
+    hashed = RequestTraceRecord::kHashedSize;
+  }
+  for (size_t i = 0; i < hashed; i++) {
+    hash ^= static_cast<unsigned char>(body[i]);
+    hash *= 1099511628211ull;
+  }
+
+  uint64_t size = body.size();
+  for (size_t i = 0; i < sizeof(size); i++) {
+    hash ^= (size >> (i * 8)) & 0xff;
+    hash *= 1099511628211ull;
+  }
+
+  return hash;
+}
+
+}  // namespace bat_ledger
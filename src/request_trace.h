@@ -0,0 +1,126 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef BAT_LEDGER_REQUEST_TRACE_H_
+#define BAT_LEDGER_REQUEST_TRACE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace bat_ledger {
+
+// One finished or cancelled request, fixed size so that records can be
+// copied in and out of the ring without allocations
+struct RequestTraceRecord {
+  static const size_t kPreviewSize = 48;
+  // bytes of the response that go into |body_hash|
+  static const size_t kHashedSize = 4096;
+
+  uint64_t time;  // ms since the epoch, when the request finished
+  uint64_t request_id;
+  uint32_t endpoint_id;
+  int32_t status;  // http response code, -1 when cancelled
+  uint32_t request_size;
+  uint32_t response_size;
+  uint32_t latency;  // ms
+  uint64_t body_hash;  // FNV-1a of the first kHashedSize bytes and the size
+  // start of the response, NUL terminated. Empty unless previews are on.
+  char preview[kPreviewSize];
+};
+
+// Bounded lock-free ring of trace records. Any number of threads can push,
+// one thread at a time drains. A full ring drops the new record instead of
+// waiting for the consumer.
+class RequestTraceBuffer {
+ public:
+  // |capacity| is rounded up to a power of two
+  explicit RequestTraceBuffer(size_t capacity);
+  ~RequestTraceBuffer();
+
+  // Returns false when the record was dropped
+  bool Push(const RequestTraceRecord& record);
+  // Moves up to |max_records| records to |records|, returns their count
+  size_t Drain(std::vector<RequestTraceRecord>* records, size_t max_records);
+
+  // Approximate while pushes are in flight
+  size_t size() const;
+  size_t capacity() const;
+  uint64_t dropped() const;
+
+ private:
+  struct Slot {
+    std::atomic<uint64_t> sequence;
+    RequestTraceRecord record;
+  };
+
+  std::unique_ptr<Slot[]> slots_;
+  size_t mask_;
+  std::atomic<uint64_t> head_;  // next position to push
+  std::atomic<uint64_t> tail_;  // next position to drain
+  std::atomic<uint64_t> dropped_;
+};
+
+// Turns requests of the ledger into trace records. Request methods need
+// to be called on the ledger thread, Format() can run on any thread while
+// they are called.
+class RequestTrace {
+ public:
+  explicit RequestTrace(size_t capacity);
+  ~RequestTrace();
+
+  void SetEnabled(bool enabled);
+  bool IsEnabled() const;
+  // Off by default, previews copy a part of the response into the trace
+  void SetPreviewEnabled(bool enabled);
+
+  void OnRequestStarted(uint64_t request_id,
+                        const std::string& url,
+                        size_t request_size);
+  void OnRequestFinished(uint64_t request_id,
+                         int response_code,
+                         const std::string& response);
+  void OnRequestCancelled(uint64_t request_id);
+
+  RequestTraceBuffer* buffer();
+
+  // One line per record, endpoint ids are resolved to the endpoint names
+  // of LedgerMetrics::GetEndpoint(). Records that were dropped since the
+  // last batch are counted in its first line.
+  std::string Format(const std::vector<RequestTraceRecord>& records);
+
+  static uint64_t HashBody(const std::string& body);
+
+ private:
+  struct PendingRequest {
+    uint64_t start;
+    uint32_t endpoint_id;
+    uint32_t request_size;
+  };
+
+  uint32_t GetEndpointId(const std::string& endpoint);
+  void Push(uint64_t request_id,
+            int32_t status,
+            const std::string& response);
+
+  std::atomic<bool> enabled_;
+  std::atomic<bool> preview_enabled_;
+  RequestTraceBuffer buffer_;
+  std::map<uint64_t, PendingRequest> requests_;
+  std::map<std::string, uint32_t> endpoint_ids_;
+  // endpoint names by id, guarded for Format()
+  std::mutex endpoints_mutex_;
+  std::vector<std::string> endpoints_;
+  uint64_t reported_dropped_;
+};
+
+}  // namespace bat_ledger
+
+#endif  // BAT_LEDGER_REQUEST_TRACE_H_
@@ -65,9 +65,15 @@
 
 #define TWITCH_MINIMUM_SECONDS          10
 #define TWITCH_MAXIMUM_SECONDS_CHUNK    120
+#define TWITCH_MAXIMUM_SESSIONS         256
 
 #define VOTE_BATCH_SIZE                 10
 
+#define PUBLISHER_LIST_PAGE_SIZE        100
+// Publishers below 0.5% round down to no percent, so only the top 200
+// can end up in the contribution
+#define TOP_PUBLISHERS_COUNT            200
+
 namespace braveledger_ledger {
 
 static const uint8_t g_hkdfSalt[] = {126, 244, 99, 158, 51, 68, 253, 80, 133, 183, 51, 180, 77,
@@ -88,10 +94,22 @@ static const unsigned int _twitch_events_array_size = 8;
 // Important: set _twitch_events_array_size as a correct array size when you modify items in _twitch_events
 static const std::string _twitch_events[] = {"buffer-empty", "buffer-refill", "video_end",
   "minute-watched", "video_pause", "player_click_vod_seek", "video-play", "video_error"};
+// Perfect hash of _twitch_events, slot is (event[4] + event[length - 4]) % 16.
+// Important: regenerate when you modify items in _twitch_events
+static const size_t _twitch_events_hash_size = 16;
+static const int8_t _twitch_events_hash[_twitch_events_hash_size] = {
+  4, 7, 0, -1, -1, -1, -1, 3, 5, -1, -1, 1, -1, -1, 2, 6};
 
 static const uint64_t _publishers_list_load_interval = 48 * 60 * 60; // 48 hours in seconds
 static const uint64_t _reconcile_default_interval = 30 * 24 * 60 * 60; // 30 days in seconds
 static const uint64_t _grant_load_interval = 24 * 60 * 60; // 1 day in seconds
+static const size_t _max_url_requests = 6;
+static const size_t _max_url_requests_per_host = 2;
+static const uint64_t _wallet_properties_ttl = 60; // 1 minute in seconds
+static const uint64_t _timer_coalescing_window = 5; // in seconds
+static const size_t _request_trace_capacity = 1024; // records
+static const uint64_t _request_trace_drain_interval = 10; // in seconds
+static const uint64_t _twitch_session_idle_timeout = 30 * 60; // 30 minutes in seconds
 
 }  // namespace braveledger_ledger
 
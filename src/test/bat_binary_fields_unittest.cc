@@ -0,0 +1,146 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include <random>
+#include <string>
+
+#include "brave/vendor/bat-native-ledger/src/bat_binary_fields.h"
+#include "brave/vendor/bat-native-ledger/src/bat_helper_fields.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace {
+
+using braveledger_bat_helper::BinaryWriter;
+using braveledger_bat_helper::CLIENT_STATE_ST;
+using braveledger_bat_helper::WireType;
+
+CLIENT_STATE_ST GetClientState() {
+  CLIENT_STATE_ST state;
+  state.walletInfo_.paymentId_ = "payment";
+  state.walletInfo_.keyInfoSeed_ = {0, 1, 2, 0xfe, 0xff};
+  state.bootStamp_ = 1541766652;
+  state.reconcileStamp_ = 0xffffffffffffffffull;
+  state.masterUserToken_ = "{\"token\":\"with \\\"quotes\\\"\"}";
+  state.preFlight_ = std::string("nul\0byte", 8);
+  state.fee_amount_ = -0.1;
+  state.days_ = 30;
+  state.auto_contribute_ = true;
+
+  braveledger_bat_helper::TRANSACTION_ST transaction;
+  transaction.viewingId_ = "viewing";
+  transaction.contribution_rates_["USD"] = 0.18;
+  transaction.surveyorIds_ = {"a", "", "c"};
+  transaction.ballots_.resize(2);
+  transaction.ballots_[1].offset_ = 7;
+  state.transactions_.push_back(transaction);
+
+  braveledger_bat_helper::CURRENT_RECONCILE reconcile;
+  reconcile.viewingId_ = "viewing";
+  reconcile.category_ = -2;
+  reconcile.retry_step_ = braveledger_bat_helper::STEP_VOTE;
+  reconcile.directions_.push_back(
+      braveledger_bat_helper::RECONCILE_DIRECTION("brave.com", -5, "BAT"));
+  state.current_reconciles_["viewing"] = reconcile;
+  return state;
+}
+
+std::string ToJson(const CLIENT_STATE_ST& state) {
+  std::string json;
+  braveledger_bat_helper::saveToJsonString(state, json);
+  return json;
+}
+
+TEST(BatBinaryFieldsTest, RoundTrip) {
+  const CLIENT_STATE_ST state = GetClientState();
+  std::string data;
+  braveledger_bat_helper::SaveToBinaryString(state, &data);
+  EXPECT_TRUE(braveledger_bat_helper::IsBinaryState(data));
+  EXPECT_FALSE(braveledger_bat_helper::IsBinaryState(ToJson(state)));
+  EXPECT_LT(data.size(), ToJson(state).size());
+
+  CLIENT_STATE_ST loaded;
+  ASSERT_TRUE(braveledger_bat_helper::LoadFromBinaryString(data, &loaded));
+  EXPECT_EQ(state.preFlight_, loaded.preFlight_);
+  EXPECT_EQ(state.walletInfo_.keyInfoSeed_, loaded.walletInfo_.keyInfoSeed_);
+  EXPECT_EQ(-2, loaded.current_reconciles_["viewing"].category_);
+  EXPECT_EQ(ToJson(state), ToJson(loaded));
+}
+
+TEST(BatBinaryFieldsTest, Corrupted) {
+  std::string data;
+  braveledger_bat_helper::SaveToBinaryString(GetClientState(), &data);
+  CLIENT_STATE_ST loaded;
+
+  std::string changed = data;
+  changed[changed.size() / 2] ^= 1;
+  EXPECT_FALSE(braveledger_bat_helper::LoadFromBinaryString(changed, &loaded));
+
+  changed = data;
+  changed[4] = braveledger_bat_helper::kBinaryStateVersion + 1;
+  EXPECT_FALSE(braveledger_bat_helper::LoadFromBinaryString(changed, &loaded));
+
+  EXPECT_FALSE(braveledger_bat_helper::LoadFromBinaryString(
+      data.substr(0, data.size() - 1), &loaded));
+  EXPECT_FALSE(braveledger_bat_helper::LoadFromBinaryString(
+      data.substr(0, 6), &loaded));
+  EXPECT_TRUE(loaded.personaId_.empty());
+}
+
+TEST(BatBinaryFieldsTest, UnknownAndMissingFields) {
+  // SURVEYOR_INFO_ST has one required field
+  std::string data;
+  braveledger_bat_helper::StartBinaryState(&data);
+  {
+    BinaryWriter writer(&data);
+    writer.Key(5, WireType::VARINT);
+    writer.Varint(300);
+    writer.Key(0, WireType::BYTES);
+    writer.Bytes("surveyor", 8);
+    writer.Key(9, WireType::BYTES);
+    size_t start = writer.StartBlock();
+    writer.Bytes("newer", 5);
+    writer.EndBlock(start);
+  }
+  braveledger_bat_helper::FinishBinaryState(&data);
+
+  braveledger_bat_helper::SURVEYOR_INFO_ST info;
+  ASSERT_TRUE(braveledger_bat_helper::LoadFromBinaryString(data, &info));
+  EXPECT_EQ("surveyor", info.surveyorId_);
+
+  // the only field with the wrong wire type
+  data.clear();
+  braveledger_bat_helper::StartBinaryState(&data);
+  {
+    BinaryWriter writer(&data);
+    writer.Key(0, WireType::VARINT);
+    writer.Varint(1);
+  }
+  braveledger_bat_helper::FinishBinaryState(&data);
+  EXPECT_FALSE(braveledger_bat_helper::LoadFromBinaryString(data, &info));
+  EXPECT_EQ("surveyor", info.surveyorId_);
+}
+
+TEST(BatBinaryFieldsTest, Crc32cKnownAnswer) {
+  const char kCheck[] = "123456789";
+  EXPECT_EQ(0xe3069283u, braveledger_bat_helper::Crc32c(kCheck, 9));
+  EXPECT_EQ(0xe3069283u, braveledger_bat_helper::Crc32cPortable(kCheck, 9));
+  EXPECT_EQ(0u, braveledger_bat_helper::Crc32c("", 0));
+  EXPECT_EQ(0u, braveledger_bat_helper::Crc32cPortable("", 0));
+}
+
+TEST(BatBinaryFieldsTest, Crc32cPathsAgree) {
+  // every tail length after the 8 byte words
+  std::mt19937 random(49);
+  for (size_t length = 0; length < 100; length++) {
+    std::string data(length, '\0');
+    for (auto& c : data) {
+      c = static_cast<char>(random());
+    }
+    EXPECT_EQ(braveledger_bat_helper::Crc32cPortable(data.data(), length),
+              braveledger_bat_helper::Crc32c(data.data(), length))
+        << length;
+  }
+}
+
+}  // namespace
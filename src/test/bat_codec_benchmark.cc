@@ -0,0 +1,70 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include <string>
+#include <vector>
+
+#include "bat_codec.h"
+#include "bat_helper.h"
+#include "third_party/google_benchmark/src/include/benchmark/benchmark.h"
+
+namespace {
+
+// 32 for keys, 64 for signatures, the rest for media payloads
+std::vector<uint8_t> GetBytes(size_t length) {
+  std::vector<uint8_t> bytes(length);
+  for (size_t i = 0; i < length; i++) {
+    bytes[i] = static_cast<uint8_t>(i * 167 + 13);
+  }
+  return bytes;
+}
+
+void BM_Uint8ToHex(benchmark::State& state) {
+  const std::vector<uint8_t> bytes = GetBytes(state.range(0));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(braveledger_bat_helper::uint8ToHex(bytes));
+  }
+
+  state.SetBytesProcessed(state.iterations() * bytes.size());
+}
+BENCHMARK(BM_Uint8ToHex)->Arg(32)->Arg(64)->Arg(4096);
+
+void BM_GetBase64(benchmark::State& state) {
+  const std::vector<uint8_t> bytes = GetBytes(state.range(0));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(braveledger_bat_helper::getBase64(bytes));
+  }
+
+  state.SetBytesProcessed(state.iterations() * bytes.size());
+}
+BENCHMARK(BM_GetBase64)->Arg(32)->Arg(64)->Arg(4096);
+
+void BM_GetFromBase64(benchmark::State& state) {
+  const std::string base64 =
+      braveledger_bat_helper::getBase64(GetBytes(state.range(0)));
+  std::vector<uint8_t> out;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(
+        braveledger_bat_helper::getFromBase64(base64, out));
+  }
+
+  state.SetBytesProcessed(state.iterations() * base64.size());
+}
+BENCHMARK(BM_GetFromBase64)->Arg(32)->Arg(64)->Arg(4096);
+
+// Encoding into a buffer that is already there, no allocation
+void BM_Base64Encode(benchmark::State& state) {
+  const std::vector<uint8_t> bytes = GetBytes(state.range(0));
+  std::string out(braveledger_bat_codec::Base64EncodedLength(bytes.size()),
+                  '\0');
+  for (auto _ : state) {
+    braveledger_bat_codec::Base64Encode(bytes.data(), bytes.size(), &out[0]);
+    benchmark::ClobberMemory();
+  }
+
+  state.SetBytesProcessed(state.iterations() * bytes.size());
+}
+BENCHMARK(BM_Base64Encode)->Arg(64)->Arg(4096);
+
+}  // namespace
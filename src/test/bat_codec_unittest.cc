@@ -0,0 +1,140 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include <stdint.h>
+#include <string.h>
+
+#include <string>
+#include <vector>
+
+#include <openssl/base64.h>
+
+#include "brave/vendor/bat-native-ledger/src/bat_codec.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace {
+
+// Lengths around the 16, 24 and 32 byte rounds of the vector code
+const size_t kMaxLength = 200;
+
+std::vector<uint8_t> GetBytes(size_t length) {
+  std::vector<uint8_t> bytes(length);
+  for (size_t i = 0; i < length; i++) {
+    bytes[i] = static_cast<uint8_t>(i * 167 + 13);
+  }
+  return bytes;
+}
+
+std::string EncodeWithBoringSSL(const std::vector<uint8_t>& in) {
+  std::vector<uint8_t> out(braveledger_bat_codec::Base64EncodedLength(
+      in.size()) + 1);
+  size_t length = EVP_EncodeBlock(out.data(), in.data(), in.size());
+  return std::string(reinterpret_cast<const char*>(out.data()), length);
+}
+
+bool DecodeWithCodec(const std::string& in, std::vector<uint8_t>* out) {
+  out->resize(braveledger_bat_codec::Base64DecodedMaxLength(in.size()));
+  size_t length = 0;
+  if (!braveledger_bat_codec::Base64Decode(in.data(), in.size(), out->data(),
+                                           &length)) {
+    return false;
+  }
+  out->resize(length);
+  return true;
+}
+
+bool DecodeWithBoringSSL(const std::string& in, std::vector<uint8_t>* out) {
+  out->resize(braveledger_bat_codec::Base64DecodedMaxLength(in.size()));
+  size_t length = 0;
+  if (!EVP_DecodeBase64(out->data(), &length, out->size(),
+                        reinterpret_cast<const uint8_t*>(in.data()),
+                        in.size())) {
+    return false;
+  }
+  out->resize(length);
+  return true;
+}
+
+TEST(BatCodecTest, Hex) {
+  for (size_t length = 0; length <= kMaxLength; length++) {
+    std::vector<uint8_t> bytes = GetBytes(length);
+    std::string expected;
+    for (uint8_t byte : bytes) {
+      expected += "0123456789abcdef"[byte >> 4];
+      expected += "0123456789abcdef"[byte & 0x0f];
+    }
+
+    std::string hex = "prefix";
+    braveledger_bat_codec::AppendHex(bytes.data(), bytes.size(), &hex);
+    ASSERT_EQ("prefix" + expected, hex) << length;
+
+    std::vector<uint8_t> decoded(length);
+    ASSERT_TRUE(braveledger_bat_codec::HexDecode(
+        expected.data(), expected.size(), decoded.data()));
+    EXPECT_EQ(bytes, decoded);
+  }
+
+  uint8_t out[2];
+  EXPECT_TRUE(braveledger_bat_codec::HexDecode("aBF0", 4, out));
+  EXPECT_EQ(0xab, out[0]);
+  EXPECT_EQ(0xf0, out[1]);
+  EXPECT_FALSE(braveledger_bat_codec::HexDecode("abc", 3, out));
+  EXPECT_FALSE(braveledger_bat_codec::HexDecode("ag", 2, out));
+  EXPECT_FALSE(braveledger_bat_codec::HexDecode("a ", 2, out));
+}
+
+TEST(BatCodecTest, Base64Encode) {
+  for (size_t length = 0; length <= kMaxLength; length++) {
+    std::vector<uint8_t> bytes = GetBytes(length);
+    std::string base64;
+    braveledger_bat_codec::AppendBase64(bytes.data(), bytes.size(), &base64);
+    ASSERT_EQ(EncodeWithBoringSSL(bytes), base64) << length;
+
+    std::vector<uint8_t> decoded;
+    ASSERT_TRUE(DecodeWithCodec(base64, &decoded));
+    EXPECT_EQ(bytes, decoded);
+  }
+
+  // every index in all four positions, "AAAA" to "////"
+  std::vector<uint8_t> bytes;
+  for (uint32_t index = 0; index < 64; index++) {
+    uint32_t value = index * 0x41041;
+    bytes.push_back(static_cast<uint8_t>(value >> 16));
+    bytes.push_back(static_cast<uint8_t>(value >> 8));
+    bytes.push_back(static_cast<uint8_t>(value));
+  }
+  std::string base64;
+  braveledger_bat_codec::AppendBase64(bytes.data(), bytes.size(), &base64);
+  EXPECT_EQ(EncodeWithBoringSSL(bytes), base64);
+}
+
+TEST(BatCodecTest, Base64Decode) {
+  const char* inputs[] = {
+    "", "QQ==", "QUI=", "QUJD", "QUJDRA==", "+/+/", "QR==", "QUJ=",
+    // rejected by both
+    "Q", "QQ", "QQ=", "QQ===", "Q===", "====", "=QQQ", "QQ=A", "Q=Q=",
+    "QQ==QUJD", "QUJD\n", " QUJD", "QU JD", "QUJ-", "QUJ_", "QUJ\x80",
+  };
+
+  for (const char* input : inputs) {
+    std::vector<uint8_t> expected;
+    std::vector<uint8_t> decoded;
+    bool expected_result = DecodeWithBoringSSL(input, &expected);
+    EXPECT_EQ(expected_result, DecodeWithCodec(input, &decoded)) << input;
+    EXPECT_EQ(expected_result,
+              braveledger_bat_codec::IsBase64(input, strlen(input)))
+        << input;
+    if (expected_result) {
+      EXPECT_EQ(expected, decoded) << input;
+    }
+  }
+
+  std::string with_nul("QU\0D", 4);
+  std::vector<uint8_t> decoded;
+  EXPECT_FALSE(DecodeWithCodec(with_nul, &decoded));
+  EXPECT_FALSE(braveledger_bat_codec::IsBase64(with_nul.data(),
+                                               with_nul.size()));
+}
+
+}  // namespace
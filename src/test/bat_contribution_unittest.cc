@@ -0,0 +1,766 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <memory>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "brave/vendor/bat-native-ledger/src/bat_helper.h"
+#include "brave/vendor/bat-native-ledger/src/bat_publishers.h"
+#include "brave/vendor/bat-native-ledger/src/ledger_impl.h"
+#include "brave/vendor/bat-native-ledger/src/rapidjson_bat_helper.h"
+#include "brave/vendor/bat-native-ledger/src/test/mock_ledger_client.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace {
+
+const char kVotingPath[] = "/v2/batch/surveyor/voting";
+
+// a transaction is only loaded with all the rates
+braveledger_bat_helper::TRANSACTION_ST MakeTransaction(
+    const std::string& viewing_id) {
+  braveledger_bat_helper::TRANSACTION_ST transaction;
+  transaction.viewingId_ = viewing_id;
+  for (const char* currency : {"BTC", "ETH", "EUR", "LTC", "USD"}) {
+    transaction.contribution_rates_[currency] = 1.0;
+  }
+  return transaction;
+}
+
+braveledger_bat_helper::CLIENT_STATE_ST ParseState(const std::string& data) {
+  braveledger_bat_helper::CLIENT_STATE_ST state;
+  EXPECT_TRUE(state.loadFromJson(data));
+  return state;
+}
+
+braveledger_bat_helper::CLIENT_HISTORY_ST ParseHistory(
+    const std::string& data) {
+  braveledger_bat_helper::CLIENT_HISTORY_ST history;
+  EXPECT_TRUE(history.loadFromJson(data));
+  return history;
+}
+
+class StringLogStream : public ledger::LogStream {
+ public:
+  std::ostream& stream() override { return stream_; }
+
+ private:
+  std::ostringstream stream_;
+};
+
+// Ledger client with a stand-in for the surveyor voting server. Host timers
+// and responses are delivered by RunUntilIdle() in virtual time (seconds).
+class ContributionTestClient : public ledger::LedgerClient {
+ public:
+  explicit ContributionTestClient(uint64_t latency) :
+    ledger_(nullptr),
+    latency_(latency),
+    now_(0),
+    next_id_(1),
+    history_result_(ledger::Result::LEDGER_OK),
+    wallet_result_(ledger::Result::LEDGER_ERROR) {}
+
+  void SetLedger(ledger::Ledger* ledger) { ledger_ = ledger; }
+
+  // Adds reconcile which votes are already proved and batched. Anonize
+  // proofs can't be made against the stand-in server, and ballot proofs
+  // are not kept in the saved state.
+  void AddReconcile(const std::string& viewing_id,
+                    int publishers,
+                    int votes_per_publisher) {
+    braveledger_bat_helper::CURRENT_RECONCILE reconcile;
+    reconcile.viewingId_ = viewing_id;
+    reconcile.retry_step_ =
+        braveledger_bat_helper::ContributionRetry::STEP_FINAL;
+    state_.current_reconciles_[viewing_id] = reconcile;
+    AddVotes(viewing_id, publishers, votes_per_publisher);
+  }
+
+  // Adds the transaction and the batched votes of a reconcile, in the
+  // state the way older versions saved it
+  void AddVotes(const std::string& viewing_id,
+                int publishers,
+                int votes_per_publisher) {
+    state_.transactions_.push_back(MakeTransaction(viewing_id));
+
+    for (int i = 0; i < publishers; i++) {
+      braveledger_bat_helper::BATCH_VOTES_ST votes;
+      votes.viewingId_ = viewing_id;
+      votes.publisher_ = "publisher" + std::to_string(i) + ".com";
+      for (int j = 0; j < votes_per_publisher; j++) {
+        braveledger_bat_helper::BATCH_VOTES_INFO_ST vote;
+        vote.surveyorId_ = viewing_id + "-surveyor-" +
+            std::to_string(i * votes_per_publisher + j);
+        vote.proof_ = "proof";
+        votes.batchVotesInfo_.push_back(vote);
+        surveyors_[vote.surveyorId_] = viewing_id;
+      }
+      state_.batch_.push_back(votes);
+    }
+  }
+
+  braveledger_bat_helper::CLIENT_STATE_ST* mutable_state() { return &state_; }
+
+  // Stored history record that the ledger loads on Initialize()
+  void SetHistory(const braveledger_bat_helper::CLIENT_HISTORY_ST& history) {
+    braveledger_bat_helper::saveToJsonString(history, history_);
+  }
+
+  // Stored history record as it is, and the result of loading it
+  void SetHistoryData(const std::string& data, ledger::Result result) {
+    history_ = data;
+    history_result_ = result;
+  }
+
+  ledger::Result wallet_result() const { return wallet_result_; }
+
+  const std::vector<std::string>& saved_states() const {
+    return saved_states_;
+  }
+  const std::vector<std::string>& saved_histories() const {
+    return saved_histories_;
+  }
+
+  // Fires host timers and delivers responses until nothing is pending
+  void RunUntilIdle() {
+    while (!events_.empty()) {
+      auto iter = events_.begin();
+      Event event = iter->second;
+      now_ = iter->first;
+      events_.erase(iter);
+
+      if (event.handler) {
+        event.handler->OnURLRequestResponse(
+            event.id, event.url, 200, event.response, {});
+        last_response_[event.viewing_id] = now_;
+      } else {
+        ledger_->OnTimer(static_cast<uint32_t>(event.id));
+      }
+    }
+  }
+
+  const std::map<std::string, int>& votes() const { return votes_; }
+  const std::map<std::string, uint64_t>& first_vote() const {
+    return first_vote_;
+  }
+  const std::map<std::string, uint64_t>& last_response() const {
+    return last_response_;
+  }
+
+  // ledger::LedgerClient
+  std::string GenerateGUID() const override { return "guid"; }
+  void OnWalletInitialized(ledger::Result result) override {
+    wallet_result_ = result;
+  }
+  void FetchWalletProperties() override {}
+  void OnWalletProperties(ledger::Result result,
+                          std::unique_ptr<ledger::WalletInfo>) override {}
+  void OnReconcileComplete(ledger::Result result,
+                           const std::string& viewing_id,
+                           ledger::PUBLISHER_CATEGORY category,
+                           const std::string& probi) override {}
+
+  void LoadLedgerState(ledger::LedgerCallbackHandler* handler) override {
+    std::string data;
+    braveledger_bat_helper::saveToJsonString(state_, data);
+    handler->OnLedgerStateLoaded(ledger::Result::LEDGER_OK, data);
+  }
+
+  void SaveLedgerState(const std::string& ledger_state,
+                       ledger::LedgerCallbackHandler* handler) override {
+    saved_states_.push_back(ledger_state);
+    handler->OnLedgerStateSaved(ledger::Result::LEDGER_OK);
+  }
+
+  void LoadLedgerHistory(ledger::LedgerCallbackHandler* handler) override {
+    handler->OnLedgerHistoryLoaded(history_.empty() ?
+        ledger::Result::NO_LEDGER_STATE : history_result_,
+        history_);
+  }
+
+  void SaveLedgerHistory(const std::string& ledger_history,
+                         ledger::LedgerCallbackHandler* handler) override {
+    saved_histories_.push_back(ledger_history);
+    handler->OnLedgerHistorySaved(ledger::Result::LEDGER_OK);
+  }
+
+  void LoadPublisherState(ledger::LedgerCallbackHandler* handler) override {
+    // keeps wallet uninitialized, so only the contributions run
+    handler->OnPublisherStateLoaded(ledger::Result::NO_PUBLISHER_STATE, "");
+  }
+
+  void SavePublisherState(const std::string& publisher_state,
+                          ledger::LedgerCallbackHandler* handler) override {}
+  void SavePublishersList(const std::string& publisher_state,
+                          ledger::LedgerCallbackHandler* handler) override {}
+  void LoadPublisherList(ledger::LedgerCallbackHandler* handler) override {}
+  void LoadNicewareList(ledger::GetNicewareListCallback callback) override {}
+  void SavePublisherInfo(std::unique_ptr<ledger::PublisherInfo> publisher_info,
+                         ledger::PublisherInfoCallback callback) override {}
+  void LoadPublisherInfo(ledger::PublisherInfoFilter filter,
+                         ledger::PublisherInfoCallback callback) override {}
+  void LoadMediaPublisherInfo(const std::string& media_key,
+                              ledger::PublisherInfoCallback callback) override {}
+  void SaveMediaPublisherInfo(const std::string& media_key,
+                              const std::string& publisher_id) override {}
+  void LoadPublisherInfoList(
+      uint32_t start,
+      uint32_t limit,
+      ledger::PublisherInfoFilter filter,
+      ledger::PublisherInfoListCallback callback) override {}
+  void FetchGrant(const std::string& lang,
+                  const std::string& paymentId) override {}
+  void OnGrant(ledger::Result result, const ledger::Grant& grant) override {}
+  void GetGrantCaptcha() override {}
+  void OnGrantCaptcha(const std::string& image,
+                      const std::string& hint) override {}
+  void OnRecoverWallet(ledger::Result result,
+                       double balance,
+                       const std::vector<ledger::Grant>& grants) override {}
+  void OnGrantFinish(ledger::Result result,
+                     const ledger::Grant& grant) override {}
+  void OnPublisherActivity(ledger::Result result,
+                           std::unique_ptr<ledger::PublisherInfo>,
+                           uint64_t windowId) override {}
+  void OnExcludedSitesChanged(const std::string& publisher_id) override {}
+  void FetchFavIcon(const std::string& url,
+                    const std::string& favicon_key,
+                    ledger::FetchIconCallback callback) override {}
+  void SaveContributionInfo(
+      const std::string& probi,
+      const int month,
+      const int year,
+      const uint32_t date,
+      const std::string& publisher_key,
+      const ledger::PUBLISHER_CATEGORY category) override {}
+  void GetRecurringDonations(
+      ledger::PublisherInfoListCallback callback) override {}
+  void OnRemoveRecurring(const std::string& publisher_key,
+                         ledger::RecurringRemoveCallback callback) override {}
+
+  void SetTimer(uint64_t time_offset, uint32_t& timer_id) override {
+    timer_id = static_cast<uint32_t>(next_id_++);
+    events_.insert(std::make_pair(now_ + time_offset,
+                                  Event{timer_id, "", "", "", nullptr}));
+  }
+
+  std::string URIEncode(const std::string& value) override { return value; }
+
+  std::unique_ptr<ledger::LedgerURLLoader> LoadURL(
+      const std::string& url,
+      const std::vector<std::string>& headers,
+      const std::string& content,
+      const std::string& contentType,
+      const ledger::URL_METHOD& method,
+      ledger::LedgerCallbackHandler* handler) override {
+    return std::unique_ptr<ledger::LedgerURLLoader>(
+        new Loader(this, next_id_++, url, content, handler));
+  }
+
+  void RunIOTask(std::unique_ptr<ledger::LedgerTaskRunner> task) override {
+    task->Run([](std::function<void(void)> callback) {
+      callback();
+    });
+  }
+
+  void SetContributionAutoInclude(std::string publisher_key,
+                                  bool excluded,
+                                  uint64_t windowId) override {}
+
+  std::unique_ptr<ledger::LogStream> Log(
+      const char* file,
+      int line,
+      const ledger::LogLevel log_level) const override {
+    return std::unique_ptr<ledger::LogStream>(new StringLogStream());
+  }
+
+ private:
+  struct Event {
+    uint64_t id;
+    std::string url;
+    std::string response;
+    std::string viewing_id;
+    ledger::LedgerCallbackHandler* handler;  // nullptr for host timers
+  };
+
+  class Loader : public ledger::LedgerURLLoader {
+   public:
+    Loader(ContributionTestClient* client,
+           uint64_t id,
+           const std::string& url,
+           const std::string& content,
+           ledger::LedgerCallbackHandler* handler) :
+      client_(client),
+      id_(id),
+      url_(url),
+      content_(content),
+      handler_(handler) {}
+
+    void Start() override {
+      client_->OnRequestStarted(id_, url_, content_, handler_);
+    }
+
+    uint64_t request_id() override { return id_; }
+
+   private:
+    ContributionTestClient* client_;  // NOT OWNED
+    uint64_t id_;
+    std::string url_;
+    std::string content_;
+    ledger::LedgerCallbackHandler* handler_;  // NOT OWNED
+  };
+
+  // Accepts every vote of the batch
+  void OnRequestStarted(uint64_t id,
+                        const std::string& url,
+                        const std::string& content,
+                        ledger::LedgerCallbackHandler* handler) {
+    ASSERT_NE(std::string::npos, url.find(kVotingPath));
+
+    const std::string key = "\"surveyorId\":\"";
+    std::string response;
+    std::string viewing_id;
+    for (size_t pos = content.find(key); pos != std::string::npos;
+         pos = content.find(key, pos)) {
+      pos += key.length();
+      size_t end = content.find('"', pos);
+      std::string surveyor_id = content.substr(pos, end - pos);
+
+      viewing_id = surveyors_[surveyor_id];
+      votes_[surveyor_id]++;
+      response += response.empty() ? "[" : ",";
+      response += "{\"surveyorId\":\"" + surveyor_id + "\"}";
+    }
+    response += "]";
+
+    if (first_vote_.count(viewing_id) == 0) {
+      first_vote_[viewing_id] = now_;
+    }
+
+    events_.insert(std::make_pair(now_ + latency_,
+                                  Event{id, url, response, viewing_id,
+                                        handler}));
+  }
+
+  ledger::Ledger* ledger_;  // NOT OWNED
+  uint64_t latency_;
+  uint64_t now_;
+  uint64_t next_id_;
+  braveledger_bat_helper::CLIENT_STATE_ST state_;
+  std::string history_;
+  ledger::Result history_result_;
+  ledger::Result wallet_result_;
+  std::vector<std::string> saved_states_;
+  std::vector<std::string> saved_histories_;
+  std::multimap<uint64_t, Event> events_;
+  std::map<std::string, std::string> surveyors_;  // surveyor -> viewing id
+  std::map<std::string, int> votes_;
+  std::map<std::string, uint64_t> first_vote_;
+  std::map<std::string, uint64_t> last_response_;
+};
+
+TEST(BatContributionTest, ConcurrentReconciles) {
+  const int kReconciles = 4;
+  const int kPublishers = 3;
+  const int kVotes = 12;
+
+  ContributionTestClient client(30);
+  for (int i = 0; i < kReconciles; i++) {
+    client.AddReconcile("viewing-" + std::to_string(i), kPublishers, kVotes);
+  }
+
+  bat_ledger::LedgerImpl ledger(&client);
+  client.SetLedger(&ledger);
+  ledger.Initialize();
+  client.RunUntilIdle();
+
+  EXPECT_TRUE(ledger.GetBallots().empty());
+  EXPECT_TRUE(ledger.GetBatch().empty());
+
+  ASSERT_EQ(static_cast<size_t>(kReconciles * kPublishers * kVotes),
+            client.votes().size());
+  for (const auto& votes : client.votes()) {
+    EXPECT_EQ(1, votes.second) << votes.first;
+  }
+
+  // every reconcile needs at least 6 round trips, so all of them are
+  // voting at the same time unless they wait for each other
+  ASSERT_EQ(static_cast<size_t>(kReconciles), client.first_vote().size());
+  uint64_t last_start = 0;
+  for (const auto& start : client.first_vote()) {
+    last_start = std::max(last_start, start.second);
+  }
+  for (const auto& end : client.last_response()) {
+    EXPECT_LT(last_start, end.second) << end.first;
+  }
+}
+
+TEST(BatContributionTest, LegacyVotesWithoutReconcile) {
+  // older versions removed a finished reconcile while its votes were
+  // still waiting to be sent
+  ContributionTestClient client(30);
+  client.AddVotes("viewing-0", 2, 3);
+
+  bat_ledger::LedgerImpl ledger(&client);
+  client.SetLedger(&ledger);
+  ledger.Initialize();
+  client.RunUntilIdle();
+
+  EXPECT_EQ(6u, client.votes().size());
+  EXPECT_TRUE(ledger.GetBatch().empty());
+  ASSERT_FALSE(client.saved_states().empty());
+  EXPECT_TRUE(ParseState(client.saved_states().back()).batch_.empty());
+}
+
+TEST(BatContributionTest, MovesLegacyHistoryOnce) {
+  ContributionTestClient client(30);
+  client.AddReconcile("viewing-0", 2, 3);
+
+  bat_ledger::LedgerImpl ledger(&client);
+  client.SetLedger(&ledger);
+  ledger.Initialize();
+  client.RunUntilIdle();
+
+  EXPECT_EQ(6u, client.votes().size());
+
+  // every state is saved without the transactions, the votes are kept
+  // in the state until they are sent
+  ASSERT_FALSE(client.saved_states().empty());
+  for (const auto& data : client.saved_states()) {
+    EXPECT_TRUE(ParseState(data).transactions_.empty());
+  }
+  EXPECT_FALSE(ParseState(client.saved_states().front()).batch_.empty());
+  EXPECT_TRUE(ParseState(client.saved_states().back()).batch_.empty());
+
+  // voting doesn't write the history again
+  ASSERT_EQ(1u, client.saved_histories().size());
+  braveledger_bat_helper::CLIENT_HISTORY_ST history =
+      ParseHistory(client.saved_histories()[0]);
+  ASSERT_EQ(1u, history.transactions_.size());
+  EXPECT_EQ("viewing-0", history.transactions_[0].viewingId_);
+  EXPECT_EQ(1u, ledger.GetTransactions().size());
+}
+
+TEST(BatContributionTest, KeepsStoredHistoryOnEarlySave) {
+  braveledger_bat_helper::CLIENT_HISTORY_ST history;
+  history.transactions_.push_back(MakeTransaction("stored"));
+
+  ContributionTestClient client(30);
+  client.SetHistory(history);
+  // a stamp in ms is fixed and saved as soon as the state is parsed,
+  // before the history is loaded
+  client.mutable_state()->bootStamp_ = 1541766652000u;
+  client.mutable_state()->transactions_.push_back(MakeTransaction("legacy"));
+
+  bat_ledger::LedgerImpl ledger(&client);
+  client.SetLedger(&ledger);
+  ledger.Initialize();
+  client.RunUntilIdle();
+  EXPECT_TRUE(client.saved_histories().empty());
+
+  ledger.SetContributionAmount(5.0);
+
+  ASSERT_EQ(1u, client.saved_histories().size());
+  braveledger_bat_helper::CLIENT_HISTORY_ST saved =
+      ParseHistory(client.saved_histories()[0]);
+  ASSERT_EQ(2u, saved.transactions_.size());
+  EXPECT_EQ("stored", saved.transactions_[0].viewingId_);
+  EXPECT_EQ("legacy", saved.transactions_[1].viewingId_);
+
+  ASSERT_FALSE(client.saved_states().empty());
+  braveledger_bat_helper::CLIENT_STATE_ST state =
+      ParseState(client.saved_states().back());
+  EXPECT_TRUE(state.transactions_.empty());
+  EXPECT_EQ(1541766652u, state.bootStamp_);
+}
+
+TEST(BatContributionTest, ParsesStoredHistoryOnFirstUse) {
+  const char kParseMetric[] = "state.history.parse";
+
+  braveledger_bat_helper::CLIENT_HISTORY_ST history;
+  history.transactions_.push_back(MakeTransaction("stored"));
+
+  ContributionTestClient client(30);
+  client.SetHistory(history);
+
+  bat_ledger::LedgerImpl ledger(&client);
+  client.SetLedger(&ledger);
+  ledger.SetMetricsEnabled(true);
+  ledger.Initialize();
+  client.RunUntilIdle();
+
+  // nothing to resume, the stored history is left as it is
+  EXPECT_EQ(0u, ledger.GetMetricsSnapshot().histograms.count(kParseMetric));
+
+  ASSERT_EQ(1u, ledger.GetTransactions().size());
+  EXPECT_EQ("stored", ledger.GetTransactions()[0].viewingId_);
+  EXPECT_EQ(1u, ledger.GetMetricsSnapshot().histograms.count(kParseMetric));
+  EXPECT_TRUE(client.saved_histories().empty());
+}
+
+TEST(BatContributionTest, HistoryLoadErrorFailsStartup) {
+  braveledger_bat_helper::CLIENT_HISTORY_ST history;
+  history.transactions_.push_back(MakeTransaction("stored"));
+  std::string data;
+  braveledger_bat_helper::saveToJsonString(history, data);
+
+  ContributionTestClient client(30);
+  client.SetHistoryData(data, ledger::Result::LEDGER_ERROR);
+  client.AddReconcile("viewing-0", 2, 3);
+
+  bat_ledger::LedgerImpl ledger(&client);
+  client.SetLedger(&ledger);
+  ledger.Initialize();
+  client.RunUntilIdle();
+
+  // nothing is resumed, the history error comes before the missing
+  // publisher state
+  EXPECT_EQ(ledger::Result::LEDGER_ERROR, client.wallet_result());
+  EXPECT_TRUE(client.votes().empty());
+
+  // the stored history is not saved over, the state keeps its transactions
+  ledger.SetContributionAmount(5.0);
+  ledger.SetTransactions({MakeTransaction("new")});
+  EXPECT_TRUE(client.saved_histories().empty());
+  ASSERT_FALSE(client.saved_states().empty());
+  braveledger_bat_helper::CLIENT_STATE_ST state =
+      ParseState(client.saved_states().back());
+  ASSERT_EQ(1u, state.transactions_.size());
+  EXPECT_EQ("viewing-0", state.transactions_[0].viewingId_);
+}
+
+TEST(BatContributionTest, UnreadableHistoryIsNotSavedOver) {
+  ContributionTestClient client(30);
+  client.SetHistoryData("{\"transactions\":", ledger::Result::LEDGER_OK);
+  client.mutable_state()->transactions_.push_back(MakeTransaction("legacy"));
+
+  bat_ledger::LedgerImpl ledger(&client);
+  client.SetLedger(&ledger);
+  ledger.Initialize();
+  client.RunUntilIdle();
+
+  EXPECT_TRUE(ledger.GetTransactions().empty());
+  ledger.SetTransactions({MakeTransaction("new")});
+  ledger.SetContributionAmount(5.0);
+  EXPECT_TRUE(client.saved_histories().empty());
+  ASSERT_FALSE(client.saved_states().empty());
+  EXPECT_EQ(1u, ParseState(client.saved_states().back()).transactions_.size());
+}
+
+// Normalization of synopsisNormalizerInternal before normalizeScores()
+void OldNormalize(ledger::PublisherInfoList* list) {
+  if (list->size() == 0) {
+    return;
+  }
+  double totalScores = 0.0;
+  for (size_t i = 0; i < list->size(); i++) {
+    totalScores += (*list)[i].score;
+  }
+  std::vector<unsigned int> percents;
+  std::vector<double> weights;
+  std::vector<double> realPercents;
+  std::vector<double> roundoffs;
+  unsigned int totalPercents = 0;
+  for (size_t i = 0; i < list->size(); i++) {
+    realPercents.push_back(
+        (double)(*list)[i].score / (double)totalScores * 100.0);
+    percents.push_back(
+        (unsigned int)std::lround(realPercents[realPercents.size() - 1]));
+    double roundoff = percents[percents.size() - 1] -
+        realPercents[realPercents.size() - 1];
+    if (roundoff < 0.0) {
+      roundoff *= -1.0;
+    }
+    roundoffs.push_back(roundoff);
+    totalPercents += percents[percents.size() - 1];
+    weights.push_back(
+        (double)(*list)[i].score / (double)list->size() * 100.0);
+  }
+  while (totalPercents != 100) {
+    size_t valueToChange = 0;
+    double currentRoundOff = 0.0;
+    for (size_t i = 0; i < percents.size(); i++) {
+      if (0 == i) {
+        currentRoundOff = roundoffs[i];
+        continue;
+      }
+      if (roundoffs[i] > currentRoundOff) {
+        currentRoundOff = roundoffs[i];
+        valueToChange = i;
+      }
+    }
+    if (totalPercents > 100) {
+      percents[valueToChange] -= 1;
+      totalPercents -= 1;
+    } else {
+      percents[valueToChange] += 1;
+      totalPercents += 1;
+    }
+    roundoffs[valueToChange] = 0;
+  }
+  for (size_t i = 0; i < list->size(); i++) {
+    (*list)[i].percent = percents[i];
+    (*list)[i].weight = weights[i];
+  }
+}
+
+// Votes by publisher of GetContributeWinners before the winners were
+// picked from PUBLISHER_ST
+std::map<std::string, unsigned int> OldContributeWinners(
+    ledger::PublisherInfoList list,
+    unsigned int ballots) {
+  OldNormalize(&list);
+  std::sort(list.begin(), list.end());
+
+  unsigned int total_votes = 0;
+  std::vector<std::pair<std::string, unsigned int>> res;
+  for (const auto& item : list) {
+    if (item.percent <= 0) {
+      continue;
+    }
+
+    unsigned int votes = (unsigned int)std::lround(
+        (double) item.percent * (double)ballots / 100.0);
+    total_votes += votes;
+    res.push_back(std::make_pair(item.id, votes));
+  }
+
+  while (total_votes > ballots) {
+    auto max = std::max_element(res.begin(), res.end(),
+        [](const std::pair<std::string, unsigned int>& a,
+           const std::pair<std::string, unsigned int>& b) {
+          return a.second < b.second;
+        });
+    max->second--;
+    total_votes--;
+  }
+
+  std::map<std::string, unsigned int> votes;
+  for (const auto& winner : res) {
+    if (winner.second > 0) {
+      votes[winner.first] = winner.second;
+    }
+  }
+  return votes;
+}
+
+// Scores where the percents need a rounding fix
+ledger::PublisherInfoList GetFixedPublisherList() {
+  const double scores[] = {
+    120.0, 95.5, 80.25, 33.3, 33.3, 20.0, 7.5, 4.0, 2.2, 1.0, 0.4, 0.1,
+  };
+  ledger::PublisherInfoList list;
+  for (size_t i = 0; i < sizeof(scores) / sizeof(scores[0]); i++) {
+    ledger::PublisherInfo info("publisher" + std::to_string(i) + ".com",
+                               ledger::PUBLISHER_MONTH::ANY,
+                               -1);
+    info.score = scores[i];
+    info.duration = 1000 * (i + 1);
+    info.visits = static_cast<unsigned int>(i + 1);
+    list.push_back(info);
+  }
+  return list;
+}
+
+TEST(BatContributionTest, NormalizeScoresMatchesOldCode) {
+  ledger::PublisherInfoList expected = GetFixedPublisherList();
+  OldNormalize(&expected);
+
+  ledger::PublisherInfoList info_list = GetFixedPublisherList();
+  braveledger_bat_helper::normalizeScores(info_list,
+                                          &ledger::PublisherInfo::score,
+                                          &ledger::PublisherInfo::percent,
+                                          &ledger::PublisherInfo::weight);
+
+  braveledger_bat_helper::PublisherList list;
+  for (const auto& info : GetFixedPublisherList()) {
+    braveledger_bat_helper::PUBLISHER_ST publisher;
+    publisher.id_ = info.id;
+    publisher.score_ = info.score;
+    list.push_back(publisher);
+  }
+  braveledger_bat_helper::normalizeScores(
+      list,
+      &braveledger_bat_helper::PUBLISHER_ST::score_,
+      &braveledger_bat_helper::PUBLISHER_ST::percent_,
+      &braveledger_bat_helper::PUBLISHER_ST::weight_);
+
+  unsigned int total = 0;
+  for (size_t i = 0; i < expected.size(); i++) {
+    EXPECT_EQ(expected[i].percent, info_list[i].percent) << expected[i].id;
+    EXPECT_EQ(expected[i].weight, info_list[i].weight) << expected[i].id;
+    EXPECT_EQ(expected[i].percent, list[i].percent_) << expected[i].id;
+    EXPECT_EQ(expected[i].weight, list[i].weight_) << expected[i].id;
+    total += expected[i].percent;
+  }
+  EXPECT_EQ(100u, total);
+}
+
+TEST(BatContributionTest, WinnersMatchOldCode) {
+  // one vote more than the ballots before the rounding fix
+  const unsigned int kBallots = 50;
+  const std::string viewing_id = "viewing-0";
+
+  // percents are set the way StartAutoContribute reads them
+  braveledger_bat_publishers::TopPublishers top;
+  for (const auto& info : GetFixedPublisherList()) {
+    top.Add(info, TOP_PUBLISHERS_COUNT);
+  }
+  top.Finish();
+
+  braveledger_bat_helper::CURRENT_RECONCILE reconcile;
+  reconcile.viewingId_ = viewing_id;
+  reconcile.category_ = ledger::PUBLISHER_CATEGORY::AUTO_CONTRIBUTE;
+  reconcile.retry_step_ =
+      braveledger_bat_helper::ContributionRetry::STEP_WINNERS;
+  for (const auto& info : top.list) {
+    braveledger_bat_helper::PUBLISHER_ST publisher;
+    publisher.id_ = info.id;
+    publisher.percent_ = info.percent;
+    publisher.weight_ = info.weight;
+    publisher.duration_ = info.duration;
+    publisher.score_ = info.score;
+    publisher.visits_ = info.visits;
+    reconcile.list_.push_back(publisher);
+  }
+
+  braveledger_bat_helper::CLIENT_STATE_ST state;
+  state.current_reconciles_[viewing_id] = reconcile;
+  braveledger_bat_helper::CLIENT_HISTORY_ST history;
+  history.transactions_.push_back(MakeTransaction(viewing_id));
+  for (unsigned int i = 0; i < kBallots; i++) {
+    history.transactions_[0].surveyorIds_.push_back(
+        "surveyor-" + std::to_string(i));
+  }
+
+  // winners are picked again when the ledger starts
+  bat_ledger::MockLedgerClient client;
+  std::string data;
+  braveledger_bat_helper::saveToJsonString(state, data);
+  client.SetLedgerState(data);
+  braveledger_bat_helper::saveToJsonString(history, data);
+  client.SetLedgerHistory(data);
+  bat_ledger::LedgerImpl* ledger =
+      static_cast<bat_ledger::LedgerImpl*>(client.ledger());
+  ledger->Initialize();
+  client.RunUntil(client.now());
+
+  std::map<std::string, unsigned int> votes;
+  for (const auto& ballot : ledger->GetBallots()) {
+    EXPECT_EQ(viewing_id, ballot.viewingId_);
+    votes[ballot.publisher_]++;
+  }
+
+  std::map<std::string, unsigned int> expected =
+      OldContributeWinners(GetFixedPublisherList(), kBallots);
+  EXPECT_EQ(kBallots, ledger->GetBallots().size());
+  EXPECT_EQ(expected, votes);
+}
+
+}  // namespace
@@ -0,0 +1,319 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+#include "brave/vendor/bat-native-ledger/src/bat_helper_fields.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace {
+
+using braveledger_bat_helper::FieldIndex;
+
+// Written by the JSON writers before the member tables, the same fixtures
+// have to give the same bytes
+const char kReconcileJson[] =
+    "{\"viewingId\":\"v2\",\"anonizeViewingId\":\"anon2\","
+    "\"registrarVK\":\"rvk2\",\"preFlight\":\"pf\","
+    "\"masterUserToken\":\"mut2\","
+    "\"surveyorInfo\":{\"surveyorId\":\"s4\"},\"timestamp\":1541766712,"
+    "\"amount\":\"10\",\"currency\":\"USD\",\"fee\":10.5,"
+    "\"category\":8,\"rates\":{\"BAT\":1.0,\"USD\":0.25},"
+    "\"directions\":[{\"amount\":5,\"publisher_key\":\"brave.com\","
+    "\"currency\":\"BAT\"}],\"list\":[{\"id\":\"brave.com\","
+    "\"duration\":42,\"score\":1.25,\"visits\":3,\"percent\":60,"
+    "\"weight\":37.5}],\"retry_step\":3,\"retry_level\":2,"
+    "\"destination\":\"dest\",\"proof\":\"rproof\"}";
+
+const char kClientStateJsonStart[] =
+    "{\"walletInfo\":{\"paymentId\":\"pid\",\"addressBAT\":\"0xbat\","
+    "\"addressBTC\":\"\",\"addressCARD_ID\":\"\",\"addressETH\":\"\","
+    "\"addressLTC\":\"\",\"keyInfoSeed\":\"AQID+g==\"},\"bootStamp\":1,"
+    "\"reconcileStamp\":2,\"last_grant_fetch_stamp\":3,"
+    "\"personaId\":\"persona\",\"userId\":\"user\","
+    "\"registrarVK\":\"rvk\",\"masterUserToken\":\"mut\","
+    "\"preFlight\":\"pf\",\"fee_currency\":\"BAT\","
+    "\"settings\":\"adFree\",\"fee_amount\":20.0,"
+    "\"user_changed_fee\":true,\"days\":30,\"rewards_enabled\":true,"
+    "\"auto_contribute\":true,\"transactions\":[{\"viewingId\":\"v1\","
+    "\"surveyorId\":\"s1\",\"contribution_fiat_amount\":\"5\","
+    "\"contribution_fiat_currency\":\"USD\",\"rates\":{\"BTC\":0.5,"
+    "\"ETH\":2.0,\"EUR\":0.25,\"LTC\":4.0,\"USD\":0.125},"
+    "\"contribution_altcurrency\":\"BAT\","
+    "\"contribution_probi\":\"20000000000000000000\","
+    "\"contribution_fee\":\"0.5\",\"submissionStamp\":\"1541766712\","
+    "\"submissionId\":\"sub1\",\"anonizeViewingId\":\"anon1\","
+    "\"registrarVK\":\"rvk\",\"masterUserToken\":\"mut\","
+    "\"surveyorIds\":[\"s2\",\"s3\"],\"votes\":2,"
+    "\"ballots\":[{\"publisher\":\"brave.com\",\"offset\":1}]}],"
+    "\"ballots\":[{\"viewingId\":\"v1\",\"surveyorId\":\"s2\","
+    "\"publisher\":\"brave.com\",\"offset\":1,"
+    "\"prepareBallot\":\"prep\",\"delayStamp\":1541766800}],"
+    "\"ruleset\":\"rs\",\"rulesetV2\":\"rs2\",\"batch\":[],"
+    "\"current_reconciles\":{\"v2\":";
+
+const char kPublisherStateJson[] =
+    "{\"min_pubslisher_duration\":8,\"min_visits\":2,"
+    "\"num_excluded_sites\":1,\"allow_non_verified\":false,"
+    "\"pubs_load_timestamp\":1541766712,"
+    "\"pubs_list_etag\":\"\\\"etag\\\"\","
+    "\"pubs_list_last_modified\":\"Fri, 09 Nov 2018 12:31:52 GMT\","
+    "\"allow_videos\":false,"
+    "\"monthly_balances\":[{\"2018_11\":{\"opening_balance\":\"0\","
+    "\"closing_balance\":\"0\",\"deposits\":\"5\",\"grants\":\"0\","
+    "\"earning_from_ads\":\"0\",\"auto_contribute\":\"0\","
+    "\"recurring_donation\":\"0\",\"one_time_donation\":\"0\","
+    "\"total\":\"5\"}}],\"recurring_donation\":[{\"brave.com\":5.0}]}";
+
+braveledger_bat_helper::CURRENT_RECONCILE Reconcile() {
+  braveledger_bat_helper::CURRENT_RECONCILE reconcile;
+  reconcile.viewingId_ = "v2";
+  reconcile.anonizeViewingId_ = "anon2";
+  reconcile.registrarVK_ = "rvk2";
+  reconcile.preFlight_ = "pf";
+  reconcile.masterUserToken_ = "mut2";
+  reconcile.surveyorInfo_.surveyorId_ = "s4";
+  reconcile.timestamp_ = 1541766712;
+  reconcile.rates_["BAT"] = 1;
+  reconcile.rates_["USD"] = 0.25;
+  reconcile.amount_ = "10";
+  reconcile.currency_ = "USD";
+  reconcile.fee_ = 10.5;
+  reconcile.directions_.push_back(
+      braveledger_bat_helper::RECONCILE_DIRECTION("brave.com", 5, "BAT"));
+  reconcile.category_ = 8;
+  braveledger_bat_helper::PUBLISHER_ST publisher;
+  publisher.id_ = "brave.com";
+  publisher.duration_ = 42;
+  publisher.score_ = 1.25;
+  publisher.visits_ = 3;
+  publisher.percent_ = 60;
+  publisher.weight_ = 37.5;
+  reconcile.list_.push_back(publisher);
+  reconcile.retry_step_ = braveledger_bat_helper::ContributionRetry::STEP_PAYLOAD;
+  reconcile.retry_level_ = 2;
+  reconcile.destination_ = "dest";
+  reconcile.proof_ = "rproof";
+  return reconcile;
+}
+
+braveledger_bat_helper::CLIENT_STATE_ST ClientState() {
+  braveledger_bat_helper::CLIENT_STATE_ST state;
+  state.walletInfo_.paymentId_ = "pid";
+  state.walletInfo_.addressBAT_ = "0xbat";
+  state.walletInfo_.keyInfoSeed_ = {1, 2, 3, 250};
+  state.bootStamp_ = 1;
+  state.reconcileStamp_ = 2;
+  state.last_grant_fetch_stamp_ = 3;
+  state.personaId_ = "persona";
+  state.userId_ = "user";
+  state.registrarVK_ = "rvk";
+  state.masterUserToken_ = "mut";
+  state.preFlight_ = "pf";
+  state.fee_currency_ = "BAT";
+  state.fee_amount_ = 20;
+  state.user_changed_fee_ = true;
+  state.days_ = 30;
+  state.ruleset_ = "rs";
+  state.rulesetV2_ = "rs2";
+  state.auto_contribute_ = true;
+  state.rewards_enabled_ = true;
+
+  braveledger_bat_helper::TRANSACTION_ST transaction;
+  transaction.viewingId_ = "v1";
+  transaction.surveyorId_ = "s1";
+  transaction.contribution_fiat_amount_ = "5";
+  transaction.contribution_fiat_currency_ = "USD";
+  transaction.contribution_rates_ = {
+      {"BTC", 0.5}, {"ETH", 2}, {"EUR", 0.25}, {"LTC", 4}, {"USD", 0.125}};
+  transaction.contribution_altcurrency_ = "BAT";
+  transaction.contribution_probi_ = "20000000000000000000";
+  transaction.contribution_fee_ = "0.5";
+  transaction.submissionStamp_ = "1541766712";
+  transaction.submissionId_ = "sub1";
+  transaction.anonizeViewingId_ = "anon1";
+  transaction.registrarVK_ = "rvk";
+  transaction.masterUserToken_ = "mut";
+  transaction.surveyorIds_ = {"s2", "s3"};
+  transaction.votes_ = 2;
+  braveledger_bat_helper::TRANSACTION_BALLOT_ST transaction_ballot;
+  transaction_ballot.publisher_ = "brave.com";
+  transaction_ballot.offset_ = 1;
+  transaction.ballots_.push_back(transaction_ballot);
+  state.transactions_.push_back(transaction);
+
+  braveledger_bat_helper::BALLOT_ST ballot;
+  ballot.viewingId_ = "v1";
+  ballot.surveyorId_ = "s2";
+  ballot.publisher_ = "brave.com";
+  ballot.offset_ = 1;
+  ballot.prepareBallot_ = "prep";
+  // not saved, the same as before
+  ballot.proofBallot_ = "proof";
+  ballot.delayStamp_ = 1541766800;
+  state.ballots_.push_back(ballot);
+
+  state.current_reconciles_["v2"] = Reconcile();
+  return state;
+}
+
+TEST(BatFieldsTest, FindsEveryField) {
+  const FieldIndex& index =
+      FieldIndex::Get<braveledger_bat_helper::CLIENT_STATE_ST>();
+  EXPECT_EQ(0, index.Find("walletInfo", 10));
+  EXPECT_EQ(3, index.Find("last_grant_fetch_stamp", 22));
+  EXPECT_EQ(21, index.Find("current_reconciles", 18));
+  EXPECT_EQ(-1, index.Find("walletInf", 9));
+  EXPECT_EQ(-1, index.Find("grant", 5));
+  EXPECT_EQ(-1, index.Find("", 0));
+}
+
+TEST(BatFieldsTest, RequiredAndOptional) {
+  braveledger_bat_helper::SURVEYOR_ST surveyor;
+  surveyor.surveySK_ = "kept";
+
+  // surveyVK is missing, nothing is loaded
+  EXPECT_FALSE(surveyor.loadFromJson(
+      "{\"signature\":\"a\",\"surveyorId\":\"b\",\"registrarVK\":\"d\"}"));
+  EXPECT_TRUE(surveyor.signature_.empty());
+
+  // surveySK of the wrong type keeps the old value
+  EXPECT_TRUE(surveyor.loadFromJson(
+      "{\"signature\":\"a\",\"surveyorId\":\"b\",\"surveyVK\":\"c\","
+      "\"registrarVK\":\"d\",\"surveySK\":1,\"unknown\":[]}"));
+  EXPECT_EQ("a", surveyor.signature_);
+  EXPECT_EQ("c", surveyor.surveyVK_);
+  EXPECT_EQ("kept", surveyor.surveySK_);
+
+  EXPECT_FALSE(surveyor.loadFromJson("{\"signature\":"));
+}
+
+TEST(BatFieldsTest, Codecs) {
+  braveledger_bat_helper::WALLET_INFO_ST wallet;
+  const std::string prefix =
+      "{\"paymentId\":\"id\",\"addressBAT\":\"\",\"addressBTC\":\"\","
+      "\"addressCARD_ID\":\"\",\"addressETH\":\"\",\"addressLTC\":\"\","
+      "\"keyInfoSeed\":";
+  EXPECT_FALSE(wallet.loadFromJson(prefix + "\"AQI\"}"));
+  EXPECT_FALSE(wallet.loadFromJson(prefix + "\"A*I=\"}"));
+  ASSERT_TRUE(wallet.loadFromJson(prefix + "\"AQID\"}"));
+  EXPECT_EQ(std::vector<uint8_t>({1, 2, 3}), wallet.keyInfoSeed_);
+
+  std::string json;
+  braveledger_bat_helper::saveToJsonString(wallet, json);
+  EXPECT_EQ(prefix + "\"AQID\"}", json);
+
+  braveledger_bat_helper::REPORT_BALANCE_ST report;
+  braveledger_bat_helper::saveToJsonString(report, json);
+  report.total_ = "12";
+  EXPECT_TRUE(report.loadFromJson(json));
+  EXPECT_EQ("0", report.total_);
+  json.replace(json.find("\"total\":\"0\""), 11, "\"total\":\"1.5\"");
+  EXPECT_FALSE(report.loadFromJson(json));
+}
+
+TEST(BatFieldsTest, PublisherRoundTrip) {
+  braveledger_bat_helper::PUBLISHER_ST publisher;
+  publisher.id_ = "brave.com";
+  publisher.duration_ = 42;
+  publisher.score_ = 1.25;
+  publisher.visits_ = 3;
+  publisher.percent_ = 60;
+  publisher.weight_ = 37.5;
+
+  std::string json;
+  braveledger_bat_helper::saveToJsonString(publisher, json);
+  EXPECT_EQ("{\"id\":\"brave.com\",\"duration\":42,\"score\":1.25,"
+            "\"visits\":3,\"percent\":60,\"weight\":37.5}",
+            json);
+
+  braveledger_bat_helper::PUBLISHER_ST loaded;
+  ASSERT_TRUE(loaded.loadFromJson(json));
+  EXPECT_EQ(publisher.id_, loaded.id_);
+  EXPECT_EQ(publisher.duration_, loaded.duration_);
+  EXPECT_EQ(publisher.score_, loaded.score_);
+  EXPECT_EQ(publisher.visits_, loaded.visits_);
+  EXPECT_EQ(publisher.percent_, loaded.percent_);
+  EXPECT_EQ(publisher.weight_, loaded.weight_);
+}
+
+TEST(BatFieldsTest, HistoryFromClientState) {
+  braveledger_bat_helper::CLIENT_STATE_ST state;
+  state.transactions_.resize(2);
+  state.batch_.resize(1);
+
+  // a state saved with the history in it loads as a history
+  std::string json;
+  braveledger_bat_helper::saveToJsonString(state, json);
+  braveledger_bat_helper::CLIENT_HISTORY_ST history;
+  ASSERT_TRUE(history.loadFromJson(json));
+  EXPECT_EQ(2u, history.transactions_.size());
+
+  // the votes are not part of it
+  braveledger_bat_helper::saveToJsonString(history, json);
+  EXPECT_EQ(0u, json.find("{\"transactions\":["));
+  EXPECT_EQ(std::string::npos, json.find("\"batch\""));
+
+  // the state without its history is still loaded by older versions
+  state.transactions_.clear();
+  state.batch_.clear();
+  braveledger_bat_helper::saveToJsonString(state, json);
+  EXPECT_NE(std::string::npos, json.find("\"transactions\":[]"));
+  EXPECT_NE(std::string::npos, json.find("\"batch\":[]"));
+}
+
+TEST(BatFieldsTest, ReconcileGolden) {
+  std::string json;
+  braveledger_bat_helper::saveToJsonString(Reconcile(), json);
+  EXPECT_EQ(kReconcileJson, json);
+
+  braveledger_bat_helper::CURRENT_RECONCILE loaded;
+  ASSERT_TRUE(loaded.loadFromJson(json));
+  braveledger_bat_helper::saveToJsonString(loaded, json);
+  EXPECT_EQ(kReconcileJson, json);
+}
+
+TEST(BatFieldsTest, ClientStateGolden) {
+  const std::string expected =
+      std::string(kClientStateJsonStart) + kReconcileJson + "}}";
+  std::string json;
+  braveledger_bat_helper::saveToJsonString(ClientState(), json);
+  EXPECT_EQ(expected, json);
+
+  braveledger_bat_helper::CLIENT_STATE_ST loaded;
+  ASSERT_TRUE(loaded.loadFromJson(json));
+  braveledger_bat_helper::saveToJsonString(loaded, json);
+  EXPECT_EQ(expected, json);
+}
+
+TEST(BatFieldsTest, PublisherStateGolden) {
+  braveledger_bat_helper::PUBLISHER_STATE_ST state;
+  state.min_publisher_duration_ = 8;
+  state.min_visits_ = 2;
+  state.num_excluded_sites_ = 1;
+  state.allow_non_verified_ = false;
+  state.pubs_load_timestamp_ = 1541766712;
+  state.pubs_list_etag_ = "\"etag\"";
+  state.pubs_list_last_modified_ = "Fri, 09 Nov 2018 12:31:52 GMT";
+  state.allow_videos_ = false;
+  braveledger_bat_helper::REPORT_BALANCE_ST balance;
+  balance.deposits_ = "5";
+  balance.total_ = "5";
+  state.monthly_balances_["2018_11"] = balance;
+  state.recurring_donation_["brave.com"] = 5;
+
+  std::string json;
+  braveledger_bat_helper::saveToJsonString(state, json);
+  EXPECT_EQ(kPublisherStateJson, json);
+
+  braveledger_bat_helper::PUBLISHER_STATE_ST loaded;
+  ASSERT_TRUE(loaded.loadFromJson(json));
+  braveledger_bat_helper::saveToJsonString(loaded, json);
+  EXPECT_EQ(kPublisherStateJson, json);
+}
+
+}  // namespace
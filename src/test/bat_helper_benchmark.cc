@@ -0,0 +1,150 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include <string>
+#include <vector>
+
+#include "bat_helper.h"
+#include "bignum.h"
+#include "http_signature.h"
+#include "random_service.h"
+#include "third_party/google_benchmark/src/include/benchmark/benchmark.h"
+
+namespace {
+
+// Niceware list has 65536 words, the generated words sort the same way
+std::vector<std::string> GetWordList(size_t size) {
+  std::vector<std::string> words;
+  words.reserve(size);
+  for (size_t i = 0; i < size; i++) {
+    std::string word = std::to_string(i);
+    words.push_back("word" + std::string(6 - word.length(), '0') + word);
+  }
+
+  return words;
+}
+
+// 16 words spread over the whole list, the way a random seed picks them
+std::string GetPassPhrase(const std::vector<std::string>& words) {
+  std::string pass_phrase;
+  for (size_t i = 0; i < 16; i++) {
+    if (i > 0) {
+      pass_phrase += WALLET_PASSPHRASE_DELIM;
+    }
+    pass_phrase += words[(i * 40503 + 7) % words.size()];
+  }
+
+  return pass_phrase;
+}
+
+void BM_NicewareMnemonicToBytes(benchmark::State& state) {
+  const std::vector<std::string> words = GetWordList(state.range(0));
+  const std::string pass_phrase = GetPassPhrase(words);
+
+  for (auto _ : state) {
+    std::vector<uint8_t> seed;
+    size_t written = 0;
+    benchmark::DoNotOptimize(braveledger_bat_helper::niceware_mnemonic_to_bytes(
+        pass_phrase, seed, &written, words));
+  }
+
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_NicewareMnemonicToBytes)->Arg(2048)->Arg(65536);
+
+// Probi amounts of |size| contributions, 18 decimals each
+std::vector<std::string> GetProbiList(size_t size) {
+  std::vector<std::string> list;
+  for (size_t i = 0; i < size; i++) {
+    list.push_back(std::to_string(1 + i % 50) + "250000000000000000");
+  }
+
+  return list;
+}
+
+// Running total, the way balance reports are added up
+void BM_BignumSum(benchmark::State& state) {
+  const std::vector<std::string> probi = GetProbiList(state.range(0));
+
+  for (auto _ : state) {
+    std::string total = "0";
+    for (const auto& amount : probi) {
+      total = braveledger_bat_bignum::sum(total, amount);
+    }
+    benchmark::DoNotOptimize(total);
+  }
+
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_BignumSum)->Arg(10)->Arg(100)->Arg(1000);
+
+// Timer jitter, every reconcile and retry timer draws one.
+// Arg 1 runs on a seeded keystream, 0 on RAND_bytes.
+void BM_GetRandomValue(benchmark::State& state) {
+  bat_ledger::RandomService* random = bat_ledger::RandomService::GetInstance();
+  if (state.range(0)) {
+    random->SetSeedForTesting(1);
+  }
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(braveledger_bat_helper::getRandomValue(10, 60));
+  }
+
+  random->ClearSeedForTesting();
+}
+BENCHMARK(BM_GetRandomValue)->Arg(0)->Arg(1);
+
+void BM_GenerateSeed(benchmark::State& state) {
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(braveledger_bat_helper::generateSeed());
+  }
+}
+BENCHMARK(BM_GenerateSeed);
+
+// Signing key the way the wallet derives it from its seed
+std::vector<uint8_t> GetSigningKey() {
+  std::vector<uint8_t> public_key;
+  std::vector<uint8_t> secret_key;
+  braveledger_bat_helper::getPublicKeyFromSeed(
+      braveledger_bat_helper::getHKDF(std::vector<uint8_t>(32, 7)),
+      public_key,
+      secret_key);
+  return secret_key;
+}
+
+// Digest and signature headers of one reconcile payload of |range(0)| bytes
+void BM_SignPayload(benchmark::State& state) {
+  const std::vector<uint8_t> secret_key = GetSigningKey();
+  const std::string body(state.range(0), 'x');
+  bat_ledger::HttpSigner signer("primary", secret_key);
+  std::string digest;
+  std::string signature;
+
+  for (auto _ : state) {
+    bat_ledger::HttpSigner::GetDigest(body, &digest);
+    signer.SignDigest(digest, &signature);
+    benchmark::DoNotOptimize(signature.data());
+  }
+
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_SignPayload)->Arg(256)->Arg(4096);
+
+// |range(0)| payloads signed with one signer
+void BM_SignBodies(benchmark::State& state) {
+  const std::vector<uint8_t> secret_key = GetSigningKey();
+  const std::vector<std::string> bodies(state.range(0), std::string(256, 'x'));
+  bat_ledger::HttpSigner signer("primary", secret_key);
+  std::vector<bat_ledger::SignedRequest> requests;
+
+  for (auto _ : state) {
+    signer.SignBodies(bodies, &requests);
+    benchmark::DoNotOptimize(requests.data());
+  }
+
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_SignBodies)->Arg(16)->Arg(256);
+
+}  // namespace
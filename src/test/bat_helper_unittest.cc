@@ -0,0 +1,48 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include <clocale>
+#include <map>
+#include <string>
+
+#include "brave/vendor/bat-native-ledger/src/bat_helper.h"
+#include "brave/vendor/bat-native-ledger/src/static_values.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace {
+
+uint64_t YoutubeDuration(const std::string& st, const std::string& et) {
+  std::map<std::string, std::string> data = {{"st", st}, {"et", et}};
+  return braveledger_bat_helper::getMediaDuration(
+      data, "youtube_id", YOUTUBE_MEDIA_TYPE);
+}
+
+TEST(BatHelperTest, MediaDurationSumsIntervals) {
+  EXPECT_EQ(94u, YoutubeDuration("0.501,31.213,62.004",
+                                 "30.742,61.873,95.311"));
+  EXPECT_EQ(20u, YoutubeDuration("1e1", "3.0E1"));
+  EXPECT_EQ(0u, YoutubeDuration("1,2", "3"));
+}
+
+TEST(BatHelperTest, MediaDurationOnlyReadsDecimals) {
+  // read as 0, strtod would take them as numbers
+  EXPECT_EQ(10u, YoutubeDuration("inf", "10"));
+  EXPECT_EQ(10u, YoutubeDuration("nan", "10"));
+  EXPECT_EQ(10u, YoutubeDuration("0x10", "10"));
+  EXPECT_EQ(10u, YoutubeDuration("abc", "10"));
+  EXPECT_EQ(8u, YoutubeDuration("2.5s", "10.5"));
+}
+
+TEST(BatHelperTest, MediaDurationIgnoresLocale) {
+  const char* locale = std::setlocale(LC_NUMERIC, "de_DE.UTF-8");
+  // nothing to check when the locale isn't installed
+  if (!locale) {
+    return;
+  }
+
+  EXPECT_EQ(30u, YoutubeDuration("0.5", "30.5"));
+  std::setlocale(LC_NUMERIC, "C");
+}
+
+}  // namespace
@@ -0,0 +1,132 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include <string>
+
+#include "brave/vendor/bat-native-ledger/src/bat_media_classifier.h"
+#include "brave/vendor/bat-native-ledger/src/static_values.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace {
+
+using braveledger_bat_get_media::MediaClassifier;
+
+// Substring rules that GetLinkType used before the classifier
+std::string OldLinkType(const std::string& url,
+                        const std::string& first_party_url,
+                        const std::string& referrer) {
+  if (url.find("https://m.youtube.com/api/stats/watchtime?") !=
+          std::string::npos ||
+      url.find("https://www.youtube.com/api/stats/watchtime?") !=
+          std::string::npos) {
+    return YOUTUBE_MEDIA_TYPE;
+  }
+
+  if ((first_party_url.find("https://www.twitch.tv/") == 0 ||
+       first_party_url.find("https://m.twitch.tv/") == 0 ||
+       referrer.find("https://player.twitch.tv/") == 0) &&
+      (url.find(".ttvnw.net/v1/segment/") != std::string::npos ||
+       url.find("https://ttvnw.net/v1/segment/") != std::string::npos)) {
+    return TWITCH_MEDIA_TYPE;
+  }
+
+  return "";
+}
+
+struct Page {
+  const char* first_party_url;
+  const char* referrer;
+};
+
+const char* const kUrls[] = {
+  "https://www.youtube.com/api/stats/watchtime?ns=yt&docid=hmNNRz6YpUY",
+  "https://m.youtube.com/api/stats/watchtime?ns=yt&docid=hmNNRz6YpUY",
+  "https://www.youtube.com/api/stats/playback?ns=yt",
+  "https://youtube.com/api/stats/watchtime?ns=yt",
+  "https://music.youtube.com/api/stats/watchtime?ns=yt",
+  "https://video-edge-c2a1b4.sjc02.abs.hls.ttvnw.net/v1/segment/CqgD.ts",
+  "https://video-weaver.sjc02.hls.ttvnw.net/v1/segment/CqgD.ts",
+  "https://ttvnw.net/v1/segment/CqgD.ts",
+  "https://video-edge-c2a1b4.sjc02.abs.hls.ttvnw.net/v1/playlist/CqgD.m3u8",
+  "https://usher.ttvnw.net/api/channel/hls/shroud.m3u8",
+  "https://attvnw.net/v1/segment/CqgD.ts",
+  "https://ttvnw.net.example.com/v1/segment/CqgD.ts",
+  "https://www.twitch.tv/shroud",
+  "https://player.twitch.tv/?channel=shroud",
+  "https://gql.twitch.tv/gql",
+  "https://www.google-analytics.com/collect?v=1",
+  "",
+};
+
+const Page kPages[] = {
+  {"https://www.twitch.tv/shroud", ""},
+  {"https://m.twitch.tv/shroud", ""},
+  {"https://www.twitch.tv/videos/334523245", "https://www.twitch.tv/"},
+  {"https://example.com/embed", "https://player.twitch.tv/?channel=shroud"},
+  // referrer only, the first party doesn't match
+  {"", "https://player.twitch.tv/?video=v334523245"},
+  {"https://twitch.tv/shroud", ""},
+  {"https://clips.twitch.tv/shroud", ""},
+  {"https://example.com/?u=https://www.twitch.tv/", ""},
+  {"https://www.youtube.com/watch?v=hmNNRz6YpUY", ""},
+  {"", "https://www.twitch.tv/shroud"},
+  {"", ""},
+};
+
+TEST(BatMediaClassifierTest, MatchesOldRules) {
+  const MediaClassifier& classifier = MediaClassifier::GetInstance();
+  for (const char* url : kUrls) {
+    for (const Page& page : kPages) {
+      EXPECT_EQ(OldLinkType(url, page.first_party_url, page.referrer),
+                classifier.GetLinkType(url,
+                                       page.first_party_url,
+                                       page.referrer))
+          << url << " " << page.first_party_url << " " << page.referrer;
+    }
+  }
+}
+
+TEST(BatMediaClassifierTest, ReferrerOnlyMatch) {
+  const MediaClassifier& classifier = MediaClassifier::GetInstance();
+  const std::string segment =
+      "https://video-weaver.sjc02.hls.ttvnw.net/v1/segment/CqgD.ts";
+  EXPECT_EQ(TWITCH_MEDIA_TYPE, classifier.GetLinkType(
+      segment, "", "https://player.twitch.tv/?channel=shroud"));
+  EXPECT_EQ("", classifier.GetLinkType(
+      segment, "", "https://www.example.com/?https://player.twitch.tv/"));
+}
+
+// The rules only match urls that start with https://<host><path>. This is
+// stricter than the old rules where a media url was embedded in another one.
+TEST(BatMediaClassifierTest, StricterThanOldRules) {
+  const MediaClassifier& classifier = MediaClassifier::GetInstance();
+  const std::string twitch_page = "https://www.twitch.tv/shroud";
+  const char* const urls[] = {
+    "https://example.com/?u=https://www.youtube.com/api/stats/watchtime?",
+    "http://video-weaver.sjc02.hls.ttvnw.net/v1/segment/CqgD.ts",
+    "https://example.com/x.ttvnw.net/v1/segment/CqgD.ts",
+  };
+  for (const char* url : urls) {
+    EXPECT_NE("", OldLinkType(url, twitch_page, "")) << url;
+    EXPECT_EQ("", classifier.GetLinkType(url, twitch_page, "")) << url;
+  }
+}
+
+// A host with an explicit port is not a media link, the same as with the
+// old rules
+TEST(BatMediaClassifierTest, ExplicitPortIsNotMedia) {
+  const MediaClassifier& classifier = MediaClassifier::GetInstance();
+  const std::string twitch_page = "https://www.twitch.tv/shroud";
+  const char* const urls[] = {
+    "https://www.youtube.com:443/api/stats/watchtime?ns=yt",
+    "https://video-weaver.sjc02.hls.ttvnw.net:443/v1/segment/CqgD.ts",
+    "https://ttvnw.net:8443/v1/segment/CqgD.ts",
+  };
+  for (const char* url : urls) {
+    EXPECT_EQ("", OldLinkType(url, twitch_page, "")) << url;
+    EXPECT_EQ("", classifier.GetLinkType(url, twitch_page, "")) << url;
+  }
+}
+
+}  // namespace
@@ -0,0 +1,236 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include <stdint.h>
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "brave/vendor/bat-native-ledger/src/bat_helper.h"
+#include "brave/vendor/bat-native-ledger/src/bat_publishers.h"
+#include "brave/vendor/bat-native-ledger/src/ledger_impl.h"
+#include "brave/vendor/bat-native-ledger/src/static_values.h"
+#include "brave/vendor/bat-native-ledger/src/test/mock_ledger_client.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace {
+
+using braveledger_bat_publishers::TopPublishers;
+
+ledger::PublisherInfo GetInfo(const std::string& id,
+                              double score,
+                              unsigned int percent) {
+  ledger::PublisherInfo info(id, ledger::PUBLISHER_MONTH::JANUARY, 2019);
+  info.score = score;
+  info.percent = percent;
+  return info;
+}
+
+TopPublishers Scan(const ledger::PublisherInfoList& list, size_t max_count) {
+  TopPublishers top;
+  for (const auto& info : list) {
+    top.Add(info, max_count);
+  }
+  top.Finish();
+  return top;
+}
+
+// Percents by id after normalizing the complete list
+std::map<std::string, unsigned int> NormalizeAll(
+    ledger::PublisherInfoList list) {
+  braveledger_bat_helper::normalizeScores(list,
+                                          &ledger::PublisherInfo::score,
+                                          &ledger::PublisherInfo::percent,
+                                          &ledger::PublisherInfo::weight);
+  std::map<std::string, unsigned int> percents;
+  for (const auto& info : list) {
+    percents[info.id] = info.percent;
+  }
+  return percents;
+}
+
+// Stores publisher info and records the pages that were asked for
+class PagingTestClient : public bat_ledger::MockLedgerClient {
+ public:
+  void AddPublisher(const ledger::PublisherInfo& info) {
+    SavePublisherInfo(
+        std::unique_ptr<ledger::PublisherInfo>(new ledger::PublisherInfo(info)),
+        [](ledger::Result, std::unique_ptr<ledger::PublisherInfo>) {});
+  }
+
+  void LoadPublisherInfoList(
+      uint32_t start,
+      uint32_t limit,
+      ledger::PublisherInfoFilter filter,
+      ledger::PublisherInfoListCallback callback) override {
+    pages_.push_back(std::make_pair(start, limit));
+    MockLedgerClient::LoadPublisherInfoList(start, limit, filter, callback);
+  }
+
+  const std::vector<std::pair<uint32_t, uint32_t>>& pages() const {
+    return pages_;
+  }
+
+ private:
+  std::vector<std::pair<uint32_t, uint32_t>> pages_;
+};
+
+TEST(BatPublishersTest, KeepsHighestScores) {
+  ledger::PublisherInfoList list;
+  for (int score : {4, 9, 1, 7, 10, 2, 8, 3, 6, 5}) {
+    list.push_back(GetInfo("site" + std::to_string(score), score, 0));
+  }
+
+  TopPublishers top = Scan(list, 3);
+  EXPECT_EQ(10u, top.count);
+  EXPECT_EQ(55.0, top.total_scores);
+  ASSERT_EQ(3u, top.list.size());
+  EXPECT_EQ("site10", top.list[0].id);
+  EXPECT_EQ("site9", top.list[1].id);
+  EXPECT_EQ("site8", top.list[2].id);
+  EXPECT_TRUE(top.stale.empty());
+}
+
+TEST(BatPublishersTest, LeftOutPublishersWithPercentAreStale) {
+  ledger::PublisherInfoList list = {
+    GetInfo("kept", 10, 40),
+    // kept at first, then pushed out by higher scores
+    GetInfo("pushed_out", 2, 30),
+    GetInfo("new", 8, 0),
+    GetInfo("never_kept", 1, 20),
+    GetInfo("no_percent", 1, 0),
+    GetInfo("newer", 9, 0),
+  };
+
+  TopPublishers top = Scan(list, 3);
+  ASSERT_EQ(3u, top.list.size());
+  EXPECT_EQ("kept", top.list[0].id);
+  EXPECT_EQ("newer", top.list[1].id);
+  EXPECT_EQ("new", top.list[2].id);
+
+  std::vector<std::string> stale;
+  for (const auto& info : top.stale) {
+    stale.push_back(info.id);
+  }
+  std::sort(stale.begin(), stale.end());
+  EXPECT_EQ(std::vector<std::string>({"never_kept", "pushed_out"}), stale);
+}
+
+TEST(BatPublishersTest, NormalizesAgainstAllPublishers) {
+  // 6 publishers get percent, 6 more round down to none, but still have
+  // enough score together to change the rounding of the others
+  ledger::PublisherInfoList list;
+  for (int i = 0; i < 6; i++) {
+    list.push_back(GetInfo("low" + std::to_string(i), 0.4, 0));
+    list.push_back(GetInfo("top" + std::to_string(i), i < 2 ? 45.6 : 1.6, 0));
+  }
+
+  TopPublishers top = Scan(list, 6);
+  std::map<std::string, unsigned int> expected = NormalizeAll(list);
+  ASSERT_EQ(6u, top.list.size());
+  for (const auto& info : top.list) {
+    EXPECT_EQ(expected[info.id], info.percent) << info.id;
+    EXPECT_EQ(info.score == 45.6 ? 46u : 2u, info.percent) << info.id;
+    EXPECT_DOUBLE_EQ(info.score / 12 * 100.0, info.weight) << info.id;
+  }
+
+  // totals of only the kept publishers round them differently
+  ledger::PublisherInfoList partial = top.list;
+  braveledger_bat_helper::normalizeScores(partial,
+                                          &ledger::PublisherInfo::score,
+                                          &ledger::PublisherInfo::percent,
+                                          &ledger::PublisherInfo::weight);
+  EXPECT_EQ(47u, partial[0].percent);
+}
+
+TEST(BatPublishersTest, RandomListsMatchFullNormalization) {
+  std::mt19937 generator(42);
+  for (size_t size : {10, 150, 1000, 5000}) {
+    // visit time has a long tail, a few sites get most of it
+    std::exponential_distribution<double> distribution(1.0);
+    ledger::PublisherInfoList list;
+    for (size_t i = 0; i < size; i++) {
+      double score = std::pow(distribution(generator), 4.0);
+      list.push_back(GetInfo("site" + std::to_string(i), score, 0));
+    }
+
+    TopPublishers top = Scan(list, TOP_PUBLISHERS_COUNT);
+    std::map<std::string, unsigned int> expected = NormalizeAll(list);
+    unsigned int total_percent = 0;
+    for (const auto& info : top.list) {
+      EXPECT_EQ(expected[info.id], info.percent) << size << " " << info.id;
+      expected.erase(info.id);
+      total_percent += info.percent;
+    }
+    EXPECT_EQ(100u, total_percent) << size;
+
+    // nobody that was left out would get a percent
+    for (const auto& percent : expected) {
+      EXPECT_EQ(0u, percent.second) << size << " " << percent.first;
+    }
+  }
+}
+
+TEST(BatPublishersTest, ReadsPublishersPageByPage) {
+  PagingTestClient client;
+  const size_t kPublishers = 2 * PUBLISHER_LIST_PAGE_SIZE + 50;
+  ledger::PublisherInfoList list;
+  for (size_t i = 0; i < kPublishers; i++) {
+    // every score once, in no particular order
+    double score = (i * 37) % kPublishers + 1;
+    list.push_back(GetInfo("site" + std::to_string(i), score, 0));
+    client.AddPublisher(list.back());
+  }
+
+  bat_ledger::LedgerImpl* ledger =
+      static_cast<bat_ledger::LedgerImpl*>(client.ledger());
+  ledger::PublisherInfoList result;
+  uint32_t next_record = 1;
+  int calls = 0;
+  ledger->GetTopPublishers(
+      ledger->CreatePublisherFilter(
+          "",
+          ledger::PUBLISHER_CATEGORY::AUTO_CONTRIBUTE,
+          ledger::PUBLISHER_MONTH::ANY,
+          -1,
+          ledger::PUBLISHER_EXCLUDE_FILTER::FILTER_ALL_EXCEPT_EXCLUDED,
+          true,
+          0),
+      5,
+      [&](const ledger::PublisherInfoList& list, uint32_t next) {
+        result = list;
+        next_record = next;
+        calls++;
+      });
+  client.RunUntil(client.now() + 1000);
+
+  ASSERT_EQ(3u, client.pages().size());
+  for (size_t i = 0; i < client.pages().size(); i++) {
+    EXPECT_EQ(i * PUBLISHER_LIST_PAGE_SIZE, client.pages()[i].first);
+    EXPECT_EQ(static_cast<uint32_t>(PUBLISHER_LIST_PAGE_SIZE),
+              client.pages()[i].second);
+  }
+
+  EXPECT_EQ(1, calls);
+  EXPECT_EQ(0u, next_record);
+  // the same as one scan over all of them
+  TopPublishers expected = Scan(list, 5);
+  ASSERT_EQ(5u, result.size());
+  for (size_t i = 0; i < result.size(); i++) {
+    EXPECT_EQ(expected.list[i].id, result[i].id);
+    EXPECT_EQ(expected.list[i].score, result[i].score);
+    EXPECT_EQ(expected.list[i].percent, result[i].percent);
+    EXPECT_DOUBLE_EQ(result[i].score / kPublishers * 100.0, result[i].weight);
+  }
+  EXPECT_EQ(250.0, result[0].score);
+  EXPECT_EQ(246.0, result[4].score);
+}
+
+}  // namespace
@@ -0,0 +1,134 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include <stdint.h>
+
+#include <clocale>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "brave/vendor/bat-native-ledger/src/bat_twitch_sessions.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace {
+
+using braveledger_bat_get_media::GetTwitchTime;
+using braveledger_bat_get_media::TwitchEvent;
+using braveledger_bat_get_media::TwitchEventState;
+using braveledger_bat_get_media::TwitchSessionTable;
+
+// Table for 4 sessions has 8 slots
+const size_t kMaxSessions = 4;
+const size_t kSlotMask = 7;
+
+// Keys that all hash to slot |home|, so they end up in one probe cluster
+std::vector<std::string> KeysForSlot(size_t home, size_t count) {
+  std::vector<std::string> keys;
+  for (int i = 0; keys.size() < count; i++) {
+    std::string key = "channel" + std::to_string(i);
+    if ((std::hash<std::string>()(key) & kSlotMask) == home) {
+      keys.push_back(key);
+    }
+  }
+  return keys;
+}
+
+TwitchEventState State(TwitchEvent event) {
+  TwitchEventState state;
+  state.event_ = event;
+  return state;
+}
+
+void ExpectEvent(const TwitchSessionTable& table,
+                 const std::string& key,
+                 uint64_t now,
+                 TwitchEvent event) {
+  EXPECT_EQ(event, table.Get(key, now).event_) << key;
+}
+
+TEST(BatTwitchSessionsTest, EraseInsideProbeCluster) {
+  // the last slot, so the cluster wraps around to the start
+  for (size_t home : {size_t(3), kSlotMask}) {
+    std::vector<std::string> keys = KeysForSlot(home, 3);
+    TwitchSessionTable table(kMaxSessions, 100);
+    table.Set(keys[0], State(TwitchEvent::VIDEO_PLAY), 0);
+    table.Set(keys[1], State(TwitchEvent::VIDEO_PAUSE), 60);
+    table.Set(keys[2], State(TwitchEvent::VIDEO_END), 60);
+    ASSERT_EQ(3u, table.size());
+
+    // expiring the head of the cluster shifts the rest back
+    table.Set("other", State(TwitchEvent::MINUTE_WATCHED), 150);
+    EXPECT_EQ(3u, table.size());
+    ExpectEvent(table, keys[0], 150, TwitchEvent::NONE);
+    ExpectEvent(table, keys[1], 150, TwitchEvent::VIDEO_PAUSE);
+    ExpectEvent(table, keys[2], 150, TwitchEvent::VIDEO_END);
+    ExpectEvent(table, "other", 150, TwitchEvent::MINUTE_WATCHED);
+
+    // the shifted entries are updated in place
+    table.Set(keys[2], State(TwitchEvent::VIDEO_PLAY), 151);
+    EXPECT_EQ(3u, table.size());
+    ExpectEvent(table, keys[2], 151, TwitchEvent::VIDEO_PLAY);
+  }
+}
+
+TEST(BatTwitchSessionsTest, EvictsLeastRecentlySeenWhenFull) {
+  std::vector<std::string> keys = KeysForSlot(5, 2);
+  TwitchSessionTable table(kMaxSessions, 1000);
+  table.Set(keys[0], State(TwitchEvent::VIDEO_PLAY), 1);
+  table.Set(keys[1], State(TwitchEvent::VIDEO_PLAY), 2);
+  table.Set("a", State(TwitchEvent::VIDEO_PLAY), 3);
+  table.Set("b", State(TwitchEvent::VIDEO_PLAY), 4);
+  // seen again, so it is not the oldest anymore
+  table.Set(keys[0], State(TwitchEvent::VIDEO_PAUSE), 5);
+  ASSERT_EQ(kMaxSessions, table.size());
+
+  table.Set("c", State(TwitchEvent::VIDEO_END), 6);
+  EXPECT_EQ(kMaxSessions, table.size());
+  ExpectEvent(table, keys[0], 6, TwitchEvent::VIDEO_PAUSE);
+  ExpectEvent(table, keys[1], 6, TwitchEvent::NONE);
+  ExpectEvent(table, "a", 6, TwitchEvent::VIDEO_PLAY);
+  ExpectEvent(table, "b", 6, TwitchEvent::VIDEO_PLAY);
+  ExpectEvent(table, "c", 6, TwitchEvent::VIDEO_END);
+}
+
+TEST(BatTwitchSessionsTest, IdleSessionsExpire) {
+  TwitchSessionTable table(kMaxSessions, 10);
+  table.Set("a", State(TwitchEvent::VIDEO_PLAY), 100);
+  table.Set("b", State(TwitchEvent::VIDEO_PLAY), 105);
+
+  ExpectEvent(table, "a", 110, TwitchEvent::VIDEO_PLAY);
+  ExpectEvent(table, "a", 111, TwitchEvent::NONE);
+  ExpectEvent(table, "b", 111, TwitchEvent::VIDEO_PLAY);
+
+  // expired sessions are dropped on the next update
+  table.Set("c", State(TwitchEvent::VIDEO_PLAY), 120);
+  EXPECT_EQ(1u, table.size());
+  ExpectEvent(table, "b", 120, TwitchEvent::NONE);
+  ExpectEvent(table, "c", 120, TwitchEvent::VIDEO_PLAY);
+}
+
+TEST(BatTwitchSessionsTest, TimeIsPlainDecimal) {
+  EXPECT_EQ(1541766712.123, GetTwitchTime("1541766712.123"));
+  EXPECT_EQ(-2.5, GetTwitchTime("-2.5"));
+  EXPECT_EQ(0, GetTwitchTime(""));
+
+  // strtod would read these as numbers
+  EXPECT_EQ(0, GetTwitchTime("inf"));
+  EXPECT_EQ(0, GetTwitchTime("nan"));
+  EXPECT_EQ(0, GetTwitchTime("0x1p4"));
+}
+
+TEST(BatTwitchSessionsTest, TimeIgnoresLocale) {
+  const char* locale = std::setlocale(LC_NUMERIC, "de_DE.UTF-8");
+  // nothing to check when the locale isn't installed
+  if (!locale) {
+    return;
+  }
+
+  EXPECT_EQ(1541766712.5, GetTwitchTime("1541766712.5"));
+  std::setlocale(LC_NUMERIC, "C");
+}
+
+}  // namespace
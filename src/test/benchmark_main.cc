@@ -0,0 +1,10 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "third_party/google_benchmark/src/include/benchmark/benchmark.h"
+
+// Results can be kept for comparison with
+//   --benchmark_out=results.json --benchmark_out_format=json
+// and compared with third_party/google_benchmark/src/tools/compare.py
+BENCHMARK_MAIN();
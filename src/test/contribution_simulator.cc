@@ -0,0 +1,488 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <queue>
+#include <set>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "bat_helper.h"
+#include "mock_ledger_client.h"
+#include "random_service.h"
+#include "rapidjson_bat_helper.h"
+#include "static_values.h"
+
+// Drives simulated wallets through an auto contribute reconcile against an
+// in-process stand-in for the ledger server, on a virtual clock:
+//   bat-native-ledger-simulator [--wallets=1000] [--publishers=5]
+//       [--votes=8] [--latency=200] [--hours=2] [--seed=1]
+//       [--registrar-vk=<file>] [--survey-vk=<file>]
+// Wallets start with a registered persona, so the reconcile starts from
+// RECONCILE_CONTRIBUTION. The ledger runs its real anonize client calls.
+// The stand-in server can't sign credentials, so without registrar and
+// survey keys captured from a staging server the anonize calls fail early
+// and wallets finish voting without proofs.
+
+namespace {
+
+enum Phase {
+  PHASE_RECONCILE = 0,
+  PHASE_CURRENT,
+  PHASE_PAYLOAD,
+  PHASE_REGISTER,
+  PHASE_VIEWING,
+  PHASE_PREPARE,
+  PHASE_VOTE,
+  PHASE_OTHER,
+  PHASE_COUNT,
+};
+
+const char* const kPhaseNames[PHASE_COUNT] = {
+  "reconcile",
+  "current",
+  "payload",
+  "register",
+  "viewing",
+  "prepare",
+  "vote",
+  "other",
+};
+
+struct Options {
+  size_t wallets = 1000;
+  size_t publishers = 5;
+  size_t votes = 8;
+  uint64_t latency = 200;  // ms
+  uint64_t hours = 2;
+  uint64_t seed = 1;  // timer jitter and keys repeat between runs
+  std::string registrar_vk = "registrar-vk";
+  std::string survey_vk = "survey-vk";
+};
+
+struct PhaseStats {
+  uint64_t requests = 0;
+  uint64_t cpu_us = 0;  // ledger time spent on the responses
+  // virtual ms from the start of the reconcile to the first request
+  std::vector<uint64_t> reached;
+};
+
+struct Response {
+  int code;
+  std::string body;
+  Phase phase;
+};
+
+bool StartsWith(const std::string& value, const std::string& prefix) {
+  return value.compare(0, prefix.length(), prefix) == 0;
+}
+
+std::string ReadFile(const std::string& path) {
+  std::ifstream stream(path, std::ios::binary);
+  std::ostringstream content;
+  content << stream.rdbuf();
+  std::string value = content.str();
+  while (!value.empty() && (value.back() == '\n' || value.back() == '\r')) {
+    value.pop_back();
+  }
+  return value;
+}
+
+uint64_t Percentile(std::vector<uint64_t>* values, double percentile) {
+  if (values->empty()) {
+    return 0;
+  }
+
+  size_t index = static_cast<size_t>(percentile * (values->size() - 1));
+  std::nth_element(values->begin(), values->begin() + index, values->end());
+  return (*values)[index];
+}
+
+// Answers the endpoints of the reconcile and the voting. Surveyor ids are
+// handed out per viewing, every vote with a known surveyor is accepted.
+class FakeLedgerServer {
+ public:
+  explicit FakeLedgerServer(const Options& options) :
+    options_(options),
+    next_surveyor_(1) {}
+
+  Response Handle(size_t wallet,
+                  uint64_t now,
+                  const std::string& url,
+                  const std::string& content,
+                  ledger::URL_METHOD method) {
+    Response response = Route(wallet, now, url, content, method);
+    PhaseStats& stats = stats_[response.phase];
+    stats.requests++;
+
+    if (response.phase == PHASE_RECONCILE &&
+        reconcile_start_.count(wallet) == 0) {
+      reconcile_start_[wallet] = now;
+    }
+
+    auto start = reconcile_start_.find(wallet);
+    if (start != reconcile_start_.end() && response.phase != PHASE_OTHER &&
+        reached_[response.phase].insert(wallet).second) {
+      stats.reached.push_back(now - start->second);
+    }
+
+    return response;
+  }
+
+  void AddCpuTime(Phase phase, uint64_t us) {
+    stats_[phase].cpu_us += us;
+  }
+
+  void Report(double wall_seconds) {
+    printf("%-10s %9s %9s %12s %12s %10s %12s\n",
+           "phase", "requests", "wallets", "p50 (s)", "p99 (s)",
+           "cpu (ms)", "req/cpu-s");
+    for (int i = 0; i < PHASE_COUNT; i++) {
+      PhaseStats& stats = stats_[i];
+      double cpu_ms = stats.cpu_us / 1000.0;
+      printf("%-10s %9llu %9zu %12.1f %12.1f %10.1f %12.0f\n",
+             kPhaseNames[i],
+             static_cast<unsigned long long>(stats.requests),
+             stats.reached.size(),
+             Percentile(&stats.reached, 0.5) / 1000.0,
+             Percentile(&stats.reached, 0.99) / 1000.0,
+             cpu_ms,
+             cpu_ms > 0 ? stats.requests * 1000.0 / cpu_ms : 0.0);
+    }
+
+    printf("\nvotes accepted: %llu, with proof: %llu\n",
+           static_cast<unsigned long long>(votes_),
+           static_cast<unsigned long long>(proved_votes_));
+    printf("wall time: %.1f s\n", wall_seconds);
+  }
+
+ private:
+  Response Route(size_t wallet,
+                 uint64_t now,
+                 const std::string& url,
+                 const std::string& content,
+                 ledger::URL_METHOD method) {
+    size_t host_end = url.find('/', url.find("://") + 3);
+    std::string path = host_end == std::string::npos ?
+        "" : url.substr(host_end);
+    if (!StartsWith(path, PREFIX_V2)) {
+      return Response{404, "", PHASE_OTHER};
+    }
+    path.erase(0, strlen(PREFIX_V2));
+
+    if (StartsWith(path, RECONCILE_CONTRIBUTION)) {
+      return Response{200,
+          "{\"surveyorId\":\"contribution-" + std::to_string(wallet) + "\"}",
+          PHASE_RECONCILE};
+    }
+
+    if (StartsWith(path, WALLET_PROPERTIES) &&
+        method == ledger::URL_METHOD::GET &&
+        path.find("?refresh=true") != std::string::npos) {
+      return Response{200,
+          "{\"rates\":{\"BTC\":0.00003,\"ETH\":0.0009,\"LTC\":0.005,"
+          "\"USD\":0.2,\"EUR\":0.18},"
+          "\"unsignedTx\":{\"denomination\":{\"amount\":\"10\","
+          "\"currency\":\"BAT\"},\"destination\":\"settlement\"}}",
+          PHASE_CURRENT};
+    }
+
+    if (StartsWith(path, WALLET_PROPERTIES) &&
+        method == ledger::URL_METHOD::PUT) {
+      return Response{200,
+          "{\"paymentStamp\":" + std::to_string(now / 1000) +
+          ",\"probi\":\"10000000000000000000\",\"altcurrency\":\"BAT\"}",
+          PHASE_PAYLOAD};
+    }
+
+    if (path == REGISTER_VIEWING) {
+      return Response{200,
+          "{\"registrarVK\":\"" + options_.registrar_vk + "\"}",
+          PHASE_REGISTER};
+    }
+
+    if (StartsWith(path, (std::string)REGISTER_VIEWING + "/")) {
+      std::string viewing = path.substr(strlen(REGISTER_VIEWING) + 1);
+      std::string ids;
+      auto& surveyors = surveyors_[viewing];
+      for (size_t i = 0; i < options_.votes; i++) {
+        std::string id = "surveyor-" + std::to_string(next_surveyor_++);
+        surveyors.push_back(id);
+        known_surveyors_.insert(id);
+        ids += (i == 0 ? "\"" : ",\"") + id + "\"";
+      }
+      return Response{200,
+          "{\"verification\":\"verification\",\"surveyorIds\":[" + ids + "]}",
+          PHASE_VIEWING};
+    }
+
+    if (StartsWith(path, (std::string)SURVEYOR_BATCH_VOTING + "/")) {
+      std::string viewing = path.substr(strlen(SURVEYOR_BATCH_VOTING) + 1);
+      std::string body;
+      for (const auto& id : surveyors_[viewing]) {
+        body += body.empty() ? "[" : ",";
+        body += "{\"surveyorId\":\"" + id + "\","
+                "\"signature\":\"primary, signature\","
+                "\"surveyVK\":\"" + options_.survey_vk + "\","
+                "\"registrarVK\":\"" + options_.registrar_vk + "\"}";
+      }
+      return Response{200, body.empty() ? "[]" : body + "]", PHASE_PREPARE};
+    }
+
+    if (path == SURVEYOR_BATCH_VOTING &&
+        method == ledger::URL_METHOD::POST) {
+      return Response{200, Vote(content), PHASE_VOTE};
+    }
+
+    return Response{404, "", PHASE_OTHER};
+  }
+
+  std::string Vote(const std::string& content) {
+    const std::string surveyor_key = "\"surveyorId\":\"";
+    const std::string proof_key = "\"proof\":\"";
+    std::string response;
+    for (size_t pos = content.find(surveyor_key); pos != std::string::npos;
+         pos = content.find(surveyor_key, pos)) {
+      pos += surveyor_key.length();
+      size_t end = content.find('"', pos);
+      std::string surveyor_id = content.substr(pos, end - pos);
+      if (known_surveyors_.erase(surveyor_id) == 0) {
+        continue;
+      }
+
+      votes_++;
+      size_t proof = content.find(proof_key, end);
+      if (proof != std::string::npos &&
+          content.compare(proof + proof_key.length(), 1, "\"") != 0) {
+        proved_votes_++;
+      }
+
+      response += response.empty() ? "[" : ",";
+      response += "{\"surveyorId\":\"" + surveyor_id + "\"}";
+    }
+
+    return response.empty() ? "[]" : response + "]";
+  }
+
+  Options options_;
+  uint64_t next_surveyor_;
+  uint64_t votes_ = 0;
+  uint64_t proved_votes_ = 0;
+  PhaseStats stats_[PHASE_COUNT];
+  std::map<size_t, uint64_t> reconcile_start_;
+  std::set<size_t> reached_[PHASE_COUNT];
+  std::map<std::string, std::vector<std::string>> surveyors_;
+  std::set<std::string> known_surveyors_;
+};
+
+// Wallet that is due for an auto contribution of its publishers
+class SimulatedWallet : public bat_ledger::MockLedgerClient {
+ public:
+  SimulatedWallet(size_t index,
+                  const Options& options,
+                  FakeLedgerServer* server) :
+    index_(index),
+    latency_(options.latency),
+    server_(server),
+    next_guid_(0) {
+    braveledger_bat_helper::CLIENT_STATE_ST state;
+    state.walletInfo_.paymentId_ = "payment-" + std::to_string(index);
+    // deterministic per wallet, so runs can be compared
+    for (size_t i = 0; i < SEED_LENGTH; i++) {
+      state.walletInfo_.keyInfoSeed_.push_back(
+          static_cast<uint8_t>((index >> (8 * (i % 4))) + i));
+    }
+    state.walletProperties_.balance_ = 100;
+    state.walletProperties_.altcurrency_ = CURRENCY;
+    state.personaId_ = GenerateGUID();
+    state.userId_ = state.personaId_;
+    state.fee_amount_ = 10;
+    state.fee_currency_ = CURRENCY;
+    state.reconcileStamp_ = 1;
+    state.auto_contribute_ = true;
+    state.rewards_enabled_ = true;
+
+    std::string data;
+    braveledger_bat_helper::saveToJsonString(state, data);
+    SetLedgerState(data);
+    braveledger_bat_helper::saveToJsonString(
+        braveledger_bat_helper::PUBLISHER_STATE_ST(), data);
+    SetPublisherState(data);
+
+    for (size_t i = 0; i < options.publishers; i++) {
+      std::unique_ptr<ledger::PublisherInfo> info(new ledger::PublisherInfo(
+          "publisher" + std::to_string(i) + ".com",
+          ledger::PUBLISHER_MONTH::ANY,
+          -1));
+      info->duration = 600 * (i + 1);
+      info->score = static_cast<double>(i + 1);
+      info->visits = static_cast<uint32_t>(i + 1);
+      MockLedgerClient::SavePublisherInfo(std::move(info),
+          [](ledger::Result, std::unique_ptr<ledger::PublisherInfo>) {});
+    }
+  }
+
+  // GUIDs need the layout of a UUID, viewing ids are cut at fixed offsets
+  std::string GenerateGUID() const override {
+    char guid[37];
+    snprintf(guid, sizeof(guid), "%08zx-%04x-4000-a000-%012llx", index_,
+             static_cast<unsigned int>(next_guid_ & 0xffff),
+             static_cast<unsigned long long>(next_guid_));
+    next_guid_++;
+    return guid;
+  }
+
+ protected:
+  void OnURLRequestStarted(uint64_t request_id,
+                           const std::string& url,
+                           const std::string& content,
+                           ledger::URL_METHOD method,
+                           ledger::LedgerCallbackHandler* handler) override {
+    Response response = server_->Handle(index_, now(), url, content, method);
+    FakeLedgerServer* server = server_;
+    Post(latency_, [server, handler, request_id, url, response]() {
+      auto start = std::chrono::steady_clock::now();
+      handler->OnURLRequestResponse(request_id, url, response.code,
+                                    response.body, {});
+      server->AddCpuTime(response.phase,
+          std::chrono::duration_cast<std::chrono::microseconds>(
+              std::chrono::steady_clock::now() - start).count());
+    });
+  }
+
+ private:
+  size_t index_;
+  uint64_t latency_;
+  FakeLedgerServer* server_;  // NOT OWNED
+  mutable uint64_t next_guid_;
+};
+
+bool ParseOptions(int argc, char* argv[], Options* options) {
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    size_t equals = arg.find('=');
+    if (!StartsWith(arg, "--") || equals == std::string::npos) {
+      return false;
+    }
+
+    std::string name = arg.substr(2, equals - 2);
+    std::string value = arg.substr(equals + 1);
+    uint64_t number = strtoull(value.c_str(), nullptr, 10);
+    if (name == "wallets") {
+      options->wallets = number;
+    } else if (name == "publishers") {
+      options->publishers = number;
+    } else if (name == "votes") {
+      options->votes = number;
+    } else if (name == "latency") {
+      options->latency = number;
+    } else if (name == "hours") {
+      options->hours = number;
+    } else if (name == "seed") {
+      options->seed = number;
+    } else if (name == "registrar-vk") {
+      options->registrar_vk = ReadFile(value);
+    } else if (name == "survey-vk") {
+      options->survey_vk = ReadFile(value);
+    } else {
+      return false;
+    }
+  }
+
+  return options->wallets > 0 && options->publishers > 0;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  Options options;
+  if (!ParseOptions(argc, argv, &options)) {
+    std::cerr << "usage: " << argv[0] << " [--wallets=N] [--publishers=N] "
+              << "[--votes=N] [--latency=ms] [--hours=N] [--seed=N] "
+              << "[--registrar-vk=file] [--survey-vk=file]" << std::endl;
+    return 1;
+  }
+
+  bat_ledger::RandomService::GetInstance()->SetSeedForTesting(options.seed);
+
+  FakeLedgerServer server(options);
+  std::vector<std::unique_ptr<SimulatedWallet>> wallets;
+  wallets.reserve(options.wallets);
+  for (size_t i = 0; i < options.wallets; i++) {
+    wallets.emplace_back(new SimulatedWallet(i, options, &server));
+    wallets.back()->ledger()->SetMetricsEnabled(true);
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  for (auto& wallet : wallets) {
+    wallet->ledger()->Initialize();
+  }
+
+  // wallets share the virtual clock, the one with the earliest event
+  // runs next
+  using Next = std::pair<uint64_t, size_t>;
+  std::priority_queue<Next, std::vector<Next>, std::greater<Next>> queue;
+  for (size_t i = 0; i < wallets.size(); i++) {
+    uint64_t time = 0;
+    if (wallets[i]->GetNextEventTime(&time)) {
+      queue.push(Next(time, i));
+    }
+  }
+
+  const uint64_t end = options.hours * 60 * 60 * 1000;
+  while (!queue.empty() && queue.top().first <= end) {
+    Next next = queue.top();
+    queue.pop();
+    wallets[next.second]->RunUntil(next.first);
+
+    uint64_t time = 0;
+    if (wallets[next.second]->GetNextEventTime(&time)) {
+      queue.push(Next(time, next.second));
+    }
+  }
+
+  double wall_seconds = std::chrono::duration<double>(
+      std::chrono::steady_clock::now() - start).count();
+  printf("%zu wallets, %zu publishers, %zu votes each, %llu ms latency\n\n",
+         options.wallets, options.publishers, options.votes,
+         static_cast<unsigned long long>(options.latency));
+  server.Report(wall_seconds);
+
+  // time the ledger spent in anonize, from its own metrics
+  std::map<std::string, ledger::HistogramSnapshot> anonize;
+  for (const auto& wallet : wallets) {
+    ledger::MetricsSnapshot snapshot = wallet->ledger()->GetMetricsSnapshot();
+    for (const auto& histogram : snapshot.histograms) {
+      if (!StartsWith(histogram.first, "anonize.")) {
+        continue;
+      }
+
+      ledger::HistogramSnapshot& total = anonize[histogram.first];
+      total.count += histogram.second.count;
+      total.sum += histogram.second.sum;
+    }
+  }
+
+  for (const auto& histogram : anonize) {
+    printf("%s: %llu calls, %.2f ms mean\n",
+           histogram.first.c_str(),
+           static_cast<unsigned long long>(histogram.second.count),
+           histogram.second.count > 0 ?
+               static_cast<double>(histogram.second.sum) /
+                   histogram.second.count : 0.0);
+  }
+
+  return 0;
+}
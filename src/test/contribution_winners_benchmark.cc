@@ -0,0 +1,106 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include <algorithm>
+#include <string>
+#include <utility>
+
+#include "bat/ledger/publisher_info.h"
+#include "bat_helper.h"
+#include "third_party/google_benchmark/src/include/benchmark/benchmark.h"
+
+namespace {
+
+braveledger_bat_helper::PublisherList GetAutoContributeList(size_t size) {
+  braveledger_bat_helper::PublisherList list;
+  for (size_t i = 0; i < size; i++) {
+    braveledger_bat_helper::PUBLISHER_ST publisher;
+    publisher.id_ = "publisher-" + std::to_string(i) + ".example.com";
+    publisher.duration_ = 60 + i * 7;
+    publisher.score_ = 1.0 + (i * 37 % 101);
+    publisher.visits_ = 1 + i % 5;
+    list.push_back(publisher);
+  }
+
+  return list;
+}
+
+// Conversions that the reconcile did before the winners were picked
+// straight from the reconcile list
+void BM_ContributeWinnersFromPublisherInfo(benchmark::State& state) {
+  const braveledger_bat_helper::PublisherList reconcile_list =
+      GetAutoContributeList(state.range(0));
+
+  for (auto _ : state) {
+    braveledger_bat_helper::PublisherList list = reconcile_list;
+
+    ledger::PublisherInfoList info_list;
+    for (const auto& publisher : list) {
+      ledger::PublisherInfo info;
+      info.id = publisher.id_;
+      info.duration = publisher.duration_;
+      info.score = publisher.score_;
+      info.visits = publisher.visits_;
+      info_list.push_back(info);
+    }
+
+    ledger::PublisherInfoList normalized = info_list;
+    braveledger_bat_helper::normalizeScores(normalized,
+                                            &ledger::PublisherInfo::score,
+                                            &ledger::PublisherInfo::percent,
+                                            &ledger::PublisherInfo::weight);
+    ledger::PublisherInfoList new_list;
+    for (const auto& info : normalized) {
+      new_list.push_back(info);
+    }
+    std::sort(new_list.begin(), new_list.end());
+
+    braveledger_bat_helper::Winners winners;
+    for (const auto& item : new_list) {
+      braveledger_bat_helper::WINNERS_ST winner;
+      winner.votes_ = item.percent;
+      winner.publisher_data_.id_ = item.id;
+      winner.publisher_data_.duration_ = item.duration;
+      winner.publisher_data_.score_ = item.score;
+      winner.publisher_data_.visits_ = item.visits;
+      winner.publisher_data_.percent_ = item.percent;
+      winner.publisher_data_.weight_ = item.weight;
+      winners.push_back(winner);
+    }
+
+    benchmark::DoNotOptimize(winners);
+  }
+}
+BENCHMARK(BM_ContributeWinnersFromPublisherInfo)->Arg(50)->Arg(500);
+
+// Reconcile list is normalized in place and moved into the winners
+void BM_ContributeWinners(benchmark::State& state) {
+  const braveledger_bat_helper::PublisherList reconcile_list =
+      GetAutoContributeList(state.range(0));
+
+  for (auto _ : state) {
+    braveledger_bat_helper::PublisherList list = reconcile_list;
+
+    braveledger_bat_helper::normalizeScores(
+        list,
+        &braveledger_bat_helper::PUBLISHER_ST::score_,
+        &braveledger_bat_helper::PUBLISHER_ST::percent_,
+        &braveledger_bat_helper::PUBLISHER_ST::weight_);
+    std::sort(list.begin(), list.end());
+
+    braveledger_bat_helper::Winners winners;
+    winners.reserve(list.size());
+    for (auto& item : list) {
+      braveledger_bat_helper::WINNERS_ST winner;
+      winner.votes_ = item.percent_;
+      winner.publisher_data_ = std::move(item);
+      winners.push_back(std::move(winner));
+    }
+
+    benchmark::DoNotOptimize(winners);
+  }
+}
+BENCHMARK(BM_ContributeWinners)->Arg(50)->Arg(500);
+
+}  // namespace
@@ -0,0 +1,157 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+#include <openssl/curve25519.h>
+
+#include "brave/vendor/bat-native-ledger/src/bat_codec.h"
+#include "brave/vendor/bat-native-ledger/src/bat_helper.h"
+#include "brave/vendor/bat-native-ledger/src/http_signature.h"
+#include "brave/vendor/bat-native-ledger/src/ledger_impl.h"
+#include "brave/vendor/bat-native-ledger/src/test/mock_ledger_client.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace {
+
+// Test 1 of RFC 8032, seed followed by the public key
+const char kSecretKey[] =
+    "9d61b19deffd5a60ba844af492ec2cc44449c5697b326919703bac031cae7f60"
+    "d75a980182b10ab7d54bfed3c964073a0ee172f3daa62325af021a68f707511a";
+
+std::vector<uint8_t> GetSecretKey() {
+  std::vector<uint8_t> key(64);
+  EXPECT_TRUE(braveledger_bat_codec::HexDecode(kSecretKey, 128, key.data()));
+  return key;
+}
+
+// Checks the header layout and the signature of |message|
+void ExpectSigned(const std::string& signature,
+                  const std::string& headers,
+                  const std::string& message) {
+  const std::string start =
+      "keyId=\"primary\",algorithm=\"ed25519\",headers=\"" + headers +
+      "\",signature=\"";
+  ASSERT_EQ(start.size() + 88 + 1, signature.size());
+  ASSERT_EQ(start, signature.substr(0, start.size()));
+  ASSERT_EQ('"', signature.back());
+
+  uint8_t decoded[66];
+  size_t length = 0;
+  ASSERT_TRUE(braveledger_bat_codec::Base64Decode(
+      signature.data() + start.size(), 88, decoded, &length));
+  ASSERT_EQ(64u, length);
+
+  std::vector<uint8_t> key = GetSecretKey();
+  EXPECT_EQ(1, ED25519_verify(
+      reinterpret_cast<const uint8_t*>(message.data()), message.size(),
+      decoded, key.data() + 32));
+}
+
+TEST(HttpSignatureTest, Digest) {
+  std::string digest;
+  bat_ledger::HttpSigner::GetDigest("", &digest);
+  EXPECT_EQ("SHA-256=47DEQpj8HBSa+/TImW+5JCeuQeRkm5NMpJWZG3hSuFU=", digest);
+}
+
+TEST(HttpSignatureTest, Sign) {
+  bat_ledger::HttpSigner signer("primary", GetSecretKey());
+  ASSERT_TRUE(signer.is_valid());
+
+  std::string keys[2] = {"digest", "date"};
+  std::string values[2] = {"SHA-256=abc", "today"};
+  std::string signature;
+  signer.Sign(keys, values, 2, &signature);
+  ExpectSigned(signature, "digest date",
+               "digest: SHA-256=abc\ndate: today");
+
+  // ed25519 signatures are deterministic
+  std::string again;
+  signer.Sign(keys, values, 2, &again);
+  EXPECT_EQ(signature, again);
+
+  signer.SignDigest("SHA-256=abc", &signature);
+  ExpectSigned(signature, "digest", "digest: SHA-256=abc");
+}
+
+// Headers that sign() wrote with tweetnacl before there was a signer
+TEST(HttpSignatureTest, MatchesOldSign) {
+  bat_ledger::HttpSigner signer("primary", GetSecretKey());
+
+  std::string keys[2] = {"digest", "date"};
+  std::string values[2] = {"SHA-256=abc", "today"};
+  std::string signature;
+  signer.Sign(keys, values, 2, &signature);
+  EXPECT_EQ("keyId=\"primary\",algorithm=\"ed25519\",headers=\"digest date\","
+            "signature=\"jB6Nb7H25yM5PIbaAvp8glIndWyxdIbYWWLmNexEHMqXwZ75Gl"
+            "UK0QO45YYFr28VAvrar3olegybnnNKPcQzCg==\"", signature);
+
+  signer.SignDigest("SHA-256=47DEQpj8HBSa+/TImW+5JCeuQeRkm5NMpJWZG3hSuFU=",
+                    &signature);
+  EXPECT_EQ("keyId=\"primary\",algorithm=\"ed25519\",headers=\"digest\","
+            "signature=\"p3qWQGRmMHCNSMq2tmUU6LMhtwu3/8sxkC0esNkvmDMedItsyJ"
+            "LlO96Ov6F1qWNEqcXm0i3w2sla1xsUAXLwCw==\"", signature);
+}
+
+TEST(HttpSignatureTest, PublicKey) {
+  std::vector<uint8_t> key = GetSecretKey();
+  bat_ledger::HttpSigner signer("primary", key);
+  EXPECT_EQ(std::vector<uint8_t>(key.begin() + 32, key.end()),
+            signer.GetPublicKey());
+}
+
+TEST(HttpSignatureTest, SignBodies) {
+  bat_ledger::HttpSigner signer("primary", GetSecretKey());
+  std::vector<std::string> bodies = {"", "{\"a\":1}", std::string(5000, 'x')};
+  std::vector<bat_ledger::SignedRequest> requests;
+  signer.SignBodies(bodies, &requests);
+  ASSERT_EQ(bodies.size(), requests.size());
+
+  for (size_t i = 0; i < bodies.size(); i++) {
+    std::string digest;
+    bat_ledger::HttpSigner::GetDigest(bodies[i], &digest);
+    EXPECT_EQ(digest, requests[i].digest);
+    ExpectSigned(requests[i].signature, "digest", "digest: " + digest);
+  }
+}
+
+TEST(HttpSignatureTest, InvalidKey) {
+  bat_ledger::HttpSigner signer("primary", std::vector<uint8_t>(32));
+  EXPECT_FALSE(signer.is_valid());
+}
+
+TEST(HttpSignatureTest, WalletSignerIsKeptPerSeed) {
+  bat_ledger::MockLedgerClient client;
+  bat_ledger::LedgerImpl* ledger =
+      static_cast<bat_ledger::LedgerImpl*>(client.ledger());
+
+  braveledger_bat_helper::WALLET_INFO_ST wallet_info = ledger->GetWalletInfo();
+  wallet_info.keyInfoSeed_ = braveledger_bat_helper::generateSeed();
+  ledger->SetWalletInfo(wallet_info);
+  bat_ledger::HttpSigner* signer = ledger->GetWalletSigner();
+  ASSERT_TRUE(signer);
+  EXPECT_EQ(signer, ledger->GetWalletSigner());
+
+  // the key the requests were signed with before
+  std::vector<uint8_t> public_key;
+  std::vector<uint8_t> secret_key;
+  ASSERT_TRUE(braveledger_bat_helper::getPublicKeyFromSeed(
+      braveledger_bat_helper::getHKDF(wallet_info.keyInfoSeed_),
+      public_key,
+      secret_key));
+  EXPECT_EQ(public_key, signer->GetPublicKey());
+
+  // a recovered wallet has a new seed
+  wallet_info.keyInfoSeed_ = braveledger_bat_helper::generateSeed();
+  ledger->SetWalletInfo(wallet_info);
+  signer = ledger->GetWalletSigner();
+  ASSERT_TRUE(signer);
+  EXPECT_NE(public_key, signer->GetPublicKey());
+  EXPECT_EQ(signer, ledger->GetWalletSigner());
+}
+
+}  // namespace
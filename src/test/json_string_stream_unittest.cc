@@ -0,0 +1,67 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include <string>
+#include <vector>
+
+#include "brave/vendor/bat-native-ledger/src/bat_helper.h"
+#include "brave/vendor/bat-native-ledger/src/rapidjson_bat_helper.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace {
+
+const char kJson[] =
+    "{\"a\":[1,-2,3.5,true,false,null],\"b\":\"esc\\\"aped\\n\\u0001\","
+    "\"c\":{\"d\":18446744073709551615,\"e\":\"\"}}";
+
+TEST(JsonStringStreamTest, SameAsStringBuffer) {
+  rapidjson::Document document;
+  document.Parse(kJson);
+  ASSERT_FALSE(document.HasParseError());
+
+  rapidjson::StringBuffer buffer;
+  rapidjson::Writer<rapidjson::StringBuffer> buffer_writer(buffer);
+  document.Accept(buffer_writer);
+
+  std::string json;
+  {
+    braveledger_bat_helper::JsonStringStream stream(&json);
+    braveledger_bat_helper::JsonWriter writer(stream);
+    document.Accept(writer);
+  }
+  EXPECT_EQ(buffer.GetString(), json);
+
+  // written after what the string holds
+  std::string appended = "prefix";
+  {
+    braveledger_bat_helper::JsonStringStream stream(&appended);
+    braveledger_bat_helper::JsonWriter writer(stream);
+    document.Accept(writer);
+  }
+  EXPECT_EQ("prefix" + json, appended);
+}
+
+TEST(JsonStringStreamTest, ReusedBuffer) {
+  std::vector<braveledger_bat_helper::BATCH_VOTES_INFO_ST> votes(3);
+  for (size_t i = 0; i < votes.size(); i++) {
+    votes[i].surveyorId_ = "surveyor" + std::to_string(i);
+    votes[i].proof_ = std::string(100, 'p');
+  }
+
+  std::string json;
+  braveledger_bat_helper::stringifyBatch(votes, votes.size(), &json);
+  EXPECT_EQ(braveledger_bat_helper::stringifyBatch(votes), json);
+  const size_t capacity = json.capacity();
+
+  braveledger_bat_helper::stringifyBatch(votes, 1, &json);
+  EXPECT_EQ("[{\"surveyorId\":\"surveyor0\",\"proof\":\"" +
+                std::string(100, 'p') + "\"}]",
+            json);
+  EXPECT_EQ(capacity, json.capacity());
+
+  braveledger_bat_helper::stringifyBatch(votes, 10, &json);
+  EXPECT_EQ(braveledger_bat_helper::stringifyBatch(votes), json);
+}
+
+}  // namespace
@@ -0,0 +1,114 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include <string>
+
+#include "brave/vendor/bat-native-ledger/src/ledger_metrics.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace {
+
+TEST(LedgerMetricsTest, DisabledByDefault) {
+  bat_ledger::LedgerMetrics metrics;
+  metrics.AddCount("state.ledger.saves", 1);
+  metrics.AddTime("reconcile.current", metrics.StartTime());
+  metrics.OnRequestStarted(1, "https://example.com/");
+  metrics.OnRequestFinished(1);
+
+  ledger::MetricsSnapshot snapshot = metrics.GetSnapshot();
+  EXPECT_FALSE(snapshot.enabled);
+  EXPECT_TRUE(snapshot.counters.empty());
+  EXPECT_TRUE(snapshot.histograms.empty());
+}
+
+TEST(LedgerMetricsTest, CountersAndHistograms) {
+  bat_ledger::LedgerMetrics metrics;
+  metrics.SetEnabled(true);
+  metrics.AddCount("state.ledger.bytes", 100);
+  metrics.AddCount("state.ledger.bytes", 20);
+
+  // start in the future counts as no time
+  metrics.AddTime("reconcile.current",
+                  bat_ledger::LedgerMetrics::Now() + 100000);
+  metrics.AddTime("reconcile.current",
+                  bat_ledger::LedgerMetrics::Now() + 100000);
+
+  ledger::MetricsSnapshot snapshot = metrics.GetSnapshot();
+  EXPECT_TRUE(snapshot.enabled);
+  EXPECT_EQ(120u, snapshot.counters["state.ledger.bytes"]);
+
+  const ledger::HistogramSnapshot& histogram =
+      snapshot.histograms["reconcile.current"];
+  ASSERT_EQ(histogram.bounds.size() + 1, histogram.buckets.size());
+  EXPECT_EQ(2u, histogram.count);
+  EXPECT_EQ(2u, histogram.buckets.front());
+  EXPECT_EQ(0u, histogram.sum);
+}
+
+TEST(LedgerMetricsTest, TimingStartedWhileDisabled) {
+  bat_ledger::LedgerMetrics metrics;
+  // the clock isn't read, so the timing is dropped once enabled
+  uint64_t start = metrics.StartTime();
+  EXPECT_EQ(0u, start);
+
+  metrics.SetEnabled(true);
+  metrics.AddTime("reconcile.current", start);
+  EXPECT_TRUE(metrics.GetSnapshot().histograms.empty());
+
+  metrics.AddTime("reconcile.current", metrics.StartTime());
+  EXPECT_EQ(1u, metrics.GetSnapshot().histograms["reconcile.current"].count);
+}
+
+TEST(LedgerMetricsTest, RequestLatency) {
+  bat_ledger::LedgerMetrics metrics;
+  metrics.SetEnabled(true);
+  metrics.OnRequestStarted(
+      1, "https://ledger.mercury.basicattentiontoken.org/v2/wallet/abc");
+  metrics.OnRequestStarted(2, "https://www.youtube.com/oembed?url=x");
+  metrics.OnRequestCancelled(2);
+  metrics.OnRequestFinished(1);
+  metrics.OnRequestFinished(2);
+
+  ledger::MetricsSnapshot snapshot = metrics.GetSnapshot();
+  ASSERT_EQ(1u, snapshot.histograms.size());
+  EXPECT_EQ(1u, snapshot.histograms[
+      "request.ledger.mercury.basicattentiontoken.org/wallet"].count);
+}
+
+TEST(LedgerMetricsTest, GetEndpoint) {
+  EXPECT_EQ("ledger.mercury.basicattentiontoken.org/registrar/persona",
+            bat_ledger::LedgerMetrics::GetEndpoint(
+                "https://ledger.mercury.basicattentiontoken.org"
+                "/v2/registrar/persona"));
+  EXPECT_EQ("ledger.mercury.basicattentiontoken.org/registrar/viewing",
+            bat_ledger::LedgerMetrics::GetEndpoint(
+                "https://ledger.mercury.basicattentiontoken.org"
+                "/v2/registrar/viewing/0ab9d3c5"));
+  EXPECT_EQ("ledger.mercury.basicattentiontoken.org/surveyor/voting",
+            bat_ledger::LedgerMetrics::GetEndpoint(
+                "https://ledger.mercury.basicattentiontoken.org"
+                "/v2/surveyor/voting/abc%2Fdef"));
+  EXPECT_EQ("ledger.mercury.basicattentiontoken.org/batch/surveyor/voting",
+            bat_ledger::LedgerMetrics::GetEndpoint(
+                "https://ledger.mercury.basicattentiontoken.org"
+                "/v2/batch/surveyor/voting/viewing"));
+  EXPECT_EQ("balance.mercury.basicattentiontoken.org/wallet",
+            bat_ledger::LedgerMetrics::GetEndpoint(
+                "https://balance.mercury.basicattentiontoken.org"
+                "/wallet/abc/balance"));
+  EXPECT_EQ("ledger.mercury.basicattentiontoken.org/wallet",
+            bat_ledger::LedgerMetrics::GetEndpoint(
+                "https://ledger.mercury.basicattentiontoken.org"
+                "/v2/wallet?publicKey=abc"));
+  EXPECT_EQ("publishers.basicattentiontoken.org/api/v1/public/channels",
+            bat_ledger::LedgerMetrics::GetEndpoint(
+                "https://publishers.basicattentiontoken.org"
+                "/api/v1/public/channels"));
+  EXPECT_EQ("www.youtube.com", bat_ledger::LedgerMetrics::GetEndpoint(
+      "https://www.youtube.com/oembed?format=json&url=abc"));
+  EXPECT_EQ("example.com",
+            bat_ledger::LedgerMetrics::GetEndpoint("https://example.com"));
+}
+
+}  // namespace
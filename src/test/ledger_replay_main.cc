@@ -0,0 +1,77 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include <stdlib.h>
+
+#include <atomic>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <new>
+#include <vector>
+
+#include "replay_ledger_client.h"
+
+// Replays a trace written by ledger::LedgerClientRecorder and prints what
+// the ledger spent on it:
+//   bat-native-ledger-replay <trace>
+
+namespace {
+
+std::atomic<uint64_t> allocations(0);
+std::atomic<uint64_t> allocated_bytes(0);
+
+}  // namespace
+
+void* operator new(size_t size) {
+  allocations++;
+  allocated_bytes += size;
+  void* ptr = malloc(size > 0 ? size : 1);
+  if (!ptr) {
+    abort();
+  }
+  return ptr;
+}
+
+void operator delete(void* ptr) noexcept {
+  free(ptr);
+}
+
+int main(int argc, char* argv[]) {
+  if (argc != 2) {
+    std::cerr << "usage: " << argv[0] << " <trace>" << std::endl;
+    return 1;
+  }
+
+  std::ifstream stream(argv[1], std::ios::binary);
+  std::vector<bat_ledger::TraceRecord> records;
+  if (!stream || !bat_ledger::ReplayLedgerClient::ReadTrace(&stream,
+                                                            &records)) {
+    std::cerr << "can't read trace " << argv[1] << std::endl;
+    return 1;
+  }
+
+  bat_ledger::ReplayLedgerClient client(records);
+  uint64_t start_allocations = allocations;
+  uint64_t start_bytes = allocated_bytes;
+  std::clock_t start = std::clock();
+  client.Replay();
+  std::clock_t end = std::clock();
+
+  bat_ledger::ReplayStats stats = client.GetStats();
+  std::cout << "records: " << records.size() << std::endl
+            << "recorded time: " << client.duration() << " ms" << std::endl
+            << "cpu time: " << (end - start) * 1000.0 / CLOCKS_PER_SEC
+            << " ms" << std::endl
+            << "allocations: " << allocations - start_allocations
+            << " (" << allocated_bytes - start_bytes << " bytes)"
+            << std::endl
+            << "state written: " << stats.state_bytes_written
+            << " bytes (recorded " << stats.recorded_state_bytes_written
+            << ")" << std::endl
+            << "replayed calls: " << stats.calls
+            << ", unmatched: " << stats.unmatched
+            << ", mismatched: " << stats.mismatched << std::endl;
+  return 0;
+}
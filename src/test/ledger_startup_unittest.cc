@@ -0,0 +1,283 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include <stdint.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "brave/vendor/bat-native-ledger/src/bat_helper.h"
+#include "brave/vendor/bat-native-ledger/src/ledger_impl.h"
+#include "brave/vendor/bat-native-ledger/src/rapidjson_bat_helper.h"
+#include "brave/vendor/bat-native-ledger/src/test/mock_ledger_client.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace {
+
+enum StartupLoad {
+  LEDGER_STATE,
+  LEDGER_HISTORY,
+  PUBLISHER_STATE,
+  PUBLISHER_LIST,
+};
+
+struct LoadResult {
+  StartupLoad load;
+  ledger::Result result;
+  std::string data;
+};
+
+std::string GetLedgerState() {
+  braveledger_bat_helper::CLIENT_STATE_ST state;
+  state.walletInfo_.paymentId_ = "payment";
+  state.walletProperties_.balance_ = 100;
+  state.personaId_ = "persona";
+  state.userId_ = "persona";
+  state.fee_amount_ = 10;
+  // in the past, so the reconcile timer starts right away
+  state.reconcileStamp_ = 1;
+  state.auto_contribute_ = true;
+  state.rewards_enabled_ = true;
+
+  std::string data;
+  braveledger_bat_helper::saveToJsonString(state, data);
+  return data;
+}
+
+std::string GetPublisherState() {
+  std::string data;
+  braveledger_bat_helper::saveToJsonString(
+      braveledger_bat_helper::PUBLISHER_STATE_ST(), data);
+  return data;
+}
+
+const char kPublisherList[] = "[[\"verified.com\",true,false,{}]]";
+
+// Stored state is only handed to the ledger when the test completes the
+// load, so the loads can finish in any order and with any result
+class StartupTestClient : public bat_ledger::MockLedgerClient {
+ public:
+  StartupTestClient() : handlers_(4, nullptr), publisher_pages_(0) {}
+
+  bat_ledger::LedgerImpl* ledger_impl() {
+    return static_cast<bat_ledger::LedgerImpl*>(ledger());
+  }
+
+  bool IsPending(StartupLoad load) const {
+    return handlers_[load] != nullptr;
+  }
+
+  void Complete(const LoadResult& load) {
+    ledger::LedgerCallbackHandler* handler = handlers_[load.load];
+    ASSERT_TRUE(handler);
+    handlers_[load.load] = nullptr;
+    switch (load.load) {
+      case LEDGER_STATE:
+        handler->OnLedgerStateLoaded(load.result, load.data);
+        break;
+      case LEDGER_HISTORY:
+        handler->OnLedgerHistoryLoaded(load.result, load.data);
+        break;
+      case PUBLISHER_STATE:
+        handler->OnPublisherStateLoaded(load.result, load.data);
+        break;
+      case PUBLISHER_LIST:
+        handler->OnPublisherListLoaded(load.result, load.data);
+        break;
+    }
+  }
+
+  const std::vector<ledger::Result>& wallet_results() const {
+    return wallet_results_;
+  }
+
+  // auto contribute reads the publisher info when it starts
+  int publisher_pages() const { return publisher_pages_; }
+
+  // ledger::LedgerClient
+  void OnWalletInitialized(ledger::Result result) override {
+    wallet_results_.push_back(result);
+  }
+  void LoadLedgerState(ledger::LedgerCallbackHandler* handler) override {
+    handlers_[LEDGER_STATE] = handler;
+  }
+  void LoadLedgerHistory(ledger::LedgerCallbackHandler* handler) override {
+    handlers_[LEDGER_HISTORY] = handler;
+  }
+  void LoadPublisherState(ledger::LedgerCallbackHandler* handler) override {
+    handlers_[PUBLISHER_STATE] = handler;
+  }
+  void LoadPublisherList(ledger::LedgerCallbackHandler* handler) override {
+    handlers_[PUBLISHER_LIST] = handler;
+  }
+  void LoadPublisherInfoList(
+      uint32_t start,
+      uint32_t limit,
+      ledger::PublisherInfoFilter filter,
+      ledger::PublisherInfoListCallback callback) override {
+    publisher_pages_++;
+    MockLedgerClient::LoadPublisherInfoList(start, limit, filter, callback);
+  }
+
+ private:
+  std::vector<ledger::LedgerCallbackHandler*> handlers_;  // NOT OWNED
+  std::vector<ledger::Result> wallet_results_;
+  int publisher_pages_;
+};
+
+std::vector<LoadResult> GetLoads(ledger::Result ledger_state,
+                                 ledger::Result ledger_history,
+                                 ledger::Result publisher_state) {
+  return {
+    {LEDGER_STATE, ledger_state,
+     ledger_state == ledger::Result::LEDGER_OK ? GetLedgerState() : ""},
+    {LEDGER_HISTORY, ledger_history, ""},
+    {PUBLISHER_STATE, publisher_state,
+     publisher_state == ledger::Result::LEDGER_OK ? GetPublisherState() : ""},
+    {PUBLISHER_LIST, ledger::Result::LEDGER_OK, kPublisherList},
+  };
+}
+
+// Runs Initialize() for every order the loads can complete in and checks
+// that the wallet is reported once, with |expected|
+void ExpectStartup(std::vector<LoadResult> loads, ledger::Result expected) {
+  std::sort(loads.begin(), loads.end(),
+            [](const LoadResult& a, const LoadResult& b) {
+              return a.load < b.load;
+            });
+  do {
+    StartupTestClient client;
+    client.ledger_impl()->Initialize();
+
+    std::string order;
+    size_t state_loads = 0;
+    for (const auto& load : loads) {
+      order += std::to_string(load.load);
+      ASSERT_TRUE(client.IsPending(load.load)) << order;
+      client.Complete(load);
+      if (load.load != PUBLISHER_LIST) {
+        state_loads++;
+      }
+      // the publisher list doesn't hold up the wallet
+      EXPECT_EQ(state_loads == 3 ? 1u : 0u, client.wallet_results().size())
+          << order;
+    }
+
+    ASSERT_EQ(1u, client.wallet_results().size()) << order;
+    EXPECT_EQ(expected, client.wallet_results()[0]) << order;
+    EXPECT_FALSE(client.ledger_impl()->IsPublisherListWarming()) << order;
+  } while (std::next_permutation(loads.begin(), loads.end(),
+                                 [](const LoadResult& a, const LoadResult& b) {
+                                   return a.load < b.load;
+                                 }));
+}
+
+TEST(LedgerStartupTest, AnyCompletionOrder) {
+  ExpectStartup(GetLoads(ledger::Result::LEDGER_OK,
+                         ledger::Result::LEDGER_OK,
+                         ledger::Result::LEDGER_OK),
+                ledger::Result::LEDGER_OK);
+  // nothing stored yet
+  ExpectStartup(GetLoads(ledger::Result::NO_LEDGER_STATE,
+                         ledger::Result::NO_LEDGER_STATE,
+                         ledger::Result::NO_PUBLISHER_STATE),
+                ledger::Result::NO_LEDGER_STATE);
+}
+
+TEST(LedgerStartupTest, ErrorPrecedence) {
+  // ledger state, then history, then publisher state
+  ExpectStartup(GetLoads(ledger::Result::NO_LEDGER_STATE,
+                         ledger::Result::LEDGER_ERROR,
+                         ledger::Result::NO_PUBLISHER_STATE),
+                ledger::Result::NO_LEDGER_STATE);
+  ExpectStartup(GetLoads(ledger::Result::LEDGER_OK,
+                         ledger::Result::LEDGER_ERROR,
+                         ledger::Result::NO_PUBLISHER_STATE),
+                ledger::Result::LEDGER_ERROR);
+  ExpectStartup(GetLoads(ledger::Result::LEDGER_OK,
+                         ledger::Result::NO_LEDGER_STATE,
+                         ledger::Result::NO_PUBLISHER_STATE),
+                ledger::Result::NO_PUBLISHER_STATE);
+
+  // stored state that doesn't parse
+  std::vector<LoadResult> loads = GetLoads(ledger::Result::LEDGER_OK,
+                                           ledger::Result::LEDGER_OK,
+                                           ledger::Result::LEDGER_OK);
+  loads[PUBLISHER_STATE].data = "{";
+  ExpectStartup(loads, ledger::Result::INVALID_PUBLISHER_STATE);
+  loads[LEDGER_STATE].data = "{";
+  ExpectStartup(loads, ledger::Result::INVALID_LEDGER_STATE);
+}
+
+TEST(LedgerStartupTest, PublisherListWarming) {
+  for (ledger::Result result : {ledger::Result::LEDGER_OK,
+                                ledger::Result::NO_PUBLISHER_LIST,
+                                ledger::Result::LEDGER_ERROR}) {
+    StartupTestClient client;
+    bat_ledger::LedgerImpl* ledger = client.ledger_impl();
+    ledger->Initialize();
+    EXPECT_TRUE(ledger->IsPublisherListWarming());
+
+    for (const auto& load : GetLoads(ledger::Result::LEDGER_OK,
+                                     ledger::Result::LEDGER_OK,
+                                     ledger::Result::LEDGER_OK)) {
+      if (load.load != PUBLISHER_LIST) {
+        client.Complete(load);
+      }
+    }
+    ASSERT_EQ(1u, client.wallet_results().size());
+    EXPECT_TRUE(ledger->IsPublisherListWarming());
+
+    // a list that failed to load is ready as well, it's refreshed from
+    // the server
+    client.Complete({PUBLISHER_LIST, result,
+                     result == ledger::Result::LEDGER_OK ? kPublisherList : ""});
+    EXPECT_FALSE(ledger->IsPublisherListWarming());
+  }
+
+  StartupTestClient client;
+  bat_ledger::LedgerImpl* ledger = client.ledger_impl();
+  ledger->Initialize();
+  client.Complete({PUBLISHER_LIST, ledger::Result::LEDGER_OK, "{"});
+  EXPECT_FALSE(ledger->IsPublisherListWarming());
+}
+
+TEST(LedgerStartupTest, AutoContributeWaitsForPublisherList) {
+  StartupTestClient client;
+  client.ledger_impl()->Initialize();
+  for (const auto& load : GetLoads(ledger::Result::LEDGER_OK,
+                                   ledger::Result::LEDGER_OK,
+                                   ledger::Result::LEDGER_OK)) {
+    if (load.load != PUBLISHER_LIST) {
+      client.Complete(load);
+    }
+  }
+  ASSERT_EQ(1u, client.wallet_results().size());
+  ASSERT_EQ(ledger::Result::LEDGER_OK, client.wallet_results()[0]);
+
+  // reconcile timer starts within a minute
+  client.RunUntil(client.now() + 120 * 1000);
+  EXPECT_EQ(0, client.publisher_pages());
+
+  client.Complete({PUBLISHER_LIST, ledger::Result::LEDGER_OK, kPublisherList});
+  client.RunUntil(client.now() + 1000);
+  EXPECT_EQ(1, client.publisher_pages());
+}
+
+TEST(LedgerStartupTest, AutoContributeWithPublisherList) {
+  StartupTestClient client;
+  client.ledger_impl()->Initialize();
+  for (const auto& load : GetLoads(ledger::Result::LEDGER_OK,
+                                   ledger::Result::LEDGER_OK,
+                                   ledger::Result::LEDGER_OK)) {
+    client.Complete(load);
+  }
+  ASSERT_EQ(1u, client.wallet_results().size());
+
+  client.RunUntil(client.now() + 120 * 1000);
+  EXPECT_EQ(1, client.publisher_pages());
+}
+
+}  // namespace
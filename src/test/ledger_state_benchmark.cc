@@ -0,0 +1,253 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "bat_binary_fields.h"
+#include "bat_helper.h"
+#include "bat_helper_fields.h"
+#include "rapidjson_bat_helper.h"
+#include "third_party/google_benchmark/src/include/benchmark/benchmark.h"
+
+namespace {
+
+const int kVotesPerTransaction = 10;
+
+// anonize keeps its tokens as JSON text, the quotes are escaped in the
+// JSON state
+std::string GetAnonizeBlob(char c, size_t size) {
+  return "{\"key\":\"" + std::string(size, c) + "\",\"points\":[\"" +
+      std::string(size / 4, c) + "\",\"" + std::string(size / 4, c) +
+      "\"]}";
+}
+
+// State of a wallet after |transactions| monthly contributions, with
+// ballots of the last one still waiting to be voted
+braveledger_bat_helper::CLIENT_STATE_ST GetClientState(size_t transactions) {
+  braveledger_bat_helper::CLIENT_STATE_ST state;
+  state.personaId_ = "b8c7c2ca-7e5c-4e4e-a2e2-6a0f7bf1a0fb";
+  state.userId_ = "5a4f6a68-6cc2-4f2e-94a0-3c5d1a4b7e1f";
+  state.registrarVK_ = GetAnonizeBlob('v', 512);
+  state.masterUserToken_ = GetAnonizeBlob('m', 1024);
+  state.fee_currency_ = "USD";
+  state.fee_amount_ = 10.0;
+  state.days_ = 30;
+  state.bootStamp_ = 1541766652;
+  state.reconcileStamp_ = 1544358652;
+
+  for (size_t i = 0; i < transactions; i++) {
+    std::string viewing_id = "viewing-" + std::to_string(i);
+
+    braveledger_bat_helper::TRANSACTION_ST transaction;
+    transaction.viewingId_ = viewing_id;
+    transaction.surveyorId_ = "surveyor-" + std::to_string(i);
+    transaction.contribution_fiat_amount_ = "10";
+    transaction.contribution_fiat_currency_ = "USD";
+    transaction.contribution_rates_["USD"] = 0.18;
+    transaction.contribution_rates_["EUR"] = 0.16;
+    transaction.contribution_altcurrency_ = "BAT";
+    transaction.contribution_probi_ = "55000000000000000000";
+    transaction.contribution_fee_ = "0";
+    transaction.submissionStamp_ = std::to_string(1541766652 + i * 2592000);
+    transaction.submissionId_ = "submission-" + std::to_string(i);
+    transaction.anonizeViewingId_ = std::string(64, 'a');
+    transaction.registrarVK_ = GetAnonizeBlob('r', 512);
+    transaction.masterUserToken_ = GetAnonizeBlob('t', 1024);
+    transaction.votes_ = kVotesPerTransaction;
+
+    for (int j = 0; j < kVotesPerTransaction; j++) {
+      std::string surveyor_id = viewing_id + "-" + std::to_string(j);
+      std::string publisher = "publisher" + std::to_string(j) + ".com";
+      transaction.surveyorIds_.push_back(surveyor_id);
+
+      braveledger_bat_helper::TRANSACTION_BALLOT_ST transaction_ballot;
+      transaction_ballot.publisher_ = publisher;
+      transaction_ballot.offset_ = j;
+      transaction.ballots_.push_back(transaction_ballot);
+
+      if (i + 1 == transactions) {
+        braveledger_bat_helper::BALLOT_ST ballot;
+        ballot.viewingId_ = viewing_id;
+        ballot.surveyorId_ = surveyor_id;
+        ballot.publisher_ = publisher;
+        ballot.offset_ = j;
+        ballot.prepareBallot_ = GetAnonizeBlob('p', 256);
+        ballot.proofBallot_ = std::string(1024, 'b');
+        state.ballots_.push_back(ballot);
+      }
+    }
+
+    state.transactions_.push_back(transaction);
+  }
+
+  return state;
+}
+
+void BM_SaveClientState(benchmark::State& state) {
+  const braveledger_bat_helper::CLIENT_STATE_ST client_state =
+      GetClientState(state.range(0));
+
+  size_t bytes = 0;
+  for (auto _ : state) {
+    std::string json;
+    braveledger_bat_helper::saveToJsonString(client_state, json);
+    bytes += json.length();
+    benchmark::DoNotOptimize(json);
+  }
+
+  state.SetBytesProcessed(bytes);
+}
+BENCHMARK(BM_SaveClientState)->Arg(1)->Arg(12)->Arg(120);
+
+// Every save into the same string, the way BatState keeps its buffer
+void BM_SaveClientStateReused(benchmark::State& state) {
+  const braveledger_bat_helper::CLIENT_STATE_ST client_state =
+      GetClientState(state.range(0));
+
+  size_t bytes = 0;
+  std::string json;
+  for (auto _ : state) {
+    braveledger_bat_helper::saveToJsonString(client_state, json);
+    bytes += json.length();
+    benchmark::DoNotOptimize(json.data());
+  }
+
+  state.SetBytesProcessed(bytes);
+  state.counters["state_bytes"] = json.length();
+}
+BENCHMARK(BM_SaveClientStateReused)->Arg(1)->Arg(12)->Arg(120);
+
+void BM_SaveClientStateBinary(benchmark::State& state) {
+  const braveledger_bat_helper::CLIENT_STATE_ST client_state =
+      GetClientState(state.range(0));
+
+  size_t bytes = 0;
+  std::string data;
+  for (auto _ : state) {
+    braveledger_bat_helper::SaveToBinaryString(client_state, &data);
+    bytes += data.length();
+    benchmark::DoNotOptimize(data.data());
+  }
+
+  state.SetBytesProcessed(bytes);
+  state.counters["state_bytes"] = data.length();
+}
+BENCHMARK(BM_SaveClientStateBinary)->Arg(1)->Arg(12)->Arg(120);
+
+// The save on every state change once the history is split off, it is
+// the same for any number of transactions. The ballots waiting to be
+// voted stay in the state.
+void BM_SaveClientStateHot(benchmark::State& state) {
+  braveledger_bat_helper::CLIENT_STATE_ST client_state =
+      GetClientState(state.range(0));
+  braveledger_bat_helper::CLIENT_HISTORY_ST history;
+  history.transactions_.swap(client_state.transactions_);
+
+  size_t bytes = 0;
+  std::string json;
+  for (auto _ : state) {
+    braveledger_bat_helper::saveToJsonString(client_state, json);
+    bytes += json.length();
+    benchmark::DoNotOptimize(json.data());
+  }
+
+  state.SetBytesProcessed(bytes);
+  state.counters["state_bytes"] = json.length();
+  braveledger_bat_helper::saveToJsonString(history, json);
+  state.counters["history_bytes"] = json.length();
+}
+BENCHMARK(BM_SaveClientStateHot)->Arg(1)->Arg(12)->Arg(120);
+
+// One vote batch payload of |range(0)| votes, VOTE_BATCH_SIZE is 10
+void BM_StringifyBatch(benchmark::State& state) {
+  std::vector<braveledger_bat_helper::BATCH_VOTES_INFO_ST> votes(
+      state.range(0));
+  for (auto& vote : votes) {
+    vote.surveyorId_ = std::string(64, 's');
+    vote.proof_ = std::string(1024, 'p');
+  }
+
+  std::string json;
+  for (auto _ : state) {
+    braveledger_bat_helper::stringifyBatch(votes, votes.size(), &json);
+    benchmark::DoNotOptimize(json.data());
+  }
+
+  state.SetBytesProcessed(state.iterations() * json.length());
+}
+BENCHMARK(BM_StringifyBatch)->Arg(10)->Arg(100);
+
+void BM_LoadClientState(benchmark::State& state) {
+  std::string json;
+  braveledger_bat_helper::saveToJsonString(GetClientState(state.range(0)),
+                                           json);
+
+  for (auto _ : state) {
+    braveledger_bat_helper::CLIENT_STATE_ST client_state;
+    benchmark::DoNotOptimize(client_state.loadFromJson(json));
+  }
+
+  state.SetBytesProcessed(state.iterations() * json.length());
+}
+BENCHMARK(BM_LoadClientState)->Arg(1)->Arg(12)->Arg(120);
+
+void BM_LoadClientStateBinary(benchmark::State& state) {
+  std::string data;
+  braveledger_bat_helper::SaveToBinaryString(GetClientState(state.range(0)),
+                                             &data);
+
+  for (auto _ : state) {
+    braveledger_bat_helper::CLIENT_STATE_ST client_state;
+    benchmark::DoNotOptimize(
+        braveledger_bat_helper::LoadFromBinaryString(data, &client_state));
+  }
+
+  state.SetBytesProcessed(state.iterations() * data.length());
+}
+BENCHMARK(BM_LoadClientStateBinary)->Arg(1)->Arg(12)->Arg(120);
+
+// Publishers list in the format of the publishers server, every tenth
+// publisher has a banner
+std::string GetServerList(size_t size) {
+  std::string json = "[";
+  for (size_t i = 0; i < size; i++) {
+    if (i > 0) {
+      json += ",";
+    }
+
+    json += "[\"publisher" + std::to_string(i) + ".com\",";
+    json += (i % 3 == 0) ? "true," : "false,";
+    json += (i % 50 == 0) ? "true" : "false";
+    if (i % 10 == 0) {
+      json += ",{\"title\":\"Publisher " + std::to_string(i) + "\","
+          "\"description\":\"Thanks for the support\","
+          "\"backgroundUrl\":\"https://example.com/background.png\","
+          "\"logoUrl\":\"https://example.com/logo.png\","
+          "\"donationAmounts\":[5,10,20],"
+          "\"socialLinks\":{\"twitter\":\"https://twitter.com/brave\"}}";
+    }
+    json += "]";
+  }
+  json += "]";
+
+  return json;
+}
+
+void BM_GetJSONServerList(benchmark::State& state) {
+  const std::string json = GetServerList(state.range(0));
+
+  for (auto _ : state) {
+    std::map<std::string, braveledger_bat_helper::SERVER_LIST> list;
+    benchmark::DoNotOptimize(
+        braveledger_bat_helper::getJSONServerList(json, list));
+  }
+
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+  state.SetBytesProcessed(state.iterations() * json.length());
+}
+BENCHMARK(BM_GetJSONServerList)->Arg(1000)->Arg(10000)->Arg(100000);
+
+}  // namespace
@@ -0,0 +1,110 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <thread>
+
+#include "brave/vendor/bat-native-ledger/src/ledger_task_executor_impl.h"
+#include "brave/vendor/bat-native-ledger/src/ledger_task_runner_impl.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace {
+
+std::unique_ptr<ledger::LedgerTaskRunner> MakeTask(
+    ledger::LedgerTaskRunner::Task task) {
+  return std::unique_ptr<ledger::LedgerTaskRunner>(
+      new bat_ledger::LedgerTaskRunnerImpl(task));
+}
+
+TEST(LedgerTaskExecutorTest, RepliesRunOnLedgerSequence) {
+  bat_ledger::LedgerTaskExecutorImpl executor(4, nullptr);
+  const std::thread::id ledger_thread = std::this_thread::get_id();
+
+  std::atomic<int> ran_on_ledger_thread(0);
+  int replies = 0;
+  for (int i = 0; i < 100; i++) {
+    executor.RunIOTask(MakeTask(
+        [&](ledger::LedgerTaskRunner::CallerThreadCallback callback) {
+          if (std::this_thread::get_id() == ledger_thread) {
+            ran_on_ledger_thread++;
+          }
+          callback([&]() {
+            EXPECT_EQ(ledger_thread, std::this_thread::get_id());
+            replies++;
+          });
+        }));
+  }
+
+  executor.Shutdown();
+  EXPECT_EQ(100u, executor.RunReplies());
+  EXPECT_EQ(100, replies);
+  EXPECT_EQ(0, ran_on_ledger_thread);
+  EXPECT_EQ(0u, executor.RunReplies());
+}
+
+TEST(LedgerTaskExecutorTest, NestedTasksAreStolen) {
+  bat_ledger::LedgerTaskExecutorImpl executor(4, nullptr);
+
+  std::mutex mutex;
+  std::set<std::thread::id> threads;
+  std::atomic<int> done(0);
+
+  // one task spawns the rest on its own queue, idle threads steal them
+  executor.RunIOTask(MakeTask(
+      [&](ledger::LedgerTaskRunner::CallerThreadCallback) {
+        for (int i = 0; i < 64; i++) {
+          executor.RunIOTask(MakeTask(
+              [&](ledger::LedgerTaskRunner::CallerThreadCallback) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(2));
+                std::lock_guard<std::mutex> lock(mutex);
+                threads.insert(std::this_thread::get_id());
+                done++;
+              }));
+        }
+      }));
+
+  // threads that find nothing to do stop once shutdown starts
+  while (done < 64) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  executor.Shutdown();
+  EXPECT_EQ(64, done);
+  EXPECT_LT(1u, threads.size());
+}
+
+TEST(LedgerTaskExecutorTest, PostReply) {
+  std::mutex mutex;
+  int posted = 0;
+  bat_ledger::LedgerTaskExecutorImpl executor(
+      2,
+      [&](ledger::LedgerTaskExecutor::Closure) {
+        std::lock_guard<std::mutex> lock(mutex);
+        posted++;
+      });
+
+  for (int i = 0; i < 10; i++) {
+    executor.RunIOTask(MakeTask(
+        [](ledger::LedgerTaskRunner::CallerThreadCallback callback) {
+          callback([]() {});
+        }));
+  }
+
+  executor.Shutdown();
+  EXPECT_EQ(10, posted);
+  EXPECT_EQ(0u, executor.RunReplies());
+
+  // runs on the calling thread once the pool is stopped
+  bool ran = false;
+  executor.RunIOTask(MakeTask(
+      [&](ledger::LedgerTaskRunner::CallerThreadCallback) {
+        ran = true;
+      }));
+  EXPECT_TRUE(ran);
+}
+
+}  // namespace
@@ -0,0 +1,152 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "bat/ledger/ledger_client_recorder.h"
+#include "brave/vendor/bat-native-ledger/src/bat_helper.h"
+#include "brave/vendor/bat-native-ledger/src/ledger_trace.h"
+#include "brave/vendor/bat-native-ledger/src/rapidjson_bat_helper.h"
+#include "brave/vendor/bat-native-ledger/src/test/mock_ledger_client.h"
+#include "brave/vendor/bat-native-ledger/src/test/replay_ledger_client.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace {
+
+class StateHandler : public ledger::LedgerCallbackHandler {
+ public:
+  StateHandler() : result(ledger::Result::LEDGER_ERROR) {}
+
+  void OnLedgerStateLoaded(ledger::Result result,
+                           const std::string& data) override {
+    this->result = result;
+    this->data = data;
+  }
+
+  ledger::Result result;
+  std::string data;
+};
+
+TEST(LedgerTraceTest, RecordRoundTrip) {
+  bat_ledger::TraceRecord record;
+  record.direction = bat_ledger::TraceRecord::RESULT;
+  record.type = "OnURLRequestResponse";
+  record.time = 1234;
+  record.call = 7;
+  record.fields = {"", "line\nbreak", std::string("\0bytes", 6)};
+
+  std::stringstream stream;
+  bat_ledger::WriteTraceRecord(record, &stream);
+  bat_ledger::WriteTraceRecord(record, &stream);
+
+  std::vector<bat_ledger::TraceRecord> records;
+  ASSERT_TRUE(bat_ledger::ReplayLedgerClient::ReadTrace(&stream, &records));
+  ASSERT_EQ(2u, records.size());
+  EXPECT_EQ(bat_ledger::TraceRecord::RESULT, records[1].direction);
+  EXPECT_EQ(record.type, records[1].type);
+  EXPECT_EQ(record.time, records[1].time);
+  EXPECT_EQ(record.call, records[1].call);
+  EXPECT_EQ(record.fields, records[1].fields);
+}
+
+TEST(LedgerTraceTest, PublisherInfoRoundTrip) {
+  ledger::PublisherInfo info("brave.com", ledger::PUBLISHER_MONTH::MAY, 2018);
+  info.duration = 300;
+  info.score = 1.0 / 3;
+  info.visits = 4;
+  info.percent = 33;
+  info.verified = true;
+  info.name = "Brave\n";
+
+  ledger::PublisherInfo decoded;
+  ASSERT_TRUE(bat_ledger::DecodePublisherInfo(
+      bat_ledger::EncodePublisherInfo(info), &decoded));
+  EXPECT_EQ(info.id, decoded.id);
+  EXPECT_EQ(info.duration, decoded.duration);
+  EXPECT_EQ(info.score, decoded.score);
+  EXPECT_EQ(info.percent, decoded.percent);
+  EXPECT_EQ(info.month, decoded.month);
+  EXPECT_EQ(info.year, decoded.year);
+  EXPECT_TRUE(decoded.verified);
+  EXPECT_EQ(info.name, decoded.name);
+
+  EXPECT_FALSE(bat_ledger::DecodePublisherInfo("1\n0\n\n", &decoded));
+}
+
+TEST(LedgerTraceTest, CorruptLengthsAreRejected) {
+  std::vector<std::string> fields;
+  EXPECT_TRUE(bat_ledger::DecodeTraceFields("1\n2\nab\n", &fields));
+  EXPECT_EQ(std::vector<std::string>({"ab"}), fields);
+
+  // a count or length past the data fails instead of allocating for it
+  EXPECT_FALSE(bat_ledger::DecodeTraceFields("18446744073709551615\n",
+                                             &fields));
+  EXPECT_FALSE(bat_ledger::DecodeTraceFields("2\n2\nab\n", &fields));
+  EXPECT_FALSE(bat_ledger::DecodeTraceFields(
+      "1\n18446744073709551615\nab\n", &fields));
+  EXPECT_FALSE(bat_ledger::DecodeTraceFields("1\n-1\nab\n", &fields));
+  EXPECT_FALSE(bat_ledger::DecodeTraceFields("1\n3\nab\n", &fields));
+
+  std::stringstream stream("C LoadURL 1 1 4611686018427387904\n0\n\n");
+  bat_ledger::TraceRecord record;
+  EXPECT_FALSE(bat_ledger::ReadTraceRecord(&stream, &record));
+}
+
+TEST(LedgerTraceTest, RecordAndReplay) {
+  braveledger_bat_helper::CLIENT_STATE_ST state;
+  state.walletInfo_.paymentId_ = "payment-id";
+  state.walletInfo_.keyInfoSeed_ = {0xca, 0xfe, 0xba, 0xbe};
+  state.personaId_ = "persona-id";
+  std::string data;
+  braveledger_bat_helper::saveToJsonString(state, data);
+
+  std::stringstream trace;
+  bat_ledger::MockLedgerClient client;
+  std::unique_ptr<ledger::LedgerClientRecorder> recorder(
+      ledger::LedgerClientRecorder::Create(&client, &trace));
+
+  StateHandler recorded;
+  recorder->SaveLedgerState(data, &recorded);
+  recorder->LoadLedgerState(&recorded);
+  client.RunUntil(0);
+  EXPECT_EQ(ledger::Result::LEDGER_OK, recorded.result);
+  // save, load and their results
+  EXPECT_EQ(4u, recorder->size());
+  EXPECT_EQ(data, recorded.data);
+  recorder.reset();
+
+  // the wallet info is not in the trace
+  EXPECT_EQ(std::string::npos, trace.str().find("payment-id"));
+  EXPECT_EQ(std::string::npos, trace.str().find("yv66vg=="));
+
+  std::vector<bat_ledger::TraceRecord> records;
+  ASSERT_TRUE(bat_ledger::ReplayLedgerClient::ReadTrace(&trace, &records));
+  bat_ledger::ReplayLedgerClient replay(records);
+
+  // state comes from the trace, nothing was saved to the replay client
+  StateHandler replayed;
+  replay.LoadLedgerState(&replayed);
+  replay.RunUntil(replay.duration());
+  EXPECT_EQ(ledger::Result::LEDGER_OK, replayed.result);
+  braveledger_bat_helper::CLIENT_STATE_ST replayed_state;
+  ASSERT_TRUE(replayed_state.loadFromJson(replayed.data));
+  EXPECT_EQ("persona-id", replayed_state.personaId_);
+  EXPECT_TRUE(replayed_state.walletInfo_.paymentId_.empty());
+  EXPECT_TRUE(replayed_state.walletInfo_.keyInfoSeed_.empty());
+
+  // trace has no more loads
+  replay.LoadLedgerState(&replayed);
+  replay.RunUntil(replay.duration());
+  EXPECT_EQ(ledger::Result::NO_LEDGER_STATE, replayed.result);
+
+  bat_ledger::ReplayStats stats = replay.GetStats();
+  EXPECT_EQ(1u, stats.calls);
+  EXPECT_EQ(1u, stats.unmatched);
+  EXPECT_EQ(data.size(), stats.recorded_state_bytes_written);
+}
+
+}  // namespace
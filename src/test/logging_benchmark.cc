@@ -0,0 +1,54 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include <map>
+#include <string>
+
+#include "ledger_impl.h"
+#include "logging.h"
+#include "mock_ledger_client.h"
+#include "third_party/google_benchmark/src/include/benchmark/benchmark.h"
+
+namespace {
+
+// Logging of one response of a request, as every URL callback does it.
+// Arg is the level set by the client, LOG_ERROR turns response logging off.
+void BM_LogResponse(benchmark::State& state) {
+  bat_ledger::MockLedgerClient client;
+  bat_ledger::LedgerImpl ledger(&client);
+  ledger.SetLogLevel(static_cast<ledger::LogLevel>(state.range(0)));
+
+  const std::string response(2048, 'r');
+  std::map<std::string, std::string> headers;
+  headers["content-type"] = "application/json; charset=utf-8";
+  headers["date"] = "Fri, 09 Nov 2018 12:30:52 GMT";
+  headers["etag"] = "W/\"5c3-Vx7H9bnv3XXm5ZQb1QKQzA\"";
+  headers["server"] = "nginx";
+
+  for (auto _ : state) {
+    ledger.LogResponse("OnReconcileStep", true, response, headers);
+  }
+}
+BENCHMARK(BM_LogResponse)
+    ->Arg(ledger::LogLevel::LOG_ERROR)
+    ->Arg(ledger::LogLevel::LOG_RESPONSE);
+
+// Debug log of a stored state that failed to parse, arg as above
+void BM_LogPayload(benchmark::State& state) {
+  bat_ledger::MockLedgerClient client;
+  bat_ledger::LedgerImpl ledger(&client);
+  ledger.SetLogLevel(static_cast<ledger::LogLevel>(state.range(0)));
+
+  const std::string data(4 * 1024 * 1024, 's');
+
+  for (auto _ : state) {
+    BLOG(&ledger, ledger::LogLevel::LOG_DEBUG) <<
+      "Failed ledger state: " << bat_ledger::LogPayload(data);
+  }
+}
+BENCHMARK(BM_LogPayload)
+    ->Arg(ledger::LogLevel::LOG_ERROR)
+    ->Arg(ledger::LogLevel::LOG_DEBUG);
+
+}  // namespace
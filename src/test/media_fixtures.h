@@ -0,0 +1,44 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVELEDGER_TEST_MEDIA_FIXTURES_H_
+#define BRAVELEDGER_TEST_MEDIA_FIXTURES_H_
+
+#include <map>
+#include <string>
+
+// Requests captured while watching YouTube and Twitch
+
+namespace braveledger_test {
+
+// minute-watched + video-play for a live stream
+static const char kTwitchLivePostData[] =
+    "data=W3siZXZlbnQiOiJtaW51dGUtd2F0Y2hlZCIsInByb3BlcnRpZXMiOnsiY2hhbm5lbCI6"
+    "InNocm91ZCIsInRpbWUiOjE1NDE3NjY3MTIuMTIzLCJtaW51dGVzX2xvZ2dlZCI6M319LHsi"
+    "ZXZlbnQiOiJ2aWRlby1wbGF5IiwicHJvcGVydGllcyI6eyJjaGFubmVsIjoic2hyb3VkIiwi"
+    "dGltZSI6MTU0MTc2NjY1Mi41fX1d";
+
+// video_pause for a VOD
+static const char kTwitchVodPostData[] =
+    "data=W3siZXZlbnQiOiJ2aWRlb19wYXVzZSIsInByb3BlcnRpZXMiOnsiY2hhbm5lbCI6ImFz"
+    "bW9uZ29sZCIsInZvZCI6InYzMzQ1MjMyNDUiLCJ0aW1lIjoxNTQxNzY2ODAwLjI1fX1d";
+
+inline std::map<std::string, std::string> GetYoutubeWatchtimeParts() {
+  return {
+    {"ns", "yt"},
+    {"el", "detailpage"},
+    {"cpn", "z4PjUvPmn5Oa3nKM"},
+    {"docid", "hmNNRz6YpUY"},
+    {"ver", "2"},
+    {"cmt", "95.311"},
+    {"st", "0.501,31.213,62.004"},
+    {"et", "30.742,61.873,95.311"},
+    {"len", "413.701"},
+    {"state", "playing"},
+  };
+}
+
+}  // namespace braveledger_test
+
+#endif  // BRAVELEDGER_TEST_MEDIA_FIXTURES_H_
@@ -0,0 +1,73 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include <string>
+#include <vector>
+
+#include "bat_get_media.h"
+#include "third_party/google_benchmark/src/include/benchmark/benchmark.h"
+
+namespace {
+
+struct LinkSample {
+  const char* url;
+  const char* first_party_url;
+  const char* referrer;
+};
+
+// Mostly regular XHRs with a few media requests, roughly what we see
+// while browsing
+const LinkSample kLinkCorpus[] = {
+  {"https://www.google.com/complete/search?client=chrome-omni&q=brave",
+   "https://www.google.com/", ""},
+  {"https://www.facebook.com/ajax/bz?__a=1&__req=1d", "https://www.facebook.com/",
+   "https://www.facebook.com/"},
+  {"https://api.twitter.com/2/timeline/home.json?include_profile_interstitial_type=1",
+   "https://twitter.com/home", "https://twitter.com/home"},
+  {"https://www.youtube.com/youtubei/v1/log_event?alt=json",
+   "https://www.youtube.com/watch?v=hmNNRz6YpUY", ""},
+  {"https://www.youtube.com/api/stats/watchtime?ns=yt&el=detailpage&cpn=z4PjUvPmn5Oa3nKM"
+   "&docid=hmNNRz6YpUY&st=0.501&et=30.742",
+   "https://www.youtube.com/watch?v=hmNNRz6YpUY", ""},
+  {"https://gql.twitch.tv/gql", "https://www.twitch.tv/shroud",
+   "https://www.twitch.tv/shroud"},
+  {"https://video-edge-c2a3a4.sjc02.hls.ttvnw.net/v1/segment/CpcE2mJx0z.ts",
+   "https://www.twitch.tv/shroud", "https://www.twitch.tv/shroud"},
+  {"https://en.wikipedia.org/api/rest_v1/page/summary/Brave_(web_browser)",
+   "https://en.wikipedia.org/wiki/Brave", ""},
+  {"https://github.com/brave/brave-browser/issues/1000/show_partial?partial=x",
+   "https://github.com/brave/brave-browser/issues", ""},
+  {"https://www.reddit.com/api/v1/access_token", "https://www.reddit.com/", ""},
+  {"https://m.youtube.com/api/stats/watchtime?ns=yt&docid=abc&st=1&et=2",
+   "https://m.youtube.com/watch?v=abc", ""},
+  {"https://static.xx.fbcdn.net/rsrc.php/v3/yX/r/abc.js",
+   "https://www.facebook.com/", ""},
+};
+
+void BM_GetLinkType(benchmark::State& state) {
+  std::vector<std::string> urls;
+  std::vector<std::string> first_party_urls;
+  std::vector<std::string> referrers;
+  for (const auto& sample : kLinkCorpus) {
+    urls.push_back(sample.url);
+    first_party_urls.push_back(sample.first_party_url);
+    referrers.push_back(sample.referrer);
+  }
+
+  size_t bytes = 0;
+  for (auto _ : state) {
+    for (size_t i = 0; i < urls.size(); i++) {
+      benchmark::DoNotOptimize(
+          braveledger_bat_get_media::BatGetMedia::GetLinkType(
+              urls[i], first_party_urls[i], referrers[i]));
+      bytes += urls[i].length();
+    }
+  }
+
+  state.SetItemsProcessed(state.iterations() * urls.size());
+  state.SetBytesProcessed(bytes);
+}
+BENCHMARK(BM_GetLinkType);
+
+}  // namespace
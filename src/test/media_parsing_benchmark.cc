@@ -0,0 +1,66 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "bat_helper.h"
+#include "bat_twitch_sessions.h"
+#include "static_values.h"
+#include "test/media_fixtures.h"
+#include "third_party/google_benchmark/src/include/benchmark/benchmark.h"
+
+namespace {
+
+void BM_GetMediaDuration(benchmark::State& state) {
+  const std::map<std::string, std::string> parts =
+      braveledger_test::GetYoutubeWatchtimeParts();
+  const std::string media_key =
+      braveledger_bat_helper::getMediaKey("hmNNRz6YpUY", YOUTUBE_MEDIA_TYPE);
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(braveledger_bat_helper::getMediaDuration(
+        parts, media_key, YOUTUBE_MEDIA_TYPE));
+  }
+}
+BENCHMARK(BM_GetMediaDuration);
+
+void BM_GetTwitchParts(benchmark::State& state) {
+  const std::string post_data = braveledger_test::kTwitchLivePostData;
+  std::vector<uint8_t> scratch;
+
+  for (auto _ : state) {
+    std::vector<std::map<std::string, std::string>> parts;
+    braveledger_bat_helper::getTwitchParts(post_data, &scratch, parts);
+    benchmark::DoNotOptimize(parts);
+  }
+}
+BENCHMARK(BM_GetTwitchParts);
+
+void BM_GetMediaId(benchmark::State& state) {
+  std::vector<std::map<std::string, std::string>> parts;
+  braveledger_bat_helper::getTwitchParts(
+      braveledger_test::kTwitchVodPostData, parts);
+
+  for (auto _ : state) {
+    for (const auto& part : parts) {
+      benchmark::DoNotOptimize(
+          braveledger_bat_helper::getMediaId(part, TWITCH_MEDIA_TYPE));
+    }
+  }
+}
+BENCHMARK(BM_GetMediaId);
+
+void BM_GetTwitchEvent(benchmark::State& state) {
+  size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(braveledger_bat_get_media::GetTwitchEvent(
+        braveledger_ledger::_twitch_events[
+            i++ % braveledger_ledger::_twitch_events_array_size]));
+  }
+}
+BENCHMARK(BM_GetTwitchEvent);
+
+}  // namespace
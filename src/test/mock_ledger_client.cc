@@ -4,73 +4,447 @@
 
 #include "mock_ledger_client.h"
 
-#include "bat/ledger/ledger.h"
+#include <sstream>
+#include <utility>
 
 namespace bat_ledger {
 
-static uint64_t next_id = 1;
+namespace {
+
+class StringLogStream : public ledger::LogStream {
+ public:
+  std::ostream& stream() override { return stream_; }
+
+ private:
+  std::ostringstream stream_;
+};
+
+bool MatchesFilter(const ledger::PublisherInfo& info,
+                   const ledger::PublisherInfoFilter& filter) {
+  return (filter.id.empty() || info.id == filter.id) &&
+      (filter.month == ledger::PUBLISHER_MONTH::ANY ||
+       info.month == filter.month) &&
+      (filter.year == -1 || info.year == filter.year);
+}
+
+}  // namespace
+
+class MockLedgerClient::Loader : public ledger::LedgerURLLoader {
+ public:
+  Loader(MockLedgerClient* client,
+         uint64_t id,
+         const std::string& url,
+         const std::string& content,
+         ledger::URL_METHOD method,
+         ledger::LedgerCallbackHandler* handler) :
+    client_(client),
+    id_(id),
+    url_(url),
+    content_(content),
+    method_(method),
+    handler_(handler) {}
+
+  void Start() override {
+    client_->OnURLRequestStarted(id_, url_, content_, method_, handler_);
+  }
+
+  uint64_t request_id() override { return id_; }
+
+ private:
+  MockLedgerClient* client_;  // NOT OWNED
+  uint64_t id_;
+  std::string url_;
+  std::string content_;
+  ledger::URL_METHOD method_;
+  ledger::LedgerCallbackHandler* handler_;  // NOT OWNED
+};
 
 MockLedgerClient::MockLedgerClient() :
-    ledger_(ledger::Ledger::CreateInstance(this)) {
+  delay_(0),
+  now_(0),
+  next_id_(1),
+  state_bytes_written_(0) {
 }
 
 MockLedgerClient::~MockLedgerClient() {
+  // ledger can still call us while it's destroyed
+  ledger_.reset();
+}
+
+ledger::Ledger* MockLedgerClient::ledger() {
+  if (!ledger_) {
+    ledger_.reset(ledger::Ledger::CreateInstance(this));
+  }
+
+  return ledger_.get();
+}
+
+void MockLedgerClient::RunUntil(uint64_t time) {
+  while (!events_.empty() && events_.begin()->first <= time) {
+    auto iter = events_.begin();
+    std::function<void()> callback = std::move(iter->second);
+    now_ = iter->first;
+    events_.erase(iter);
+    callback();
+  }
+
+  if (now_ < time) {
+    now_ = time;
+  }
+}
+
+uint64_t MockLedgerClient::now() const {
+  return now_;
+}
+
+bool MockLedgerClient::GetNextEventTime(uint64_t* time) const {
+  if (events_.empty()) {
+    return false;
+  }
+
+  *time = events_.begin()->first;
+  return true;
+}
+
+void MockLedgerClient::SetLedgerState(const std::string& data) {
+  ledger_state_ = data;
+}
+
+void MockLedgerClient::SetLedgerHistory(const std::string& data) {
+  ledger_history_ = data;
+}
+
+void MockLedgerClient::SetPublisherState(const std::string& data) {
+  publisher_state_ = data;
+}
+
+const std::string& MockLedgerClient::ledger_state() const {
+  return ledger_state_;
+}
+
+const std::string& MockLedgerClient::ledger_history() const {
+  return ledger_history_;
+}
+
+const std::string& MockLedgerClient::publisher_state() const {
+  return publisher_state_;
+}
+
+uint64_t MockLedgerClient::state_bytes_written() const {
+  return state_bytes_written_;
 }
 
-void MockLedgerClient::CreateWallet() {
-  ledger_->CreateWallet();
+void MockLedgerClient::Post(uint64_t delay, std::function<void()> callback) {
+  // events with the same time run in the order they were posted
+  events_.insert(std::make_pair(now_ + delay, std::move(callback)));
 }
 
 std::string MockLedgerClient::GenerateGUID() const {
   return "guid";
 }
 
-void MockLedgerClient::Shutdown() {
-  ledger_.reset();
+void MockLedgerClient::OnWalletInitialized(ledger::Result result) {
 }
 
-void MockLedgerClient::OnWalletInitialized(ledger::Result result) {
+void MockLedgerClient::FetchWalletProperties() {
 }
 
-void MockLedgerClient::OnReconcileComplete(ledger::Result result,
-                                              const std::string& viewing_id) {
+void MockLedgerClient::OnWalletProperties(
+    ledger::Result result,
+    std::unique_ptr<ledger::WalletInfo> info) {
+}
+
+void MockLedgerClient::OnReconcileComplete(
+    ledger::Result result,
+    const std::string& viewing_id,
+    ledger::PUBLISHER_CATEGORY category,
+    const std::string& probi) {
 }
 
 void MockLedgerClient::LoadLedgerState(
     ledger::LedgerCallbackHandler* handler) {
-  handler->OnLedgerStateLoaded(ledger::Result::OK, ledger_state_);
+  std::string data = ledger_state_;
+  Post(delay_, [handler, data]() {
+    handler->OnLedgerStateLoaded(data.empty() ?
+        ledger::Result::NO_LEDGER_STATE : ledger::Result::LEDGER_OK, data);
+  });
 }
 
-void MockLedgerClient::LoadPublisherState(
+void MockLedgerClient::SaveLedgerState(
+    const std::string& ledger_state,
+    ledger::LedgerCallbackHandler* handler) {
+  ledger_state_ = ledger_state;
+  state_bytes_written_ += ledger_state.size();
+  Post(delay_, [handler]() {
+    handler->OnLedgerStateSaved(ledger::Result::LEDGER_OK);
+  });
+}
+
+void MockLedgerClient::LoadLedgerHistory(
     ledger::LedgerCallbackHandler* handler) {
-  handler->OnLedgerStateLoaded(ledger::Result::OK, publisher_state_);
+  std::string data = ledger_history_;
+  Post(delay_, [handler, data]() {
+    handler->OnLedgerHistoryLoaded(data.empty() ?
+        ledger::Result::NO_LEDGER_STATE : ledger::Result::LEDGER_OK, data);
+  });
 }
 
-void MockLedgerClient::SaveLedgerState(const std::string& ledger_state,
-                                      ledger::LedgerCallbackHandler* handler) {
-  ledger_state_ = ledger_state;
-  handler->OnLedgerStateSaved(ledger::Result::OK);
+void MockLedgerClient::SaveLedgerHistory(
+    const std::string& ledger_history,
+    ledger::LedgerCallbackHandler* handler) {
+  ledger_history_ = ledger_history;
+  state_bytes_written_ += ledger_history.size();
+  Post(delay_, [handler]() {
+    handler->OnLedgerHistorySaved(ledger::Result::LEDGER_OK);
+  });
+}
+
+void MockLedgerClient::LoadPublisherState(
+    ledger::LedgerCallbackHandler* handler) {
+  std::string data = publisher_state_;
+  Post(delay_, [handler, data]() {
+    handler->OnPublisherStateLoaded(data.empty() ?
+        ledger::Result::NO_PUBLISHER_STATE : ledger::Result::LEDGER_OK, data);
+  });
 }
 
-void MockLedgerClient::SavePublisherState(const std::string& publisher_state,
-                                      ledger::LedgerCallbackHandler* handler) {
+void MockLedgerClient::SavePublisherState(
+    const std::string& publisher_state,
+    ledger::LedgerCallbackHandler* handler) {
   publisher_state_ = publisher_state;
-  handler->OnPublisherStateSaved(ledger::Result::OK);
+  state_bytes_written_ += publisher_state.size();
+  Post(delay_, [handler]() {
+    handler->OnPublisherStateSaved(ledger::Result::LEDGER_OK);
+  });
+}
+
+void MockLedgerClient::SavePublishersList(
+    const std::string& publisher_state,
+    ledger::LedgerCallbackHandler* handler) {
+  publishers_list_ = publisher_state;
+  state_bytes_written_ += publisher_state.size();
+  Post(delay_, [handler]() {
+    handler->OnPublishersListSaved(ledger::Result::LEDGER_OK);
+  });
+}
+
+void MockLedgerClient::LoadPublisherList(
+    ledger::LedgerCallbackHandler* handler) {
+  std::string data = publishers_list_;
+  Post(delay_, [handler, data]() {
+    handler->OnPublisherListLoaded(data.empty() ?
+        ledger::Result::NO_PUBLISHER_LIST : ledger::Result::LEDGER_OK, data);
+  });
+}
+
+void MockLedgerClient::LoadNicewareList(
+    ledger::GetNicewareListCallback callback) {
+  Post(delay_, [callback]() {
+    callback(ledger::Result::LEDGER_ERROR, "");
+  });
+}
+
+void MockLedgerClient::SavePublisherInfo(
+    std::unique_ptr<ledger::PublisherInfo> publisher_info,
+    ledger::PublisherInfoCallback callback) {
+  if (!publisher_info) {
+    Post(delay_, [callback]() {
+      callback(ledger::Result::LEDGER_ERROR, nullptr);
+    });
+    return;
+  }
+
+  publisher_info_[publisher_info->id] = *publisher_info;
+  ledger::PublisherInfo info = *publisher_info;
+  Post(delay_, [callback, info]() {
+    callback(ledger::Result::LEDGER_OK,
+             std::unique_ptr<ledger::PublisherInfo>(
+                 new ledger::PublisherInfo(info)));
+  });
+}
+
+void MockLedgerClient::LoadPublisherInfo(
+    ledger::PublisherInfoFilter filter,
+    ledger::PublisherInfoCallback callback) {
+  auto iter = publisher_info_.find(filter.id);
+  if (iter == publisher_info_.end() || !MatchesFilter(iter->second, filter)) {
+    Post(delay_, [callback]() {
+      callback(ledger::Result::NOT_FOUND, nullptr);
+    });
+    return;
+  }
+
+  ledger::PublisherInfo info = iter->second;
+  Post(delay_, [callback, info]() {
+    callback(ledger::Result::LEDGER_OK,
+             std::unique_ptr<ledger::PublisherInfo>(
+                 new ledger::PublisherInfo(info)));
+  });
+}
+
+void MockLedgerClient::LoadMediaPublisherInfo(
+    const std::string& media_key,
+    ledger::PublisherInfoCallback callback) {
+  ledger::PublisherInfoFilter filter;
+  auto iter = media_publishers_.find(media_key);
+  filter.id = iter != media_publishers_.end() ? iter->second : "";
+  LoadPublisherInfo(filter, callback);
+}
+
+void MockLedgerClient::SaveMediaPublisherInfo(
+    const std::string& media_key,
+    const std::string& publisher_id) {
+  media_publishers_[media_key] = publisher_id;
+}
+
+void MockLedgerClient::LoadPublisherInfoList(
+    uint32_t start,
+    uint32_t limit,
+    ledger::PublisherInfoFilter filter,
+    ledger::PublisherInfoListCallback callback) {
+  ledger::PublisherInfoList list;
+  uint32_t index = 0;
+  uint32_t next_record = 0;
+  for (const auto& info : publisher_info_) {
+    if (!MatchesFilter(info.second, filter)) {
+      continue;
+    }
+
+    if (index++ < start) {
+      continue;
+    }
+
+    if (limit > 0 && list.size() == limit) {
+      next_record = index - 1;
+      break;
+    }
+
+    list.push_back(info.second);
+  }
+
+  Post(delay_, [callback, list, next_record]() {
+    callback(list, next_record);
+  });
+}
+
+void MockLedgerClient::FetchGrant(const std::string& lang,
+                                  const std::string& paymentId) {
+}
+
+void MockLedgerClient::OnGrant(ledger::Result result,
+                               const ledger::Grant& grant) {
+}
+
+void MockLedgerClient::GetGrantCaptcha() {
+}
+
+void MockLedgerClient::OnGrantCaptcha(const std::string& image,
+                                      const std::string& hint) {
 }
 
-uint64_t MockLedgerClient::LoadURL(const std::string& url,
-                 const std::vector<std::string>& headers,
-                 const std::string& content,
-                 const std::string& contentType,
-                 const ledger::URL_METHOD& method,
-                 ledger::LedgerCallbackHandler* handler) {
-  handler->OnURLRequestResponse(next_id, url, 200, "{}");
-  return next_id++;
+void MockLedgerClient::OnRecoverWallet(
+    ledger::Result result,
+    double balance,
+    const std::vector<ledger::Grant>& grants) {
+}
+
+void MockLedgerClient::OnGrantFinish(ledger::Result result,
+                                     const ledger::Grant& grant) {
+}
+
+void MockLedgerClient::OnPublisherActivity(
+    ledger::Result result,
+    std::unique_ptr<ledger::PublisherInfo> info,
+    uint64_t windowId) {
+}
+
+void MockLedgerClient::OnExcludedSitesChanged(
+    const std::string& publisher_id) {
+}
+
+void MockLedgerClient::FetchFavIcon(const std::string& url,
+                                    const std::string& favicon_key,
+                                    ledger::FetchIconCallback callback) {
+  Post(delay_, [callback]() {
+    callback(false, "");
+  });
+}
+
+void MockLedgerClient::SaveContributionInfo(
+    const std::string& probi,
+    const int month,
+    const int year,
+    const uint32_t date,
+    const std::string& publisher_key,
+    const ledger::PUBLISHER_CATEGORY category) {
+}
+
+void MockLedgerClient::GetRecurringDonations(
+    ledger::PublisherInfoListCallback callback) {
+  Post(delay_, [callback]() {
+    callback(ledger::PublisherInfoList(), 0);
+  });
+}
+
+void MockLedgerClient::OnRemoveRecurring(
+    const std::string& publisher_key,
+    ledger::RecurringRemoveCallback callback) {
+  Post(delay_, [callback]() {
+    callback(ledger::Result::LEDGER_OK);
+  });
+}
+
+void MockLedgerClient::SetTimer(uint64_t time_offset, uint32_t& timer_id) {
+  timer_id = static_cast<uint32_t>(next_id_++);
+  uint32_t id = timer_id;
+  Post(time_offset * 1000, [this, id]() {
+    ledger()->OnTimer(id);
+  });
+}
+
+std::string MockLedgerClient::URIEncode(const std::string& value) {
+  return value;
+}
+
+std::unique_ptr<ledger::LedgerURLLoader> MockLedgerClient::LoadURL(
+    const std::string& url,
+    const std::vector<std::string>& headers,
+    const std::string& content,
+    const std::string& contentType,
+    const ledger::URL_METHOD& method,
+    ledger::LedgerCallbackHandler* handler) {
+  return std::unique_ptr<ledger::LedgerURLLoader>(
+      new Loader(this, next_id_++, url, content, method, handler));
+}
+
+void MockLedgerClient::OnURLRequestStarted(
+    uint64_t request_id,
+    const std::string& url,
+    const std::string& content,
+    ledger::URL_METHOD method,
+    ledger::LedgerCallbackHandler* handler) {
+  Post(delay_, [request_id, url, handler]() {
+    handler->OnURLRequestResponse(request_id, url, 404, "", {});
+  });
 }
 
 void MockLedgerClient::RunIOTask(
     std::unique_ptr<ledger::LedgerTaskRunner> task) {
-  task->Run();
+  task->Run([](std::function<void(void)> callback) {
+    callback();
+  });
+}
+
+void MockLedgerClient::SetContributionAutoInclude(std::string publisher_key,
+                                                  bool excluded,
+                                                  uint64_t windowId) {
+}
+
+std::unique_ptr<ledger::LogStream> MockLedgerClient::Log(
+    const char* file,
+    int line,
+    const ledger::LogLevel log_level) const {
+  return std::unique_ptr<ledger::LogStream>(new StringLogStream());
 }
 
-}  // namespace payments
+}  // namespace bat_ledger
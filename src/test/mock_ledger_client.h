@@ -5,50 +5,160 @@
 #ifndef BAT_LEDGER_MOCK_LEDGER_CLIENT_
 #define BAT_LEDGER_MOCK_LEDGER_CLIENT_
 
-#include "bat/ledger/ledger_client.h"
+#include <stdint.h>
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
 
-namespace ledger {
-class Ledger;
-class LedgerCallbackHandler;
-}
+#include "bat/ledger/ledger.h"
+#include "bat/ledger/ledger_client.h"
 
 namespace bat_ledger {
 
+// In-memory LedgerClient. State and publisher info are kept in memory,
+// IO tasks run inline and everything else is delivered asynchronously by
+// RunUntil() in virtual time (ms), so runs are deterministic.
 class MockLedgerClient : public ledger::LedgerClient {
  public:
   MockLedgerClient();
   ~MockLedgerClient() override;
 
-  // KeyedService:
-  void Shutdown() override;
+  // Ledger is created on first use
+  ledger::Ledger* ledger();
 
-  void CreateWallet() override;
+  // Runs host timers and results that are due by |time|. Ledger keeps
+  // periodic timers armed, so there is no "until idle".
+  void RunUntil(uint64_t time);
+  uint64_t now() const;
+  // Returns false when nothing is pending
+  bool GetNextEventTime(uint64_t* time) const;
+
+  // Stored state that the ledger loads on Initialize()
+  void SetLedgerState(const std::string& data);
+  void SetLedgerHistory(const std::string& data);
+  void SetPublisherState(const std::string& data);
+  const std::string& ledger_state() const;
+  const std::string& ledger_history() const;
+  const std::string& publisher_state() const;
+  uint64_t state_bytes_written() const;
 
- protected:
   // ledger::LedgerClient
   std::string GenerateGUID() const override;
   void OnWalletInitialized(ledger::Result result) override;
+  void FetchWalletProperties() override;
+  void OnWalletProperties(ledger::Result result,
+                          std::unique_ptr<ledger::WalletInfo> info) override;
   void OnReconcileComplete(ledger::Result result,
-                           const std::string& viewing_id) override;
+                           const std::string& viewing_id,
+                           ledger::PUBLISHER_CATEGORY category,
+                           const std::string& probi) override;
   void LoadLedgerState(ledger::LedgerCallbackHandler* handler) override;
-  void LoadPublisherState(ledger::LedgerCallbackHandler* handler) override;
   void SaveLedgerState(const std::string& ledger_state,
                        ledger::LedgerCallbackHandler* handler) override;
+  void LoadLedgerHistory(ledger::LedgerCallbackHandler* handler) override;
+  void SaveLedgerHistory(const std::string& ledger_history,
+                         ledger::LedgerCallbackHandler* handler) override;
+  void LoadPublisherState(ledger::LedgerCallbackHandler* handler) override;
   void SavePublisherState(const std::string& publisher_state,
                           ledger::LedgerCallbackHandler* handler) override;
-  uint64_t LoadURL(const std::string& url,
-                   const std::vector<std::string>& headers,
-                   const std::string& content,
-                   const std::string& contentType,
-                   const ledger::URL_METHOD& method,
-                   ledger::LedgerCallbackHandler* handler) override;
+  void SavePublishersList(const std::string& publisher_state,
+                          ledger::LedgerCallbackHandler* handler) override;
+  void LoadPublisherList(ledger::LedgerCallbackHandler* handler) override;
+  void LoadNicewareList(ledger::GetNicewareListCallback callback) override;
+  void SavePublisherInfo(std::unique_ptr<ledger::PublisherInfo> publisher_info,
+                         ledger::PublisherInfoCallback callback) override;
+  void LoadPublisherInfo(ledger::PublisherInfoFilter filter,
+                         ledger::PublisherInfoCallback callback) override;
+  void LoadMediaPublisherInfo(const std::string& media_key,
+                              ledger::PublisherInfoCallback callback) override;
+  void SaveMediaPublisherInfo(const std::string& media_key,
+                              const std::string& publisher_id) override;
+  void LoadPublisherInfoList(
+      uint32_t start,
+      uint32_t limit,
+      ledger::PublisherInfoFilter filter,
+      ledger::PublisherInfoListCallback callback) override;
+  void FetchGrant(const std::string& lang,
+                  const std::string& paymentId) override;
+  void OnGrant(ledger::Result result, const ledger::Grant& grant) override;
+  void GetGrantCaptcha() override;
+  void OnGrantCaptcha(const std::string& image,
+                      const std::string& hint) override;
+  void OnRecoverWallet(ledger::Result result,
+                       double balance,
+                       const std::vector<ledger::Grant>& grants) override;
+  void OnGrantFinish(ledger::Result result,
+                     const ledger::Grant& grant) override;
+  void OnPublisherActivity(ledger::Result result,
+                           std::unique_ptr<ledger::PublisherInfo> info,
+                           uint64_t windowId) override;
+  void OnExcludedSitesChanged(const std::string& publisher_id) override;
+  void FetchFavIcon(const std::string& url,
+                    const std::string& favicon_key,
+                    ledger::FetchIconCallback callback) override;
+  void SaveContributionInfo(
+      const std::string& probi,
+      const int month,
+      const int year,
+      const uint32_t date,
+      const std::string& publisher_key,
+      const ledger::PUBLISHER_CATEGORY category) override;
+  void GetRecurringDonations(
+      ledger::PublisherInfoListCallback callback) override;
+  void OnRemoveRecurring(const std::string& publisher_key,
+                         ledger::RecurringRemoveCallback callback) override;
+  void SetTimer(uint64_t time_offset, uint32_t& timer_id) override;
+  std::string URIEncode(const std::string& value) override;
+  std::unique_ptr<ledger::LedgerURLLoader> LoadURL(
+      const std::string& url,
+      const std::vector<std::string>& headers,
+      const std::string& content,
+      const std::string& contentType,
+      const ledger::URL_METHOD& method,
+      ledger::LedgerCallbackHandler* handler) override;
   void RunIOTask(std::unique_ptr<ledger::LedgerTaskRunner> task) override;
+  void SetContributionAutoInclude(std::string publisher_key,
+                                  bool excluded,
+                                  uint64_t windowId) override;
+  std::unique_ptr<ledger::LogStream> Log(
+      const char* file,
+      int line,
+      const ledger::LogLevel log_level) const override;
+
+ protected:
+  // Runs |callback| after |delay| ms of virtual time
+  void Post(uint64_t delay, std::function<void()> callback);
+
+  // Called when the loader of |request_id| is started, stand-in
+  // network answers every request with 404 after |delay| ms
+  virtual void OnURLRequestStarted(uint64_t request_id,
+                                   const std::string& url,
+                                   const std::string& content,
+                                   ledger::URL_METHOD method,
+                                   ledger::LedgerCallbackHandler* handler);
+
+  // Results of the in-memory storage are delivered after |delay| ms
+  uint64_t delay_;
+
+ private:
+  class Loader;
 
   std::unique_ptr<ledger::Ledger> ledger_;
+  uint64_t now_;
+  uint64_t next_id_;
+  std::multimap<uint64_t, std::function<void()>> events_;
   std::string ledger_state_;
+  std::string ledger_history_;
   std::string publisher_state_;
+  std::string publishers_list_;
+  uint64_t state_bytes_written_;
+  std::map<std::string, ledger::PublisherInfo> publisher_info_;
+  std::map<std::string, std::string> media_publishers_;
 };
 
-}  // namespace history
+}  // namespace bat_ledger
 
-#endif  //BAT_LEDGER_MOCK_LEDGER_CLIENT_
+#endif  // BAT_LEDGER_MOCK_LEDGER_CLIENT_
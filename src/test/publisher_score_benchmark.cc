@@ -0,0 +1,66 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include <string>
+#include <utility>
+
+#include "bat/ledger/publisher_info.h"
+#include "bat_helper.h"
+#include "bat_publishers.h"
+#include "static_values.h"
+#include "third_party/google_benchmark/src/include/benchmark/benchmark.h"
+
+namespace {
+
+// Publisher info table of a month with |size| visited sites, a few of
+// them are visited a lot more than the rest
+ledger::PublisherInfoList GetPublisherInfoList(size_t size) {
+  ledger::PublisherInfoList list;
+  for (size_t i = 0; i < size; i++) {
+    ledger::PublisherInfo info("publisher-" + std::to_string(i) + ".com",
+                               ledger::PUBLISHER_MONTH::NOVEMBER,
+                               2018);
+    info.duration = 10 + (i * 7919) % 3600;
+    info.visits = 1 + i % 13;
+    info.score = (i % 17 == 0 ? 50.0 : 1.0) + (i * 37 % 101) / 10.0;
+    info.percent = i < 100 ? 1 : 0;
+    list.push_back(info);
+  }
+
+  return list;
+}
+
+void BM_ConcaveScore(benchmark::State& state) {
+  // ledger is only needed for the state changes
+  braveledger_bat_publishers::BatPublishers publishers(nullptr);
+
+  uint64_t duration = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(publishers.concaveScore(duration));
+    duration = (duration + 997) % 7200000;
+  }
+
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ConcaveScore);
+
+// Paged scan and normalization that synopsisNormalizerInternal does
+void BM_SynopsisNormalizer(benchmark::State& state) {
+  const ledger::PublisherInfoList publisher_info =
+      GetPublisherInfoList(state.range(0));
+
+  for (auto _ : state) {
+    braveledger_bat_publishers::TopPublishers top;
+    for (const auto& info : publisher_info) {
+      top.Add(info, TOP_PUBLISHERS_COUNT);
+    }
+    top.Finish();
+    benchmark::DoNotOptimize(top);
+  }
+
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_SynopsisNormalizer)->Arg(100)->Arg(1000)->Arg(10000);
+
+}  // namespace
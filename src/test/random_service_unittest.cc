@@ -0,0 +1,66 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include <stdint.h>
+
+#include <vector>
+
+#include "brave/vendor/bat-native-ledger/src/random_service.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace {
+
+class RandomServiceTest : public ::testing::Test {
+ protected:
+  RandomServiceTest() : random_(bat_ledger::RandomService::GetInstance()) {}
+
+  ~RandomServiceTest() override {
+    random_->ClearSeedForTesting();
+  }
+
+  std::vector<uint8_t> GetBytes(size_t length) {
+    std::vector<uint8_t> bytes(length);
+    random_->RandBytes(&bytes.front(), length);
+    return bytes;
+  }
+
+  bat_ledger::RandomService* random_;
+};
+
+TEST_F(RandomServiceTest, Seeded) {
+  random_->SetSeedForTesting(1);
+  // crosses the end of the buffer
+  std::vector<uint8_t> first = GetBytes(5000);
+  uint64_t value = random_->RandUint64();
+
+  random_->SetSeedForTesting(1);
+  EXPECT_EQ(first, GetBytes(5000));
+  EXPECT_EQ(value, random_->RandUint64());
+
+  random_->SetSeedForTesting(2);
+  EXPECT_NE(first, GetBytes(5000));
+}
+
+TEST_F(RandomServiceTest, Unseeded) {
+  EXPECT_NE(GetBytes(32), GetBytes(32));
+}
+
+TEST_F(RandomServiceTest, RandInt) {
+  random_->SetSeedForTesting(3);
+  std::vector<int> counts(6);
+  for (int i = 0; i < 6000; i++) {
+    uint64_t value = random_->RandInt(10, 15);
+    ASSERT_GE(value, 10u);
+    ASSERT_LE(value, 15u);
+    counts[value - 10]++;
+  }
+  for (int count : counts) {
+    EXPECT_GT(count, 800);
+  }
+
+  EXPECT_EQ(7u, random_->RandInt(7, 7));
+  random_->RandInt(0, UINT64_MAX);
+}
+
+}  // namespace
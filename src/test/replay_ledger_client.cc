@@ -0,0 +1,425 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "replay_ledger_client.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace bat_ledger {
+
+namespace {
+
+ledger::Result GetResult(const std::string& field) {
+  return static_cast<ledger::Result>(TraceFieldToUint64(field));
+}
+
+bool IsStateSave(const std::string& type) {
+  return type == "SaveLedgerState" ||
+      type == "SaveLedgerHistory" ||
+      type == "SavePublisherState" ||
+      type == "SavePublishersList";
+}
+
+}  // namespace
+
+ReplayStats::ReplayStats() :
+  calls(0),
+  unmatched(0),
+  mismatched(0),
+  state_bytes_written(0),
+  recorded_state_bytes_written(0) {}
+
+ReplayLedgerClient::Call::Call() : has_result(false) {}
+
+ReplayLedgerClient::Call::Call(const Call& call) :
+  call(call.call),
+  result(call.result),
+  has_result(call.has_result) {}
+
+ReplayLedgerClient::Call::~Call() {}
+
+ReplayLedgerClient::ReplayLedgerClient(
+    const std::vector<TraceRecord>& records) :
+  duration_(0) {
+  // call id -> position in its queue
+  std::map<uint64_t, std::pair<std::string, size_t>> positions;
+  for (const auto& record : records) {
+    duration_ = std::max(duration_, record.time);
+
+    if (record.direction == TraceRecord::CALL) {
+      if (IsStateSave(record.type) && !record.fields.empty()) {
+        stats_.recorded_state_bytes_written +=
+            TraceFieldToUint64(record.fields[0]);
+      }
+
+      auto& queue = calls_[record.type];
+      positions[record.call] = std::make_pair(record.type, queue.size());
+      Call call;
+      call.call = record;
+      // calls that return a value are complete without a result
+      call.has_result = record.type == "GenerateGUID" ||
+          record.type == "URIEncode";
+      queue.push_back(call);
+      continue;
+    }
+
+    auto position = positions.find(record.call);
+    if (position == positions.end()) {
+      continue;
+    }
+
+    Call& call = calls_[position->second.first][position->second.second];
+    call.result = record;
+    call.has_result = true;
+  }
+}
+
+ReplayLedgerClient::~ReplayLedgerClient() {
+}
+
+// static
+bool ReplayLedgerClient::ReadTrace(std::istream* stream,
+                                   std::vector<TraceRecord>* records) {
+  TraceRecord record;
+  while (ReadTraceRecord(stream, &record)) {
+    records->push_back(record);
+  }
+
+  return stream->eof();
+}
+
+void ReplayLedgerClient::Replay() {
+  ledger()->Initialize();
+  RunUntil(duration_);
+}
+
+ReplayStats ReplayLedgerClient::GetStats() const {
+  ReplayStats stats = stats_;
+  stats.state_bytes_written = state_bytes_written();
+  return stats;
+}
+
+uint64_t ReplayLedgerClient::duration() const {
+  return duration_;
+}
+
+bool ReplayLedgerClient::NextCall(const std::string& type,
+                                  const std::string& argument,
+                                  Call* call) const {
+  auto& queue = calls_[type];
+  // results that never came back can't be replayed
+  while (!queue.empty() && !queue.front().has_result) {
+    queue.pop_front();
+  }
+
+  if (queue.empty()) {
+    stats_.unmatched++;
+    return false;
+  }
+
+  *call = queue.front();
+  queue.pop_front();
+  stats_.calls++;
+
+  if (!argument.empty() &&
+      (call->call.fields.empty() || call->call.fields[0] != argument)) {
+    stats_.mismatched++;
+  }
+
+  return true;
+}
+
+// static
+uint64_t ReplayLedgerClient::GetLatency(const Call& call) {
+  return call.result.time > call.call.time ?
+      call.result.time - call.call.time : 0;
+}
+
+void ReplayLedgerClient::PostPublisherInfo(
+    const Call& call,
+    ledger::PublisherInfoCallback callback) {
+  const auto& fields = call.result.fields;
+  ledger::Result result = fields.empty() ?
+      ledger::Result::LEDGER_ERROR : GetResult(fields[0]);
+  std::unique_ptr<ledger::PublisherInfo> info;
+  if (fields.size() > 1 && !fields[1].empty()) {
+    info.reset(new ledger::PublisherInfo());
+    if (!DecodePublisherInfo(fields[1], info.get())) {
+      info.reset();
+    }
+  }
+
+  std::shared_ptr<ledger::PublisherInfo> shared_info(std::move(info));
+  Post(GetLatency(call), [callback, result, shared_info]() {
+    callback(result, shared_info ?
+        std::unique_ptr<ledger::PublisherInfo>(
+            new ledger::PublisherInfo(*shared_info)) :
+        nullptr);
+  });
+}
+
+void ReplayLedgerClient::PostPublisherInfoList(
+    const Call& call,
+    ledger::PublisherInfoListCallback callback) {
+  const auto& fields = call.result.fields;
+  uint32_t next_record = fields.empty() ?
+      0 : static_cast<uint32_t>(TraceFieldToUint64(fields[0]));
+  ledger::PublisherInfoList list;
+  for (size_t i = 1; i < fields.size(); i++) {
+    ledger::PublisherInfo info;
+    if (DecodePublisherInfo(fields[i], &info)) {
+      list.push_back(info);
+    }
+  }
+
+  Post(GetLatency(call), [callback, list, next_record]() {
+    callback(list, next_record);
+  });
+}
+
+std::string ReplayLedgerClient::GenerateGUID() const {
+  Call call;
+  if (!NextCall("GenerateGUID", "", &call) || call.call.fields.empty()) {
+    return MockLedgerClient::GenerateGUID();
+  }
+
+  return call.call.fields[0];
+}
+
+void ReplayLedgerClient::LoadLedgerState(
+    ledger::LedgerCallbackHandler* handler) {
+  Call call;
+  if (!NextCall("LoadLedgerState", "", &call) ||
+      call.result.fields.size() < 2) {
+    MockLedgerClient::LoadLedgerState(handler);
+    return;
+  }
+
+  ledger::Result result = GetResult(call.result.fields[0]);
+  std::string data = call.result.fields[1];
+  Post(GetLatency(call), [handler, result, data]() {
+    handler->OnLedgerStateLoaded(result, data);
+  });
+}
+
+void ReplayLedgerClient::LoadLedgerHistory(
+    ledger::LedgerCallbackHandler* handler) {
+  Call call;
+  if (!NextCall("LoadLedgerHistory", "", &call) ||
+      call.result.fields.size() < 2) {
+    MockLedgerClient::LoadLedgerHistory(handler);
+    return;
+  }
+
+  ledger::Result result = GetResult(call.result.fields[0]);
+  std::string data = call.result.fields[1];
+  Post(GetLatency(call), [handler, result, data]() {
+    handler->OnLedgerHistoryLoaded(result, data);
+  });
+}
+
+void ReplayLedgerClient::LoadPublisherState(
+    ledger::LedgerCallbackHandler* handler) {
+  Call call;
+  if (!NextCall("LoadPublisherState", "", &call) ||
+      call.result.fields.size() < 2) {
+    MockLedgerClient::LoadPublisherState(handler);
+    return;
+  }
+
+  ledger::Result result = GetResult(call.result.fields[0]);
+  std::string data = call.result.fields[1];
+  Post(GetLatency(call), [handler, result, data]() {
+    handler->OnPublisherStateLoaded(result, data);
+  });
+}
+
+void ReplayLedgerClient::LoadPublisherList(
+    ledger::LedgerCallbackHandler* handler) {
+  Call call;
+  if (!NextCall("LoadPublisherList", "", &call) ||
+      call.result.fields.size() < 2) {
+    MockLedgerClient::LoadPublisherList(handler);
+    return;
+  }
+
+  ledger::Result result = GetResult(call.result.fields[0]);
+  std::string data = call.result.fields[1];
+  Post(GetLatency(call), [handler, result, data]() {
+    handler->OnPublisherListLoaded(result, data);
+  });
+}
+
+void ReplayLedgerClient::LoadNicewareList(
+    ledger::GetNicewareListCallback callback) {
+  Call call;
+  if (!NextCall("LoadNicewareList", "", &call) ||
+      call.result.fields.size() < 2) {
+    MockLedgerClient::LoadNicewareList(callback);
+    return;
+  }
+
+  ledger::Result result = GetResult(call.result.fields[0]);
+  std::string data = call.result.fields[1];
+  Post(GetLatency(call), [callback, result, data]() {
+    callback(result, data);
+  });
+}
+
+void ReplayLedgerClient::SavePublisherInfo(
+    std::unique_ptr<ledger::PublisherInfo> publisher_info,
+    ledger::PublisherInfoCallback callback) {
+  Call call;
+  if (!NextCall("SavePublisherInfo", "", &call)) {
+    MockLedgerClient::SavePublisherInfo(std::move(publisher_info), callback);
+    return;
+  }
+
+  PostPublisherInfo(call, callback);
+}
+
+void ReplayLedgerClient::LoadPublisherInfo(
+    ledger::PublisherInfoFilter filter,
+    ledger::PublisherInfoCallback callback) {
+  Call call;
+  if (!NextCall("LoadPublisherInfo", filter.id, &call)) {
+    MockLedgerClient::LoadPublisherInfo(filter, callback);
+    return;
+  }
+
+  PostPublisherInfo(call, callback);
+}
+
+void ReplayLedgerClient::LoadMediaPublisherInfo(
+    const std::string& media_key,
+    ledger::PublisherInfoCallback callback) {
+  Call call;
+  if (!NextCall("LoadMediaPublisherInfo", media_key, &call)) {
+    MockLedgerClient::LoadMediaPublisherInfo(media_key, callback);
+    return;
+  }
+
+  PostPublisherInfo(call, callback);
+}
+
+void ReplayLedgerClient::LoadPublisherInfoList(
+    uint32_t start,
+    uint32_t limit,
+    ledger::PublisherInfoFilter filter,
+    ledger::PublisherInfoListCallback callback) {
+  Call call;
+  if (!NextCall("LoadPublisherInfoList", std::to_string(start), &call)) {
+    MockLedgerClient::LoadPublisherInfoList(start, limit, filter, callback);
+    return;
+  }
+
+  PostPublisherInfoList(call, callback);
+}
+
+void ReplayLedgerClient::FetchFavIcon(const std::string& url,
+                                      const std::string& favicon_key,
+                                      ledger::FetchIconCallback callback) {
+  Call call;
+  if (!NextCall("FetchFavIcon", url, &call) ||
+      call.result.fields.size() < 2) {
+    MockLedgerClient::FetchFavIcon(url, favicon_key, callback);
+    return;
+  }
+
+  bool success = call.result.fields[0] == "1";
+  std::string favicon_url = call.result.fields[1];
+  Post(GetLatency(call), [callback, success, favicon_url]() {
+    callback(success, favicon_url);
+  });
+}
+
+void ReplayLedgerClient::GetRecurringDonations(
+    ledger::PublisherInfoListCallback callback) {
+  Call call;
+  if (!NextCall("GetRecurringDonations", "", &call)) {
+    MockLedgerClient::GetRecurringDonations(callback);
+    return;
+  }
+
+  PostPublisherInfoList(call, callback);
+}
+
+void ReplayLedgerClient::OnRemoveRecurring(
+    const std::string& publisher_key,
+    ledger::RecurringRemoveCallback callback) {
+  Call call;
+  if (!NextCall("OnRemoveRecurring", publisher_key, &call) ||
+      call.result.fields.empty()) {
+    MockLedgerClient::OnRemoveRecurring(publisher_key, callback);
+    return;
+  }
+
+  ledger::Result result = GetResult(call.result.fields[0]);
+  Post(GetLatency(call), [callback, result]() {
+    callback(result);
+  });
+}
+
+std::string ReplayLedgerClient::URIEncode(const std::string& value) {
+  Call call;
+  if (!NextCall("URIEncode", value, &call) || call.call.fields.size() < 2) {
+    return MockLedgerClient::URIEncode(value);
+  }
+
+  return call.call.fields[1];
+}
+
+std::unique_ptr<ledger::LedgerURLLoader> ReplayLedgerClient::LoadURL(
+    const std::string& url,
+    const std::vector<std::string>& headers,
+    const std::string& content,
+    const std::string& contentType,
+    const ledger::URL_METHOD& method,
+    ledger::LedgerCallbackHandler* handler) {
+  auto loader = MockLedgerClient::LoadURL(url, headers, content, contentType,
+                                          method, handler);
+  // matched in call order, scheduler can start them in another order
+  Call call;
+  if (NextCall("LoadURL", url, &call) && call.result.fields.size() >= 4) {
+    url_requests_[loader->request_id()] = call;
+  }
+
+  return loader;
+}
+
+void ReplayLedgerClient::OnURLRequestStarted(
+    uint64_t request_id,
+    const std::string& url,
+    const std::string& content,
+    ledger::URL_METHOD method,
+    ledger::LedgerCallbackHandler* handler) {
+  auto iter = url_requests_.find(request_id);
+  if (iter == url_requests_.end()) {
+    MockLedgerClient::OnURLRequestStarted(request_id, url, content, method,
+                                          handler);
+    return;
+  }
+
+  const auto& fields = iter->second.result.fields;
+  int response_code = static_cast<int>(TraceFieldToUint64(fields[1]));
+  std::string response = fields[2];
+  std::map<std::string, std::string> headers;
+  std::vector<std::string> header_fields;
+  if (DecodeTraceFields(fields[3], &header_fields)) {
+    for (size_t i = 0; i + 1 < header_fields.size(); i += 2) {
+      headers[header_fields[i]] = header_fields[i + 1];
+    }
+  }
+
+  uint64_t latency = GetLatency(iter->second);
+  url_requests_.erase(iter);
+  Post(latency, [handler, request_id, url, response_code, response,
+                 headers]() {
+    handler->OnURLRequestResponse(request_id, url, response_code, response,
+                                  headers);
+  });
+}
+
+}  // namespace bat_ledger
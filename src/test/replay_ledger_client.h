@@ -0,0 +1,127 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef BAT_LEDGER_REPLAY_LEDGER_CLIENT_
+#define BAT_LEDGER_REPLAY_LEDGER_CLIENT_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <deque>
+#include <istream>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "ledger_trace.h"
+#include "mock_ledger_client.h"
+
+namespace bat_ledger {
+
+struct ReplayStats {
+  ReplayStats();
+
+  size_t calls;  // calls that had a result in the trace
+  size_t unmatched;  // calls the trace has no more results for
+  size_t mismatched;  // calls with other arguments than were recorded
+  uint64_t state_bytes_written;
+  uint64_t recorded_state_bytes_written;
+};
+
+// Feeds results of a trace that was written by ledger::LedgerClientRecorder
+// back to the ledger. Calls are matched to the recorded ones by type and
+// order, results are delivered after the recorded latency in virtual time
+// and host timers fire on the virtual clock. Calls without a recorded
+// result fall back to the in-memory MockLedgerClient.
+class ReplayLedgerClient : public MockLedgerClient {
+ public:
+  explicit ReplayLedgerClient(const std::vector<TraceRecord>& records);
+  ~ReplayLedgerClient() override;
+
+  // Returns false when the trace is malformed
+  static bool ReadTrace(std::istream* stream,
+                        std::vector<TraceRecord>* records);
+
+  // Initializes the ledger and runs until the end of the recording
+  void Replay();
+
+  ReplayStats GetStats() const;
+  // Time of the last record
+  uint64_t duration() const;
+
+  // ledger::LedgerClient
+  std::string GenerateGUID() const override;
+  void LoadLedgerState(ledger::LedgerCallbackHandler* handler) override;
+  void LoadLedgerHistory(ledger::LedgerCallbackHandler* handler) override;
+  void LoadPublisherState(ledger::LedgerCallbackHandler* handler) override;
+  void LoadPublisherList(ledger::LedgerCallbackHandler* handler) override;
+  void LoadNicewareList(ledger::GetNicewareListCallback callback) override;
+  void SavePublisherInfo(std::unique_ptr<ledger::PublisherInfo> publisher_info,
+                         ledger::PublisherInfoCallback callback) override;
+  void LoadPublisherInfo(ledger::PublisherInfoFilter filter,
+                         ledger::PublisherInfoCallback callback) override;
+  void LoadMediaPublisherInfo(const std::string& media_key,
+                              ledger::PublisherInfoCallback callback) override;
+  void LoadPublisherInfoList(
+      uint32_t start,
+      uint32_t limit,
+      ledger::PublisherInfoFilter filter,
+      ledger::PublisherInfoListCallback callback) override;
+  void FetchFavIcon(const std::string& url,
+                    const std::string& favicon_key,
+                    ledger::FetchIconCallback callback) override;
+  void GetRecurringDonations(
+      ledger::PublisherInfoListCallback callback) override;
+  void OnRemoveRecurring(const std::string& publisher_key,
+                         ledger::RecurringRemoveCallback callback) override;
+  std::string URIEncode(const std::string& value) override;
+  std::unique_ptr<ledger::LedgerURLLoader> LoadURL(
+      const std::string& url,
+      const std::vector<std::string>& headers,
+      const std::string& content,
+      const std::string& contentType,
+      const ledger::URL_METHOD& method,
+      ledger::LedgerCallbackHandler* handler) override;
+
+ protected:
+  void OnURLRequestStarted(uint64_t request_id,
+                           const std::string& url,
+                           const std::string& content,
+                           ledger::URL_METHOD method,
+                           ledger::LedgerCallbackHandler* handler) override;
+
+ private:
+  struct Call {
+    Call();
+    Call(const Call& call);
+    ~Call();
+
+    TraceRecord call;
+    TraceRecord result;
+    bool has_result;
+  };
+
+  // Takes the next recorded call of |type|, |argument| is compared to the
+  // first recorded field when it's set. Returns false when the trace has
+  // no more calls of |type| with a result.
+  bool NextCall(const std::string& type,
+                const std::string& argument,
+                Call* call) const;
+  static uint64_t GetLatency(const Call& call);
+  void PostPublisherInfo(const Call& call,
+                         ledger::PublisherInfoCallback callback);
+  void PostPublisherInfoList(const Call& call,
+                             ledger::PublisherInfoListCallback callback);
+
+  // GenerateGUID() is const
+  mutable std::map<std::string, std::deque<Call>> calls_;
+  mutable ReplayStats stats_;
+  std::map<uint64_t, Call> url_requests_;
+  uint64_t duration_;
+};
+
+}  // namespace bat_ledger
+
+#endif  // BAT_LEDGER_REPLAY_LEDGER_CLIENT_
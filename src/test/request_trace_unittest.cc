@@ -0,0 +1,145 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include <string.h>
+
+#include <algorithm>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "brave/vendor/bat-native-ledger/src/request_trace.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace {
+
+bat_ledger::RequestTraceRecord GetRecord(uint64_t request_id) {
+  bat_ledger::RequestTraceRecord record = {};
+  record.request_id = request_id;
+  return record;
+}
+
+TEST(RequestTraceTest, DrainsInOrder) {
+  bat_ledger::RequestTraceBuffer buffer(3);
+  EXPECT_EQ(4u, buffer.capacity());
+
+  for (uint64_t i = 1; i <= 6; i++) {
+    buffer.Push(GetRecord(i));
+  }
+  EXPECT_EQ(4u, buffer.size());
+  EXPECT_EQ(2u, buffer.dropped());
+
+  std::vector<bat_ledger::RequestTraceRecord> records;
+  EXPECT_EQ(3u, buffer.Drain(&records, 3));
+  EXPECT_TRUE(buffer.Push(GetRecord(7)));
+  EXPECT_EQ(2u, buffer.Drain(&records, 10));
+  EXPECT_EQ(0u, buffer.Drain(&records, 10));
+
+  ASSERT_EQ(5u, records.size());
+  EXPECT_EQ(1u, records[0].request_id);
+  EXPECT_EQ(4u, records[3].request_id);
+  EXPECT_EQ(7u, records[4].request_id);
+}
+
+TEST(RequestTraceTest, ConcurrentPushes) {
+  const size_t kThreads = 4;
+  const size_t kRecords = 10000;
+  bat_ledger::RequestTraceBuffer buffer(256);
+
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < kThreads; i++) {
+    threads.push_back(std::thread([&buffer, i, kRecords]() {
+      for (size_t j = 0; j < kRecords; j++) {
+        buffer.Push(GetRecord(i * kRecords + j));
+      }
+    }));
+  }
+
+  // every record is either drained or dropped
+  std::vector<bat_ledger::RequestTraceRecord> records;
+  size_t drained = 0;
+  while (drained + buffer.dropped() < kThreads * kRecords) {
+    drained += buffer.Drain(&records, 64);
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  drained += buffer.Drain(&records, kThreads * kRecords);
+
+  EXPECT_EQ(kThreads * kRecords, drained + buffer.dropped());
+  EXPECT_EQ(drained, records.size());
+}
+
+TEST(RequestTraceTest, Requests) {
+  bat_ledger::RequestTrace trace(16);
+  trace.OnRequestStarted(1, "https://example.com/", 0);
+  trace.OnRequestFinished(1, 200, "{}");
+  EXPECT_EQ(0u, trace.buffer()->size());
+
+  trace.SetEnabled(true);
+  trace.SetPreviewEnabled(true);
+  trace.OnRequestStarted(2,
+      "https://ledger.mercury.basicattentiontoken.org/v2/wallet/id?refresh=true",
+      10);
+  trace.OnRequestStarted(3, "https://example.com/", 0);
+  const std::string response = "{\"balance\":\"25.0\"}\n" +
+      std::string(1000, ' ');
+  trace.OnRequestFinished(2, 200, response);
+  trace.OnRequestCancelled(3);
+
+  std::vector<bat_ledger::RequestTraceRecord> records;
+  ASSERT_EQ(2u, trace.buffer()->Drain(&records, 10));
+  EXPECT_EQ(200, records[0].status);
+  EXPECT_EQ(10u, records[0].request_size);
+  EXPECT_EQ(response.size(), records[0].response_size);
+  EXPECT_EQ(bat_ledger::RequestTrace::HashBody(response),
+            records[0].body_hash);
+  EXPECT_EQ(bat_ledger::RequestTraceRecord::kPreviewSize - 1,
+            strlen(records[0].preview));
+  EXPECT_EQ(-1, records[1].status);
+
+  std::string batch = trace.Format(records);
+  EXPECT_NE(std::string::npos, batch.find(
+      "endpoint=ledger.mercury.basicattentiontoken.org/wallet status=200"));
+  EXPECT_NE(std::string::npos,
+            batch.find("endpoint=example.com status=-1"));
+  // preview newlines don't break the lines
+  EXPECT_EQ(2, std::count(batch.begin(), batch.end(), '\n'));
+}
+
+TEST(RequestTraceTest, NoPreviewByDefault) {
+  bat_ledger::RequestTrace trace(16);
+  trace.SetEnabled(true);
+  trace.OnRequestStarted(1, "https://example.com/", 0);
+  trace.OnRequestFinished(1, 200, "{\"paymentId\":\"secret\"}");
+
+  std::vector<bat_ledger::RequestTraceRecord> records;
+  ASSERT_EQ(1u, trace.buffer()->Drain(&records, 10));
+  EXPECT_EQ('\0', records[0].preview[0]);
+
+  std::string batch = trace.Format(records);
+  EXPECT_NE(std::string::npos, batch.find("hash="));
+  EXPECT_EQ(std::string::npos, batch.find("preview="));
+  EXPECT_EQ(std::string::npos, batch.find("secret"));
+}
+
+TEST(RequestTraceTest, HashesPrefixAndSize) {
+  const size_t hashed = bat_ledger::RequestTraceRecord::kHashedSize;
+  const std::string body(hashed, 'a');
+  const uint64_t hash = bat_ledger::RequestTrace::HashBody(body);
+
+  EXPECT_NE(hash, bat_ledger::RequestTrace::HashBody(body.substr(1)));
+  EXPECT_NE(hash, bat_ledger::RequestTrace::HashBody("b" + body.substr(1)));
+  // only the size tells these apart
+  EXPECT_NE(hash, bat_ledger::RequestTrace::HashBody(body + "a"));
+  EXPECT_NE(bat_ledger::RequestTrace::HashBody(body + "a"),
+            bat_ledger::RequestTrace::HashBody(body + "aa"));
+  // bytes after the prefix aren't read
+  EXPECT_EQ(bat_ledger::RequestTrace::HashBody(body + "a"),
+            bat_ledger::RequestTrace::HashBody(body + "b"));
+  EXPECT_NE(bat_ledger::RequestTrace::HashBody(""),
+            bat_ledger::RequestTrace::HashBody(std::string(1, '\0')));
+}
+
+}  // namespace
@@ -0,0 +1,148 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "brave/vendor/bat-native-ledger/src/timer_service.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace {
+
+// Host side of LedgerClient::SetTimer with virtual time
+class TimerServiceTest : public ::testing::Test {
+ protected:
+  TimerServiceTest() :
+    now_(0),
+    next_host_id_(1),
+    service_(std::bind(&TimerServiceTest::SetHostTimer, this,
+                       std::placeholders::_1, std::placeholders::_2),
+             5) {}
+
+  void SetHostTimer(uint64_t delay, uint32_t* timer_id) {
+    *timer_id = next_host_id_++;
+    host_timers_.insert(std::make_pair(now_ + delay, *timer_id));
+  }
+
+  // Fires host timers that are due in the next |seconds|
+  void Advance(uint64_t seconds) {
+    uint64_t end = now_ + seconds;
+    while (!host_timers_.empty() && host_timers_.begin()->first <= end) {
+      now_ = host_timers_.begin()->first;
+      uint32_t id = host_timers_.begin()->second;
+      host_timers_.erase(host_timers_.begin());
+      service_.OnHostTimer(id, now_);
+    }
+    now_ = end;
+  }
+
+  uint32_t Start(uint64_t delay, const std::string& name) {
+    return service_.Start(delay, now_, [this, name]() {
+      fired_.push_back(name + "@" + std::to_string(now_));
+    });
+  }
+
+  uint64_t now_;
+  uint32_t next_host_id_;
+  std::multimap<uint64_t, uint32_t> host_timers_;
+  std::vector<std::string> fired_;
+  bat_ledger::TimerService service_;
+};
+
+TEST_F(TimerServiceTest, FiresInDeadlineOrder) {
+  Start(100, "c");
+  Start(10, "a");
+  Start(50, "b");
+
+  // "a" was earlier than the armed host timer, "b" wasn't
+  EXPECT_EQ(2u, host_timers_.size());
+
+  Advance(1000);
+  ASSERT_EQ(3u, fired_.size());
+  EXPECT_EQ("a@10", fired_[0]);
+  EXPECT_EQ("b@50", fired_[1]);
+  EXPECT_EQ("c@100", fired_[2]);
+  EXPECT_EQ(0u, service_.size());
+}
+
+TEST_F(TimerServiceTest, LaterTimersShareHostTimer) {
+  Start(10, "a");
+  Start(20, "b");
+  Start(30, "c");
+  EXPECT_EQ(1u, host_timers_.size());
+
+  Advance(1000);
+  EXPECT_EQ(3u, fired_.size());
+}
+
+TEST_F(TimerServiceTest, CoalescesNearbyDeadlines) {
+  Start(10, "a");
+  Start(14, "b");
+  Start(16, "c");
+
+  Advance(1000);
+  ASSERT_EQ(3u, fired_.size());
+  EXPECT_EQ("a@10", fired_[0]);
+  EXPECT_EQ("b@10", fired_[1]);
+  EXPECT_EQ("c@16", fired_[2]);
+}
+
+TEST_F(TimerServiceTest, Cancel) {
+  uint32_t a = Start(10, "a");
+  Start(20, "b");
+
+  EXPECT_TRUE(service_.IsRunning(a));
+  EXPECT_TRUE(service_.Cancel(a));
+  EXPECT_FALSE(service_.Cancel(a));
+  EXPECT_FALSE(service_.IsRunning(a));
+
+  Advance(1000);
+  ASSERT_EQ(1u, fired_.size());
+  EXPECT_EQ("b@20", fired_[0]);
+}
+
+TEST_F(TimerServiceTest, CallbackStartsTimer) {
+  service_.Start(10, now_, [this]() {
+    fired_.push_back("a");
+    Start(0, "b");
+    Start(30, "c");
+  });
+
+  Advance(1000);
+  ASSERT_EQ(3u, fired_.size());
+  EXPECT_EQ("b@10", fired_[1]);
+  EXPECT_EQ("c@40", fired_[2]);
+}
+
+TEST_F(TimerServiceTest, HostTimerAheadOfClock) {
+  bool fired = false;
+  service_.Start(100, 1000, [&fired]() { fired = true; });
+  ASSERT_EQ(1u, host_timers_.size());
+
+  // wall clock is still behind when host timer fires
+  uint32_t id = host_timers_.begin()->second;
+  host_timers_.clear();
+  service_.OnHostTimer(id, 1050);
+  EXPECT_TRUE(fired);
+  EXPECT_TRUE(host_timers_.empty());
+}
+
+TEST_F(TimerServiceTest, ManyCancelledTimers) {
+  std::vector<uint32_t> handles;
+  for (int i = 0; i < 1000; i++) {
+    handles.push_back(Start(1000 + i, "x"));
+  }
+  for (uint32_t handle : handles) {
+    EXPECT_TRUE(service_.Cancel(handle));
+  }
+  Start(10, "a");
+
+  Advance(10000);
+  ASSERT_EQ(1u, fired_.size());
+  EXPECT_EQ("a@10", fired_[0]);
+}
+
+}  // namespace
@@ -0,0 +1,359 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "brave/vendor/bat-native-ledger/src/ledger_impl.h"
+#include "brave/vendor/bat-native-ledger/src/test/mock_ledger_client.h"
+#include "brave/vendor/bat-native-ledger/src/url_request_handler.h"
+#include "brave/vendor/bat-native-ledger/src/url_request_scheduler.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace {
+
+// Stands in for the network side of LedgerClient::LoadURL. Every request
+// takes |latency| ticks of virtual time from Start() until the response.
+class FakeNetwork {
+ public:
+  explicit FakeNetwork(uint64_t latency) :
+    latency_(latency),
+    now_(0),
+    next_id_(1),
+    in_flight_(0),
+    max_in_flight_(0) {}
+
+  std::unique_ptr<ledger::LedgerURLLoader> LoadURL(
+      const std::string& url,
+      ledger::LedgerCallbackHandler* handler,
+      bat_ledger::URLRequestScheduler* scheduler) {
+    uint64_t id = next_id_++;
+    scheduler->SetRequestURL(id, url);
+    return std::unique_ptr<ledger::LedgerURLLoader>(
+        new Loader(this, id, url, handler));
+  }
+
+  // Delivers responses that are due in the next |ticks|
+  void Advance(uint64_t ticks) {
+    uint64_t end = now_ + ticks;
+    while (!pending_.empty() && pending_.begin()->first <= end) {
+      auto response = pending_.begin()->second;
+      now_ = pending_.begin()->first;
+      pending_.erase(pending_.begin());
+      in_flight_--;
+      response.handler->OnURLRequestResponse(
+          response.id, response.url, 200, "{}", {});
+    }
+    now_ = end;
+  }
+
+  const std::vector<std::string>& started() const { return started_; }
+  size_t in_flight() const { return in_flight_; }
+  size_t max_in_flight() const { return max_in_flight_; }
+
+ private:
+  struct Response {
+    uint64_t id;
+    std::string url;
+    ledger::LedgerCallbackHandler* handler;
+  };
+
+  class Loader : public ledger::LedgerURLLoader {
+   public:
+    Loader(FakeNetwork* network,
+           uint64_t id,
+           const std::string& url,
+           ledger::LedgerCallbackHandler* handler) :
+      network_(network),
+      id_(id),
+      url_(url),
+      handler_(handler) {}
+
+    void Start() override {
+      network_->started_.push_back(url_);
+      network_->in_flight_++;
+      if (network_->in_flight_ > network_->max_in_flight_) {
+        network_->max_in_flight_ = network_->in_flight_;
+      }
+      network_->pending_.insert(std::make_pair(
+          network_->now_ + network_->latency_,
+          Response{id_, url_, handler_}));
+    }
+
+    uint64_t request_id() override { return id_; }
+
+   private:
+    FakeNetwork* network_;
+    uint64_t id_;
+    std::string url_;
+    ledger::LedgerCallbackHandler* handler_;
+  };
+
+  uint64_t latency_;
+  uint64_t now_;
+  uint64_t next_id_;
+  size_t in_flight_;
+  size_t max_in_flight_;
+  std::multimap<uint64_t, Response> pending_;
+  std::vector<std::string> started_;
+};
+
+class URLRequestSchedulerTest : public ::testing::Test {
+ protected:
+  URLRequestSchedulerTest() :
+    network_(10),
+    scheduler_(3, 2),
+    handler_(&scheduler_, bat_ledger::URLRequestPriority::PANEL),
+    completed_(0) {}
+
+  uint64_t Load(const std::string& url,
+                bat_ledger::URLRequestPriority priority) {
+    return Load(&handler_, url, priority);
+  }
+
+  uint64_t Load(bat_ledger::URLRequestHandler* handler,
+                const std::string& url,
+                bat_ledger::URLRequestPriority priority) {
+    auto loader = network_.LoadURL(url, handler, &scheduler_);
+    uint64_t id = loader->request_id();
+    handler->AddRequestHandler(std::move(loader),
+        [this](bool success,
+               const std::string& response,
+               const std::map<std::string, std::string>& headers) {
+          completed_++;
+        },
+        priority);
+    return id;
+  }
+
+  FakeNetwork network_;
+  bat_ledger::URLRequestScheduler scheduler_;
+  bat_ledger::URLRequestHandler handler_;
+  int completed_;
+};
+
+TEST_F(URLRequestSchedulerTest, GlobalLimit) {
+  for (int i = 0; i < 10; i++) {
+    Load("https://host" + std::to_string(i) + ".com/",
+         bat_ledger::URLRequestPriority::PANEL);
+  }
+
+  EXPECT_EQ(3u, network_.in_flight());
+  EXPECT_EQ(7u, scheduler_.queued_count());
+
+  network_.Advance(100);
+  EXPECT_EQ(10, completed_);
+  EXPECT_EQ(3u, network_.max_in_flight());
+  EXPECT_EQ(0u, scheduler_.active_count());
+  EXPECT_EQ(0u, scheduler_.queued_count());
+}
+
+TEST_F(URLRequestSchedulerTest, PerHostLimit) {
+  for (int i = 0; i < 4; i++) {
+    Load("https://ledger.mercury.basicattentiontoken.org/v2/wallet/" +
+         std::to_string(i), bat_ledger::URLRequestPriority::PANEL);
+  }
+  Load("https://publishers.basicattentiontoken.org/api/v1/public/channels",
+       bat_ledger::URLRequestPriority::BACKGROUND);
+
+  // 2 for the ledger host and the other host fills the last slot
+  EXPECT_EQ(3u, network_.in_flight());
+  EXPECT_EQ(
+      "https://publishers.basicattentiontoken.org/api/v1/public/channels",
+      network_.started()[2]);
+
+  network_.Advance(100);
+  EXPECT_EQ(5, completed_);
+}
+
+TEST_F(URLRequestSchedulerTest, Priorities) {
+  // fill all the slots
+  for (int i = 0; i < 3; i++) {
+    Load("https://busy" + std::to_string(i) + ".com/",
+         bat_ledger::URLRequestPriority::PANEL);
+  }
+
+  Load("https://a.com/background", bat_ledger::URLRequestPriority::BACKGROUND);
+  Load("https://b.com/panel", bat_ledger::URLRequestPriority::PANEL);
+  Load("https://c.com/contribution",
+       bat_ledger::URLRequestPriority::CONTRIBUTION);
+
+  network_.Advance(10);
+  ASSERT_EQ(6u, network_.started().size());
+  EXPECT_EQ("https://c.com/contribution", network_.started()[3]);
+  EXPECT_EQ("https://b.com/panel", network_.started()[4]);
+  EXPECT_EQ("https://a.com/background", network_.started()[5]);
+}
+
+TEST_F(URLRequestSchedulerTest, CancelQueued) {
+  uint64_t first = 0;
+  for (int i = 0; i < 3; i++) {
+    uint64_t id = Load("https://busy" + std::to_string(i) + ".com/",
+                       bat_ledger::URLRequestPriority::PANEL);
+    if (i == 0) {
+      first = id;
+    }
+  }
+  uint64_t queued = Load("https://a.com/",
+                         bat_ledger::URLRequestPriority::BACKGROUND);
+
+  // started requests can't be cancelled
+  EXPECT_FALSE(handler_.CancelRequest(first));
+  EXPECT_TRUE(handler_.CancelRequest(queued));
+  EXPECT_FALSE(handler_.CancelRequest(queued));
+
+  network_.Advance(100);
+  EXPECT_EQ(3, completed_);
+  EXPECT_EQ(3u, network_.started().size());
+}
+
+TEST_F(URLRequestSchedulerTest, ClearReleasesStartedRequests) {
+  for (int i = 0; i < 4; i++) {
+    Load("https://host" + std::to_string(i) + ".com/",
+         bat_ledger::URLRequestPriority::PANEL);
+  }
+  EXPECT_EQ(3u, scheduler_.active_count());
+  EXPECT_EQ(1u, scheduler_.queued_count());
+
+  // nobody waits for the started requests anymore
+  handler_.Clear();
+  EXPECT_EQ(0u, scheduler_.active_count());
+  EXPECT_EQ(0u, scheduler_.queued_count());
+  EXPECT_EQ(3u, network_.started().size());
+
+  Load("https://next.com/", bat_ledger::URLRequestPriority::PANEL);
+  EXPECT_EQ(1u, scheduler_.active_count());
+  EXPECT_EQ(4u, network_.started().size());
+
+  // the responses of the cleared requests don't take the slot of another
+  network_.Advance(100);
+  EXPECT_EQ(1, completed_);
+  EXPECT_EQ(0u, scheduler_.active_count());
+}
+
+TEST_F(URLRequestSchedulerTest, DestroyedHandlerReleasesSlots) {
+  {
+    bat_ledger::URLRequestHandler handler(
+        &scheduler_, bat_ledger::URLRequestPriority::PANEL);
+    for (int i = 0; i < 2; i++) {
+      Load(&handler, "https://ledger.com/" + std::to_string(i),
+           bat_ledger::URLRequestPriority::PANEL);
+    }
+    Load(&handler, "https://ledger.com/queued",
+         bat_ledger::URLRequestPriority::PANEL);
+    EXPECT_EQ(2u, scheduler_.active_count());
+    EXPECT_EQ(1u, scheduler_.queued_count());
+  }
+
+  // the queued request is not started in one of the released slots
+  EXPECT_EQ(0u, scheduler_.active_count());
+  EXPECT_EQ(0u, scheduler_.queued_count());
+  EXPECT_EQ(2u, network_.started().size());
+
+  // the per host slots are free too
+  for (int i = 0; i < 2; i++) {
+    Load("https://ledger.com/next" + std::to_string(i),
+         bat_ledger::URLRequestPriority::PANEL);
+  }
+  EXPECT_EQ(2u, scheduler_.active_count());
+  EXPECT_EQ(0u, scheduler_.queued_count());
+}
+
+TEST_F(URLRequestSchedulerTest, ForgetsUnscheduledURLs) {
+  auto discarded = network_.LoadURL("https://a.com/", &handler_, &scheduler_);
+  auto finished = network_.LoadURL("https://b.com/", &handler_, &scheduler_);
+  auto cancelled = network_.LoadURL("https://c.com/", &handler_, &scheduler_);
+  EXPECT_EQ(3u, scheduler_.unscheduled_count());
+
+  // never scheduled
+  scheduler_.Discard(discarded->request_id());
+  EXPECT_EQ(2u, scheduler_.unscheduled_count());
+
+  // started without the scheduler
+  finished->Start();
+  network_.Advance(100);
+  EXPECT_EQ(1u, scheduler_.unscheduled_count());
+
+  EXPECT_FALSE(scheduler_.Cancel(cancelled->request_id()));
+  EXPECT_EQ(0u, scheduler_.unscheduled_count());
+
+  Load("https://d.com/", bat_ledger::URLRequestPriority::PANEL);
+  EXPECT_EQ(0u, scheduler_.unscheduled_count());
+}
+
+// Records the requests that the stand-in network of MockLedgerClient starts
+class StartedRequestsClient : public bat_ledger::MockLedgerClient {
+ public:
+  StartedRequestsClient() {
+    delay_ = 10;
+  }
+
+  void OnURLRequestStarted(uint64_t request_id,
+                           const std::string& url,
+                           const std::string& content,
+                           ledger::URL_METHOD method,
+                           ledger::LedgerCallbackHandler* handler) override {
+    started_.push_back(url);
+    MockLedgerClient::OnURLRequestStarted(
+        request_id, url, content, method, handler);
+  }
+
+  const std::vector<std::string>& started() const { return started_; }
+
+ private:
+  std::vector<std::string> started_;
+};
+
+TEST(URLRequestSchedulerLedgerTest, ResponsesReleaseSlots) {
+  StartedRequestsClient client;
+  bat_ledger::LedgerImpl* ledger =
+      static_cast<bat_ledger::LedgerImpl*>(client.ledger());
+  bat_ledger::URLRequestScheduler* scheduler =
+      ledger->GetURLRequestScheduler();
+  bat_ledger::URLRequestHandler handler(
+      scheduler, bat_ledger::URLRequestPriority::PANEL);
+
+  std::vector<int> response_codes;
+  for (int i = 0; i < 4; i++) {
+    auto loader = ledger->LoadURL(
+        "https://ledger.mercury.basicattentiontoken.org/v2/wallet/" +
+            std::to_string(i),
+        {}, "", "", ledger::URL_METHOD::GET, &handler);
+    handler.AddResponseHandler(std::move(loader),
+        [&response_codes](int response_code,
+                          const std::string& response,
+                          const std::map<std::string, std::string>& headers) {
+          response_codes.push_back(response_code);
+        });
+  }
+
+  // per host limit of the ledger
+  EXPECT_EQ(2u, client.started().size());
+  EXPECT_EQ(2u, scheduler->active_count());
+  EXPECT_EQ(2u, scheduler->queued_count());
+
+  // each response frees the slot for a queued request
+  client.RunUntil(10);
+  EXPECT_EQ(2u, response_codes.size());
+  EXPECT_EQ(4u, client.started().size());
+  EXPECT_EQ(2u, scheduler->active_count());
+  EXPECT_EQ(0u, scheduler->queued_count());
+
+  client.RunUntil(20);
+  EXPECT_EQ(std::vector<int>({404, 404, 404, 404}), response_codes);
+  EXPECT_EQ(0u, scheduler->active_count());
+}
+
+TEST(URLRequestSchedulerHostTest, GetHost) {
+  EXPECT_EQ("example.com",
+            bat_ledger::URLRequestScheduler::GetHost("https://example.com"));
+  EXPECT_EQ("example.com", bat_ledger::URLRequestScheduler::GetHost(
+      "https://example.com:8080/path?query"));
+  EXPECT_EQ("example.com", bat_ledger::URLRequestScheduler::GetHost(
+      "https://example.com?query"));
+}
+
+}  // namespace
@@ -0,0 +1,87 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "brave/vendor/bat-native-ledger/src/url_response_cache.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace {
+
+const char kURL[] = "https://ledger.mercury.basicattentiontoken.org/balance";
+
+TEST(URLResponseCacheTest, ConditionalHeaders) {
+  bat_ledger::URLResponseCache cache;
+  std::vector<std::string> headers;
+  cache.AddConditionalHeaders(kURL, &headers);
+  EXPECT_TRUE(headers.empty());
+
+  cache.OnResponse(kURL, 200,
+                   {{"ETag", "\"abc\""},
+                    {"last-modified", "Wed, 21 Oct 2015 07:28:00 GMT"}},
+                   0, 100);
+  cache.AddConditionalHeaders(kURL, &headers);
+  ASSERT_EQ(2u, headers.size());
+  EXPECT_EQ("If-None-Match: \"abc\"", headers[0]);
+  EXPECT_EQ("If-Modified-Since: Wed, 21 Oct 2015 07:28:00 GMT", headers[1]);
+
+  // 304 without validators keeps the old ones
+  cache.OnResponse(kURL, 304, {}, 0, 200);
+  std::string etag;
+  std::string last_modified;
+  EXPECT_TRUE(cache.GetValidators(kURL, &etag, &last_modified));
+  EXPECT_EQ("\"abc\"", etag);
+
+  cache.Remove(kURL);
+  EXPECT_FALSE(cache.GetValidators(kURL, &etag, &last_modified));
+}
+
+TEST(URLResponseCacheTest, NewRepresentationReplacesValidators) {
+  bat_ledger::URLResponseCache cache;
+  cache.OnResponse(kURL, 200,
+                   {{"ETag", "\"abc\""},
+                    {"Last-Modified", "Wed, 21 Oct 2015 07:28:00 GMT"}},
+                   0, 100);
+
+  // 304 that only repeats the etag keeps the date
+  cache.OnResponse(kURL, 304, {{"ETag", "\"abd\""}}, 0, 150);
+  std::string etag;
+  std::string last_modified;
+  ASSERT_TRUE(cache.GetValidators(kURL, &etag, &last_modified));
+  EXPECT_EQ("\"abd\"", etag);
+  EXPECT_EQ("Wed, 21 Oct 2015 07:28:00 GMT", last_modified);
+
+  // validators of the replaced representation are not sent again
+  cache.OnResponse(kURL, 200, {}, 0, 200);
+  EXPECT_FALSE(cache.GetValidators(kURL, &etag, &last_modified));
+  std::vector<std::string> headers;
+  cache.AddConditionalHeaders(kURL, &headers);
+  EXPECT_TRUE(headers.empty());
+
+  cache.OnResponse(kURL, 200, {{"ETag", "\"xyz\""}}, 0, 300);
+  cache.AddConditionalHeaders(kURL, &headers);
+  ASSERT_EQ(1u, headers.size());
+  EXPECT_EQ("If-None-Match: \"xyz\"", headers[0]);
+}
+
+TEST(URLResponseCacheTest, Freshness) {
+  bat_ledger::URLResponseCache cache;
+  EXPECT_FALSE(cache.IsFresh(kURL, 100));
+
+  cache.OnResponse(kURL, 200, {}, 60, 100);
+  EXPECT_TRUE(cache.IsFresh(kURL, 100));
+  EXPECT_TRUE(cache.IsFresh(kURL, 159));
+  EXPECT_FALSE(cache.IsFresh(kURL, 160));
+
+  cache.OnResponse(kURL, 200, {{"ETag", "\"abc\""}}, 60, 200);
+  cache.ExpireAll();
+  EXPECT_FALSE(cache.IsFresh(kURL, 200));
+  std::vector<std::string> headers;
+  cache.AddConditionalHeaders(kURL, &headers);
+  EXPECT_EQ(1u, headers.size());
+}
+
+}  // namespace
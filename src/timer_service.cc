@@ -0,0 +1,147 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "timer_service.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace bat_ledger {
+
+TimerService::TimerService(SetHostTimerCallback set_host_timer,
+                           uint64_t coalescing_window) :
+  set_host_timer_(set_host_timer),
+  coalescing_window_(coalescing_window),
+  next_handle_(1),
+  now_(0),
+  host_deadline_(0),
+  host_timer_armed_(false),
+  firing_(false) {
+}
+
+TimerService::~TimerService() {
+}
+
+uint32_t TimerService::Start(uint64_t delay,
+                             uint64_t now,
+                             TimerCallback callback) {
+  now = UpdateTime(now);
+  uint32_t handle = next_handle_++;
+  if (next_handle_ == 0) {
+    next_handle_ = 1;
+  }
+
+  callbacks_[handle] = callback;
+  heap_.push_back(Entry{now + delay, handle});
+  std::push_heap(heap_.begin(), heap_.end(), Later());
+
+  // host timer is armed once all due timers ran
+  if (!firing_) {
+    ArmHostTimer(now);
+  }
+
+  return handle;
+}
+
+bool TimerService::Cancel(uint32_t handle) {
+  if (callbacks_.erase(handle) == 0) {
+    return false;
+  }
+
+  // don't let cancelled timers pile up behind the long ones
+  if (heap_.size() > 2 * callbacks_.size() + 16) {
+    heap_.erase(std::remove_if(heap_.begin(), heap_.end(),
+        [this](const Entry& entry) {
+          return callbacks_.find(entry.handle) == callbacks_.end();
+        }), heap_.end());
+    std::make_heap(heap_.begin(), heap_.end(), Later());
+  }
+
+  return true;
+}
+
+bool TimerService::IsRunning(uint32_t handle) const {
+  return callbacks_.find(handle) != callbacks_.end();
+}
+
+void TimerService::OnHostTimer(uint32_t host_timer_id, uint64_t now) {
+  // host timers can't be cancelled, older host timers that were replaced
+  // by an earlier one still fire and only run whatever is due
+  auto host_timer = host_timers_.find(host_timer_id);
+  if (host_timer != host_timers_.end()) {
+    UpdateTime(host_timer->second);
+    if (host_timer_armed_ && host_timer->second == host_deadline_) {
+      host_timer_armed_ = false;
+    }
+    host_timers_.erase(host_timer);
+  }
+  now = UpdateTime(now);
+
+  std::vector<uint32_t> due;
+  PopCancelled();
+  while (!heap_.empty() &&
+         heap_.front().deadline <= now + coalescing_window_) {
+    due.push_back(heap_.front().handle);
+    std::pop_heap(heap_.begin(), heap_.end(), Later());
+    heap_.pop_back();
+    PopCancelled();
+  }
+
+  firing_ = true;
+  for (uint32_t handle : due) {
+    // callback of an earlier timer can cancel this one
+    auto iter = callbacks_.find(handle);
+    if (iter == callbacks_.end()) {
+      continue;
+    }
+
+    TimerCallback callback = std::move(iter->second);
+    callbacks_.erase(iter);
+    callback();
+  }
+  firing_ = false;
+
+  ArmHostTimer(now);
+}
+
+size_t TimerService::size() const {
+  return callbacks_.size();
+}
+
+uint64_t TimerService::UpdateTime(uint64_t now) {
+  if (now > now_) {
+    now_ = now;
+  }
+
+  return now_;
+}
+
+void TimerService::PopCancelled() {
+  while (!heap_.empty() &&
+         callbacks_.find(heap_.front().handle) == callbacks_.end()) {
+    std::pop_heap(heap_.begin(), heap_.end(), Later());
+    heap_.pop_back();
+  }
+}
+
+void TimerService::ArmHostTimer(uint64_t now) {
+  PopCancelled();
+  if (heap_.empty()) {
+    return;
+  }
+
+  uint64_t deadline = heap_.front().deadline;
+  if (host_timer_armed_ && host_deadline_ <= deadline) {
+    return;
+  }
+
+  uint64_t delay = deadline > now ? deadline - now : 0;
+  host_deadline_ = now + delay;
+  host_timer_armed_ = true;
+  uint32_t host_timer_id = 0;
+  set_host_timer_(delay, &host_timer_id);
+  host_timers_[host_timer_id] = host_deadline_;
+}
+
+}  // namespace bat_ledger
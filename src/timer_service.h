@@ -0,0 +1,84 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef BAT_LEDGER_TIMER_SERVICE_H_
+#define BAT_LEDGER_TIMER_SERVICE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <functional>
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+namespace bat_ledger {
+
+// Runs all ledger timers from a single host timer. Deadlines are kept in
+// a min-heap and callbacks are looked up by handle, so firing and
+// cancelling don't depend on the number of other timers. Timers that are
+// due within |coalescing_window| seconds of the one that fired run together
+// instead of arming another host timer.
+// Host timer is trusted to fire on time, so service time never goes back
+// and it catches up with the deadline of the host timer that fired.
+// Times are in seconds. All methods need to be called on the ledger thread.
+class TimerService {
+ public:
+  using TimerCallback = std::function<void()>;
+  // Arms host timer that fires in |delay| seconds and sets its id
+  using SetHostTimerCallback =
+      std::function<void(uint64_t delay, uint32_t* timer_id)>;
+
+  TimerService(SetHostTimerCallback set_host_timer,
+               uint64_t coalescing_window);
+  ~TimerService();
+
+  // Returns handle of the new timer, handle is never 0
+  uint32_t Start(uint64_t delay, uint64_t now, TimerCallback callback);
+
+  // Returns false when timer already fired or was cancelled
+  bool Cancel(uint32_t handle);
+
+  bool IsRunning(uint32_t handle) const;
+
+  // Called when any of the host timers fires
+  void OnHostTimer(uint32_t host_timer_id, uint64_t now);
+
+  size_t size() const;
+
+ private:
+  struct Entry {
+    uint64_t deadline;
+    uint32_t handle;
+  };
+
+  // earlier deadline first, timers with the same deadline in start order
+  struct Later {
+    bool operator()(const Entry& a, const Entry& b) const {
+      return a.deadline > b.deadline ||
+          (a.deadline == b.deadline && a.handle > b.handle);
+    }
+  };
+
+  uint64_t UpdateTime(uint64_t now);
+  void PopCancelled();
+  void ArmHostTimer(uint64_t now);
+
+  SetHostTimerCallback set_host_timer_;
+  uint64_t coalescing_window_;
+  // cancelled timers stay in the heap until they reach the top
+  std::vector<Entry> heap_;
+  std::unordered_map<uint32_t, TimerCallback> callbacks_;
+  // host timer id -> deadline
+  std::map<uint32_t, uint64_t> host_timers_;
+  uint32_t next_handle_;
+  uint64_t now_;
+  uint64_t host_deadline_;
+  bool host_timer_armed_;
+  bool firing_;
+};
+
+}  // namespace bat_ledger
+
+#endif  // BAT_LEDGER_TIMER_SERVICE_H_
@@ -8,14 +8,35 @@
 
 namespace bat_ledger {
 
-URLRequestHandler::URLRequestHandler() {}
+URLRequestHandler::URLRequestHandler() :
+  scheduler_(nullptr),
+  priority_(URLRequestPriority::PANEL) {}
+
+URLRequestHandler::URLRequestHandler(URLRequestScheduler* scheduler,
+                                     URLRequestPriority priority) :
+  scheduler_(scheduler),
+  priority_(priority) {}
 
 URLRequestHandler::~URLRequestHandler() {
   Clear();
 }
 
 void URLRequestHandler::Clear() {
-  request_handlers_.clear();
+  std::map<uint64_t, URLResponseCallback> handlers;
+  handlers.swap(request_handlers_);
+  if (!scheduler_) {
+    return;
+  }
+
+  // queued requests would respond to us after we are gone. They are all
+  // removed before the slots of the started ones are released, so none
+  // of them is started in a released slot.
+  for (const auto& handler : handlers) {
+    scheduler_->Cancel(handler.first);
+  }
+  for (const auto& handler : handlers) {
+    scheduler_->Release(handler.first);
+  }
 }
 
 void URLRequestHandler::OnURLRequestResponse(uint64_t request_id,
@@ -23,7 +44,11 @@ void URLRequestHandler::OnURLRequestResponse(uint64_t request_id,
                                             int response_code,
                                             const std::string& response,
                                             const std::map<std::string, std::string>& headers) {
-  if (!RunRequestHandler(request_id, response_code == 200, response, headers)) {
+  if (scheduler_) {
+    scheduler_->OnRequestFinished(request_id, response_code, response);
+  }
+
+  if (!RunResponseHandler(request_id, response_code, response, headers)) {
     return;
   }
 }
@@ -31,12 +56,57 @@ void URLRequestHandler::OnURLRequestResponse(uint64_t request_id,
 bool URLRequestHandler::AddRequestHandler(
     std::unique_ptr<ledger::LedgerURLLoader> loader,
     URLRequestCallback callback) {
+  return AddRequestHandler(std::move(loader), callback, priority_);
+}
+
+bool URLRequestHandler::AddRequestHandler(
+    std::unique_ptr<ledger::LedgerURLLoader> loader,
+    URLRequestCallback callback,
+    URLRequestPriority priority) {
+  return AddHandler(std::move(loader),
+      [callback](int response_code,
+                 const std::string& response,
+                 const std::map<std::string, std::string>& headers) {
+        callback(response_code == 200, response, headers);
+      },
+      priority);
+}
+
+bool URLRequestHandler::AddResponseHandler(
+    std::unique_ptr<ledger::LedgerURLLoader> loader,
+    URLResponseCallback callback) {
+  return AddHandler(std::move(loader), callback, priority_);
+}
+
+bool URLRequestHandler::AddHandler(
+    std::unique_ptr<ledger::LedgerURLLoader> loader,
+    URLResponseCallback callback,
+    URLRequestPriority priority) {
   uint64_t request_id = loader->request_id();
-  if (request_handlers_.find(request_id) != request_handlers_.end())
+  if (request_handlers_.find(request_id) != request_handlers_.end()) {
+    if (scheduler_) {
+      scheduler_->Discard(request_id);
+    }
     return false;
+  }
 
   request_handlers_[request_id] = callback;
-  loader->Start();
+  if (scheduler_) {
+    scheduler_->Schedule(std::move(loader), priority);
+  } else {
+    loader->Start();
+  }
+  return true;
+}
+
+bool URLRequestHandler::CancelRequest(uint64_t request_id) {
+  if (request_handlers_.find(request_id) == request_handlers_.end())
+    return false;
+
+  if (!scheduler_ || !scheduler_->Cancel(request_id))
+    return false;
+
+  request_handlers_.erase(request_id);
   return true;
 }
 
@@ -44,12 +114,19 @@ bool URLRequestHandler::RunRequestHandler(uint64_t request_id,
                                           bool success,
                                           const std::string& response,
                                           const std::map<std::string, std::string>& headers) {
+  return RunResponseHandler(request_id, success ? 200 : 0, response, headers);
+}
+
+bool URLRequestHandler::RunResponseHandler(uint64_t request_id,
+                                           int response_code,
+                                           const std::string& response,
+                                           const std::map<std::string, std::string>& headers) {
   if (request_handlers_.find(request_id) == request_handlers_.end())
     return false;
 
   auto callback = request_handlers_[request_id];
   request_handlers_.erase(request_id);
-  callback(success, response, headers);
+  callback(response_code, response, headers);
   return true;
 }
 
@@ -13,23 +13,43 @@
 #include "bat/ledger/ledger_callback_handler.h"
 #include "bat/ledger/ledger_url_loader.h"
 #include "bat_helper.h"
+#include "url_request_scheduler.h"
 
 namespace bat_ledger {
 
 class URLRequestHandler : public ledger::LedgerCallbackHandler {
  public:
   using URLRequestCallback = std::function<void (bool, const std::string&, const std::map<std::string, std::string>& headers)>;
+  // Gets the http response code, used by requests that handle
+  // other codes than 200, e.g. 304 for conditional requests
+  using URLResponseCallback = std::function<void (int, const std::string&, const std::map<std::string, std::string>& headers)>;
 
   URLRequestHandler();
+  // Requests are started through |scheduler| with |priority|
+  // unless it's overridden in AddRequestHandler
+  URLRequestHandler(URLRequestScheduler* scheduler,
+                    URLRequestPriority priority);
   ~URLRequestHandler() override;
 
   void Clear();
   bool AddRequestHandler(std::unique_ptr<ledger::LedgerURLLoader> loader,
                          URLRequestCallback callback);
+  bool AddRequestHandler(std::unique_ptr<ledger::LedgerURLLoader> loader,
+                         URLRequestCallback callback,
+                         URLRequestPriority priority);
+  bool AddResponseHandler(std::unique_ptr<ledger::LedgerURLLoader> loader,
+                          URLResponseCallback callback);
+  // Cancels request that is still waiting in the scheduler queue,
+  // callback won't be called for it
+  bool CancelRequest(uint64_t request_id);
   bool RunRequestHandler(uint64_t request_id,
                          bool success,
                          const std::string& response,
                          const std::map<std::string, std::string>& headers);
+  bool RunResponseHandler(uint64_t request_id,
+                          int response_code,
+                          const std::string& response,
+                          const std::map<std::string, std::string>& headers);
 
  private:
   //  LedgerCallbackHandler impl
@@ -39,7 +59,13 @@ class URLRequestHandler : public ledger::LedgerCallbackHandler {
                             const std::string& response,
                             const std::map<std::string, std::string>& headers) override;
 
-  std::map<uint64_t, URLRequestCallback> request_handlers_;
+  bool AddHandler(std::unique_ptr<ledger::LedgerURLLoader> loader,
+                  URLResponseCallback callback,
+                  URLRequestPriority priority);
+
+  std::map<uint64_t, URLResponseCallback> request_handlers_;
+  URLRequestScheduler* scheduler_;  // NOT OWNED
+  URLRequestPriority priority_;
  };
 }  // namespace bat_ledger
 
@@ -0,0 +1,234 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "url_request_scheduler.h"
+
+#include <utility>
+
+#include "bat_helper_platform.h"
+#include "ledger_metrics.h"
+#include "request_trace.h"
+
+namespace bat_ledger {
+
+URLRequestScheduler::QueuedRequest::QueuedRequest() {}
+
+URLRequestScheduler::QueuedRequest::QueuedRequest(QueuedRequest&& request) :
+  loader(std::move(request.loader)),
+  host(std::move(request.host)) {}
+
+URLRequestScheduler::QueuedRequest&
+URLRequestScheduler::QueuedRequest::operator=(QueuedRequest&& request) {
+  loader = std::move(request.loader);
+  host = std::move(request.host);
+  return *this;
+}
+
+URLRequestScheduler::QueuedRequest::~QueuedRequest() {}
+
+URLRequestScheduler::URLRequestScheduler(size_t max_requests,
+                                         size_t max_requests_per_host) :
+  max_requests_(max_requests > 0 ? max_requests : 1),
+  max_requests_per_host_(max_requests_per_host > 0 ?
+      max_requests_per_host : 1),
+  starting_(false),
+  metrics_(nullptr),
+  trace_(nullptr) {
+}
+
+URLRequestScheduler::~URLRequestScheduler() {
+}
+
+void URLRequestScheduler::SetMetrics(LedgerMetrics* metrics) {
+  metrics_ = metrics;
+}
+
+void URLRequestScheduler::SetTrace(RequestTrace* trace) {
+  trace_ = trace;
+}
+
+// static
+std::string URLRequestScheduler::GetHost(const std::string& url) {
+  size_t start = url.find("://");
+  start = (start == std::string::npos) ? 0 : start + 3;
+  size_t end = url.find_first_of(":/?#", start);
+  if (end == std::string::npos) {
+    end = url.length();
+  }
+
+  return url.substr(start, end - start);
+}
+
+void URLRequestScheduler::SetRequestURL(uint64_t request_id,
+                                        const std::string& url,
+                                        size_t request_size) {
+  request_hosts_[request_id] = GetHost(url);
+  if (metrics_) {
+    metrics_->OnRequestStarted(request_id, url);
+  }
+  if (trace_) {
+    trace_->OnRequestStarted(request_id, url, request_size);
+  }
+}
+
+void URLRequestScheduler::Schedule(
+    std::unique_ptr<ledger::LedgerURLLoader> loader,
+    URLRequestPriority priority) {
+  QueuedRequest request;
+  auto iter = request_hosts_.find(loader->request_id());
+  if (iter != request_hosts_.end()) {
+    request.host = iter->second;
+    request_hosts_.erase(iter);
+  }
+  request.loader = std::move(loader);
+
+  size_t index = static_cast<size_t>(priority);
+  DCHECK(index < kPriorities);
+  queues_[index].push_back(std::move(request));
+
+  StartQueued();
+}
+
+bool URLRequestScheduler::Cancel(uint64_t request_id) {
+  request_hosts_.erase(request_id);
+  for (auto& queue : queues_) {
+    for (auto iter = queue.begin(); iter != queue.end(); ++iter) {
+      if (iter->loader->request_id() == request_id) {
+        queue.erase(iter);
+        if (metrics_) {
+          metrics_->OnRequestCancelled(request_id);
+        }
+        if (trace_) {
+          trace_->OnRequestCancelled(request_id);
+        }
+        return true;
+      }
+    }
+  }
+
+  return false;
+}
+
+void URLRequestScheduler::Release(uint64_t request_id) {
+  if (Cancel(request_id) || !ReleaseSlot(request_id)) {
+    return;
+  }
+
+  if (metrics_) {
+    metrics_->OnRequestCancelled(request_id);
+  }
+  if (trace_) {
+    trace_->OnRequestCancelled(request_id);
+  }
+
+  StartQueued();
+}
+
+void URLRequestScheduler::Discard(uint64_t request_id) {
+  if (request_hosts_.erase(request_id) == 0) {
+    return;
+  }
+
+  if (metrics_) {
+    metrics_->OnRequestCancelled(request_id);
+  }
+  if (trace_) {
+    trace_->OnRequestCancelled(request_id);
+  }
+}
+
+void URLRequestScheduler::OnRequestFinished(uint64_t request_id,
+                                            int response_code,
+                                            const std::string& response) {
+  if (metrics_) {
+    metrics_->OnRequestFinished(request_id);
+  }
+  if (trace_) {
+    trace_->OnRequestFinished(request_id, response_code, response);
+  }
+
+  // the loader was started without us
+  request_hosts_.erase(request_id);
+
+  if (ReleaseSlot(request_id)) {
+    StartQueued();
+  }
+}
+
+bool URLRequestScheduler::ReleaseSlot(uint64_t request_id) {
+  auto iter = active_requests_.find(request_id);
+  if (iter == active_requests_.end()) {
+    return false;
+  }
+
+  auto host = active_per_host_.find(iter->second);
+  if (host != active_per_host_.end() && --host->second == 0) {
+    active_per_host_.erase(host);
+  }
+  active_requests_.erase(iter);
+  return true;
+}
+
+size_t URLRequestScheduler::active_count() const {
+  return active_requests_.size();
+}
+
+size_t URLRequestScheduler::queued_count() const {
+  size_t count = 0;
+  for (const auto& queue : queues_) {
+    count += queue.size();
+  }
+
+  return count;
+}
+
+size_t URLRequestScheduler::unscheduled_count() const {
+  return request_hosts_.size();
+}
+
+bool URLRequestScheduler::CanStart(const std::string& host) const {
+  auto iter = active_per_host_.find(host);
+  return iter == active_per_host_.end() ||
+      iter->second < max_requests_per_host_;
+}
+
+void URLRequestScheduler::StartQueued() {
+  // Start() can finish the request synchronously and call us again,
+  // outer loop will pick up the free slot in that case
+  if (starting_) {
+    return;
+  }
+  starting_ = true;
+
+  while (active_requests_.size() < max_requests_) {
+    bool found = false;
+    QueuedRequest request;
+    for (auto& queue : queues_) {
+      for (auto iter = queue.begin(); iter != queue.end(); ++iter) {
+        if (CanStart(iter->host)) {
+          request = std::move(*iter);
+          queue.erase(iter);
+          found = true;
+          break;
+        }
+      }
+
+      if (found) {
+        break;
+      }
+    }
+
+    if (!found) {
+      break;
+    }
+
+    active_requests_[request.loader->request_id()] = request.host;
+    active_per_host_[request.host]++;
+    request.loader->Start();
+  }
+
+  starting_ = false;
+}
+
+}  // namespace bat_ledger
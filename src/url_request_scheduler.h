@@ -0,0 +1,104 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef BAT_LEDGER_URL_REQUEST_SCHEDULER_H_
+#define BAT_LEDGER_URL_REQUEST_SCHEDULER_H_
+
+#include <deque>
+#include <map>
+#include <memory>
+#include <string>
+
+#include "bat/ledger/ledger_url_loader.h"
+
+namespace bat_ledger {
+
+class LedgerMetrics;
+class RequestTrace;
+
+// Lower value is started first
+enum class URLRequestPriority {
+  CONTRIBUTION = 0,  // contribution and wallet requests
+  PANEL = 1,  // data that user is waiting for in the panel
+  BACKGROUND = 2,  // periodic refreshes
+};
+
+// Starts url loaders in priority order while keeping number of
+// requests in flight under global and per host limits.
+// All methods need to be called on the ledger thread.
+class URLRequestScheduler {
+ public:
+  URLRequestScheduler(size_t max_requests, size_t max_requests_per_host);
+  ~URLRequestScheduler();
+
+  // Request latency is recorded to |metrics| when it's set
+  void SetMetrics(LedgerMetrics* metrics);
+  // Finished and cancelled requests are traced to |trace| when it's set
+  void SetTrace(RequestTrace* trace);
+
+  // Remembers url of the loader, so that the request can be limited
+  // per host when it's scheduled
+  void SetRequestURL(uint64_t request_id,
+                     const std::string& url,
+                     size_t request_size = 0);
+
+  // Starts the loader now or once there is a free slot for it
+  void Schedule(std::unique_ptr<ledger::LedgerURLLoader> loader,
+                URLRequestPriority priority);
+
+  // Removes queued request, returns false when request is
+  // unknown or it was already started
+  bool Cancel(uint64_t request_id);
+
+  // Forgets the request whether it's queued or started, the slot of a
+  // started one is released since nobody waits for its response anymore
+  void Release(uint64_t request_id);
+
+  // Forgets the url of a loader that won't be scheduled
+  void Discard(uint64_t request_id);
+
+  // Releases slot of the finished request and starts queued requests
+  void OnRequestFinished(uint64_t request_id,
+                         int response_code = 0,
+                         const std::string& response = std::string());
+
+  size_t active_count() const;
+  size_t queued_count() const;
+  // loaders that have their url set but are not scheduled yet
+  size_t unscheduled_count() const;
+
+  static std::string GetHost(const std::string& url);
+
+ private:
+  struct QueuedRequest {
+    QueuedRequest();
+    QueuedRequest(QueuedRequest&& request);
+    QueuedRequest& operator=(QueuedRequest&& request);
+    ~QueuedRequest();
+
+    std::unique_ptr<ledger::LedgerURLLoader> loader;
+    std::string host;
+  };
+
+  bool CanStart(const std::string& host) const;
+  void StartQueued();
+  // Returns false when the request is not active
+  bool ReleaseSlot(uint64_t request_id);
+
+  static const size_t kPriorities = 3;
+
+  std::deque<QueuedRequest> queues_[kPriorities];
+  std::map<uint64_t, std::string> request_hosts_;
+  std::map<uint64_t, std::string> active_requests_;
+  std::map<std::string, size_t> active_per_host_;
+  size_t max_requests_;
+  size_t max_requests_per_host_;
+  bool starting_;
+  LedgerMetrics* metrics_;  // NOT OWNED
+  RequestTrace* trace_;  // NOT OWNED
+};
+
+}  // namespace bat_ledger
+
+#endif  // BAT_LEDGER_URL_REQUEST_SCHEDULER_H_
@@ -0,0 +1,121 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "url_response_cache.h"
+
+#include <algorithm>
+#include <cctype>
+
+namespace bat_ledger {
+
+namespace {
+
+bool EqualsCaseInsensitive(const std::string& a, const std::string& b) {
+  return a.length() == b.length() &&
+      std::equal(a.begin(), a.end(), b.begin(), [](char x, char y) {
+        return tolower(static_cast<unsigned char>(x)) ==
+            tolower(static_cast<unsigned char>(y));
+      });
+}
+
+}  // namespace
+
+URLResponseCache::URLResponseCache() {}
+
+URLResponseCache::~URLResponseCache() {}
+
+// static
+std::string URLResponseCache::GetHeader(
+    const std::map<std::string, std::string>& headers,
+    const std::string& name) {
+  // header names are case insensitive
+  for (const auto& header : headers) {
+    if (EqualsCaseInsensitive(header.first, name)) {
+      return header.second;
+    }
+  }
+
+  return "";
+}
+
+void URLResponseCache::OnResponse(
+    const std::string& url,
+    int response_code,
+    const std::map<std::string, std::string>& headers,
+    uint64_t ttl,
+    uint64_t now) {
+  std::string etag = GetHeader(headers, "etag");
+  std::string last_modified = GetHeader(headers, "last-modified");
+
+  Entry& entry = entries_[url];
+  // 304 doesn't have to repeat the validators
+  bool not_modified = response_code == 304;
+  if (!not_modified || !etag.empty()) {
+    entry.etag = etag;
+  }
+  if (!not_modified || !last_modified.empty()) {
+    entry.last_modified = last_modified;
+  }
+  entry.expires = ttl > 0 ? now + ttl : 0;
+}
+
+bool URLResponseCache::IsFresh(const std::string& url, uint64_t now) const {
+  auto iter = entries_.find(url);
+  return iter != entries_.end() && now < iter->second.expires;
+}
+
+void URLResponseCache::AddConditionalHeaders(
+    const std::string& url,
+    std::vector<std::string>* headers) const {
+  auto iter = entries_.find(url);
+  if (iter == entries_.end()) {
+    return;
+  }
+
+  if (!iter->second.etag.empty()) {
+    headers->push_back("If-None-Match: " + iter->second.etag);
+  }
+  if (!iter->second.last_modified.empty()) {
+    headers->push_back("If-Modified-Since: " + iter->second.last_modified);
+  }
+}
+
+bool URLResponseCache::GetValidators(const std::string& url,
+                                     std::string* etag,
+                                     std::string* last_modified) const {
+  auto iter = entries_.find(url);
+  if (iter == entries_.end() ||
+      (iter->second.etag.empty() && iter->second.last_modified.empty())) {
+    return false;
+  }
+
+  *etag = iter->second.etag;
+  *last_modified = iter->second.last_modified;
+  return true;
+}
+
+void URLResponseCache::SetValidators(const std::string& url,
+                                     const std::string& etag,
+                                     const std::string& last_modified) {
+  if (etag.empty() && last_modified.empty()) {
+    Remove(url);
+    return;
+  }
+
+  Entry& entry = entries_[url];
+  entry.etag = etag;
+  entry.last_modified = last_modified;
+}
+
+void URLResponseCache::Remove(const std::string& url) {
+  entries_.erase(url);
+}
+
+void URLResponseCache::ExpireAll() {
+  for (auto& entry : entries_) {
+    entry.second.expires = 0;
+  }
+}
+
+}  // namespace bat_ledger
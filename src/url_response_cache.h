@@ -0,0 +1,72 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef BAT_LEDGER_URL_RESPONSE_CACHE_H_
+#define BAT_LEDGER_URL_RESPONSE_CACHE_H_
+
+#include <stdint.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
+namespace bat_ledger {
+
+// Remembers ETag/Last-Modified validators of GET responses, so that the
+// next request for the same url can be made conditional. Cache doesn't
+// keep response bodies, owner of the url keeps the parsed response and
+// reuses it when the server answers with 304 or while the entry is fresh.
+// All methods need to be called on the ledger thread.
+class URLResponseCache {
+ public:
+  URLResponseCache();
+  ~URLResponseCache();
+
+  // Stores validators from |headers| of a successful response and keeps
+  // the entry fresh for |ttl| seconds from |now|. A 200 replaces the
+  // validators, a new representation without them has none; a 304 only
+  // updates the ones it repeats.
+  void OnResponse(const std::string& url,
+                  int response_code,
+                  const std::map<std::string, std::string>& headers,
+                  uint64_t ttl,
+                  uint64_t now);
+
+  // Returns true while response for |url| can be reused without a request
+  bool IsFresh(const std::string& url, uint64_t now) const;
+
+  // Appends If-None-Match/If-Modified-Since for |url| to |headers|
+  void AddConditionalHeaders(const std::string& url,
+                             std::vector<std::string>* headers) const;
+
+  // Used to persist validators of the responses that are saved to disk
+  bool GetValidators(const std::string& url,
+                     std::string* etag,
+                     std::string* last_modified) const;
+  void SetValidators(const std::string& url,
+                     const std::string& etag,
+                     const std::string& last_modified);
+
+  void Remove(const std::string& url);
+
+  // Keeps validators, but next request will go to the server
+  void ExpireAll();
+
+  static std::string GetHeader(
+      const std::map<std::string, std::string>& headers,
+      const std::string& name);
+
+ private:
+  struct Entry {
+    std::string etag;
+    std::string last_modified;
+    uint64_t expires = 0;
+  };
+
+  std::map<std::string, Entry> entries_;
+};
+
+}  // namespace bat_ledger
+
+#endif  // BAT_LEDGER_URL_RESPONSE_CACHE_H_